@@ -0,0 +1,82 @@
+#include "../../Umbrella-Engine/Utils/Cryptography/CRC32.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+
+/**
+ * Checksum throughput for the CRC32 / CRC32C paths the running CPU picks and for the portable fallback.
+ *
+ *		CRCBenchmark [buffer size in MiB, default 64]
+ */
+
+using namespace J;
+using namespace J::Crypto;
+
+using CRCFunction = uint32(*)(const void*, SIZE_T, uint32);
+
+
+static void Measure(const char* InName, CRCFunction InFunction, const JVector<uint8>& InBuffer, SIZE_T InBlockSize)
+{
+	// at least ~256 MiB of data, so short blocks are not dominated by the clock
+	const SIZE_T repeats = std::max<SIZE_T>(1, (SIZE_T(256) << 20) / InBuffer.size());
+
+	// summed so the calls cannot be optimized out
+	uint32 checksum = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (SIZE_T r = 0; r < repeats; ++r)
+	{
+		for (SIZE_T offset = 0; offset + InBlockSize <= InBuffer.size(); offset += InBlockSize)
+		{
+			checksum += InFunction(InBuffer.data() + offset, InBlockSize, 0);
+		}
+	}
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	const double bytes = static_cast<double>(repeats) * (InBuffer.size() / InBlockSize) * InBlockSize;
+
+	std::printf("%-16s %10zu B blocks  %8.2f GB/s  (%08x)\n", InName, InBlockSize, bytes / seconds * 1e-9, checksum);
+}
+
+int main(int argc, char* argv[])
+{
+	const SIZE_T megabytes = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 64;
+
+	if (megabytes == 0)
+	{
+		std::printf("Usage: CRCBenchmark [buffer size in MiB]\n");
+		return 1;
+	}
+
+	JVector<uint8> buffer(megabytes << 20);
+	std::mt19937 random(42);
+
+	for (uint8& value : buffer)
+	{
+		value = static_cast<uint8>(random());
+	}
+
+	const char* check = "123456789";
+
+	if (CRC32(check, 9) != 0xCBF43926u || CRC32C(check, 9) != 0xE3069283u)
+	{
+		std::printf("CRC check values mismatch!\n");
+		return 1;
+	}
+
+	const SIZE_T blockSizes[] = { 64, 4096, 64 * 1024, buffer.size() };
+
+	for (SIZE_T blockSize : blockSizes)
+	{
+		Measure("CRC32", static_cast<CRCFunction>(&CRC32), buffer, blockSize);
+		Measure("CRC32 (table)", &Details::CRC32Software, buffer, blockSize);
+		Measure("CRC32C", static_cast<CRCFunction>(&CRC32C), buffer, blockSize);
+		Measure("CRC32C (table)", &Details::CRC32CSoftware, buffer, blockSize);
+	}
+
+	return 0;
+}
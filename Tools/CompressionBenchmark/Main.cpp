@@ -0,0 +1,112 @@
+#include "../../Umbrella-Engine/Utils/Compression/BlockCompression.h"
+#include "../../Umbrella-Engine/Utils/FileSystem/FileSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+
+/**
+ * Block stream ratio and throughput, single threaded and on the engine thread pool.
+ *
+ *		CompressionBenchmark [file, default 64 MiB of generated text-like data] [block size in KiB, default 64]
+ */
+
+using namespace J;
+using namespace J::Compression;
+
+
+/** Words from a small vocabulary with random numbers in between, compresses about like source text. */
+static JVector<byte> GenerateData(SIZE_T InSize)
+{
+	static const char* const words[] = { "vertex", "texture", "shader", "buffer", "uniform", "mesh", "frame", "light", " ", "\n", "\t", "=", ";" };
+
+	JVector<byte> data;
+	data.reserve(InSize + 32);
+
+	std::mt19937 random(42);
+
+	while (data.size() < InSize)
+	{
+		const uint32 value = random();
+		const char* word = words[value % std::size(words)];
+
+		for (const char* c = word; *c != 0; ++c)
+		{
+			data.push_back(static_cast<byte>(*c));
+		}
+
+		if ((value >> 8) % 4 == 0)
+		{
+			data.push_back(static_cast<byte>('0' + (value >> 16) % 10));
+		}
+	}
+
+	data.resize(InSize);
+	return data;
+}
+
+template<class FunctionType>
+static double Measure(const char* InName, SIZE_T InBytes, FunctionType&& InFunction)
+{
+	// the best of a few runs, the first one warms the pool and the caches
+	double best = 1e30;
+
+	for (int run = 0; run < 5; ++run)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		InFunction();
+		best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	std::printf("%-24s %8.2f GB/s\n", InName, InBytes / best * 1e-9);
+	return best;
+}
+
+int main(int argc, char* argv[])
+{
+	JVector<byte> data;
+
+	if (argc > 1)
+	{
+		data = system::File::ReadAll(system::FilePath(argv[1]));
+
+		if (data.empty())
+		{
+			std::printf("%s is empty\n", argv[1]);
+			return 1;
+		}
+	}
+	else
+	{
+		data = GenerateData(SIZE_T(64) << 20);
+	}
+
+	const SIZE_T blockSize = (argc > 2) ? (std::strtoull(argv[2], nullptr, 10) << 10) : DefaultBlockSize;
+
+	if (blockSize == 0 || blockSize > MaxBlockSize)
+	{
+		std::printf("Usage: CompressionBenchmark [file] [block size in KiB, up to %zu]\n", MaxBlockSize >> 10);
+		return 1;
+	}
+
+	JVector<byte> compressed = Compress(data, blockSize);
+	JVector<byte> decompressed(data.size());
+
+	if (!Decompress(compressed, decompressed.data()) || decompressed != data)
+	{
+		std::printf("Round trip mismatch!\n");
+		return 1;
+	}
+
+	std::printf("%zu -> %zu bytes (%.3f), %zu KiB blocks\n", data.size(), compressed.size(),
+				static_cast<double>(compressed.size()) / data.size(), blockSize >> 10);
+
+	Measure("Compress", data.size(), [&]() { compressed = Compress(data, blockSize, false); });
+	Measure("Compress (parallel)", data.size(), [&]() { compressed = Compress(data, blockSize, true); });
+	Measure("Decompress", data.size(), [&]() { Decompress(compressed, decompressed.data(), false); });
+	Measure("Decompress (parallel)", data.size(), [&]() { Decompress(compressed, decompressed.data(), true); });
+
+	return 0;
+}
@@ -0,0 +1,101 @@
+#include "../../Umbrella-Engine/Image/ImageLoader.h"
+#include "../../Umbrella-Engine/Image/ImageUtils.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+
+/**
+ * Golden image comparison for render regression checks.
+ *
+ *		ImageDiff <reference> <image> [--tolerance <value>] [--error-map <path>]
+ *
+ * Exit codes: 0 - images match within the tolerance, 1 - they differ, 2 - bad arguments or unreadable images.
+ */
+
+using namespace J;
+using namespace J::Utils;
+
+
+static void PrintUsage()
+{
+	std::cout << "Usage: ImageDiff <reference> <image> [--tolerance <value>] [--error-map <path>]\n"
+			  << "  --tolerance	largest channel difference still considered equal, in [0, 1] (default 0)\n"
+			  << "  --error-map	saves the per-pixel error map\n";
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	const std::string referencePath = argv[1];
+	const std::string imagePath = argv[2];
+
+	float tolerance = 0.0f;
+	std::string errorMapPath;
+
+	for (int i = 3; i < argc; ++i)
+	{
+		const std::string argument = argv[i];
+
+		if (argument == "--tolerance" && i + 1 < argc)
+		{
+			tolerance = std::strtof(argv[++i], nullptr);
+		}
+		else if (argument == "--error-map" && i + 1 < argc)
+		{
+			errorMapPath = argv[++i];
+		}
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+
+	auto reference = ImageLoader::Load(referencePath);
+	auto image = ImageLoader::Load(imagePath);
+
+	if (!reference || !image)
+	{
+		std::cout << "Could not load " << (reference ? imagePath : referencePath) << '\n';
+		return 2;
+	}
+
+	auto result = ImageUtils::Compare(*reference, *image, tolerance);
+
+	if (!result.bComparable)
+	{
+		std::cout << "Images have different sizes or channels: "
+				  << reference->GetWidth() << 'x' << reference->GetHeight() << 'x' << reference->GetChannelsCount() << " vs "
+				  << image->GetWidth() << 'x' << image->GetHeight() << 'x' << image->GetChannelsCount() << '\n';
+		return 1;
+	}
+
+	std::cout << "max delta:      " << result.MaxDelta << " at (" << result.MaxDeltaPosition.x << ", " << result.MaxDeltaPosition.y << ")\n"
+			  << "over tolerance: " << result.PixelsOverTolerance << " / " << reference->GetPixelsCount() << " pixels\n"
+			  << "mse:            " << result.MeanSquaredError << '\n'
+			  << "psnr:           " << result.PSNR << " dB\n"
+			  << "ssim:           " << result.SSIM << '\n'
+			  << (result.bPassed ? "PASSED" : "FAILED") << '\n';
+
+	if (!errorMapPath.empty())
+	{
+		// 8-bit values proportional to the error: no sRGB curve, no dithering
+		STonemapSettings settings;
+		settings.Operator = ETonemapOperator::Clamp;
+		settings.bEncodeSRGB = false;
+		settings.Dither = EDitherMode::None;
+
+		if (!ImageLoader::Save(errorMapPath, result.ErrorMap, settings))
+		{
+			std::cout << "Could not save " << errorMapPath << '\n';
+		}
+	}
+
+	return result.bPassed ? 0 : 1;
+}
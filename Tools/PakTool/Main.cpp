@@ -0,0 +1,150 @@
+#include "../../Umbrella-Engine/Utils/FileSystem/Pak.h"
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+
+/**
+ * Offline packer and inspector for engine archives.
+ *
+ *		PakTool create <output.pak> <directory> [--prefix <path>] [--no-crc] [--compress]
+ *		PakTool list <archive.pak>
+ *		PakTool verify <archive.pak>
+ *
+ * Exit codes: 0 - success, 1 - the archive is damaged (verify), 2 - bad arguments or I/O errors.
+ */
+
+using namespace J;
+using namespace J::system;
+
+
+static void PrintUsage()
+{
+	std::cout << "Usage: PakTool create <output.pak> <directory> [--prefix <path>] [--no-crc] [--compress]\n"
+			  << "       PakTool list <archive.pak>\n"
+			  << "       PakTool verify <archive.pak>\n"
+			  << "  --prefix	path the files of the directory are stored under\n"
+			  << "  --no-crc	skips the per-entry checksums\n"
+			  << "  --compress	compresses the entries that shrink enough, the rest stay stored\n";
+}
+
+static int Create(int argc, char* argv[])
+{
+	if (argc < 4)
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	std::string prefix;
+	bool bCRC = true;
+	EPakCompression compression = EPakCompression::None;
+
+	for (int i = 4; i < argc; ++i)
+	{
+		const std::string option = argv[i];
+
+		if (option == "--prefix" && i + 1 < argc)
+		{
+			prefix = argv[++i];
+		}
+		else if (option == "--no-crc")
+		{
+			bCRC = false;
+		}
+		else if (option == "--compress")
+		{
+			compression = EPakCompression::LZBlock;
+		}
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+
+	if (!IsDirectory(argv[3]))
+	{
+		std::cout << argv[3] << " is not a directory\n";
+		return 2;
+	}
+
+	PakWriter writer;
+	const SIZE_T count = writer.AddDirectory(argv[3], prefix, compression, bCRC);
+
+	if (!writer.Write(argv[2]))
+	{
+		std::cout << "Could not write " << argv[2] << "\n";
+		return 2;
+	}
+
+	std::cout << "Packed " << count << " files into " << argv[2] << "\n";
+	return 0;
+}
+
+static int List(const PakArchive& InArchive)
+{
+	for (const SPakEntry& entry : InArchive.GetEntries())
+	{
+		std::printf("%12llu %12llu  %08x  %.*s\n",
+					static_cast<unsigned long long>(entry.Size),
+					static_cast<unsigned long long>(entry.StoredSize),
+					entry.bHasCRC ? entry.CRC : 0u,
+					static_cast<int>(entry.NameLength),
+					InArchive.GetEntryPath(entry).data());
+	}
+
+	return 0;
+}
+
+static int Verify(const PakArchive& InArchive)
+{
+	SIZE_T damaged = 0;
+	JVector<byte> buffer;
+
+	for (const SPakEntry& entry : InArchive.GetEntries())
+	{
+		buffer.resize(static_cast<SIZE_T>(entry.Size));
+
+		if (!InArchive.Read(entry, buffer.data()))
+		{
+			std::cout << "Damaged: " << InArchive.GetEntryPath(entry) << "\n";
+			++damaged;
+		}
+	}
+
+	std::cout << InArchive.GetEntries().size() << " entries, " << damaged << " damaged\n";
+	return damaged == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	const std::string command = argv[1];
+
+	if (command == "create")
+	{
+		return Create(argc, argv);
+	}
+
+	if (command != "list" && command != "verify")
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	PakArchive archive;
+
+	if (!archive.Open(argv[2]))
+	{
+		std::cout << "Could not open " << argv[2] << " or it is not a valid archive\n";
+		return 2;
+	}
+
+	return (command == "list") ? List(archive) : Verify(archive);
+}
@@ -1,4 +1,6 @@
 #include "Application.h"
+#include "../Utils/FileSystem/HotReload.h"
+#include "../Utils/Profiling/Profiler.h"
 
 
 namespace J
@@ -18,11 +20,15 @@ namespace J
 	{
 		bIsRunning = true;
 
+		JF_PROFILE_THREAD("Main");
+
 		while (bIsRunning)
 		{
 			OnUpdate();
 
 			OnRender();
+
+			JF_PROFILE_FRAME();
 		}
 	}
 
@@ -34,12 +40,19 @@ namespace J
 
 	void Application::OnUpdate()
 	{
+		JF_PROFILE_SCOPE("Application::OnUpdate");
+
 		// process all the events and update states.
 		window->OnUpdate();
+
+		// textures and shaders whose files changed, on the thread that owns the GL context
+		system::HotReload::Get().Update();
 	}
 
 	void Application::OnRender()
 	{
+		JF_PROFILE_SCOPE("Application::OnRender");
+
 		window->OnRender();
 	}
 
@@ -0,0 +1,165 @@
+#pragma once
+#include "Compiler.h"
+
+// Compile-time instruction set detection.
+// MSVC does not define __SSE4_1__ & co, so /arch:AVX and /arch:AVX2 are used to imply them.
+
+#if defined(__AVX2__)
+	#define ENGINE_SIMD_AVX2 1
+#else
+	#define ENGINE_SIMD_AVX2 0
+#endif
+
+#if defined(__AVX__) || ENGINE_SIMD_AVX2
+	#define ENGINE_SIMD_AVX 1
+#else
+	#define ENGINE_SIMD_AVX 0
+#endif
+
+#if defined(__SSE4_2__) || ENGINE_SIMD_AVX
+	#define ENGINE_SIMD_SSE42 1
+#else
+	#define ENGINE_SIMD_SSE42 0
+#endif
+
+#if defined(__SSE4_1__) || ENGINE_SIMD_SSE42
+	#define ENGINE_SIMD_SSE41 1
+#else
+	#define ENGINE_SIMD_SSE41 0
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || ENGINE_SIMD_SSE41
+	#define ENGINE_SIMD_SSE2 1
+#else
+	#define ENGINE_SIMD_SSE2 0
+#endif
+
+#if defined(__F16C__) || (ENGINE_MSVC_COMPILER && ENGINE_SIMD_AVX2)
+	#define ENGINE_SIMD_F16C 1
+#else
+	#define ENGINE_SIMD_F16C 0
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define ENGINE_SIMD_NEON 1
+#else
+	#define ENGINE_SIMD_NEON 0
+#endif
+
+
+#if ENGINE_SIMD_SSE2
+	#include <immintrin.h>
+#endif
+
+#if ENGINE_SIMD_NEON
+	#include <arm_neon.h>
+#endif
+
+
+// Width in bytes of the widest vector register the engine is compiled for.
+#if ENGINE_SIMD_AVX
+	#define ENGINE_SIMD_WIDTH 32
+#elif ENGINE_SIMD_SSE2 || ENGINE_SIMD_NEON
+	#define ENGINE_SIMD_WIDTH 16
+#else
+	#define ENGINE_SIMD_WIDTH 4
+#endif
+
+
+// x86 builds may use instructions above the compile-time baseline in functions marked with
+// ENGINE_SIMD_TARGET, after checking J::SIMD::GetCPUFeatures(). MSVC needs no attribute for intrinsics.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define ENGINE_ARCH_X86 1
+#else
+	#define ENGINE_ARCH_X86 0
+#endif
+
+#if ENGINE_ARCH_X86 && !ENGINE_MSVC_COMPILER
+	#define ENGINE_SIMD_TARGET(targets) __attribute__((target(targets)))
+#else
+	#define ENGINE_SIMD_TARGET(targets)
+#endif
+
+#if ENGINE_ARCH_X86
+	#if ENGINE_MSVC_COMPILER
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+
+namespace J::SIMD
+{
+	/** Instruction sets the running CPU supports, whatever the engine was compiled for. */
+	struct SCPUFeatures
+	{
+		bool bSSE41		= false;
+		bool bSSE42		= false;
+		bool bPCLMUL	= false;
+		bool bAVX2		= false;
+	};
+
+	inline const SCPUFeatures& GetCPUFeatures()
+	{
+		static const SCPUFeatures features = []()
+		{
+			SCPUFeatures result;
+
+#if ENGINE_ARCH_X86
+			unsigned int registers[4] = { };	// eax, ebx, ecx, edx
+
+	#if ENGINE_MSVC_COMPILER
+			auto query = [&registers](unsigned int Leaf) -> bool
+			{
+				int values[4];
+				__cpuidex(values, static_cast<int>(Leaf), 0);
+
+				for (int i = 0; i < 4; ++i)
+				{
+					registers[i] = static_cast<unsigned int>(values[i]);
+				}
+
+				return true;
+			};
+	#else
+			auto query = [&registers](unsigned int Leaf) -> bool
+			{
+				return __get_cpuid_count(Leaf, 0, &registers[0], &registers[1], &registers[2], &registers[3]) != 0;
+			};
+	#endif
+
+			if (query(1))
+			{
+				result.bPCLMUL	= (registers[2] & (1u << 1)) != 0;
+				result.bSSE41	= (registers[2] & (1u << 19)) != 0;
+				result.bSSE42	= (registers[2] & (1u << 20)) != 0;
+
+				// AVX registers must also be saved by the OS: OSXSAVE, then XCR0 bits 1 and 2
+				bool bAVXUsable = (registers[2] & (1u << 27)) != 0 && (registers[2] & (1u << 28)) != 0;
+
+				if (bAVXUsable)
+				{
+	#if ENGINE_MSVC_COMPILER
+					const unsigned long long xcr0 = _xgetbv(0);
+	#else
+					unsigned int xcr0Low, xcr0High;
+					__asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+					const unsigned long long xcr0 = xcr0Low | (static_cast<unsigned long long>(xcr0High) << 32);
+	#endif
+					bAVXUsable = (xcr0 & 0x6) == 0x6;
+				}
+
+				if (bAVXUsable && query(7))
+				{
+					result.bAVX2 = (registers[1] & (1u << 5)) != 0;
+				}
+			}
+#endif
+
+			return result;
+		}();
+
+		return features;
+	}
+}
@@ -8,6 +8,15 @@
 // 1 if JflaEngine utilizes custom proxies for OpenImageIO library
 #define JF_SUPPORT_OIIO_CUSTOM_PROXY 0
 
+// 1 if textures and shaders reload when their files change on disk
+#define JF_HOT_RELOAD JF_DEBUG
+
+// 1 if JF_PROFILE_SCOPE zones are recorded
+#define JF_PROFILE 1
+
+// 1 if the OpenGL wrappers count their calls and uploads per frame
+#define JF_GL_STATISTICS 1
+
 
 
 #include "Common/Common.h"
@@ -22,6 +31,7 @@
 #include "Common/Assert.h"
 #include "Common/Macro.h"
 #include "Common/Span.h"
+#include "Common/SIMD.h"
 
 
 #include "Memory/Memory.h"
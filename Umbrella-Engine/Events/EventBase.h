@@ -1,5 +1,6 @@
 #pragma once
 #include "../Core.h"
+#include "../Utils/Cryptography/Hash.h"
 #include <string>
 
 
@@ -9,7 +10,7 @@ namespace J
 	enum class EEventCategory : uint8
 	{
 		Common		= 0,
-		Application = BIT(0),
+		Application = JF_BIT(0),
 		Input		= Application << 1,
 		Mouse		= Input << 1,
 		MouseButton = Mouse << 1,
@@ -35,6 +36,8 @@ namespace J
 		bool InCategory(EEventCategory category) const { return GetEventCategoryFlags() & category; }
 	};
 
+// Event ids are hashes of the event names, computed at compile time.
 #define EVENT_BODY(event_name)\
-		uint32 GetEventId() const override { return std::hash()}
+		static constexpr uint32 StaticEventId = static_cast<uint32>(J::Crypto::HashString(#event_name));\
+		uint32 GetEventId() const override { return StaticEventId; }
 }
\ No newline at end of file
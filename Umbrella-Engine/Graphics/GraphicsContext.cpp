@@ -1,5 +1,7 @@
 #include "GraphicsContext.h"
 #include "Platform/GraphicsAPI/GpuApi.h"
+#include "Platform/GraphicsAPI/OpenGL/OpenGLDebug.h"
+#include "Platform/GraphicsAPI/OpenGL/OpenGLStateCache.h"
 
 
 namespace J::Graphics
@@ -27,6 +29,11 @@ namespace J::Graphics
 		// opengl version
 		SDL_GL_SetAttribute( SDL_GL_CONTEXT_MAJOR_VERSION, 4 );
 		SDL_GL_SetAttribute( SDL_GL_CONTEXT_MINOR_VERSION, 3 );
+
+#if JF_DEBUG
+		// the debug output (KHR_debug) is only guaranteed to report everything in debug contexts
+		SDL_GL_SetAttribute( SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_DEBUG_FLAG );
+#endif
 		
 		SDL_GL_SetAttribute( SDL_GL_DOUBLEBUFFER, 1 );
 		SDL_GL_SetAttribute( SDL_GL_DEPTH_SIZE, 16 );
@@ -45,10 +52,18 @@ namespace J::Graphics
 			[]( SDL_Renderer* renderer ) { SDL_DestroyRenderer( renderer ); } );
 
 		FATAL_ASSERT( gladLoadGLLoader( SDL_GL_GetProcAddress ), "Failed to initialize glad" );	
+
+		OpenGLDebug::Initialize();
+
+		// SDL may have used the context while creating its renderer
+		OpenGLStateCache::Invalidate();
 	}
 
 	void GraphicsContext::OnDestroy()
 	{
+		// the GL objects go before their context
+		GpuApi::ShutdownDevice();
+
 		SDL_GL_DeleteContext( context );
 		SDL_Quit();
 	}
@@ -3,6 +3,7 @@
 #include "../Core.h"
 #include "SDL.h"
 #include "Platform/GraphicsAPI/GraphicsAPI.h"
+#include "Platform/GraphicsAPI/GpuApi.h"
 #include "../Math/Color.h"
 
 //#include "Platform/GraphicsAPI/OpenGL/OpenGLContext.h"
@@ -45,7 +46,7 @@ namespace J::Graphics
 
 		static inline void ClearColor( const Math::Color& color ) 
 		{ 
-			Math::LinearColor linear = Math::Color::ToLinearColor( color ); 
+			Math::LinearColor linear = Math::Color::Normalize( color );	// default framebuffer is not sRGB 
 			OpenGLContext::ClearColor( linear.R(), linear.G(), linear.B(), linear.A() ); 
 		}
 		
@@ -63,6 +64,8 @@ namespace J::Graphics
 
 		static inline void DrawElements( EGLPrimitiveType primitive, const OpenGLIndexBuffer& indicies )
 		{
+			JF_GPU_SCOPE( "DrawElements" );
+
 			indicies.Bind();
 			OpenGLContext::DrawElements( GL_ENUM( primitive ), indicies.GetSize(), GL_ENUM( EGLDataType::UINT32 ), nullptr );
 		}
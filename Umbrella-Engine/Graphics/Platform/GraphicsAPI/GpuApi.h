@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GpuTypes.h"
+#include "../../../Utils/Profiling/Profiler.h"
 
 
 // #TODO IMPLEMENT THIS AS GPU LAYER OVER OPENGL CONTEXT AND OPENGL ENTITIES (OpenGLTexture, OpenGLBuffer, etc ...)
@@ -26,6 +27,9 @@ namespace J::Graphics::GpuApi
 
 	bool						InitDevice();
 
+	/** Waits for the GPU, deletes the released resources still waiting for it and the GL objects of the device, while the context is current. */
+	void						ShutdownDevice();
+
 	EDeviceType					GetDeviceType();
 
 	EGPUVendor					GetGPUVendor();
@@ -36,7 +40,7 @@ namespace J::Graphics::GpuApi
 	TextureRef UploadTexture ( const STextureInitData& data );
 
 	
-	// #TODO CreateTexture, UploadTexture, CreateGpuFence, ...
+	// #TODO CreateTexture, UploadTexture, ...
 
 
 	BufferRef					CreateBuffer( EBufferType type = EBufferType::NONE,
@@ -53,6 +57,7 @@ namespace J::Graphics::GpuApi
 
 	void						UnbindBuffer( BufferRef ref );
 
+	/** Whether the buffer is bound to its target, as tracked by OpenGLStateCache (false when the binding is not known). */
 	bool						IsBufferBound( BufferRef ref );
 
 	SBufferDesc					GetBufferDesc( BufferRef ref );
@@ -123,4 +128,111 @@ namespace J::Graphics::GpuApi
 	JString						GetBufferDebugName( BufferRef ref );
 
 
+	/************************************************************************/
+	/*						STREAMING										*/
+	/************************************************************************/
+
+	/**
+	 * Memory of the current frame in the persistently mapped stream buffer, written directly by the CPU (dynamic
+	 * vertices, per draw constants, ...) and read by the commands of the frame, with no driver copy.
+	 * Invalid when the frame's part of the stream buffer is full or unsupported, see WriteBufferData then.
+	 * 
+	 * \param size		- bytes.
+	 * \param alignment	- power of two, GetStreamUniformAlignment() for the uniform blocks.
+	 */
+	SStreamAllocation			AllocateStreamData( SIZE_T size, SIZE_T alignment = 16 );
+
+	/**
+	 * Binds the stream buffer: the range of the allocation at index for the indexed targets (uniform blocks,
+	 * shader storage, ...), the whole buffer otherwise (the offset goes to the attribute pointers or the draw).
+	 * 
+	 * \param allocation	- memory of the current frame.
+	 * \param type			- target.
+	 * \param index			- binding point of the indexed targets.
+	 */
+	void						BindStreamData( const SStreamAllocation& allocation, EBufferType type, uint32 index = 0 );
+
+	/** Offset alignment of the uniform block ranges. */
+	SIZE_T						GetStreamUniformAlignment();
+
+	/** Grows the stream buffer to bytesPerFrame for each frame in flight, between two frames. */
+	bool						ReserveStreamData( SIZE_T bytesPerFrame );
+
+
+	/************************************************************************/
+	/*						GPU FENCES										*/
+	/************************************************************************/
+
+	/**
+	 * Fence to wait for the GPU with (read backs, CPU writes to the memory the GPU reads, ...), used in the thread
+	 * of the GL context. The resources released with Release do not need one: they are deleted by EndGpuFrame once
+	 * the GPU has passed the frame which released them.
+	 * 
+	 * \param desc - locked at creation or not, debug name.
+	 */
+	Scope<SGpuFence>			CreateGpuFence( const SGpuFenceDesc& desc = SGpuFenceDesc() );
+
+	/** Frame being recorded, counted by EndGpuFrame. */
+	uint64						GetGpuFrameIndex();
+
+	/** Frames the GPU has passed: every frame before this index is done. */
+	uint64						GetCompletedGpuFrames();
+
+
+	/************************************************************************/
+	/*						GPU TIMING										*/
+	/************************************************************************/
+
+	/**
+	 * Timestamps the start of a GPU zone, see JF_GPU_SCOPE. Zones nest, and their GPU times reach the profiler
+	 * timeline a few frames later, without stalling.
+	 * 
+	 * \param name - string literal.
+	 */
+	void						BeginGpuZone( const CHAR* name );
+
+	void						EndGpuZone();
+
+	/** Fences the frame and the streamed data, deletes the released resources the GPU is done with, reads back the GPU times of the finished frames, reports the GL errors and snapshots the GL statistics, once a frame before swapping the buffers. */
+	void						EndGpuFrame();
+
+	/** GPU time of the last frame read back. */
+	Utils::TimeSpan				GetGpuFrameTime();
+
+
+	/** GPU zone around a scope, see JF_GPU_SCOPE. */
+	struct SGpuProfileScope
+	{
+		explicit SGpuProfileScope( const CHAR* name )
+			: bActive( Utils::Profiler::IsEnabled() )
+		{
+			if ( bActive )
+			{
+				BeginGpuZone( name );
+			}
+		}
+
+		SGpuProfileScope( const SGpuProfileScope& ) = delete;
+
+		SGpuProfileScope& operator = ( const SGpuProfileScope& ) = delete;
+
+		~SGpuProfileScope()
+		{
+			if ( bActive )
+			{
+				EndGpuZone();
+			}
+		}
+
+		bool bActive;
+	};
+
 }
+
+
+#if JF_PROFILE
+	/** Times the GPU work submitted in the rest of the scope under a string literal name. */
+	#define JF_GPU_SCOPE(Name) ::J::Graphics::GpuApi::SGpuProfileScope JF_CONCATENATE2(gpuProfileScope, __LINE__)(Name)
+#else
+	#define JF_GPU_SCOPE(Name)
+#endif
@@ -178,7 +178,7 @@ namespace J::Graphics::GpuApi
 		NONE			= 0,
 		READ			= JF_BIT(0),
 		WRITE			= JF_BIT(1),	// GL_DYNAMIC_STORAGE_BIT
-		DYNAMIC_READ	= JF_BIT(3),	// GL_MAP_READ_BIT				#TODO implement GPU pointers! GL_MAP_PERSISTENT_BIT??
+		DYNAMIC_READ	= JF_BIT(3),	// GL_MAP_READ_BIT				(persistently mapped memory: see GpuApi::AllocateStreamData)
 		DYNAMIC_WRITE	= JF_BIT(4),	// GL_MAP_WRITE_BIT
 		REALLOCATE		= JF_BIT(5),	// Immutable storage
 
@@ -190,6 +190,24 @@ namespace J::Graphics::GpuApi
 	DECLARE_ENUM_FLAG_OPERATIONS(EBufferAccessBits);
 
 
+	/** Memory of the stream buffer for the current frame, see GpuApi::AllocateStreamData. */
+	struct SStreamAllocation
+	{
+		MemPtr				Data;		//< written by the CPU, null if the allocation failed
+		SIZE_T				Offset;		//< offset in the stream buffer
+		SIZE_T				Size;		//< bytes
+
+		SStreamAllocation()
+			: Data( NullPtr )
+			, Offset( 0 )
+			, Size( 0 )
+		{
+		}
+
+		bool IsValid() const { return Data != NullPtr; }
+	};
+
+
 	/************************************************************************/
 	/*					SHADER SPECIFIC STUFF                               */
 	/************************************************************************/
@@ -222,6 +240,7 @@ namespace J::Graphics::GpuApi
 
 	struct SGpuFence
 	{
+		virtual ~SGpuFence() = default;
 
 		virtual void Lock() = 0;
 		virtual bool Lock(Utils::TimeSpan timeout) = 0;
@@ -238,7 +257,14 @@ namespace J::Graphics::GpuApi
 
 	struct SGpuFenceDesc
 	{
-		// #TODO MAKE IT
+		JString				DebugName;	//< label of the fence (maybe empty)
+		bool				bLocked;	//< locked at creation, after the commands submitted so far
+
+		SGpuFenceDesc()
+			: DebugName()
+			, bLocked( false )
+		{
+		}
 	};
 
 
@@ -263,7 +289,6 @@ namespace J::Graphics::GpuApi
 		EBufferType			eType;
 		EBufferUsage		eUsage;
 
-		bool				bBoundToCurrentContext;
 		bool				bInvalidated;
 		bool				bStorageAllocated;
 
@@ -276,7 +301,6 @@ namespace J::Graphics::GpuApi
 		SBufferDesc()
 			: eType(EBufferType::NONE)
 			, eUsage(EBufferUsage::NONE)
-			, bBoundToCurrentContext(false)
 			, bInvalidated(false)
 			, bStorageAllocated(false)
 			, Size(0)
@@ -2,6 +2,10 @@
 #include "../../../../../Utils/Time/TimeSpan.h"
 #include "../../../../../Utils/Containers/ResourceContainer.h"
 #include "OpenGLGpuApi.h"
+#include "../OpenGLGpuTimer.h"
+#include "../OpenGLStreamBuffer.h"
+#include "../OpenGLSync.h"
+#include <array>
 
 
 
@@ -36,6 +40,16 @@ namespace J::Graphics::GpuApi
 
 
 
+	/** Resource released in a frame, deleted once the GPU has passed the fence of that frame. */
+	template< typename _ResRef >
+	struct SPendingRelease
+	{
+		_ResRef		Ref;
+		uint64		Frame;
+	};
+
+
+
 	struct SDeviceData
 	{
 		
@@ -47,6 +61,8 @@ namespace J::Graphics::GpuApi
 			, bDeviceShutDone( false )
 			, eDevice(EDeviceType::UNKNOWN)
 			, eGPUVendor(EGPUVendor::UNKNOWN)
+			, FrameIndex( 0 )
+			, CompletedFrames( 0 )
 			, BufferResources( AccessMutex )
 			//, VertexArrayResources( AccessMutex )
 			//, ShaderResources( AccessMutex )
@@ -65,6 +81,18 @@ namespace J::Graphics::GpuApi
 		EGPUVendor												eGPUVendor;
 
 
+		static constexpr uint32									FramesInFlight = 3;
+
+		// fence after the commands of each frame in flight (FrameIndex % FramesInFlight)
+		std::array< OpenGLSync, FramesInFlight >				FrameFences;
+
+		// frame being recorded
+		uint64													FrameIndex;
+
+		// frames passed by the GPU, the frames before this one
+		uint64													CompletedFrames;
+
+
 		// #TODO
 		// BufferLayouts, Samplers, FrameBuffers (aka swap chains), RenderBuffers etc ...
 		// Consider Pixel Buffers (useful for streaming images)
@@ -76,6 +104,15 @@ namespace J::Graphics::GpuApi
 		//ResourceContainer< TextureRef,		JTexture >			TextureResources;
 		// ResourceContainer< GPU FENCES
 
+		// released resources waiting for the GPU, see EndGpuFrame (guarded by AccessMutex)
+		JVector< SPendingRelease< BufferRef > >					BufferReleases;
+
+		// JF_GPU_SCOPE zones
+		OpenGLGpuTimer											GpuTimer;
+
+		// AllocateStreamData memory
+		OpenGLStreamBuffer										StreamBuffer;
+
 		TMutex													AccessMutex;
 	};
 
@@ -1,5 +1,7 @@
 #include "GpuDeviceData.h"
 #include "../../GpuApi.h"
+#include "../../../../../Utils/Profiling/Profiler.h"
+#include <algorithm>
 
 // #todo
 /*********************************************************************************************************************/
@@ -13,11 +15,34 @@ namespace J::Graphics::GpuApi
 
 	bool InitDevice()
 	{
+		JF_PROFILE_SCOPE( "GpuApi::InitDevice" );
+
 		GDeviceData = new SDeviceData();
 
 		return true;
 	}
 
+	static void DrainFrameFences( SDeviceData& deviceData );
+
+	void ShutdownDevice()
+	{
+		JF_PROFILE_SCOPE( "GpuApi::ShutdownDevice" );
+
+		auto& deviceData = GetDeviceData();
+
+		if ( deviceData.bDeviceShutDone )
+		{
+			return;
+		}
+
+		DrainFrameFences( deviceData );
+
+		deviceData.StreamBuffer.Release();
+		deviceData.GpuTimer.Release();
+
+		deviceData.bDeviceShutDone = true;
+	}
+
 	// helper functions, inline implementations
 
 	SDeviceData& GetDeviceData()
@@ -34,6 +59,8 @@ namespace J::Graphics::GpuApi
 
 	EGPUVendor GetGPUVendor()
 	{
+		JF_PROFILE_SCOPE( "GpuApi::GetGPUVendor" );
+
 		const auto& deviceData = GetDeviceData();
 
 		return deviceData.eGPUVendor;
@@ -41,13 +68,29 @@ namespace J::Graphics::GpuApi
 
 	EDeviceType GetDeviceType()
 	{
+		JF_PROFILE_SCOPE( "GpuApi::GetDeviceType" );
+
 		const auto& deviceData = GetDeviceData();
 
 		return deviceData.eDevice;
 	}
 
 
-#define DEFINE_DEFAULT_REF_FUNCTIONS( ResRefType, ResContainer )					\
+	// the GL objects go with the slot, once no frame in flight uses them
+
+	static void DestroyBufferResource( const BufferRef& ref )
+	{
+		auto& deviceData = GetDeviceData();
+
+		auto& bufData = deviceData.BufferResources.Data( ref );
+
+		OpenGLContext::DeleteBuffers( 1, &bufData.Resource );
+
+		deviceData.BufferResources.Destroy( ref );
+	}
+
+
+#define DEFINE_DEFAULT_REF_FUNCTIONS( ResRefType, ResContainer, ResReleases )		\
 	void AddRef( const ResRefType& ref )											\
 	{																				\
 		auto& deviceData = GetDeviceData();											\
@@ -69,19 +112,21 @@ namespace J::Graphics::GpuApi
 																					\
 		if ( newCount == 0 )														\
 		{																			\
-			deviceData.ResContainer.Destroy( ref );									\
+			/* the commands of this frame may still use it, see EndGpuFrame */		\
+			JF_SCOPED_LOCK( deviceData.AccessMutex );								\
+			deviceData.ResReleases.push_back( { ref, deviceData.FrameIndex } );		\
 		}																			\
 																					\
 		return newCount;															\
 	}
 
-	DEFINE_DEFAULT_REF_FUNCTIONS(BufferRef, BufferResources)
+	DEFINE_DEFAULT_REF_FUNCTIONS(BufferRef, BufferResources, BufferReleases)
 
 	// #todo - implement other apis later
 	
-	//DEFINE_DEFAULT_REF_FUNCTIONS(TextureRef, TextureResources)
-	//DEFINE_DEFAULT_REF_FUNCTIONS(ShaderRef, ShaderResources)
-	//DEFINE_DEFAULT_REF_FUNCTIONS(VertexArrayRef, VertexArrayResources)
+	//DEFINE_DEFAULT_REF_FUNCTIONS(TextureRef, TextureResources, TextureReleases)
+	//DEFINE_DEFAULT_REF_FUNCTIONS(ShaderRef, ShaderResources, ShaderReleases)
+	//DEFINE_DEFAULT_REF_FUNCTIONS(VertexArrayRef, VertexArrayResources, VertexArrayReleases)
 
 
 #undef DEFINE_DEFAULT_REF_FUNCTIONS
@@ -142,6 +187,8 @@ namespace J::Graphics::GpuApi
 							EBufferAccessBits access,
 							const JString& debugName )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::CreateBuffer" );
+
 		auto& deviceData = GetDeviceData();
 	
 		BufferRef ref = AllocateBuffer();
@@ -174,6 +221,8 @@ namespace J::Graphics::GpuApi
 
 	BufferRef CreateBuffer( const SBufferInitData& initData )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::CreateBuffer" );
+
 		auto& deviceData = GetDeviceData();
 
 		const auto& [ Type, Usage, Offset, DebugName, Size, Data, Access ] = initData;
@@ -209,12 +258,16 @@ namespace J::Graphics::GpuApi
 
 	void DestroyBuffer( BufferRef ref )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::DestroyBuffer" );
+
 		int32 newCount = SafeRelease( ref );
 		JF_ASSERT( newCount == 0, "Cannot destroy buffer. It used used somewhere else." );
 	}
 
 	void BindBuffer( BufferRef ref )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::BindBuffer" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 	
@@ -227,11 +280,12 @@ namespace J::Graphics::GpuApi
 		}
 
 		OpenGLContext::BindBuffer( GL_ENUM( bufData.Description.eType ), bufData.Resource );
-		bufData.Description.bBoundToCurrentContext = true;
 	}
 
 	void UnbindBuffer( BufferRef ref )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::UnbindBuffer" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 
@@ -244,21 +298,30 @@ namespace J::Graphics::GpuApi
 		}
 
 		OpenGLContext::UnbindBuffer( GL_ENUM( bufData.Description.eType ) );
-		bufData.Description.bBoundToCurrentContext = false;
 	}
 
 	bool IsBufferBound( BufferRef ref )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::IsBufferBound" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 
 		auto& bufData = deviceData.BufferResources.Data( ref );
 
-		return bufData.Description.bBoundToCurrentContext;
+		if ( bufData.Description.eType == EBufferType::NONE )
+		{
+			return false;
+		}
+
+		// the state cache follows every bind to the target, a VAO bind and Invalidate included
+		return OpenGLStateCache::GetBuffer( GL_ENUM( bufData.Description.eType ) ) == bufData.Resource;
 	}
 
 	SBufferDesc GetBufferDesc( BufferRef ref )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::GetBufferDesc" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 
@@ -272,6 +335,8 @@ namespace J::Graphics::GpuApi
 								SIZE_T offset /* = 0 */, MemPtr data /* = NullPtr */,
 								EBufferAccessBits accessBits /* = EBufferAccessBits::ALL */ )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::AllocateBufferStorage" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 
@@ -317,6 +382,8 @@ namespace J::Graphics::GpuApi
 
 	MemPtr ReadBufferData( BufferRef ref, SIZE_T offset, SIZE_T size )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::ReadBufferData" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 
@@ -350,6 +417,8 @@ namespace J::Graphics::GpuApi
 		   
 	void ReadBufferData( BufferRef ref, SIZE_T offset, SIZE_T size, MemPtr storage )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::ReadBufferData" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 
@@ -378,6 +447,8 @@ namespace J::Graphics::GpuApi
 	
 	MemPtr ReadBufferData( BufferRef ref, SIZE_T size )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::ReadBufferData" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 
@@ -388,6 +459,8 @@ namespace J::Graphics::GpuApi
 
 	void ReadBufferData( BufferRef ref, SIZE_T size, MemPtr storage )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::ReadBufferData" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 
@@ -398,6 +471,8 @@ namespace J::Graphics::GpuApi
 
 	MemPtr ReadBufferData( BufferRef ref )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::ReadBufferData" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT ( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 
@@ -408,6 +483,8 @@ namespace J::Graphics::GpuApi
 
 	void ReadBufferData( BufferRef ref, MemPtr storage )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::ReadBufferData" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 
@@ -418,6 +495,8 @@ namespace J::Graphics::GpuApi
 
 	void CopyBufferData( BufferRef srcRef, BufferRef dstRef, SIZE_T srcOffset, SIZE_T dstOffset, SIZE_T size )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::CopyBufferData" );
+
 		auto& deviceData = GetDeviceData();
 
 		JF_ASSERT( deviceData.BufferResources.IsInUse( srcRef ), "buffer does not exist" );
@@ -456,6 +535,8 @@ namespace J::Graphics::GpuApi
 
 	void WriteBufferData( BufferRef ref, SIZE_T offset, SIZE_T size, MemPtr source )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::WriteBufferData" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 
@@ -477,6 +558,8 @@ namespace J::Graphics::GpuApi
 
 	void WriteBufferData( BufferRef ref, SIZE_T size, MemPtr source )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::WriteBufferData" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 
@@ -487,6 +570,8 @@ namespace J::Graphics::GpuApi
 
 	void SetBufferDebugName( BufferRef ref, const JString& name )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::SetBufferDebugName" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 
@@ -499,6 +584,8 @@ namespace J::Graphics::GpuApi
 
 	JString GetBufferDebugName( BufferRef ref )
 	{
+		JF_PROFILE_SCOPE( "GpuApi::GetBufferDebugName" );
+
 		auto& deviceData = GetDeviceData();
 		JF_ASSERT( deviceData.BufferResources.IsInUse( ref ), "buffer does not exist" );
 
@@ -507,4 +594,181 @@ namespace J::Graphics::GpuApi
 		return bufData.Description.DebugName;
 	}
 
+	/****/
+	/* GPU FENCES */
+
+	Scope<SGpuFence> CreateGpuFence( const SGpuFenceDesc& desc /* = SGpuFenceDesc() */ )
+	{
+		JF_PROFILE_SCOPE( "GpuApi::CreateGpuFence" );
+
+		return MakeScoped<OpenGLSync>( desc );
+	}
+
+	uint64 GetGpuFrameIndex()
+	{
+		return GetDeviceData().FrameIndex;
+	}
+
+	uint64 GetCompletedGpuFrames()
+	{
+		return GetDeviceData().CompletedFrames;
+	}
+
+	static void DestroyPendingReleases( SDeviceData& deviceData )
+	{
+		JVector< BufferRef > buffers;
+
+		{
+			JF_SCOPED_LOCK( deviceData.AccessMutex );
+
+			auto& releases = deviceData.BufferReleases;
+
+			// the ones still waiting for the GPU stay in front
+			auto passed = std::stable_partition( releases.begin(), releases.end(),
+				[ completed = deviceData.CompletedFrames ]( const SPendingRelease< BufferRef >& release )
+				{
+					return release.Frame >= completed;
+				} );
+
+			for ( auto it = passed; it != releases.end(); ++it )
+			{
+				buffers.push_back( it->Ref );
+			}
+
+			releases.erase( passed, releases.end() );
+		}
+
+		// the container locks AccessMutex itself
+		for ( const BufferRef& ref : buffers )
+		{
+			DestroyBufferResource( ref );
+		}
+	}
+
+	static void EndFrameFence( SDeviceData& deviceData )
+	{
+		JF_PROFILE_SCOPE( "GpuApi::EndFrameFence" );
+
+		constexpr uint32 framesInFlight = SDeviceData::FramesInFlight;
+
+		const uint64 frame = deviceData.FrameIndex++;
+
+		// waits for the frame that used the fence before, the CPU is never more than FramesInFlight frames ahead
+		deviceData.FrameFences[ frame % framesInFlight ].Lock();
+
+		// the GPU executes the frames in order: that one and all the frames before it are done
+		if ( frame >= framesInFlight )
+		{
+			deviceData.CompletedFrames = std::max( deviceData.CompletedFrames, frame - framesInFlight + 1 );
+		}
+
+		// polls the following ones
+		while ( deviceData.CompletedFrames <= frame
+				&& deviceData.FrameFences[ deviceData.CompletedFrames % framesInFlight ].WaitForLock( Utils::TimeSpan::Zero() ) )
+		{
+			deviceData.CompletedFrames++;
+		}
+
+		DestroyPendingReleases( deviceData );
+	}
+
+	static void DrainFrameFences( SDeviceData& deviceData )
+	{
+		// the frame being recorded is fenced too, its releases are the last ones
+		deviceData.FrameFences[ deviceData.FrameIndex % SDeviceData::FramesInFlight ].Lock();
+
+		for ( OpenGLSync& fence : deviceData.FrameFences )
+		{
+			fence.WaitForLock();
+		}
+
+		deviceData.CompletedFrames = ++deviceData.FrameIndex;
+
+		DestroyPendingReleases( deviceData );
+	}
+
+	/****/
+	/* STREAMING */
+
+	SStreamAllocation AllocateStreamData( SIZE_T size, SIZE_T alignment /* = 16 */ )
+	{
+		JF_PROFILE_SCOPE( "GpuApi::AllocateStreamData" );
+
+		SStreamAllocation allocation;
+		allocation.Data = GetDeviceData().StreamBuffer.Allocate( size, alignment, allocation.Offset );
+		allocation.Size = allocation.Data ? size : 0;
+
+		return allocation;
+	}
+
+	void BindStreamData( const SStreamAllocation& allocation, EBufferType type, uint32 index /* = 0 */ )
+	{
+		JF_PROFILE_SCOPE( "GpuApi::BindStreamData" );
+
+		JF_ASSERT( allocation.IsValid(), "stream allocation failed" );
+
+		const GLuint resource = GetDeviceData().StreamBuffer.GetResource();
+
+		switch ( type )
+		{
+		case EBufferType::ATOMIC_COUNTER_BUFFER:
+		case EBufferType::SHADER_STORAGE_BUFFER:
+		case EBufferType::TRANSFORM_FEEDBACK_BUFFER:
+		case EBufferType::UNIFORM_BUFFER:
+			OpenGLContext::BindBufferRange( GL_ENUM( type ), index, resource, allocation.Offset, allocation.Size );
+			break;
+
+		default:
+			OpenGLContext::BindBuffer( GL_ENUM( type ), resource );
+			break;
+		}
+	}
+
+	SIZE_T GetStreamUniformAlignment()
+	{
+		auto& streamBuffer = GetDeviceData().StreamBuffer;
+
+		return streamBuffer.IsSupported() ? streamBuffer.GetUniformAlignment() : 256;
+	}
+
+	bool ReserveStreamData( SIZE_T bytesPerFrame )
+	{
+		JF_PROFILE_SCOPE( "GpuApi::ReserveStreamData" );
+
+		return GetDeviceData().StreamBuffer.Reserve( bytesPerFrame );
+	}
+
+	/****/
+	/* GPU TIMING */
+
+	void BeginGpuZone( const CHAR* name )
+	{
+		GetDeviceData().GpuTimer.BeginZone( name );
+	}
+
+	void EndGpuZone()
+	{
+		GetDeviceData().GpuTimer.EndZone();
+	}
+
+	void EndGpuFrame()
+	{
+		JF_PROFILE_SCOPE( "GpuApi::EndGpuFrame" );
+
+		GetDeviceData().StreamBuffer.EndFrame();
+
+		EndFrameFence( GetDeviceData() );
+
+		GetDeviceData().GpuTimer.EndFrame();
+
+		OpenGLDebug::EndFrame();
+
+		OpenGLStatistics::EndFrame();
+	}
+
+	Utils::TimeSpan GetGpuFrameTime()
+	{
+		return GetDeviceData().GpuTimer.GetLastFrameTime();
+	}
+
 }
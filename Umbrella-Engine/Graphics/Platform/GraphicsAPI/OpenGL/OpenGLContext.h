@@ -1,31 +1,32 @@
 #pragma once
 #include "../../../../Core.h"
 #include "glad/glad.h"
+#include "OpenGLDebug.h"
+#include "OpenGLStateCache.h"
+#include "OpenGLStatistics.h"
 
 #define GL_ENUM(element) (GLenum)(element)
 
-#ifdef JF_DEBUG
-
-	#define GL_ERROR_CODE_STR(code) OpenGLContext::GetStrErrorCode(code)
-
-	#define GLCALL(call) do														\
-	{																			\
-		call;																	\
-		GLenum error = glGetError();											\
-		bool has_error = error != GL_NO_ERROR;									\
-		if (has_error)															\
-			std::cout << "OpenGL error in " << #call << " instruction.\n";		\
-		while (error != GL_NO_ERROR)											\
-		{																		\
-			std::cout << std::format("Error code - {}\n.",						\
-										GL_ERROR_CODE_STR(error));				\
-			error = glGetError();												\
-		}																		\
-		if (has_error) JF_DEBUG_BREAK();										\
+#if JF_GL_STATISTICS
+	#define GL_STAT(stat, value) ::J::Graphics::OpenGLStatistics::Add(::J::Graphics::EGLStat::stat, (uint64)(value))
+#else
+	#define GL_STAT(stat, value) do { } while (0)
+#endif
+
+#if JF_DEBUG
+
+	// the site is kept for the error reports, glGetError is only called when checking every call (see OpenGLDebug)
+	#define GLCALL(call) do																			\
+	{																								\
+		::J::Graphics::OpenGLDebug::SetCallSite(#call, __FILE__, __LINE__);							\
+		call;																						\
+		if (::J::Graphics::OpenGLDebug::GetMode() == ::J::Graphics::EGLErrorMode::EVERY_CALL)		\
+			::J::Graphics::OpenGLDebug::CheckErrors();												\
 	} while (0)
 
 #else
 
+	// errors are found by the debug output and a glGetError once a frame (OpenGLDebug::EndFrame)
 	#define GLCALL(call) do { call; } while(0)
 
 #endif
@@ -41,18 +42,8 @@ namespace J::Graphics
 	{
 		constexpr static GLuint GInvalidGLResource = 0;
 
-		/**
-		 * POSSIBLY IMPLEMENT HERE OPENGL STATISTICS (INHERITED FROM GPU API STATISTICS ??? )
-		 * 
-		 * BindCalls
-		 * GenCalls
-		 * DeleteCalls
-		 * Errors
-		 * ShaderCalls
-		 * 
-		 * 
-		 * etc...
-		 */
+		// every wrapper counts its call (GL_STAT), see OpenGLStatistics
+		// the binds and the pipeline state skip the calls which change nothing, see OpenGLStateCache
 
 
 		// constants
@@ -84,6 +75,40 @@ namespace J::Graphics
 #undef CASE_LABEL
 
 		}
+
+		// bytes of a pixel of client data, 0 for the formats not listed
+		static constexpr uint32 GetPixelSize(GLenum Format, GLenum Type)
+		{
+			uint32 channels = 0;
+
+			switch (Format)
+			{
+			case GL_RED: case GL_RED_INTEGER: case GL_DEPTH_COMPONENT: case GL_STENCIL_INDEX:
+				channels = 1;
+				break;
+			case GL_RG: case GL_RG_INTEGER:
+				channels = 2;
+				break;
+			case GL_RGB: case GL_BGR: case GL_RGB_INTEGER:
+				channels = 3;
+				break;
+			case GL_RGBA: case GL_BGRA: case GL_RGBA_INTEGER:
+				channels = 4;
+				break;
+			}
+
+			switch (Type)
+			{
+			case GL_UNSIGNED_BYTE: case GL_BYTE:
+				return channels;
+			case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT:
+				return channels * 2;
+			case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT:
+				return channels * 4;
+			default:
+				return 0;
+			}
+		}
 		
 
 		/************************************************************************/
@@ -92,6 +117,7 @@ namespace J::Graphics
 
 		static FORCEINLINE void ClearBufferfv(GLenum Buffer, GLint DrawBufferIndex, const GLfloat* value)
 		{
+			GL_STAT(ClearCalls, 1);
 			GLCALL(glClearBufferfv(Buffer, DrawBufferIndex, value));
 		}
 
@@ -101,31 +127,37 @@ namespace J::Graphics
 														GLfloat Depth,
 														GLint Stencil)
 		{
+			GL_STAT(ClearCalls, 1);
 			GLCALL(glClearBufferfi(Buffer, DrawBufferIndex, Depth, Stencil));
 		}
 
 		static FORCEINLINE void ClearBufferiv(GLenum Buffer, GLint DrawBufferIndex, const GLint* Value)
 		{
+			GL_STAT(ClearCalls, 1);
 			GLCALL(glClearBufferiv(Buffer, DrawBufferIndex, Value));
 		}
 
 		static FORCEINLINE void ClearDepth(GLdouble Depth)
 		{
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glClearDepth(Depth));
 		}
 
 		static FORCEINLINE void ClearColor(GLfloat Red, GLfloat Green, GLfloat Blue, GLfloat Alpha)
 		{
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glClearColor(Red, Green, Blue, Alpha));
 		}
 
 		static FORCEINLINE void Clear(GLbitfield Mask)
 		{
+			GL_STAT(ClearCalls, 1);
 			GLCALL(glClear(Mask));
 		}
 		
 		static FORCEINLINE void PointSize(GLfloat Size)
 		{
+			GL_STAT(OtherCalls, 1);
 			check(Size >= 1.f);
 			GLCALL(glPointSize(Size));
 		}
@@ -134,26 +166,44 @@ namespace J::Graphics
 
 		static FORCEINLINE void GenBuffers(GLsizei n, GLuint* buffers)
 		{
+			GL_STAT(GenCalls, 1);
 			GLCALL(glGenBuffers(n, buffers));
 		}
 
 		static FORCEINLINE void CreateBuffers(GLsizei n, GLuint* buffers)
 		{
+			GL_STAT(GenCalls, 1);
 			GLCALL(glCreateBuffers(n, buffers));
 		}
 
 		static FORCEINLINE void DeleteBuffers( GLsizei n, GLuint* buffers )
 		{
+			GL_STAT( DeleteCalls, 1 );
 			GLCALL( glDeleteBuffers( n, buffers ) );
+			OpenGLStateCache::OnBuffersDeleted( n, buffers );
 		}
 
 		static FORCEINLINE void BindBuffer( GLenum Target, GLuint Buffer )
 		{
+			if ( !OpenGLStateCache::SetBuffer( Target, Buffer ) )
+			{
+				GL_STAT( SavedCalls, 1 );
+				return;
+			}
+
+			GL_STAT( BufferBinds, 1 );
 			GLCALL( glBindBuffer( Target, Buffer ) );
 		}
 
 		static FORCEINLINE void UnbindBuffer( GLenum Target )
 		{
+			if ( !OpenGLStateCache::SetBuffer( Target, GInvalidGLResource ) )
+			{
+				GL_STAT( SavedCalls, 1 );
+				return;
+			}
+
+			GL_STAT( BufferBinds, 1 );
 			GLCALL( glBindBuffer( Target, GInvalidGLResource ) );
 		}
 
@@ -162,6 +212,8 @@ namespace J::Graphics
 											CMemPtr Data,
 											GLenum Usage )
 		{
+			GL_STAT( BufferUploads, Data ? 1 : 0 );
+			GL_STAT( BufferUploadBytes, Data ? Size : 0 );
 			GLCALL( glBufferData( Target, Size, Data, Usage ) );
 		}
 
@@ -170,6 +222,8 @@ namespace J::Graphics
 												 CMemPtr Data,
 												 GLenum Usage )
 		{
+			GL_STAT( BufferUploads, Data ? 1 : 0 );
+			GL_STAT( BufferUploadBytes, Data ? Size : 0 );
 			GLCALL( glNamedBufferData( Buffer, Size, Data, Usage ) );
 		}
 
@@ -179,6 +233,7 @@ namespace J::Graphics
 												   GLintptr WriteOffset,
 												   GLsizeiptr Size )
 		{
+			GL_STAT( BufferCopyBytes, Size );
 			GLCALL( glCopyBufferSubData( ReadTarget, WriteTarget, ReadOffset, WriteOffset, Size ) );
 		}
 
@@ -188,6 +243,7 @@ namespace J::Graphics
 														GLintptr WriteOffset,
 														GLsizeiptr Size )
 		{
+			GL_STAT( BufferCopyBytes, Size );
 			GLCALL( glCopyNamedBufferSubData( ReadBuffer, WriteBuffer, ReadOffset, WriteOffset, Size ) );
 		}
 
@@ -196,6 +252,8 @@ namespace J::Graphics
 							GLsizeiptr Size,
 							CMemPtr Data )
 		{
+			GL_STAT( BufferUploads, 1 );
+			GL_STAT( BufferUploadBytes, Size );
 			GLCALL( glBufferSubData( Target, Offset, Size, Data ) );
 		}
 
@@ -204,6 +262,8 @@ namespace J::Graphics
 								 GLsizeiptr Size,
 								 CMemPtr Data )
 		{
+			GL_STAT( BufferUploads, 1 );
+			GL_STAT( BufferUploadBytes, Size );
 			GLCALL( glNamedBufferSubData( Buffer, Offset, Size, Data ) );
 		}
 
@@ -212,6 +272,7 @@ namespace J::Graphics
 							   GLsizeiptr Size,
 							   MemPtr Data )
 		{
+			GL_STAT( BufferReadBytes, Size );
 			GLCALL( glGetBufferSubData( Target, Offset, Size, Data ) );
 		}
 
@@ -220,6 +281,7 @@ namespace J::Graphics
 									GLsizeiptr Size,
 									MemPtr Data )
 		{
+			GL_STAT( BufferReadBytes, Size );
 			GLCALL( glGetNamedBufferSubData( Buffer, Offset, Size, Data ) );
 		}
 
@@ -228,6 +290,8 @@ namespace J::Graphics
 											   CMemPtr Data,
 											   GLbitfield Flags )
 		{
+			GL_STAT( BufferUploads, Data ? 1 : 0 );
+			GL_STAT( BufferUploadBytes, Data ? Size : 0 );
 			GLCALL( glBufferStorage( Target, Size, Data, Flags ) );
 		}
 
@@ -236,14 +300,46 @@ namespace J::Graphics
 													CMemPtr Data,
 													GLbitfield Flags )
 		{
+			GL_STAT( BufferUploads, Data ? 1 : 0 );
+			GL_STAT( BufferUploadBytes, Data ? Size : 0 );
 			GLCALL( glNamedBufferStorage( Buffer, Size, Data, Flags ) );
 		}
 
+		static FORCEINLINE MemPtr MapNamedBufferRange( GLuint Buffer,
+													   GLintptr Offset,
+													   GLsizeiptr Length,
+													   GLbitfield Access )
+		{
+			GL_STAT( OtherCalls, 1 );
+			MemPtr mapped;
+			GLCALL( mapped = glMapNamedBufferRange( Buffer, Offset, Length, Access ) );
+
+			return mapped;
+		}
+
+		static FORCEINLINE GLboolean UnmapNamedBuffer( GLuint Buffer )
+		{
+			GL_STAT( OtherCalls, 1 );
+			GLboolean bUnmapped;
+			GLCALL( bUnmapped = glUnmapNamedBuffer( Buffer ) );
+
+			return bUnmapped;
+		}
+
+		// binds a range to an indexed target (uniform blocks, shader storage, ...), and to the generic target as well
+		static FORCEINLINE void BindBufferRange( GLenum Target, GLuint Index, GLuint Buffer, GLintptr Offset, GLsizeiptr Size )
+		{
+			GL_STAT( BufferBinds, 1 );
+			GLCALL( glBindBufferRange( Target, Index, Buffer, Offset, Size ) );
+			OpenGLStateCache::SetBuffer( Target, Buffer );
+		}
+
 
 		// Shaders
 
 		static FORCEINLINE GLuint CreateShader(GLenum Type)
 		{
+			GL_STAT(GenCalls, 1);
 			GLuint resource;
 			GLCALL(resource = glCreateShader(Type));
 		
@@ -256,16 +352,19 @@ namespace J::Graphics
 														const GLchar* const *String,
 														const GLint* Length)
 		{
+			GL_STAT(ShaderCalls, 1);
 			GLCALL(glShaderSource(Shader, Count, String, Length));
 		}
 
 		static FORCEINLINE void CompileShader( GLuint Shader )
 		{
+			GL_STAT( ShaderCalls, 1 );
 			GLCALL( glCompileShader( Shader ) );
 		}
 
 		static FORCEINLINE void GetShaderiv( GLuint Shader, GLenum ParameterName, GLint* Value )
 		{
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glGetShaderiv(Shader, ParameterName, Value));
 		}
 
@@ -274,16 +373,19 @@ namespace J::Graphics
 												  GLsizei* Length,
 												  GLchar* InfoLogBuffer )
 		{
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glGetShaderInfoLog(Shader, BufferSize, Length, InfoLogBuffer));
 		}
 
 		static FORCEINLINE void DeleteShader(GLuint Shader)
 		{
+			GL_STAT(DeleteCalls, 1);
 			GLCALL(glDeleteShader(Shader));
 		}
 
 		static FORCEINLINE void DetachShader(GLuint Program, GLuint Shader)
 		{
+			GL_STAT(ShaderCalls, 1);
 			GLCALL(glDetachShader(Program, Shader));
 		}
 
@@ -291,6 +393,7 @@ namespace J::Graphics
 
 		static FORCEINLINE GLint GetUniformLocation(GLuint Program, const GLchar* Name)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLint result;
 			GLCALL(result = glGetUniformLocation(Program, Name));
 			
@@ -299,61 +402,73 @@ namespace J::Graphics
 
 		static FORCEINLINE void Uniform1f(GLint location, float v0)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniform1f(location, v0));
 		}
 
 		static FORCEINLINE void Uniform2f(GLint location, float v0, float v1)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniform2f(location, v0, v1));
 		}
 
 		static FORCEINLINE void Uniform3f(GLint location, float v0, float v1, float v2)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniform3f(location, v0, v1, v2));
 		}
 
 		static FORCEINLINE void Uniform4f(GLint location, float v0, float v1, float v2, float v3)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniform4f(location, v0, v1, v2, v3));
 		}
 
 		static FORCEINLINE void Uniform1i(GLint location, GLint v0)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniform1i(location, v0));
 		}
 
 		static FORCEINLINE void Uniform2i(GLint location, GLint v0, GLint v1)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniform2i(location, v0, v1));
 		}
 
 		static FORCEINLINE void Uniform3i(GLint location, GLint v0, GLint v1, GLint v2)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniform3i(location, v0, v1, v2));
 		}
 
 		static FORCEINLINE void Uniform4i(GLint location, GLint v0, GLint v1, GLint v2, GLint v3)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniform4i(location, v0, v1, v2, v3));
 		}
 
 		static FORCEINLINE void Uniform1d(GLint location, GLdouble v0)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniform1d(location, v0));
 		}
 
 		static FORCEINLINE void Uniform2d(GLint location, GLdouble v0, GLdouble v1)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniform2d(location, v0, v1));
 		}
 
 		static FORCEINLINE void Uniform3d(GLint location, GLdouble v0, GLdouble v1, GLdouble v2)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniform3d(location, v0, v1, v2));
 		}
 
 		static FORCEINLINE void Uniform4d(GLint location, GLdouble v0, GLdouble v1, GLdouble v2, GLdouble v3)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniform4d(location, v0, v1, v2, v3));
 		}
 
@@ -363,6 +478,7 @@ namespace J::Graphics
 													GLboolean transpose,
 													const GLfloat* value)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniformMatrix2fv(location, count, transpose, value));
 		}
 
@@ -372,6 +488,7 @@ namespace J::Graphics
 													GLboolean transpose,
 													const GLfloat* value)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniformMatrix2x3fv(location, count, transpose, value));
 		}
 		
@@ -381,6 +498,7 @@ namespace J::Graphics
 													GLboolean transpose,
 													const GLfloat* value)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniformMatrix3x2fv(location, count, transpose, value));
 		}
 		
@@ -390,6 +508,7 @@ namespace J::Graphics
 													GLboolean transpose,
 													const GLfloat* value)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniformMatrix4fv(location, count, transpose, value));
 		}
 
@@ -399,6 +518,7 @@ namespace J::Graphics
 													GLboolean transpose,
 													const GLfloat* value)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniformMatrix3x4fv(location, count, transpose, value));
 		}
 
@@ -408,6 +528,7 @@ namespace J::Graphics
 													GLboolean transpose,
 													const GLfloat* value)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniformMatrix4x3fv(location, count, transpose, value));
 		}
 
@@ -417,6 +538,7 @@ namespace J::Graphics
 													GLboolean transpose,
 													const GLfloat* value)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniformMatrix2x4fv(location, count, transpose, value));
 		}
 
@@ -426,6 +548,7 @@ namespace J::Graphics
 													GLboolean transpose,
 													const GLfloat* value)
 		{
+			GL_STAT(UniformCalls, 1);
 			GLCALL(glUniformMatrix4x2fv(location, count, transpose, value));
 		}
 
@@ -433,6 +556,7 @@ namespace J::Graphics
 
 		static FORCEINLINE GLuint CreateProgram()
 		{
+			GL_STAT(GenCalls, 1);
 			GLuint resource;
 			GLCALL(resource = glCreateProgram());
 
@@ -441,31 +565,44 @@ namespace J::Graphics
 
 		static FORCEINLINE void UseProgram(GLuint Program)
 		{
+			if (!OpenGLStateCache::SetProgram(Program))
+			{
+				GL_STAT(SavedCalls, 1);
+				return;
+			}
+
+			GL_STAT(ProgramBinds, 1);
 			GLCALL(glUseProgram(Program));
 		}
 
 		static FORCEINLINE void DeleteProgram(GLuint Program)
 		{
+			GL_STAT(DeleteCalls, 1);
 			GLCALL(glDeleteProgram(Program));
+			OpenGLStateCache::OnProgramDeleted(Program);
 		}
 
 		static FORCEINLINE void ValidateProgram(GLuint Program)
 		{
+			GL_STAT(ShaderCalls, 1);
 			GLCALL(glValidateProgram(Program));
 		}
 
 		static FORCEINLINE void AttachShader(GLuint Program, GLuint Shader)
 		{
+			GL_STAT(ShaderCalls, 1);
 			GLCALL(glAttachShader(Program, Shader));
 		}
 
 		static FORCEINLINE void LinkProgram(GLuint Program)
 		{
+			GL_STAT(ShaderCalls, 1);
 			GLCALL(glLinkProgram(Program));
 		}
 
 		static FORCEINLINE void GetProgramiv(GLuint Program, GLenum ParameterName, GLint* Value)
 		{
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glGetProgramiv(Program, ParameterName, Value));
 		}
 
@@ -475,11 +612,13 @@ namespace J::Graphics
 													GLsizei* Length,
 													GLchar* InfoLogBuffer)
 		{
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glGetProgramInfoLog(Program, BufferSize, Length, InfoLogBuffer));
 		}
 
 		static FORCEINLINE GLuint CreateShaderProgram(GLenum Type, GLsizei Count, const GLchar* const *Sources)
 		{
+			GL_STAT(GenCalls, 1);
 			GLuint program;
 			GLCALL(program = glCreateShaderProgramv(Type, Count, Sources));
 		
@@ -490,26 +629,38 @@ namespace J::Graphics
 
 		static FORCEINLINE void GenVertexArrays(GLsizei Count, GLuint* Arrays)
 		{
+			GL_STAT(GenCalls, 1);
 			GLCALL(glGenVertexArrays(Count, Arrays));
 		}
 
 		static FORCEINLINE void DeleteVertexArrays(GLsizei Count, const GLuint* Arrays)
 		{
+			GL_STAT(DeleteCalls, 1);
 			GLCALL(glDeleteVertexArrays(Count, Arrays));
+			OpenGLStateCache::OnVertexArraysDeleted(Count, Arrays);
 		}
 
 		static FORCEINLINE void BindVertexArray(GLuint Array)
 		{
+			if (!OpenGLStateCache::SetVertexArray(Array))
+			{
+				GL_STAT(SavedCalls, 1);
+				return;
+			}
+
+			GL_STAT(VertexArrayBinds, 1);
 			GLCALL(glBindVertexArray(Array));
 		}
 
 		static FORCEINLINE void EnableVertexAttribArray(GLuint Index)
 		{
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glEnableVertexAttribArray(Index));
 		}
 
 		static FORCEINLINE void DisableVertexAttribArray(GLuint Index)
 		{
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glDisableVertexAttribArray(Index));
 		}
 
@@ -521,6 +672,7 @@ namespace J::Graphics
 													GLsizei Stride,
 													CMemPtr Offset)
 		{
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glVertexAttribPointer(Index, Size, Type, Normalized, Stride, Offset));
 		}
 		
@@ -531,6 +683,7 @@ namespace J::Graphics
 													GLsizei Stride,
 													CMemPtr Offset)
 		{
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glVertexAttribIPointer(Index, Size, Type, Stride, Offset));
 		}
 
@@ -541,6 +694,7 @@ namespace J::Graphics
 													GLsizei Stride,
 													CMemPtr Offset)
 		{
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glVertexAttribLPointer(Index, Size, Type, Stride, Offset));
 		}
 
@@ -552,6 +706,7 @@ namespace J::Graphics
 													GLboolean normalized,
 													GLuint relativeOffset)
 		{
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glVertexAttribFormat(attribIndex, size, type, normalized, relativeOffset));
 		}
 
@@ -560,32 +715,217 @@ namespace J::Graphics
 
 		static FORCEINLINE void GenTextures(GLsizei n, GLuint* textures)
 		{
+			GL_STAT(GenCalls, 1);
 			GLCALL(glGenTextures(n, textures));
 		}
 
 		static FORCEINLINE void BindTexture(GLenum Target, GLuint Texture)
 		{
+			if (!OpenGLStateCache::SetTexture(Target, Texture))
+			{
+				GL_STAT(SavedCalls, 1);
+				return;
+			}
+
+			GL_STAT(TextureBinds, 1);
 			GLCALL(glBindTexture(Target, Texture));
 		}
 
+		static FORCEINLINE void TexImage2D(
+													GLenum Target,
+													GLint Level,
+													GLint InternalFormat,
+													GLsizei Width,
+													GLsizei Height,
+													GLenum Format,
+													GLenum Type,
+													CMemPtr Pixels)
+		{
+			GL_STAT(TextureUploads, Pixels ? 1 : 0);
+			GL_STAT(TextureUploadBytes, Pixels ? uint64(Width) * uint64(Height) * GetPixelSize(Format, Type) : 0);
+			GLCALL(glTexImage2D(Target, Level, InternalFormat, Width, Height, 0, Format, Type, Pixels));
+		}
+
 		static FORCEINLINE void ActiveTexture(GLenum Texture)
 		{
+			if (!OpenGLStateCache::SetActiveTexture(Texture))
+			{
+				GL_STAT(SavedCalls, 1);
+				return;
+			}
+
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glActiveTexture(Texture));
 		}
 
 		static FORCEINLINE void GenerateMipmap(GLenum Target)
 		{
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glGenerateMipmap(Target));
 		}
 
 		static FORCEINLINE void GenerateTextureMipmap(GLuint Texture)
 		{
+			GL_STAT(OtherCalls, 1);
 			GLCALL(glGenerateTextureMipmap(Texture));
 		}
 
 		static FORCEINLINE void DeleteTextures(GLsizei n, const GLuint* textures)
 		{
+			GL_STAT(DeleteCalls, 1);
 			GLCALL(glDeleteTextures(n, textures));
+			OpenGLStateCache::OnTexturesDeleted(n, textures);
+		}
+
+
+		// Sync objects
+
+		static FORCEINLINE GLsync FenceSync(GLenum Condition, GLbitfield Flags)
+		{
+			GL_STAT(OtherCalls, 1);
+			GLsync sync;
+			GLCALL(sync = glFenceSync(Condition, Flags));
+
+			return sync;
+		}
+
+		static FORCEINLINE GLenum ClientWaitSync(GLsync Sync, GLbitfield Flags, GLuint64 Timeout)
+		{
+			GL_STAT(OtherCalls, 1);
+			GLenum result;
+			GLCALL(result = glClientWaitSync(Sync, Flags, Timeout));
+
+			return result;
+		}
+
+		static FORCEINLINE void DeleteSync(GLsync Sync)
+		{
+			GL_STAT(DeleteCalls, 1);
+			GLCALL(glDeleteSync(Sync));
+		}
+
+
+		// Blending and depth
+
+		static FORCEINLINE void BlendFunc(GLenum SourceFactor, GLenum DestinationFactor)
+		{
+			if (!OpenGLStateCache::SetBlendFunc(SourceFactor, DestinationFactor))
+			{
+				GL_STAT(SavedCalls, 1);
+				return;
+			}
+
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glBlendFunc(SourceFactor, DestinationFactor));
+		}
+
+		static FORCEINLINE void BlendEquation(GLenum Mode)
+		{
+			if (!OpenGLStateCache::SetBlendEquation(Mode))
+			{
+				GL_STAT(SavedCalls, 1);
+				return;
+			}
+
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glBlendEquation(Mode));
+		}
+
+		static FORCEINLINE void DepthFunc(GLenum Function)
+		{
+			if (!OpenGLStateCache::SetDepthFunc(Function))
+			{
+				GL_STAT(SavedCalls, 1);
+				return;
+			}
+
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glDepthFunc(Function));
+		}
+
+		static FORCEINLINE void DepthMask(GLboolean bWrite)
+		{
+			if (!OpenGLStateCache::SetDepthMask(bWrite))
+			{
+				GL_STAT(SavedCalls, 1);
+				return;
+			}
+
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glDepthMask(bWrite));
+		}
+
+
+		// Queries
+
+		static FORCEINLINE void GenQueries(GLsizei n, GLuint* ids)
+		{
+			GL_STAT(GenCalls, 1);
+			GLCALL(glGenQueries(n, ids));
+		}
+
+		static FORCEINLINE void DeleteQueries(GLsizei n, const GLuint* ids)
+		{
+			GL_STAT(DeleteCalls, 1);
+			GLCALL(glDeleteQueries(n, ids));
+		}
+
+		static FORCEINLINE void BeginQuery(GLenum Target, GLuint Id)
+		{
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glBeginQuery(Target, Id));
+		}
+
+		static FORCEINLINE void EndQuery(GLenum Target)
+		{
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glEndQuery(Target));
+		}
+
+		// records the GPU time (GL_TIMESTAMP) once the previous commands are done
+		static FORCEINLINE void QueryCounter(GLuint Id, GLenum Target)
+		{
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glQueryCounter(Id, Target));
+		}
+
+		static FORCEINLINE void GetQueryObjectiv(GLuint Id, GLenum ParameterName, GLint* Value)
+		{
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glGetQueryObjectiv(Id, ParameterName, Value));
+		}
+
+		static FORCEINLINE void GetQueryObjectui64v(GLuint Id, GLenum ParameterName, GLuint64* Value)
+		{
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glGetQueryObjectui64v(Id, ParameterName, Value));
+		}
+
+		static FORCEINLINE void GetIntegerv(GLenum ParameterName, GLint* Value)
+		{
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glGetIntegerv(ParameterName, Value));
+		}
+
+		static FORCEINLINE void GetInteger64v(GLenum ParameterName, GLint64* Value)
+		{
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glGetInteger64v(ParameterName, Value));
+		}
+
+
+		// Debug output
+
+		static FORCEINLINE void DebugMessageCallback(GLDEBUGPROC Callback, CMemPtr UserParam)
+		{
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glDebugMessageCallback(Callback, UserParam));
+		}
+
+		static FORCEINLINE void DebugMessageControl(GLenum Source, GLenum Type, GLenum Severity, GLsizei Count, const GLuint* Ids, GLboolean bEnabled)
+		{
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glDebugMessageControl(Source, Type, Severity, Count, Ids, bEnabled));
 		}
 
 
@@ -593,11 +933,15 @@ namespace J::Graphics
 
 		static FORCEINLINE void DrawArrays( GLenum Mode, GLint First, GLsizei Count )
 		{
+			GL_STAT( DrawCalls, 1 );
+			GL_STAT( DrawnElements, Count );
 			GLCALL( glDrawArrays( Mode, First, Count ) );
 		}
 
 		static FORCEINLINE void DrawElements( GLenum Mode, GLsizei Count, GLenum Type, CMemPtr Indices )
 		{
+			GL_STAT( DrawCalls, 1 );
+			GL_STAT( DrawnElements, Count );
 			GLCALL( glDrawElements( Mode, Count, Type, Indices ) );
 		}
 
@@ -608,11 +952,13 @@ namespace J::Graphics
 
 		static FORCEINLINE void ObjectLabel(GLenum Identifier, GLuint Name, GLsizei Length, const GLchar* Label)
 		{
+			GL_STAT(OtherCalls, 1);
 			glObjectLabel(Identifier, Name, Length, Label);
 		}
 
 		static FORCEINLINE void ObjectPtrLabel(MemPtr Ptr, GLsizei Length, const GLchar* Label)
 		{
+			GL_STAT(OtherCalls, 1);
 			glObjectPtrLabel(Ptr, Length, Label);
 		}
 
@@ -622,6 +968,30 @@ namespace J::Graphics
 		//}
 
 		// Other
+
+		static FORCEINLINE void Enable(GLenum Capability)
+		{
+			if (!OpenGLStateCache::SetCapability(Capability, true))
+			{
+				GL_STAT(SavedCalls, 1);
+				return;
+			}
+
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glEnable(Capability));
+		}
+
+		static FORCEINLINE void Disable(GLenum Capability)
+		{
+			if (!OpenGLStateCache::SetCapability(Capability, false))
+			{
+				GL_STAT(SavedCalls, 1);
+				return;
+			}
+
+			GL_STAT(OtherCalls, 1);
+			GLCALL(glDisable(Capability));
+		}
 	};
 
 }
@@ -0,0 +1,340 @@
+#include "OpenGLDebug.h"
+#include "OpenGLContext.h"
+#include "../../../../Utils/Profiling/Profiler.h"
+#include "../../../../Utils/Time/Timer.h"
+#include <format>
+#include <iostream>
+#include <unordered_map>
+
+
+
+namespace J::Graphics
+{
+
+	static constexpr Utils::TimeSpan GRateLimitWindow = Utils::TimeSpan::FromSeconds(1.0);
+
+	// in FRAME_END mode, the messages past it are only counted until the end of the frame
+	static constexpr SIZE_T GMaxPendingMessages = OpenGLDebug::MaxMessagesPerSecond;
+
+	struct SGLDebugMessage
+	{
+		GLenum		Source		= 0;
+		GLenum		Type		= 0;
+		GLenum		Severity	= 0;
+		GLuint		Id			= 0;
+		JString		Text;
+	};
+
+	/** Lets MaxMessagesPerSecond messages through in every window, MaxRepeatsPerSecond of a same one. */
+	struct SGLRateLimiter
+	{
+		uint64									WindowStart		= 0;
+
+		uint32									Reported		= 0;
+
+		uint64									Suppressed		= 0;
+
+		std::unordered_map<uint64, uint32>		Repeats;
+
+		bool Allow(uint64 key)
+		{
+			Roll();
+
+			uint32& repeats = Repeats[key];
+
+			if (Reported >= OpenGLDebug::MaxMessagesPerSecond || repeats >= OpenGLDebug::MaxRepeatsPerSecond)
+			{
+				Suppressed++;
+				return false;
+			}
+
+			Reported++;
+			repeats++;
+
+			return true;
+		}
+
+		void Roll()
+		{
+			if (Utils::Timer::GetElapsed(WindowStart) < GRateLimitWindow)
+			{
+				return;
+			}
+
+			if (Suppressed != 0)
+			{
+				std::cout << std::format("OpenGL - {} more messages suppressed in the last second.\n", Suppressed);
+			}
+
+			WindowStart = Utils::Timer::GetTicks();
+			Reported = 0;
+			Suppressed = 0;
+			Repeats.clear();
+		}
+	};
+
+	// the reports are made on the thread of the context, the queue is filled by the driver threads
+	static SGLRateLimiter					GRateLimiter;
+
+	static TMutex							GPendingMutex;
+	static JVector<SGLDebugMessage>			GPendingMessages;
+	static uint64							GDroppedMessages = 0;
+
+	static Atomic::TAtomicBool				GSynchronous { false };
+	static Atomic::TAtomic<uint64>			GErrorCount { 0 };
+
+	// errors reported by the debug output since the last glGetError, not reported twice
+	static uint64							GFrameDebugErrors = 0;
+
+	static bool								GDebugOutputSupported = false;
+
+
+	static constexpr const CHAR* GetSourceName(GLenum source)
+	{
+		switch (source)
+		{
+		case GL_DEBUG_SOURCE_API:				return "API";
+		case GL_DEBUG_SOURCE_WINDOW_SYSTEM:		return "Window System";
+		case GL_DEBUG_SOURCE_SHADER_COMPILER:	return "Shader Compiler";
+		case GL_DEBUG_SOURCE_THIRD_PARTY:		return "Third Party";
+		case GL_DEBUG_SOURCE_APPLICATION:		return "Application";
+		default:								return "Other";
+		}
+	}
+
+	static constexpr const CHAR* GetTypeName(GLenum type)
+	{
+		switch (type)
+		{
+		case GL_DEBUG_TYPE_ERROR:				return "error";
+		case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:	return "deprecated behavior";
+		case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:	return "undefined behavior";
+		case GL_DEBUG_TYPE_PORTABILITY:			return "portability";
+		case GL_DEBUG_TYPE_PERFORMANCE:			return "performance";
+		case GL_DEBUG_TYPE_MARKER:				return "marker";
+		default:								return "message";
+		}
+	}
+
+	static constexpr const CHAR* GetSeverityName(GLenum severity)
+	{
+		switch (severity)
+		{
+		case GL_DEBUG_SEVERITY_HIGH:			return "high";
+		case GL_DEBUG_SEVERITY_MEDIUM:			return "medium";
+		case GL_DEBUG_SEVERITY_LOW:				return "low";
+		default:								return "notification";
+		}
+	}
+
+	static void PrintCallSite(bool bExact)
+	{
+		const SGLCallSite& site = OpenGLDebug::GetCallSite();
+
+		// the sites are only recorded by the GLCALLs of the debug builds
+		if (site.Line != 0)
+		{
+			std::cout << std::format("  {} {} ({}:{})\n", bExact ? "in" : "after", site.Call, site.File, site.Line);
+		}
+	}
+
+	static void ReportMessage(const SGLDebugMessage& message, bool bExactSite)
+	{
+		const bool bError = message.Type == GL_DEBUG_TYPE_ERROR;
+
+		if (bError)
+		{
+			GErrorCount++;
+			GFrameDebugErrors++;
+			GL_STAT(Errors, 1);
+		}
+
+		const uint64 key = (static_cast<uint64>(message.Source) << 48) ^ (static_cast<uint64>(message.Type) << 32) ^ message.Id;
+
+		if (!GRateLimiter.Allow(key))
+		{
+			return;
+		}
+
+		std::cout << std::format("OpenGL {} {} ({}, id {}): {}\n",
+			GetSeverityName(message.Severity), GetTypeName(message.Type), GetSourceName(message.Source), message.Id, message.Text);
+		PrintCallSite(bExactSite);
+
+		if (JF_DEBUG && bError && bExactSite)
+		{
+			JF_DEBUG_BREAK();
+		}
+	}
+
+	/** Reads the error flags, reporting them unless the debug output already did. */
+	static void DrainErrors(bool bExactSite, bool bReport)
+	{
+		for (GLenum error = glGetError(); error != GL_NO_ERROR; error = glGetError())
+		{
+			if (!bReport)
+			{
+				continue;
+			}
+
+			GErrorCount++;
+			GL_STAT(Errors, 1);
+
+			if (GRateLimiter.Allow(error))
+			{
+				std::cout << std::format("OpenGL error - {}\n", OpenGLContext::GetStrErrorCode(error));
+				PrintCallSite(bExactSite);
+
+				if (JF_DEBUG && bExactSite)
+				{
+					JF_DEBUG_BREAK();
+				}
+			}
+		}
+	}
+
+	static void APIENTRY OnDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* text, const void*)
+	{
+		SGLDebugMessage message { source, type, severity, id, length >= 0 ? JString(text, length) : JString(text) };
+
+		if (GSynchronous)
+		{
+			ReportMessage(message, true);
+			return;
+		}
+
+		JF_SCOPED_LOCK(GPendingMutex);
+
+		if (GPendingMessages.size() < GMaxPendingMessages)
+		{
+			GPendingMessages.push_back(std::move(message));
+		}
+		else
+		{
+			GDroppedMessages++;
+		}
+	}
+
+
+	void OpenGLDebug::Initialize(EGLErrorMode mode)
+	{
+		// KHR_debug is core since OpenGL 4.3
+		GDebugOutputSupported = GLAD_GL_VERSION_4_3 != 0;
+
+		if (GDebugOutputSupported)
+		{
+			OpenGLContext::DebugMessageCallback(&OnDebugMessage, nullptr);
+			SetMinSeverity(JF_DEBUG ? EGLDebugSeverity::LOW : EGLDebugSeverity::MEDIUM);
+		}
+
+		SetMode(mode);
+	}
+
+	void OpenGLDebug::SetMode(EGLErrorMode mode)
+	{
+		if (mode == EGLErrorMode::DEBUG_OUTPUT && !GDebugOutputSupported)
+		{
+			mode = JF_DEBUG ? EGLErrorMode::EVERY_CALL : EGLErrorMode::FRAME_END;
+		}
+
+		// the errors of the previous mode are not blamed on the next call
+		DrainErrors(false, Mode != EGLErrorMode::NONE);
+
+		Mode = mode;
+		GSynchronous = mode == EGLErrorMode::DEBUG_OUTPUT;
+
+		if (!GDebugOutputSupported)
+		{
+			return;
+		}
+
+		// with EVERY_CALL the errors are already found by glGetError
+		if (mode == EGLErrorMode::DEBUG_OUTPUT || mode == EGLErrorMode::FRAME_END)
+		{
+			OpenGLContext::Enable(GL_DEBUG_OUTPUT);
+		}
+		else
+		{
+			OpenGLContext::Disable(GL_DEBUG_OUTPUT);
+		}
+
+		// synchronous messages come from the faulty call, at the cost of the driver's threading
+		if (mode == EGLErrorMode::DEBUG_OUTPUT)
+		{
+			OpenGLContext::Enable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+		}
+		else
+		{
+			OpenGLContext::Disable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+		}
+	}
+
+	void OpenGLDebug::SetMinSeverity(EGLDebugSeverity severity)
+	{
+		if (!GDebugOutputSupported)
+		{
+			return;
+		}
+
+		static constexpr GLenum severities[] =
+		{
+			GL_DEBUG_SEVERITY_NOTIFICATION,
+			GL_DEBUG_SEVERITY_LOW,
+			GL_DEBUG_SEVERITY_MEDIUM,
+			GL_DEBUG_SEVERITY_HIGH,
+		};
+
+		for (uint8 i = 0; i < std::size(severities); ++i)
+		{
+			const GLboolean bEnabled = i >= static_cast<uint8>(severity) ? GL_TRUE : GL_FALSE;
+			OpenGLContext::DebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, severities[i], 0, nullptr, bEnabled);
+		}
+	}
+
+	void OpenGLDebug::CheckErrors()
+	{
+		DrainErrors(true, true);
+	}
+
+	void OpenGLDebug::EndFrame()
+	{
+		JF_PROFILE_SCOPE("OpenGLDebug::EndFrame");
+
+		if (Mode == EGLErrorMode::NONE)
+		{
+			return;
+		}
+
+		JVector<SGLDebugMessage> messages;
+		uint64 dropped;
+
+		{
+			JF_SCOPED_LOCK(GPendingMutex);
+
+			messages.swap(GPendingMessages);
+			dropped = GDroppedMessages;
+			GDroppedMessages = 0;
+		}
+
+		for (const SGLDebugMessage& message : messages)
+		{
+			ReportMessage(message, false);
+		}
+
+		if (dropped != 0)
+		{
+			std::cout << std::format("OpenGL - {} more messages dropped this frame.\n", dropped);
+		}
+
+		// a single glGetError a frame, for the contexts without (or not generating) debug output
+		DrainErrors(false, GFrameDebugErrors == 0);
+		GFrameDebugErrors = 0;
+
+		GRateLimiter.Roll();
+	}
+
+	uint64 OpenGLDebug::GetErrorCount()
+	{
+		return GErrorCount;
+	}
+
+}
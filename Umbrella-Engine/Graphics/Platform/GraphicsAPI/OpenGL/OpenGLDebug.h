@@ -0,0 +1,101 @@
+#pragma once
+#include "../../../../Core.h"
+#include "glad/glad.h"
+
+
+
+namespace J::Graphics
+{
+
+	/** How the GL errors are found. */
+	enum class EGLErrorMode : uint8
+	{
+		NONE,
+
+		// glGetError after every GLCALL, each one waits for the driver (debug builds, once a frame otherwise)
+		EVERY_CALL,
+
+		// KHR_debug messages reported as they come, synchronous in debug builds for the exact GLCALL site
+		DEBUG_OUTPUT,
+
+		// KHR_debug messages queued, reported with a glGetError once a frame (shipping builds)
+		FRAME_END,
+	};
+
+	enum class EGLDebugSeverity : uint8
+	{
+		NOTIFICATION,
+		LOW,
+		MEDIUM,
+		HIGH,
+	};
+
+	/** The GLCALL being made, recorded for the error reports. */
+	struct SGLCallSite
+	{
+		const CHAR*	Call	= "";
+
+		const CHAR*	File	= "";
+
+		uint32		Line	= 0;
+	};
+
+
+	/**
+	 * Reports the GL errors and KHR_debug messages, at most MaxMessagesPerSecond of them (and MaxRepeatsPerSecond of a
+	 * same message), the others are counted and summed up.
+	 *
+	 * Apart from EVERY_CALL nothing waits for the driver. In the asynchronous modes the reported site is the last
+	 * GLCALL made before the message arrived, not necessarily the faulty one.
+	 */
+	class OpenGLDebug
+	{
+	public:
+
+		static constexpr uint32 MaxMessagesPerSecond = 32;
+
+		static constexpr uint32 MaxRepeatsPerSecond = 4;
+
+	public:
+
+		/**
+		 * Sets up the reports once the context is current. Without KHR_debug (before OpenGL 4.3) DEBUG_OUTPUT falls
+		 * back to EVERY_CALL in the debug builds and to FRAME_END otherwise.
+		 */
+		static void Initialize(EGLErrorMode mode = GetDefaultMode());
+
+		static constexpr EGLErrorMode GetDefaultMode() { return JF_DEBUG ? EGLErrorMode::DEBUG_OUTPUT : EGLErrorMode::FRAME_END; }
+
+		static void SetMode(EGLErrorMode mode);
+
+		static EGLErrorMode GetMode() { return Mode; }
+
+		/** Messages below it are filtered out by the driver. */
+		static void SetMinSeverity(EGLDebugSeverity severity);
+
+		static FORCEINLINE void SetCallSite(const CHAR* call, const CHAR* file, uint32 line)
+		{
+			CallSite.Call = call;
+			CallSite.File = file;
+			CallSite.Line = line;
+		}
+
+		static const SGLCallSite& GetCallSite() { return CallSite; }
+
+		/** glGetError after the call of the current site, for EVERY_CALL. */
+		static void CheckErrors();
+
+		/** Reports what was queued in the frame, see GpuApi::EndGpuFrame. */
+		static void EndFrame();
+
+		/** Errors found so far (the messages of the error type, and glGetError). */
+		static uint64 GetErrorCount();
+
+	private:
+
+		static inline SGLCallSite	CallSite;
+
+		static inline EGLErrorMode	Mode		= EGLErrorMode::NONE;
+	};
+
+}
@@ -0,0 +1,197 @@
+#include "OpenGLGpuTimer.h"
+#include "../../../../Utils/Profiling/Profiler.h"
+#include <algorithm>
+
+
+
+namespace J::Graphics
+{
+
+	// the GPU and CPU clocks drift apart, they are read together again this often (in frames)
+	static constexpr uint64 GClockSyncInterval = 64;
+
+
+	bool OpenGLGpuTimer::IsSupported()
+	{
+		if (eSupport == ESupport::UNKNOWN)
+		{
+			eSupport = GLAD_GL_VERSION_3_3 ? ESupport::SUPPORTED : ESupport::UNSUPPORTED;
+
+			if (eSupport == ESupport::SUPPORTED)
+			{
+				if (ProfilerTrack == 0)
+				{
+					ProfilerTrack = Utils::Profiler::Get().RegisterTrack("GPU");
+				}
+
+				SyncClocks();
+			}
+		}
+
+		return eSupport == ESupport::SUPPORTED;
+	}
+
+	void OpenGLGpuTimer::BeginZone(const CHAR* InName)
+	{
+		if (!IsSupported())
+		{
+			return;
+		}
+
+		SFrame& frame = Frames[CurrentFrame];
+
+		OpenZones.push_back(static_cast<uint32>(frame.Zones.size()));
+		frame.Zones.push_back({ InName, Timestamp(frame), 0, static_cast<uint32>(OpenZones.size() - 1) });
+	}
+
+	void OpenGLGpuTimer::EndZone()
+	{
+		if (!IsSupported())
+		{
+			return;
+		}
+
+		JF_ASSERT(!OpenZones.empty(), "No GPU zone to end.");
+
+		SFrame& frame = Frames[CurrentFrame];
+
+		frame.Zones[OpenZones.back()].EndQuery = Timestamp(frame);
+		OpenZones.pop_back();
+	}
+
+	void OpenGLGpuTimer::EndFrame()
+	{
+		if (!IsSupported())
+		{
+			return;
+		}
+
+		JF_ASSERT(OpenZones.empty(), "A GPU zone crosses the end of the frame.");
+
+		SFrame& frame = Frames[CurrentFrame];
+		frame.GpuSyncTime = GpuSyncTime;
+		frame.CpuSyncTicks = CpuSyncTicks;
+		frame.bPending = !frame.Zones.empty();
+
+		// oldest first (the one after the current), stopping at the first one the GPU is still working on
+		for (uint32 i = 1; i <= FramesInFlight; ++i)
+		{
+			SFrame& recorded = Frames[(CurrentFrame + i) % FramesInFlight];
+
+			if (recorded.bPending && !ReadBack(recorded))
+			{
+				break;
+			}
+		}
+
+		CurrentFrame = (CurrentFrame + 1) % FramesInFlight;
+
+		SFrame& next = Frames[CurrentFrame];
+
+		if (next.bPending)
+		{
+			DroppedFrames++;
+		}
+
+		next.bPending = false;
+		next.UsedQueries = 0;
+		next.Zones.clear();
+
+		if (++FrameCount % GClockSyncInterval == 0)
+		{
+			SyncClocks();
+		}
+	}
+
+	void OpenGLGpuTimer::Release()
+	{
+		for (SFrame& frame : Frames)
+		{
+			if (!frame.Queries.empty())
+			{
+				OpenGLContext::DeleteQueries(static_cast<GLsizei>(frame.Queries.size()), frame.Queries.data());
+			}
+
+			frame = SFrame();
+		}
+
+		OpenZones.clear();
+		eSupport = ESupport::UNKNOWN;
+	}
+
+	uint32 OpenGLGpuTimer::Timestamp(SFrame& InFrame)
+	{
+		if (InFrame.UsedQueries == InFrame.Queries.size())
+		{
+			GLuint query;
+			OpenGLContext::GenQueries(1, &query);
+
+			InFrame.Queries.push_back(query);
+		}
+
+		OpenGLContext::QueryCounter(InFrame.Queries[InFrame.UsedQueries], GL_TIMESTAMP);
+
+		return InFrame.UsedQueries++;
+	}
+
+	bool OpenGLGpuTimer::ReadBack(SFrame& InFrame)
+	{
+		// the timestamps complete in the order of the command stream, the last one being available means all are
+		GLint bAvailable = GL_FALSE;
+		OpenGLContext::GetQueryObjectiv(InFrame.Queries[InFrame.UsedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+
+		if (bAvailable == GL_FALSE)
+		{
+			return false;
+		}
+
+		const auto toCpuTicks = [&InFrame](GLuint64 InGpuTime)
+		{
+			const int64 offset = static_cast<int64>(InGpuTime) - InFrame.GpuSyncTime;
+
+			return offset >= 0
+				? InFrame.CpuSyncTicks + Utils::Timer::ToTicks(Utils::TimeSpan(offset))
+				: InFrame.CpuSyncTicks - Utils::Timer::ToTicks(Utils::TimeSpan(-offset));
+		};
+
+		JVector<Utils::SProfileZone> zones;
+		zones.reserve(InFrame.Zones.size());
+
+		GLuint64 frameBegin = std::numeric_limits<GLuint64>::max();
+		GLuint64 frameEnd = 0;
+
+		for (const SZone& zone : InFrame.Zones)
+		{
+			GLuint64 begin, end;
+			OpenGLContext::GetQueryObjectui64v(InFrame.Queries[zone.BeginQuery], GL_QUERY_RESULT, &begin);
+			OpenGLContext::GetQueryObjectui64v(InFrame.Queries[zone.EndQuery], GL_QUERY_RESULT, &end);
+
+			frameBegin = std::min(frameBegin, begin);
+			frameEnd = std::max(frameEnd, end);
+
+			zones.push_back({ zone.Name, toCpuTicks(begin), toCpuTicks(end), zone.Depth });
+		}
+
+		LastFrameTime = Utils::TimeSpan(static_cast<int64>(frameEnd - frameBegin));
+
+		if (Utils::Profiler::IsEnabled())
+		{
+			Utils::Profiler::Get().SubmitZones(ProfilerTrack, zones);
+		}
+
+		InFrame.bPending = false;
+
+		return true;
+	}
+
+	void OpenGLGpuTimer::SyncClocks()
+	{
+		// the time the GPU has reached in the command stream, without waiting for it
+		GLint64 gpuTime;
+		OpenGLContext::GetInteger64v(GL_TIMESTAMP, &gpuTime);
+
+		GpuSyncTime = gpuTime;
+		CpuSyncTicks = Utils::Timer::GetTicks();
+	}
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "OpenGLContext.h"
+#include "../../../../Utils/Time/TimeSpan.h"
+
+
+
+namespace J::Graphics
+{
+
+	/**
+	 * Measures the GPU time between points of the command stream with GL_TIMESTAMP queries.
+	 *
+	 * The queries of a frame are read back FramesInFlight - 1 frames later, once the GPU is done with them, so
+	 * nothing waits for the GPU: a frame whose results are still missing when its queries are needed again is
+	 * dropped. The zones read back go to the profiler on a "GPU" track, converted to the CPU clock.
+	 *
+	 * Works in the thread of the GL context, the queries are created on first use.
+	 */
+	class OpenGLGpuTimer
+	{
+	public:
+
+		static constexpr uint32 FramesInFlight = 4;
+
+	public:
+
+		OpenGLGpuTimer() = default;
+
+		OpenGLGpuTimer(const OpenGLGpuTimer&) = delete;
+
+		OpenGLGpuTimer& operator = (const OpenGLGpuTimer&) = delete;
+
+		/** Timestamps the start of a zone, a string literal. Zones nest, and do not cross EndFrame. */
+		void BeginZone(const CHAR* InName);
+
+		void EndZone();
+
+		/** Reads back the finished frames, once a frame before swapping the buffers. */
+		void EndFrame();
+
+		/** false if the context has no timer queries (before OpenGL 3.3), everything is a no-op then. */
+		bool IsSupported();
+
+		/** GPU time of the last frame read back, from its first to its last timestamp. */
+		Utils::TimeSpan GetLastFrameTime() const { return LastFrameTime; }
+
+		/** Frames whose results were not ready in time. */
+		uint64 GetDroppedFrames() const { return DroppedFrames; }
+
+		/** Deletes the queries, while the context is current. */
+		void Release();
+
+	private:
+
+		struct SZone
+		{
+			const CHAR*	Name;
+
+			uint32		BeginQuery;
+
+			uint32		EndQuery;
+
+			uint32		Depth;
+		};
+
+		struct SFrame
+		{
+			// grows to the most timestamps a frame has needed
+			JVector<GLuint>	Queries;
+
+			uint32			UsedQueries		= 0;
+
+			JVector<SZone>	Zones;
+
+			// GPU time and CPU ticks read together, when the frame was recorded
+			int64			GpuSyncTime		= 0;
+
+			uint64			CpuSyncTicks	= 0;
+
+			// recorded, not read back yet
+			bool			bPending		= false;
+		};
+
+		uint32 Timestamp(SFrame& InFrame);
+
+		/** \return false if some results are not available yet. */
+		bool ReadBack(SFrame& InFrame);
+
+		void SyncClocks();
+
+		SFrame				Frames[FramesInFlight];
+
+		// zones of the current frame not ended yet
+		JVector<uint32>		OpenZones;
+
+		uint32				CurrentFrame	= 0;
+
+		uint64				FrameCount		= 0;
+
+		int64				GpuSyncTime		= 0;
+
+		uint64				CpuSyncTicks	= 0;
+
+		Utils::TimeSpan		LastFrameTime;
+
+		uint64				DroppedFrames	= 0;
+
+		uint32				ProfilerTrack	= 0;
+
+		enum class ESupport : uint8 { UNKNOWN, SUPPORTED, UNSUPPORTED };
+
+		ESupport			eSupport		= ESupport::UNKNOWN;
+	};
+
+}
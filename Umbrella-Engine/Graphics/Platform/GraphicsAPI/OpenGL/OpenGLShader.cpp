@@ -9,16 +9,16 @@
 namespace J::Graphics
 {
 
-	OpenGLShader::IdType OpenGLShader::CurrentlyAttachedShader = OpenGLShader::InvalidShaderId;
-
 	OpenGLShader::OpenGLShader()
 		: Resource(InvalidShaderId)
 	{
 	}
 
 	OpenGLShader::OpenGLShader(OpenGLShader&& another) NOEXCEPT
-		: Resource(another.Resource)
+		: Resource(std::exchange(another.Resource, InvalidShaderId))
 	{
+		// the reload is bound to the moved from object
+		another.HotReloadHandle.Reset();
 	}
 
 	OpenGLShader::~OpenGLShader()
@@ -29,8 +29,14 @@ namespace J::Graphics
 
 	OpenGLShader& OpenGLShader::operator = (OpenGLShader&& another) NOEXCEPT
 	{
-		this->Release();
-		this->Resource = another.Resource;
+		if (this != &another)
+		{
+			this->HotReloadHandle.Reset();
+			another.HotReloadHandle.Reset();
+
+			this->Release();
+			this->Resource = std::exchange(another.Resource, InvalidShaderId);
+		}
 
 		return *this;
 	}
@@ -56,13 +62,10 @@ namespace J::Graphics
 	
 	void OpenGLShader::Release()
 	{
+		this->HotReloadHandle.Reset();
+
 		if (this->Resource != InvalidShaderId)
 		{
-			if (this->Resource == CurrentlyAttachedShader)
-			{
-				CurrentlyAttachedShader = InvalidShaderId;
-			}
-
 			OpenGLContext::DeleteProgram(this->Resource);
 		}
 
@@ -106,13 +109,11 @@ namespace J::Graphics
 	void OpenGLShader::Bind() const
 	{
 		OpenGLContext::UseProgram(this->Resource);
-		OpenGLShader::CurrentlyAttachedShader = this->Resource;
 	}
 
 	void OpenGLShader::Unbind() const
 	{
 		OpenGLContext::UseProgram(InvalidShaderId);
-		OpenGLShader::CurrentlyAttachedShader = InvalidShaderId;
 	}
 
 
@@ -149,6 +150,23 @@ namespace J::Graphics
 
 	// loaders
 
+	void OpenGLShader::ReplaceProgram(IdType program)
+	{
+		const bool bWasBound = IsValid() && this->Resource == GetCurrentlyAttachedShader();
+
+		if (this->Resource != InvalidShaderId)
+		{
+			OpenGLContext::DeleteProgram(this->Resource);
+		}
+
+		this->SetHandler(program);
+
+		if (bWasBound)
+		{
+			this->Bind();
+		}
+	}
+
 	void OpenGLShader::LoadFromString(const std::string& vertex, const std::string& fragment)
 	{
 		std::array<SPipelineStageInfo, 2>  stages =
@@ -157,26 +175,86 @@ namespace J::Graphics
 			SPipelineStageInfo { EShaderType::FRAGMENT_SHADER, fragment, InvalidShaderId },
 		};
 
-		auto program = CreateShaderProgram(stages);
+		// not from files anymore
+		this->HotReloadHandle.Reset();
 
-		this->SetHandler(program);
+		this->ReplaceProgram(CreateShaderProgram(stages));
 	}
 
-	// #todo implement later other loaders (with appropriate engine filesystem)
-
 	void OpenGLShader::LoadFromString(const std::string& vertex, const std::string& geometry, const std::string& fragment)
 	{
-		throw "NotImplementedYet";
+		std::array<SPipelineStageInfo, 3>  stages =
+		{
+			SPipelineStageInfo { EShaderType::VERTEX_SHADER, vertex, InvalidShaderId },
+			SPipelineStageInfo { EShaderType::GEOMETRY_SHADER, geometry, InvalidShaderId },
+			SPipelineStageInfo { EShaderType::FRAGMENT_SHADER, fragment, InvalidShaderId },
+		};
+
+		this->HotReloadHandle.Reset();
+
+		this->ReplaceProgram(CreateShaderProgram(stages));
 	}
 
 	void OpenGLShader::Load(const system::FilePath& vertexPath, const system::FilePath& fragmentPath)
 	{
-		throw "NotImplementedYet";
+		this->LoadFromString(system::File::ReadAllText(vertexPath), system::File::ReadAllText(fragmentPath));
+
+		this->WatchSources({ vertexPath, fragmentPath });
 	}
 
 	void OpenGLShader::Load(const system::FilePath& vertexPath, const system::FilePath& geometry, const system::FilePath& fragmentPath)
 	{
-		throw "NotImplementedYet";
+		this->LoadFromString(system::File::ReadAllText(vertexPath), system::File::ReadAllText(geometry), system::File::ReadAllText(fragmentPath));
+
+		this->WatchSources({ vertexPath, geometry, fragmentPath });
+	}
+
+	void OpenGLShader::WatchSources(JVector<system::FilePath> paths)
+	{
+		// vertex, (geometry,) fragment - like the loaders
+		using SourcesType = JVector<std::string>;
+
+		auto prepare = [paths]() -> Ref<SourcesType>
+		{
+			auto sources = MakeRef<SourcesType>();
+
+			for (const auto& path : paths)
+			{
+				sources->push_back(system::File::ReadAllText(path));
+			}
+
+			return sources;
+		};
+
+		auto apply = [this](SourcesType& sources)
+		{
+			JVector<SPipelineStageInfo> stages;
+
+			stages.push_back({ EShaderType::VERTEX_SHADER, std::move(sources.front()), InvalidShaderId });
+
+			if (sources.size() == 3)
+			{
+				stages.push_back({ EShaderType::GEOMETRY_SHADER, std::move(sources[1]), InvalidShaderId });
+			}
+
+			stages.push_back({ EShaderType::FRAGMENT_SHADER, std::move(sources.back()), InvalidShaderId });
+
+			IdType program = CreateShaderProgram(stages);
+
+			GLint linked = GL_FALSE;
+			OpenGLContext::GetProgramiv(program, GL_LINK_STATUS, &linked);
+
+			if (linked != GL_TRUE)
+			{
+				// the errors are logged already, keep drawing with the working program
+				OpenGLContext::DeleteProgram(program);
+				return;
+			}
+
+			this->ReplaceProgram(program);
+		};
+
+		this->HotReloadHandle = system::HotReload::Get().Register<SourcesType>(paths, prepare, apply);
 	}
 
 	// uniforms
@@ -5,6 +5,7 @@
 #include <filesystem>
 #include "OpenGLUtils.h"
 #include "../Shader.h"
+#include "../../../../Utils/FileSystem/HotReload.h"
 
 
 
@@ -44,10 +45,11 @@ namespace J::Graphics
 
 	private:
 
-		static IdType CurrentlyAttachedShader;
-
 		IdType Resource;
 
+		// rebuilds the program when the sources given to Load change on disk
+		system::HotReload::Handle HotReloadHandle;
+
 	public:
 
 		OpenGLShader();
@@ -75,17 +77,17 @@ namespace J::Graphics
 		static IdType CreateShaderProgram(_Range&& range);
 
 
-		static IdType GetCurrentlyAttachedShader() { return CurrentlyAttachedShader; }
+		static IdType GetCurrentlyAttachedShader() { return OpenGLStateCache::GetProgram(); }
 		
 		// loaders
 
 		void LoadFromString( const std::string& vertex, const std::string& fragment ) override;
 		
-		// ! todo implement those later !
 		// ! possibly create preprocessor entity to process shader sources !
 
 		void LoadFromString( const std::string& vertex, const std::string& geometry, const std::string& fragment ) override;
 
+		/** Sources read through the file system, the program is rebuilt when they change while hot reload is on (see system::HotReload). */
 		void Load( const system::FilePath& vertexPath, const system::FilePath& fragmentPath ) override;
 		void Load( const system::FilePath& vertexPath, const system::FilePath& geometry, const system::FilePath& fragmentPath ) override;
 
@@ -123,6 +125,12 @@ namespace J::Graphics
 
 	protected:
 
+		/** Replaces the program, rebinding the new one if the old one was bound. */
+		void ReplaceProgram(IdType program);
+
+		/** Rebuilds the program from the changed sources, keeping the current one if they don't link. */
+		void WatchSources(JVector<system::FilePath> paths);
+
 		static IdType CreateShader(EShaderType type, const std::string& Source);
 
 		static IdType CreateProgram(IdType* ids, SIZE_T shaderCount);
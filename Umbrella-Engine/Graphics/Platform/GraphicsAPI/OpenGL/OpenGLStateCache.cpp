@@ -0,0 +1,83 @@
+#include "OpenGLStateCache.h"
+
+
+
+namespace J::Graphics
+{
+
+	void OpenGLStateCache::Invalidate()
+	{
+		Program = UnknownObject;
+		VertexArray = UnknownObject;
+		Buffers.fill(UnknownObject);
+
+		ActiveTextureUnit = MaxTextureUnits;
+		Textures.fill(SGLTextureBinding());
+
+		Capabilities.fill(EGLCapabilityState::UNKNOWN);
+
+		BlendSource = UnknownEnum;
+		BlendDestination = UnknownEnum;
+		BlendEquation = UnknownEnum;
+		DepthFunction = UnknownEnum;
+		DepthMask = UnknownEnum;
+	}
+
+	void OpenGLStateCache::OnBuffersDeleted(GLsizei count, const GLuint* buffers)
+	{
+		for (GLsizei i = 0; i < count; ++i)
+		{
+			for (GLuint& buffer : Buffers)
+			{
+				if (buffer == buffers[i])
+				{
+					buffer = 0;
+				}
+			}
+		}
+	}
+
+	void OpenGLStateCache::OnVertexArraysDeleted(GLsizei count, const GLuint* arrays)
+	{
+		for (GLsizei i = 0; i < count; ++i)
+		{
+			if (VertexArray == arrays[i])
+			{
+				VertexArray = 0;
+				Buffers[ElementArraySlot] = UnknownObject;
+			}
+		}
+	}
+
+	void OpenGLStateCache::OnTexturesDeleted(GLsizei count, const GLuint* textures)
+	{
+		// unbound from every unit, not only the active one
+		for (GLsizei i = 0; i < count; ++i)
+		{
+			for (SGLTextureBinding& binding : Textures)
+			{
+				if (binding.Texture == textures[i])
+				{
+					binding.Texture = 0;
+				}
+			}
+		}
+	}
+
+	void OpenGLStateCache::OnProgramDeleted(GLuint program)
+	{
+		// a program in use is only flagged for deletion, and stays in use until another one is
+		if (Program == program)
+		{
+			Program = UnknownObject;
+		}
+	}
+
+	GLuint OpenGLStateCache::GetBuffer(GLenum target)
+	{
+		const uint32 slot = GetBufferSlot(target);
+
+		return slot != UntrackedSlot ? Buffers[slot] : UnknownObject;
+	}
+
+}
@@ -0,0 +1,247 @@
+#pragma once
+#include "../../../../Core.h"
+#include "glad/glad.h"
+#include <array>
+
+
+
+namespace J::Graphics
+{
+
+	enum class EGLCapabilityState : uint8
+	{
+		UNKNOWN,
+		DISABLED,
+		ENABLED,
+	};
+
+	// binding of a texture unit, unknown (~0) until set
+	struct SGLTextureBinding
+	{
+		GLenum	Target	= ~0u;
+
+		GLuint	Texture	= ~0u;
+	};
+
+
+	/**
+	 * State last set through the OpenGLContext wrappers, to skip the calls which would not change it (counted as
+	 * EGLStat::SavedCalls).
+	 *
+	 * What was never set, or may have been changed behind the wrappers' back, is unknown and the next call always goes
+	 * through. Code calling GL directly (SDL, third parties) has to Invalidate the cache afterwards.
+	 * Used on the thread of the context, like the wrappers.
+	 */
+	class OpenGLStateCache
+	{
+	public:
+
+		static constexpr GLuint		UnknownObject		= ~0u;
+
+		static constexpr GLenum		UnknownEnum			= ~0u;
+
+		// units past it are not cached
+		static constexpr uint32		MaxTextureUnits		= 32;
+
+	public:
+
+		/** When disabled the state is still tracked but every call goes through, to rule the cache out of a rendering bug. */
+		static void SetEnabled(bool bEnable) { bEnabled = bEnable; }
+
+		static bool IsEnabled() { return bEnabled; }
+
+		/** Forgets the whole state, once the context is created or after GL was used outside of the wrappers. */
+		static void Invalidate();
+
+		// the setters record the new state and return true when the GL call is needed
+
+		static FORCEINLINE bool SetProgram(GLuint program) { return Exchange(Program, program); }
+
+		static FORCEINLINE bool SetVertexArray(GLuint array)
+		{
+			if (!Exchange(VertexArray, array))
+			{
+				return false;
+			}
+
+			// the element array binding is part of the vertex array
+			Buffers[ElementArraySlot] = UnknownObject;
+			return true;
+		}
+
+		static FORCEINLINE bool SetBuffer(GLenum target, GLuint buffer)
+		{
+			const uint32 slot = GetBufferSlot(target);
+
+			return slot == UntrackedSlot || Exchange(Buffers[slot], buffer);
+		}
+
+		static FORCEINLINE bool SetActiveTexture(GLenum unit)
+		{
+			const uint32 index = unit - GL_TEXTURE0;
+
+			if (bEnabled && index == ActiveTextureUnit && index < MaxTextureUnits)
+			{
+				return false;
+			}
+
+			ActiveTextureUnit = index < MaxTextureUnits ? index : MaxTextureUnits;
+			return true;
+		}
+
+		static FORCEINLINE bool SetTexture(GLenum target, GLuint texture)
+		{
+			if (ActiveTextureUnit >= MaxTextureUnits)
+			{
+				return true;
+			}
+
+			// only the last target bound on a unit is kept, binding another one of the unit is never skipped
+			SGLTextureBinding& binding = Textures[ActiveTextureUnit];
+
+			if (bEnabled && binding.Target == target && binding.Texture == texture)
+			{
+				return false;
+			}
+
+			binding = { target, texture };
+			return true;
+		}
+
+		static FORCEINLINE bool SetCapability(GLenum capability, bool bEnable)
+		{
+			const uint32 slot = GetCapabilitySlot(capability);
+
+			if (slot == UntrackedSlot)
+			{
+				return true;
+			}
+
+			const EGLCapabilityState state = bEnable ? EGLCapabilityState::ENABLED : EGLCapabilityState::DISABLED;
+
+			if (bEnabled && Capabilities[slot] == state)
+			{
+				return false;
+			}
+
+			Capabilities[slot] = state;
+			return true;
+		}
+
+		static FORCEINLINE bool SetBlendFunc(GLenum source, GLenum destination)
+		{
+			if (bEnabled && BlendSource == source && BlendDestination == destination)
+			{
+				return false;
+			}
+
+			BlendSource = source;
+			BlendDestination = destination;
+			return true;
+		}
+
+		static FORCEINLINE bool SetBlendEquation(GLenum mode) { return Exchange(BlendEquation, mode); }
+
+		static FORCEINLINE bool SetDepthFunc(GLenum function) { return Exchange(DepthFunction, function); }
+
+		static FORCEINLINE bool SetDepthMask(GLboolean bWrite) { return Exchange(DepthMask, static_cast<GLenum>(bWrite)); }
+
+		// hooks of the delete wrappers, GL unbinds the deleted objects
+
+		static void OnBuffersDeleted(GLsizei count, const GLuint* buffers);
+
+		static void OnVertexArraysDeleted(GLsizei count, const GLuint* arrays);
+
+		static void OnTexturesDeleted(GLsizei count, const GLuint* textures);
+
+		static void OnProgramDeleted(GLuint program);
+
+		// bound objects, UnknownObject when not known
+
+		static GLuint GetProgram() { return Program; }
+
+		static GLuint GetVertexArray() { return VertexArray; }
+
+		static GLuint GetBuffer(GLenum target);
+
+	private:
+
+		static constexpr uint32 UntrackedSlot = ~0u;
+
+		static constexpr uint32 ElementArraySlot = 1;
+
+		static constexpr uint32 GetBufferSlot(GLenum target)
+		{
+			switch (target)
+			{
+			case GL_ARRAY_BUFFER:				return 0;
+			case GL_ELEMENT_ARRAY_BUFFER:		return ElementArraySlot;
+			case GL_COPY_READ_BUFFER:			return 2;
+			case GL_COPY_WRITE_BUFFER:			return 3;
+			case GL_PIXEL_PACK_BUFFER:			return 4;
+			case GL_PIXEL_UNPACK_BUFFER:		return 5;
+			case GL_UNIFORM_BUFFER:				return 6;
+			case GL_SHADER_STORAGE_BUFFER:		return 7;
+			case GL_DRAW_INDIRECT_BUFFER:		return 8;
+			case GL_DISPATCH_INDIRECT_BUFFER:	return 9;
+			case GL_TEXTURE_BUFFER:				return 10;
+			default:							return UntrackedSlot;
+			}
+		}
+
+		static constexpr uint32 BufferSlotsCount = 11;
+
+		static constexpr uint32 GetCapabilitySlot(GLenum capability)
+		{
+			switch (capability)
+			{
+			case GL_BLEND:						return 0;
+			case GL_DEPTH_TEST:					return 1;
+			case GL_CULL_FACE:					return 2;
+			case GL_SCISSOR_TEST:				return 3;
+			case GL_STENCIL_TEST:				return 4;
+			default:							return UntrackedSlot;
+			}
+		}
+
+		static constexpr uint32 CapabilitySlotsCount = 5;
+
+		static FORCEINLINE bool Exchange(GLuint& cached, GLuint value)
+		{
+			if (bEnabled && cached == value)
+			{
+				return false;
+			}
+
+			cached = value;
+			return true;
+		}
+
+	private:
+
+		static inline bool													bEnabled			= true;
+
+		static inline GLuint												Program				= UnknownObject;
+
+		static inline GLuint												VertexArray			= UnknownObject;
+
+		static inline std::array<GLuint, BufferSlotsCount>					Buffers				= [] { std::array<GLuint, BufferSlotsCount> buffers; buffers.fill(UnknownObject); return buffers; }();
+
+		static inline uint32												ActiveTextureUnit	= MaxTextureUnits;
+
+		static inline std::array<SGLTextureBinding, MaxTextureUnits>			Textures;
+
+		static inline std::array<EGLCapabilityState, CapabilitySlotsCount>	Capabilities		= {};
+
+		static inline GLenum												BlendSource			= UnknownEnum;
+
+		static inline GLenum												BlendDestination	= UnknownEnum;
+
+		static inline GLenum												BlendEquation		= UnknownEnum;
+
+		static inline GLenum												DepthFunction		= UnknownEnum;
+
+		static inline GLenum												DepthMask			= UnknownEnum;
+	};
+
+}
@@ -0,0 +1,128 @@
+#include "OpenGLStatistics.h"
+#include <algorithm>
+#include <iomanip>
+
+
+
+namespace J::Graphics
+{
+
+	static constexpr const CHAR* GStatNames[] =
+	{
+		"DrawCalls",
+		"DrawnElements",
+		"ClearCalls",
+
+		"BufferBinds",
+		"VertexArrayBinds",
+		"TextureBinds",
+		"ProgramBinds",
+		"UniformCalls",
+
+		"GenCalls",
+		"DeleteCalls",
+		"ShaderCalls",
+
+		"BufferUploads",
+		"BufferUploadBytes",
+		"TextureUploads",
+		"TextureUploadBytes",
+		"BufferReadBytes",
+		"BufferCopyBytes",
+
+		"OtherCalls",
+		"SavedCalls",
+		"Errors",
+	};
+
+	static_assert(std::size(GStatNames) == (SIZE_T)EGLStat::COUNT, "Every GL statistic needs a name.");
+
+
+	void OpenGLStatistics::EndFrame()
+	{
+		Current.Frame = FrameCount;
+		History[FrameCount % HistorySize] = Current;
+
+		FrameCount++;
+		Current = SGLStatistics();
+	}
+
+	SGLStatistics OpenGLStatistics::GetLastFrame()
+	{
+		return FrameCount != 0 ? History[(FrameCount - 1) % HistorySize] : SGLStatistics();
+	}
+
+	JVector<SGLStatistics> OpenGLStatistics::GetHistory()
+	{
+		const uint64 count = std::min<uint64>(FrameCount, HistorySize);
+
+		JVector<SGLStatistics> history;
+		history.reserve(count);
+
+		for (uint64 frame = FrameCount - count; frame < FrameCount; ++frame)
+		{
+			history.push_back(History[frame % HistorySize]);
+		}
+
+		return history;
+	}
+
+	SGLStatistics OpenGLStatistics::GetPeak()
+	{
+		SGLStatistics peak = GetLastFrame();
+
+		for (const SGLStatistics& frame : GetHistory())
+		{
+			for (SIZE_T i = 0; i < peak.Counters.size(); ++i)
+			{
+				peak.Counters[i] = std::max(peak.Counters[i], frame.Counters[i]);
+			}
+		}
+
+		return peak;
+	}
+
+	const CHAR* OpenGLStatistics::GetStatName(EGLStat stat)
+	{
+		return stat < EGLStat::COUNT ? GStatNames[(SIZE_T)stat] : "[Unknown statistic]";
+	}
+
+	void OpenGLStatistics::Dump(std::ostream& stream)
+	{
+		const JVector<SGLStatistics> history = GetHistory();
+
+		if (history.empty())
+		{
+			stream << "No GL statistics, no frame has ended yet.\n";
+			return;
+		}
+
+		const SGLStatistics& last = history.back();
+		const SGLStatistics peak = GetPeak();
+
+		// the caller's stream keeps its formatting
+		const std::ios::fmtflags flags = stream.flags();
+		const std::streamsize precision = stream.precision();
+
+		stream << "GL statistics of frame " << last.Frame << ", average and peak of the last " << history.size() << " frames:\n";
+
+		for (SIZE_T i = 0; i < (SIZE_T)EGLStat::COUNT; ++i)
+		{
+			uint64 sum = 0;
+
+			for (const SGLStatistics& frame : history)
+			{
+				sum += frame.Counters[i];
+			}
+
+			stream << "  " << std::left << std::setw(20) << GStatNames[i]
+				<< std::right << std::setw(12) << last.Counters[i]
+				<< std::setw(14) << std::fixed << std::setprecision(1) << static_cast<double>(sum) / static_cast<double>(history.size())
+				<< std::setw(12) << peak.Counters[i] << '\n';
+		}
+
+		stream.flags(flags);
+		stream.precision(precision);
+	}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "../../../../Core.h"
+#include <array>
+#include <ostream>
+
+
+
+namespace J::Graphics
+{
+
+	/** Counters of the OpenGLContext wrappers. */
+	enum class EGLStat : uint8
+	{
+		DrawCalls,
+		DrawnElements,			// vertices or indices
+		ClearCalls,
+
+		BufferBinds,
+		VertexArrayBinds,
+		TextureBinds,
+		ProgramBinds,
+		UniformCalls,
+
+		GenCalls,				// glGen*, glCreate*
+		DeleteCalls,
+		ShaderCalls,			// sources, compilation, linking
+
+		BufferUploads,
+		BufferUploadBytes,
+		TextureUploads,
+		TextureUploadBytes,
+		BufferReadBytes,
+		BufferCopyBytes,
+
+		OtherCalls,
+		SavedCalls,				// skipped by OpenGLStateCache, they would not have changed the state
+		Errors,
+
+		COUNT
+	};
+
+	struct SGLStatistics
+	{
+		// index of the frame, counted by OpenGLStatistics::EndFrame
+		uint64											Frame		= 0;
+
+		std::array<uint64, (SIZE_T)EGLStat::COUNT>		Counters	= {};
+
+		uint64 operator [] (EGLStat stat) const { return Counters[(SIZE_T)stat]; }
+	};
+
+
+	/**
+	 * GL calls made through the OpenGLContext wrappers in a frame, and in the frames before it.
+	 *
+	 * Counted when JF_GL_STATISTICS is set, on the thread of the GL context (the counters are not atomic).
+	 */
+	class OpenGLStatistics
+	{
+	public:
+
+		// frames kept by the history
+		static constexpr uint32 HistorySize = 120;
+
+	public:
+
+		static FORCEINLINE void Add(EGLStat stat, uint64 value = 1) { Current.Counters[(SIZE_T)stat] += value; }
+
+		/** Snapshots the frame into the history and starts the next one, see GpuApi::EndGpuFrame. */
+		static void EndFrame();
+
+		/** Calls of the frame in progress so far. */
+		static const SGLStatistics& GetCurrentFrame() { return Current; }
+
+		static SGLStatistics GetLastFrame();
+
+		/** The frames of the history, oldest first. */
+		static JVector<SGLStatistics> GetHistory();
+
+		/** Highest value of each counter over the history (upload spikes, ...), Frame is the last one. */
+		static SGLStatistics GetPeak();
+
+		static const CHAR* GetStatName(EGLStat stat);
+
+		/** Writes the last frame, the average and the peak of every counter. */
+		static void Dump(std::ostream& stream);
+
+	private:
+
+		static inline SGLStatistics								Current;
+
+		static inline std::array<SGLStatistics, HistorySize>	History;
+
+		static inline uint64									FrameCount = 0;
+	};
+
+}
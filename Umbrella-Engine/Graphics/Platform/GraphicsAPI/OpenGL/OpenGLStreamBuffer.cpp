@@ -0,0 +1,164 @@
+#include "OpenGLStreamBuffer.h"
+#include "../../../../Utils/Profiling/Profiler.h"
+#include <algorithm>
+
+
+
+namespace J::Graphics
+{
+
+	static constexpr GLbitfield GStreamMapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+
+	bool OpenGLStreamBuffer::IsSupported()
+	{
+		if (eSupport == ESupport::UNKNOWN)
+		{
+			// glNamedBufferStorage and glMapNamedBufferRange
+			eSupport = GLAD_GL_VERSION_4_5 && Create(FrameSize) ? ESupport::SUPPORTED : ESupport::UNSUPPORTED;
+		}
+
+		return eSupport == ESupport::SUPPORTED;
+	}
+
+	MemPtr OpenGLStreamBuffer::Allocate(SIZE_T InSize, SIZE_T InAlignment, SIZE_T& OutOffset)
+	{
+		JF_ASSERT(InAlignment != 0 && (InAlignment & (InAlignment - 1)) == 0, "The alignment must be a power of two.");
+
+		if (!IsSupported())
+		{
+			return NullPtr;
+		}
+
+		if (!bFrameReady)
+		{
+			WaitForFrame(CurrentFrame);
+			bFrameReady = true;
+		}
+
+		// aligned in the whole buffer, a part only starts at a multiple of UniformAlignment
+		const SIZE_T partStart = CurrentFrame * FrameSize;
+		const SIZE_T offset = ((partStart + Head + InAlignment - 1) & ~(InAlignment - 1)) - partStart;
+
+		if (InSize > FrameSize || offset > FrameSize - InSize)
+		{
+			Overflows++;
+			return NullPtr;
+		}
+
+		Head = offset + InSize;
+		OutOffset = partStart + offset;
+
+		return Mapped + OutOffset;
+	}
+
+	void OpenGLStreamBuffer::EndFrame()
+	{
+		if (eSupport != ESupport::SUPPORTED)
+		{
+			return;
+		}
+
+		// nothing to protect in a part the frame did not write
+		if (Head != 0)
+		{
+			Fences[CurrentFrame].Lock();
+		}
+
+		LastFrameUsage = Head;
+
+		CurrentFrame = (CurrentFrame + 1) % FramesInFlight;
+		Head = 0;
+		bFrameReady = false;
+	}
+
+	bool OpenGLStreamBuffer::Reserve(SIZE_T InFrameSize)
+	{
+		if (InFrameSize <= FrameSize && eSupport != ESupport::UNKNOWN)
+		{
+			return eSupport == ESupport::SUPPORTED;
+		}
+
+		if (eSupport != ESupport::SUPPORTED)
+		{
+			// created with this size on first use
+			FrameSize = std::max(FrameSize, InFrameSize);
+			return eSupport == ESupport::UNKNOWN;
+		}
+
+		// GL keeps the old buffer alive until the commands reading it are done
+		Release();
+
+		eSupport = Create(InFrameSize) ? ESupport::SUPPORTED : ESupport::UNSUPPORTED;
+
+		return eSupport == ESupport::SUPPORTED;
+	}
+
+	void OpenGLStreamBuffer::Release()
+	{
+		for (OpenGLSync& fence : Fences)
+		{
+			fence.Unlock();
+		}
+
+		if (Resource != OpenGLContext::GInvalidGLResource)
+		{
+			OpenGLContext::UnmapNamedBuffer(Resource);
+			OpenGLContext::DeleteBuffers(1, &Resource);
+		}
+
+		Resource = OpenGLContext::GInvalidGLResource;
+		Mapped = NullPtr;
+		CurrentFrame = 0;
+		Head = 0;
+		bFrameReady = false;
+		eSupport = ESupport::UNKNOWN;
+	}
+
+	bool OpenGLStreamBuffer::Create(SIZE_T InFrameSize)
+	{
+		JF_PROFILE_SCOPE("OpenGLStreamBuffer::Create");
+
+		GLint alignment = 0;
+		OpenGLContext::GetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		UniformAlignment = alignment > 0 ? static_cast<SIZE_T>(alignment) : 256;
+
+		// every part starts aligned for any use
+		FrameSize = (InFrameSize + UniformAlignment - 1) / UniformAlignment * UniformAlignment;
+
+		const GLsizeiptr size = static_cast<GLsizeiptr>(FrameSize * FramesInFlight);
+
+		OpenGLContext::CreateBuffers(1, &Resource);
+		OpenGLContext::NamedBufferStorage(Resource, size, NullPtr, GStreamMapFlags);
+		OpenGLContext::ObjectLabel(GL_BUFFER, Resource, -1, "Stream Buffer");
+
+		Mapped = static_cast<byte*>(OpenGLContext::MapNamedBufferRange(Resource, 0, size, GStreamMapFlags));
+
+		if (Mapped == NullPtr)
+		{
+			OpenGLContext::DeleteBuffers(1, &Resource);
+			Resource = OpenGLContext::GInvalidGLResource;
+
+			return false;
+		}
+
+		return true;
+	}
+
+	void OpenGLStreamBuffer::WaitForFrame(uint32 InFrame)
+	{
+		OpenGLSync& fence = Fences[InFrame];
+
+		if (fence.IsLocked())
+		{
+			JF_PROFILE_SCOPE("OpenGLStreamBuffer::Stall");
+
+			Stalls++;
+
+			fence.WaitForLock();
+		}
+
+		fence.Unlock();
+	}
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include "OpenGLContext.h"
+#include "OpenGLSync.h"
+#include <array>
+
+
+
+namespace J::Graphics
+{
+
+	/**
+	 * Buffer mapped once (persistent and coherent) whose memory is handed out to the CPU for the data written every
+	 * frame (dynamic vertices, per draw constants, ...), without glBufferSubData copies nor implicit synchronization.
+	 *
+	 * The buffer is split in FramesInFlight parts, one written per frame. A fence is put after the commands of each
+	 * frame, and a part is only written again once the GPU passed it: with the GPU that many frames behind, the first
+	 * allocation of the frame waits (counted as a stall).
+	 *
+	 * Works in the thread of the GL context, the buffer is created on first use.
+	 */
+	class OpenGLStreamBuffer
+	{
+	public:
+
+		static constexpr uint32 FramesInFlight = 3;
+
+		static constexpr SIZE_T DefaultFrameSize = 4 * 1024 * 1024;
+
+	public:
+
+		OpenGLStreamBuffer() = default;
+
+		OpenGLStreamBuffer(const OpenGLStreamBuffer&) = delete;
+
+		OpenGLStreamBuffer& operator = (const OpenGLStreamBuffer&) = delete;
+
+		/**
+		 * Memory for size bytes of the current frame, written by the CPU and read by the commands of the frame.
+		 * Null when the frame part is full (or without persistent mapping), the data has to be uploaded otherwise then.
+		 *
+		 * \param InSize		- bytes.
+		 * \param InAlignment	- power of two, see GetUniformAlignment for the uniform blocks.
+		 * \param OutOffset		- offset of the memory in the buffer, for the binds and attribute pointers.
+		 */
+		MemPtr Allocate(SIZE_T InSize, SIZE_T InAlignment, SIZE_T& OutOffset);
+
+		/** Fences the commands of the frame and moves to the next part, once a frame before swapping the buffers. */
+		void EndFrame();
+
+		/** Recreates the buffer with bigger frame parts, between two frames (the memory handed out is lost). */
+		bool Reserve(SIZE_T InFrameSize);
+
+		/** false if the context cannot map buffers persistently (before OpenGL 4.5), everything is a no-op then. */
+		bool IsSupported();
+
+		GLuint GetResource() const { return Resource; }
+
+		SIZE_T GetFrameSize() const { return FrameSize; }
+
+		/** Offset alignment of the uniform block ranges. */
+		SIZE_T GetUniformAlignment() const { return UniformAlignment; }
+
+		/** Bytes handed out in the last frame. */
+		SIZE_T GetLastFrameUsage() const { return LastFrameUsage; }
+
+		/** Frames which waited for the GPU before writing. */
+		uint64 GetStalls() const { return Stalls; }
+
+		/** Allocations refused, their frame part being full. */
+		uint64 GetOverflows() const { return Overflows; }
+
+		/** Unmaps and deletes the buffer, while the context is current. */
+		void Release();
+
+	private:
+
+		bool Create(SIZE_T InFrameSize);
+
+		void WaitForFrame(uint32 InFrame);
+
+		GLuint								Resource			= OpenGLContext::GInvalidGLResource;
+
+		byte*								Mapped				= NullPtr;
+
+		SIZE_T								FrameSize			= DefaultFrameSize;
+
+		SIZE_T								UniformAlignment	= 256;
+
+		// fence after the last commands of each part's frame, unlocked once passed
+		std::array<OpenGLSync, FramesInFlight>	Fences;
+
+		uint32								CurrentFrame		= 0;
+
+		// bytes used in the current part
+		SIZE_T								Head				= 0;
+
+		// the current part may still be read by the GPU until its fence is waited for
+		bool								bFrameReady			= false;
+
+		SIZE_T								LastFrameUsage		= 0;
+
+		uint64								Stalls				= 0;
+
+		uint64								Overflows			= 0;
+
+		enum class ESupport : uint8 { UNKNOWN, SUPPORTED, UNSUPPORTED };
+
+		ESupport							eSupport			= ESupport::UNKNOWN;
+	};
+
+}
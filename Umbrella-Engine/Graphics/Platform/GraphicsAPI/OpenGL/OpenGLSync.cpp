@@ -1,4 +1,5 @@
 #include "OpenGLSync.h"
+#include <utility>
 
 
 
@@ -6,34 +7,123 @@
 namespace J::Graphics
 {
 
-    //void OpenGLSync::Lock()
-    //{
+    // the infinite waits are made of these, glClientWaitSync taking nanoseconds
+    static constexpr Utils::TimeSpan GWaitSlice = Utils::TimeSpan::FromMilliseconds(100);
 
-    //}
 
-    //bool OpenGLSync::Lock(Utils::TimeSpan timeout)
-    //{
+    OpenGLSync::OpenGLSync()
+        : Sync(NullPtr)
+    {
+    }
 
-    //}
+    OpenGLSync::OpenGLSync(const GpuApi::SGpuFenceDesc& desc)
+        : Sync(NullPtr)
+        , DebugName(desc.DebugName)
+    {
+        if (desc.bLocked)
+        {
+            Lock();
+        }
+    }
 
-    //void OpenGLSync::Unlock()
-    //{
-    //}
+    OpenGLSync::~OpenGLSync()
+    {
+        Unlock();
+    }
 
-    //bool OpenGLSync::IsLocked() const
-    //{
-    //    return false;
-    //}
+    OpenGLSync::OpenGLSync(OpenGLSync&& another) NOEXCEPT
+        : Sync(std::exchange(another.Sync, NullPtr))
+        , DebugName(std::move(another.DebugName))
+    {
+    }
 
-    //bool OpenGLSync::WaitForLock()
-    //{
-    //    return false;
-    //}
+    OpenGLSync& OpenGLSync::operator = (OpenGLSync&& another) NOEXCEPT
+    {
+        if (this != &another)
+        {
+            Unlock();
 
-    //bool OpenGLSync::WaitForLock(Utils::TimeSpan timeout)
-    //{
-    //    return false;
-    //}
+            Sync = std::exchange(another.Sync, NullPtr);
+            DebugName = std::move(another.DebugName);
+        }
 
-}
+        return *this;
+    }
+
+    void OpenGLSync::Lock()
+    {
+        Lock(Utils::TimeSpan::Infinite());
+    }
+
+    bool OpenGLSync::Lock(Utils::TimeSpan timeout)
+    {
+        if (!WaitForLock(timeout))
+        {
+            return false;
+        }
+
+        Sync = OpenGLContext::FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        if (Sync && !DebugName.empty())
+        {
+            OpenGLContext::ObjectPtrLabel(Sync, -1, DebugName.c_str());
+        }
+
+        return true;
+    }
+
+    void OpenGLSync::Unlock()
+    {
+        if (Sync)
+        {
+            OpenGLContext::DeleteSync(Sync);
+            Sync = NullPtr;
+        }
+    }
+
+    bool OpenGLSync::IsLocked() const
+    {
+        return Sync && OpenGLContext::ClientWaitSync(Sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED;
+    }
+
+    bool OpenGLSync::WaitForLock()
+    {
+        return WaitForLock(Utils::TimeSpan::Infinite());
+    }
 
+    bool OpenGLSync::WaitForLock(Utils::TimeSpan timeout)
+    {
+        if (!Sync)
+        {
+            return true;
+        }
+
+        GLenum result;
+
+        if (timeout.IsInfinite())
+        {
+            do
+            {
+                result = OpenGLContext::ClientWaitSync(Sync, GL_SYNC_FLUSH_COMMANDS_BIT, GWaitSlice.GetNanoseconds());
+            }
+            while (result == GL_TIMEOUT_EXPIRED);
+        }
+        else
+        {
+            const GLuint64 nanoseconds = timeout > Utils::TimeSpan::Zero() ? static_cast<GLuint64>(timeout.GetNanoseconds()) : 0;
+
+            result = OpenGLContext::ClientWaitSync(Sync, GL_SYNC_FLUSH_COMMANDS_BIT, nanoseconds);
+        }
+
+        if (result == GL_TIMEOUT_EXPIRED)
+        {
+            return false;
+        }
+
+        // passed (or GL_WAIT_FAILED, reported by OpenGLDebug), nothing left to wait for
+        Unlock();
+
+        return true;
+    }
+
+}
@@ -7,27 +7,49 @@
 namespace J::Graphics
 {
 
-	//struct OpenGLSync final : public SGpuFence
-	//{
-	//	GLsync Sync;
-	//	
-	//	OpenGLSync();
-	//	~OpenGLSync();
+	/**
+	 * GPU fence over a GL sync object: locked from the moment it is put in the command stream (Lock) until the GPU
+	 * has executed every command submitted before it.
+	 *
+	 * The waits flush the commands first, a fence never reached by the GPU would never be signaled otherwise.
+	 * Used in the thread of the GL context.
+	 */
+	struct OpenGLSync final : public GpuApi::SGpuFence
+	{
+		GLsync Sync;
 
-	//	// GPU Fence Interface
+		JString DebugName;
 
-	//	void Lock() override;
-	//	bool Lock(Utils::TimeSpan timeout) override;
+		OpenGLSync();
+		explicit OpenGLSync(const GpuApi::SGpuFenceDesc& desc);
+		~OpenGLSync();
 
-	//	void Unlock() override;
-	//	bool IsLocked() const override;
+		OpenGLSync(const OpenGLSync&) = delete;
+		OpenGLSync& operator = (const OpenGLSync&) = delete;
 
-	//	// for the moment, but does no lock
-	//	bool WaitForLock() override;
-	//	bool WaitForLock(Utils::TimeSpan timeout) override;
-	//	
+		OpenGLSync(OpenGLSync&& another) NOEXCEPT;
+		OpenGLSync& operator = (OpenGLSync&& another) NOEXCEPT;
 
-	//};
+		// GPU Fence Interface
 
-}
+		/** Waits for the previous lock to be passed, and fences the commands submitted so far. */
+		void Lock() override;
+
+		/** Lock, false (and nothing fenced) if the previous lock is not passed within timeout. */
+		bool Lock(Utils::TimeSpan timeout) override;
+
+		/** Forgets the fence, without waiting for it. */
+		void Unlock() override;
+
+		/** Whether the GPU has not passed the fence yet, without waiting. */
+		bool IsLocked() const override;
 
+		/** Waits for the GPU to pass the fence, true once it has (or if not locked). */
+		bool WaitForLock() override;
+
+		/** WaitForLock for at most timeout (TimeSpan::Zero() only polls, TimeSpan::Infinite() never times out). */
+		bool WaitForLock(Utils::TimeSpan timeout) override;
+
+	};
+
+}
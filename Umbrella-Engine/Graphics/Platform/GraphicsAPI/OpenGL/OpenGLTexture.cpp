@@ -136,7 +136,7 @@ case ETextureFormat::format_type:\
 
 	void OpenGLTexture::Unbind() const
 	{
-		OpenGLContext::ActiveTexture(TextureType);
+		OpenGLContext::ActiveTexture(GL_TEXTURE0 + Active);
 		OpenGLContext::BindTexture(TextureType, OpenGLContext::GInvalidGLResource);
 	}
 
@@ -165,64 +165,41 @@ case ETextureFormat::format_type:\
 			return false;
 		}
 
-		GLenum pixelType = GL_UNSIGNED_BYTE;
-		GLenum internalType = Map(format);
-		GLenum dataFormat = GL_RGB;
-
-		switch (img->GetChannelsCount())
+		if (!this->Upload(img->RawData(), img->GetWidth(), img->GetHeight(), img->GetChannelsCount(), format))
 		{
-			case 1:
-			{
-				dataFormat = GL_RED;
-				break;
-			}
-
-			case 2:
-			{
-				dataFormat = GL_RG;
-				break;
-			}
-			
-			case 3:
-			{
-				dataFormat = GL_RGB;
-				break;
-			}
-
-			case 4:
-			{
-				dataFormat = GL_RGBA;
-				break;
-			}
-			
-			default:
-			{
-				// #todo LOG it
-				return false;
-			}
-
+			return false;
 		}
-		
-		// opengl context :: ...
-		OpenGLContext::BindTexture(TextureType, Resource);
-		glTexImage2D(TextureType, 0, internalType, img->GetWidth(), img->GetHeight(), 0, dataFormat, pixelType, img->RawData());
-		
+
 		ResourcePath = path;
 
-		SizeInfo.Width = img->GetWidth();
-		SizeInfo.Height = img->GetHeight();
-		SizeInfo.Depth = 0;
-		SizeInfo.ChannelsCount = img->GetChannelsCount();
-		
-		bInitialized = true;
-		bLoaded = true;
+		// absolute, the image loader reads from the disk and not through the mounts
+		const system::FilePath file = std::filesystem::absolute(path);
 
-		this->GenerateMipmapChain();
+		HotReloadHandle = system::HotReload::Get().Register<Image>(
+			Span<const system::FilePath>(&file, 1),
+			[file]() -> Ref<Image>
+			{
+				auto reloaded = ImageLoader::Load(file, true);
+
+				return reloaded && reloaded->IsInitialized() ? Ref<Image>(std::move(reloaded)) : nullptr;
+			},
+			[this, format](Image& reloaded)
+			{
+				this->Upload(reloaded.RawData(), reloaded.GetWidth(), reloaded.GetHeight(), reloaded.GetChannelsCount(), format);
+			});
 
 		return true;
 	}
 
 	bool OpenGLTexture::Load(CMemPtr data, uint32 width, uint32 height, uint32 channels, ETextureFormat format /* = ETextureFormat::AUTO */)
+	{
+		// not from a file anymore
+		HotReloadHandle.Reset();
+
+		return this->Upload(data, width, height, channels, format);
+	}
+
+	bool OpenGLTexture::Upload(CMemPtr data, uint32 width, uint32 height, uint32 channels, ETextureFormat format)
 	{
 		GLenum pixelType = GL_UNSIGNED_BYTE;
 		GLenum internalType = Map(format);
@@ -262,9 +239,11 @@ case ETextureFormat::format_type:\
 
 		}
 
+		JF_GPU_SCOPE("Texture Upload");
+
 		// opengl context :: ...
 		OpenGLContext::BindTexture(TextureType, Resource);
-		glTexImage2D(TextureType, 0, internalType, width, height, 0, dataFormat, pixelType, data);
+		OpenGLContext::TexImage2D(TextureType, 0, internalType, width, height, dataFormat, pixelType, data);
 
 		SizeInfo.Width = width;
 		SizeInfo.Height = height;
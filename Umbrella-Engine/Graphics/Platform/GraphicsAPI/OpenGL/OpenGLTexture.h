@@ -1,6 +1,7 @@
 #pragma once
 #include "../Texture.h"
 #include "../../../../Math/Math.h"
+#include "../../../../Utils/FileSystem/HotReload.h"
 #include "OpenGLContext.h"
 
 
@@ -56,6 +57,9 @@ namespace J::Graphics
 
 		system::FilePath ResourcePath;
 
+		// reloads the texture when ResourcePath changes on disk
+		system::HotReload::Handle HotReloadHandle;
+
 		
 		// OpenGL Specific, get rid of this some day
 
@@ -67,6 +71,8 @@ namespace J::Graphics
 
 		NODISCARD bool AllocateResource();	// GPU API ?
 
+		bool Upload(CMemPtr data, uint32 width, uint32 height, uint32 channels, ETextureFormat format);
+
 	public:
 
 		OpenGLTexture();
@@ -95,6 +101,7 @@ namespace J::Graphics
 		INLINE bool IsValid() const override { return bInitialized; }
 
 
+		/** Reloads the texture when the file changes while hot reload is on (see system::HotReload). */
 		bool Load(const system::FilePath& path, ETextureFormat format = ETextureFormat::AUTO);
 
 		bool Load(CMemPtr data, uint32 width, uint32 height, uint32 channels, ETextureFormat format = ETextureFormat::AUTO);
@@ -68,18 +68,10 @@ namespace J::Graphics
 
 	// Vertex Array
 
-	OpenGLVertexArray::IdType OpenGLVertexArray::CurrentlyBoundVertexArray = OpenGLVertexArray::InvalidVertexArrayId;
-
-
 	void OpenGLVertexArray::Release()
 	{
 		if (this->Resource != OpenGLVertexArray::InvalidVertexArrayId)
 		{
-			if (this->Resource == OpenGLVertexArray::CurrentlyBoundVertexArray)
-			{
-				OpenGLVertexArray::CurrentlyBoundVertexArray = InvalidVertexArrayId;
-			}
-
 			OpenGLContext::DeleteVertexArrays(1, &this->Resource);
 		}
 
@@ -129,13 +121,11 @@ namespace J::Graphics
 	void OpenGLVertexArray::Bind() const
 	{
 		OpenGLContext::BindVertexArray(this->Resource);
-		OpenGLVertexArray::CurrentlyBoundVertexArray = this->Resource;
 	}
 
 	void OpenGLVertexArray::Unbind() const
 	{
 		OpenGLContext::BindVertexArray(OpenGLVertexArray::InvalidVertexArrayId);
-		OpenGLVertexArray::CurrentlyBoundVertexArray = OpenGLVertexArray::InvalidVertexArrayId;
 	}
 
 
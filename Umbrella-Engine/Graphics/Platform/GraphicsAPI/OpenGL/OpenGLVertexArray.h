@@ -68,7 +68,7 @@ namespace J::Graphics
 		void Unbind() const;
 
 		IdType GetHandle() const { return Resource; }
-		IdType GetCurrentlyBoundedVertexArray() const { return CurrentlyBoundVertexArray; }
+		IdType GetCurrentlyBoundedVertexArray() const { return OpenGLStateCache::GetVertexArray(); }
 		IdType GetNextAttributeIndex() const { return AttributeIndex; }
 
 		//const std::vector<Ref<OpenGLVertexBuffer>>& GetVertexBuffers() const NOEXCEPT { return VertexBuffers; }
@@ -98,8 +98,6 @@ namespace J::Graphics
 		IdType Resource;
 		uint32 AttributeIndex;
 
-		static IdType CurrentlyBoundVertexArray;
-
 		/*
 		* possibly implement buffer -> List<Layout> layouts mapping
 		*/
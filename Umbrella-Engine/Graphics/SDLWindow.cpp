@@ -269,6 +269,8 @@ namespace J::Graphics
 		//glDrawArrays(GL_POINTS, 0, 3);
 		GraphicsContext::DrawElements(EGLPrimitiveType::TRIANGLES, *RECT_IBO);	// instead of graphics context here will be used renderer
 
+		GpuApi::EndGpuFrame();
+
 		GraphicsContext::SwapBuffers(window.get());
 	}
 
@@ -13,12 +13,12 @@ namespace J::Utils
 		case ERawImageFormat::L8:
 		case ERawImageFormat::LA8:
 		case ERawImageFormat::R8:
+		case ERawImageFormat::RG8:
 		case ERawImageFormat::RGB8:
 		case ERawImageFormat::RGBA8:
 			return 1;
 
 		case ERawImageFormat::RH:
-		case ERawImageFormat::RG8:
 		case ERawImageFormat::RGBH:
 		case ERawImageFormat::RGBAH:
 			return 2;
@@ -114,7 +114,7 @@ namespace J::Utils
 		, Format(InImageFormat)
 		, bInitialized(false)
 	{
-		Source.assign((SIZE_T)SizeX * SizeY * ChannelsCount * GetBytesPerPixel(), byte(0x00));
+		Source.assign(GetPixelsCount() * GetBytesPerPixel(), byte(0x00));
 	}
 
 	Image::Image(VectorUInt2 InSize, ERawImageFormat InImageFormat)
@@ -273,6 +273,8 @@ namespace J::Utils
 
 	VectorUInt2		Image::GetSize() const { return { SizeX, SizeY }; }
 
+	SIZE_T			Image::GetPixelsCount() const { return (SIZE_T)SizeX * SizeY; }
+
 	uint32			Image::GetWidth() const { return SizeX; }
 
 	uint32			Image::GetHeight() const { return SizeY; }
@@ -154,6 +154,8 @@ namespace J::Utils
 
 		VectorUInt2		GetSize() const;
 
+		SIZE_T			GetPixelsCount() const;
+
 		uint32			GetWidth() const;
 
 		uint32			GetHeight() const;
@@ -0,0 +1,258 @@
+#include "ImageUtils.h"
+#include "PixelConversion.h"
+#include "../Utils/Threading/ThreadPool.h"
+#include "../Utils/Profiling/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+
+namespace J::Utils
+{
+	using Details::EChannelDataType;
+	using Details::GPixelChunkSize;
+
+	static constexpr float GLuminanceWeights[3] = { 0.2126f, 0.7152f, 0.0722f };
+
+	// SSIM constants for a dynamic range of 1: (0.01 * L)^2 and (0.03 * L)^2
+	static constexpr float GSSIMC1 = 0.0001f;
+	static constexpr float GSSIMC2 = 0.0009f;
+	static constexpr float GSSIMSigma = 1.5f;
+
+
+	/** Abs differences of Count values, returns the sum of their squares. */
+	static double AbsDifference(const float* A, const float* B, float* Dest, SIZE_T Count)
+	{
+		SIZE_T i = 0;
+		float sum = 0.0f;
+
+#if ENGINE_SIMD_SSE2
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		__m128 acc = _mm_setzero_ps();
+
+		for (; i + 4 <= Count; i += 4)
+		{
+			const __m128 delta = _mm_sub_ps(_mm_loadu_ps(A + i), _mm_loadu_ps(B + i));
+
+			acc = _mm_add_ps(acc, _mm_mul_ps(delta, delta));
+			_mm_storeu_ps(Dest + i, _mm_and_ps(delta, signMask));
+		}
+
+		float lanes[4];
+		_mm_storeu_ps(lanes, acc);
+		sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+		for (; i < Count; ++i)
+		{
+			const float delta = A[i] - B[i];
+
+			sum += delta * delta;
+			Dest[i] = std::abs(delta);
+		}
+
+		return sum;
+	}
+
+	/** Writes the luminance of every pixel into Dest[pixel * InStride + InOffset]. */
+	static void LoadLuminance(const Image& InImage, uint32 InLumaChannels, float* Dest, SIZE_T InStride, SIZE_T InOffset)
+	{
+		const uint32 channels = InImage.GetChannelsCount();
+		const EChannelDataType type = Details::GetChannelDataType(InImage.GetFormat());
+		const SIZE_T rowLength = static_cast<SIZE_T>(InImage.GetWidth()) * channels;
+		const SIZE_T pitch = static_cast<SIZE_T>(InImage.GetWidth()) * InImage.GetBytesPerPixel();
+
+		ParallelFor(InImage.GetHeight(), Details::GetRowsGrain(rowLength), [&](SIZE_T Begin, SIZE_T End)
+		{
+			float values[GPixelChunkSize];
+
+			for (SIZE_T y = Begin; y < End; ++y)
+			{
+				const byte* row = InImage.RawData() + y * pitch;
+				float* dest = Dest + y * InImage.GetWidth() * InStride + InOffset;
+
+				for (SIZE_T offset = 0; offset < rowLength; offset += GPixelChunkSize)
+				{
+					const SIZE_T count = std::min(GPixelChunkSize, rowLength - offset);
+					Details::LoadChannels(row + offset * InImage.GetBytesPerChannel(), type, values, count);
+
+					for (SIZE_T i = 0, x = offset / channels; i < count; i += channels, ++x)
+					{
+						dest[x * InStride] = (InLumaChannels >= 3)
+							? values[i] * GLuminanceWeights[0] + values[i + 1] * GLuminanceWeights[1] + values[i + 2] * GLuminanceWeights[2]
+							: values[i];
+					}
+				}
+			}
+		});
+	}
+
+	static double ComputeSSIM(const Image& InA, const Image& InB)
+	{
+		const uint32 width = InA.GetWidth();
+		const uint32 height = InA.GetHeight();
+		const SIZE_T pixelsCount = InA.GetPixelsCount();
+
+		const uint32 lumaChannels = Details::HasAlphaChannel(InA.GetFormat()) ? InA.GetChannelsCount() - 1 : InA.GetChannelsCount();
+
+		// (a, b, a^2 + b^2, a * b) of the luminances: blurring them gives every local mean
+		// and (co)variance SSIM needs in a single filter pass
+		Image moments(width, height, ERawImageFormat::RGBAF);
+		float* values = reinterpret_cast<float*>(moments.RawData());
+
+		LoadLuminance(InA, lumaChannels, values, 4, 0);
+		LoadLuminance(InB, lumaChannels, values, 4, 1);
+
+		for (SIZE_T i = 0; i < pixelsCount; ++i)
+		{
+			float* pixel = values + i * 4;
+
+			pixel[2] = pixel[0] * pixel[0] + pixel[1] * pixel[1];
+			pixel[3] = pixel[0] * pixel[1];
+		}
+
+		moments.MarkInitialized();
+		ImageUtils::GaussianBlur(moments, GSSIMSigma, moments);
+
+		values = reinterpret_cast<float*>(moments.RawData());
+
+		double sum = 0.0;
+		TMutex mergeMutex;
+
+		ParallelFor(pixelsCount, 64 * 1024, [&](SIZE_T Begin, SIZE_T End)
+		{
+			double partial = 0.0;
+
+			for (SIZE_T i = Begin; i < End; ++i)
+			{
+				const float* pixel = values + i * 4;
+
+				const float meanA = pixel[0];
+				const float meanB = pixel[1];
+				const float meansProduct = meanA * meanB;
+				const float meansSquares = meanA * meanA + meanB * meanB;
+
+				const float variances = pixel[2] - meansSquares;
+				const float covariance = pixel[3] - meansProduct;
+
+				partial += ((2.0f * meansProduct + GSSIMC1) * (2.0f * covariance + GSSIMC2))
+						 / ((meansSquares + GSSIMC1) * (variances + GSSIMC2));
+			}
+
+			JF_SCOPED_LOCK(mergeMutex);
+			sum += partial;
+		});
+
+		return sum / pixelsCount;
+	}
+
+
+	SImageCompareResult ImageUtils::Compare(const Image& InA, const Image& InB, float InTolerance)
+	{
+		JF_PROFILE_SCOPE("ImageUtils::Compare");
+
+		SImageCompareResult result;
+
+		if (!InA.IsInitialized() || !InB.IsInitialized()
+			|| InA.GetSize() != InB.GetSize()
+			|| InA.GetChannelsCount() != InB.GetChannelsCount()
+			|| InA.GetPixelsCount() == 0)
+		{
+			return result;
+		}
+
+		const uint32 width = InA.GetWidth();
+		const uint32 height = InA.GetHeight();
+		const uint32 channels = InA.GetChannelsCount();
+		const SIZE_T rowLength = static_cast<SIZE_T>(width) * channels;
+
+		const EChannelDataType typeA = Details::GetChannelDataType(InA.GetFormat());
+		const EChannelDataType typeB = Details::GetChannelDataType(InB.GetFormat());
+		const SIZE_T pitchA = static_cast<SIZE_T>(width) * InA.GetBytesPerPixel();
+		const SIZE_T pitchB = static_cast<SIZE_T>(width) * InB.GetBytesPerPixel();
+
+		result.bComparable = true;
+		result.ErrorMap = Image(width, height, ERawImageFormat::RF);
+
+		float* errorMap = reinterpret_cast<float*>(result.ErrorMap.RawData());
+		double squaresSum = 0.0;
+		TMutex mergeMutex;
+
+		ParallelFor(height, Details::GetRowsGrain(rowLength), [&](SIZE_T Begin, SIZE_T End)
+		{
+			float valuesA[GPixelChunkSize];
+			float valuesB[GPixelChunkSize];
+			float deltas[GPixelChunkSize];
+
+			double partialSquares = 0.0;
+			float partialMax = -1.0f;
+			VectorUInt2 partialPosition = { 0, 0 };
+			SIZE_T partialOver = 0;
+
+			for (SIZE_T y = Begin; y < End; ++y)
+			{
+				const byte* rowA = InA.RawData() + y * pitchA;
+				const byte* rowB = InB.RawData() + y * pitchB;
+				float* errorRow = errorMap + y * width;
+
+				for (SIZE_T offset = 0; offset < rowLength; offset += GPixelChunkSize)
+				{
+					const SIZE_T count = std::min(GPixelChunkSize, rowLength - offset);
+
+					Details::LoadChannels(rowA + offset * InA.GetBytesPerChannel(), typeA, valuesA, count);
+					Details::LoadChannels(rowB + offset * InB.GetBytesPerChannel(), typeB, valuesB, count);
+
+					partialSquares += AbsDifference(valuesA, valuesB, deltas, count);
+
+					for (SIZE_T i = 0, x = offset / channels; i < count; i += channels, ++x)
+					{
+						float delta = deltas[i];
+
+						for (uint32 c = 1; c < channels; ++c)
+						{
+							delta = std::max(delta, deltas[i + c]);
+						}
+
+						errorRow[x] = delta;
+						partialOver += (delta > InTolerance) ? 1 : 0;
+
+						if (delta > partialMax)
+						{
+							partialMax = delta;
+							partialPosition = { static_cast<uint32>(x), static_cast<uint32>(y) };
+						}
+					}
+				}
+			}
+
+			JF_SCOPED_LOCK(mergeMutex);
+
+			squaresSum += partialSquares;
+			result.PixelsOverTolerance += partialOver;
+
+			// ties go to the first pixel in scan order, whatever the job order
+			const bool bEarlier = partialPosition.y < result.MaxDeltaPosition.y
+				|| (partialPosition.y == result.MaxDeltaPosition.y && partialPosition.x < result.MaxDeltaPosition.x);
+
+			if (partialMax > result.MaxDelta || (partialMax == result.MaxDelta && bEarlier))
+			{
+				result.MaxDelta = partialMax;
+				result.MaxDeltaPosition = partialPosition;
+			}
+		});
+
+		result.ErrorMap.MarkInitialized();
+
+		result.MeanSquaredError = squaresSum / (static_cast<double>(InA.GetPixelsCount()) * channels);
+		result.PSNR = (result.MeanSquaredError > 0.0)
+			? 10.0 * std::log10(1.0 / result.MeanSquaredError)
+			: std::numeric_limits<double>::infinity();
+
+		result.SSIM = (result.MaxDelta > 0.0f) ? ComputeSSIM(InA, InB) : 1.0;
+		result.bPassed = (result.MaxDelta <= InTolerance);
+
+		return result;
+	}
+
+}
@@ -0,0 +1,653 @@
+#include "ImageUtils.h"
+#include "PixelConversion.h"
+#include "../Utils/Threading/ThreadPool.h"
+#include "../Utils/Profiling/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+
+
+namespace J::Utils
+{
+	using Details::SFloatImage;
+
+	// Vertical passes walk the image in column strips of this many floats (1KB per row), so the
+	// rows of a tap window stay in cache instead of striding through the whole image for each pixel.
+	static constexpr SIZE_T GColumnStripSize = 256;
+
+	// Rows per tile of the vertical passes.
+	static constexpr uint32 GTileRows = 64;
+
+	// Gaussian kernels wider than this are replaced with three box passes.
+	static constexpr uint32 GMaxGaussianRadius = 24;
+
+
+	static INLINE uint32 ClampRow(int64 Y, uint32 Height)
+	{
+		return static_cast<uint32>(std::clamp<int64>(Y, 0, static_cast<int64>(Height) - 1));
+	}
+
+	/**
+	 * Runs InTask over tiles of GColumnStripSize floats by GTileRows rows.
+	 * InTask gets (StripBegin, StripEnd, RowBegin, RowEnd).
+	 */
+	template<typename TaskType>
+	static void ForEachTile(const SFloatImage& InImage, const TaskType& InTask)
+	{
+		const SIZE_T rowLength = InImage.GetRowLength();
+		const SIZE_T stripsCount = (rowLength + GColumnStripSize - 1) / GColumnStripSize;
+		const SIZE_T bandsCount = (InImage.Height + GTileRows - 1) / GTileRows;
+
+		ParallelFor(stripsCount * bandsCount, 1, [&](SIZE_T Begin, SIZE_T End)
+		{
+			for (SIZE_T tile = Begin; tile < End; ++tile)
+			{
+				const SIZE_T strip = tile % stripsCount;
+				const SIZE_T band = tile / stripsCount;
+
+				InTask(strip * GColumnStripSize, std::min((strip + 1) * GColumnStripSize, rowLength),
+					   static_cast<uint32>(band * GTileRows), static_cast<uint32>(std::min<SIZE_T>((band + 1) * GTileRows, InImage.Height)));
+			}
+		});
+	}
+
+	/** Copies a row with its edge pixels replicated InLeft times on the left and InRight times on the right. */
+	static void PadRow(const float* Row, uint32 Width, uint32 Channels, uint32 InLeft, uint32 InRight, float* Padded)
+	{
+		for (uint32 i = 0; i < InLeft; ++i)
+		{
+			Memory::Memcpy(Row, Padded + i * Channels, Channels * sizeof(float));
+		}
+
+		Memory::Memcpy(Row, Padded + InLeft * Channels, static_cast<SIZE_T>(Width) * Channels * sizeof(float));
+
+		const float* last = Row + (Width - 1) * Channels;
+		float* right = Padded + static_cast<SIZE_T>(InLeft + Width) * Channels;
+
+		for (uint32 i = 0; i < InRight; ++i)
+		{
+			Memory::Memcpy(last, right + i * Channels, Channels * sizeof(float));
+		}
+	}
+
+
+	/************************************************************************/
+	/*							CONVOLUTION KERNELS                         */
+	/************************************************************************/
+
+	/** Dest[j] += sum(Kernel[i] * Source[j + i * Stride]) for j in [0, Count). */
+	static void AccumulateRow(const float* Source, const float* Kernel, SIZE_T Taps, SIZE_T Stride, float* Dest, SIZE_T Count)
+	{
+		SIZE_T j = 0;
+
+#if ENGINE_SIMD_AVX
+		for (; j + 16 <= Count; j += 16)
+		{
+			__m256 acc0 = _mm256_loadu_ps(Dest + j);
+			__m256 acc1 = _mm256_loadu_ps(Dest + j + 8);
+
+			for (SIZE_T i = 0; i < Taps; ++i)
+			{
+				const __m256 k = _mm256_set1_ps(Kernel[i]);
+				const float* source = Source + j + i * Stride;
+
+				acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(k, _mm256_loadu_ps(source)));
+				acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(k, _mm256_loadu_ps(source + 8)));
+			}
+
+			_mm256_storeu_ps(Dest + j, acc0);
+			_mm256_storeu_ps(Dest + j + 8, acc1);
+		}
+#endif
+
+#if ENGINE_SIMD_SSE2
+		for (; j + 8 <= Count; j += 8)
+		{
+			__m128 acc0 = _mm_loadu_ps(Dest + j);
+			__m128 acc1 = _mm_loadu_ps(Dest + j + 4);
+
+			for (SIZE_T i = 0; i < Taps; ++i)
+			{
+				const __m128 k = _mm_set1_ps(Kernel[i]);
+				const float* source = Source + j + i * Stride;
+
+				acc0 = _mm_add_ps(acc0, _mm_mul_ps(k, _mm_loadu_ps(source)));
+				acc1 = _mm_add_ps(acc1, _mm_mul_ps(k, _mm_loadu_ps(source + 4)));
+			}
+
+			_mm_storeu_ps(Dest + j, acc0);
+			_mm_storeu_ps(Dest + j + 4, acc1);
+		}
+#endif
+
+		for (; j < Count; ++j)
+		{
+			float acc = Dest[j];
+
+			for (SIZE_T i = 0; i < Taps; ++i)
+			{
+				acc += Kernel[i] * Source[j + i * Stride];
+			}
+
+			Dest[j] = acc;
+		}
+	}
+
+	/** Dest[j] = sum(Kernel[i] * Rows[i][j]) for j in [0, Count). */
+	static void ConvolveColumns(const float* const* Rows, const float* Kernel, SIZE_T Taps, float* Dest, SIZE_T Count)
+	{
+		SIZE_T j = 0;
+
+#if ENGINE_SIMD_AVX
+		for (; j + 16 <= Count; j += 16)
+		{
+			__m256 acc0 = _mm256_setzero_ps();
+			__m256 acc1 = _mm256_setzero_ps();
+
+			for (SIZE_T i = 0; i < Taps; ++i)
+			{
+				const __m256 k = _mm256_set1_ps(Kernel[i]);
+
+				acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(k, _mm256_loadu_ps(Rows[i] + j)));
+				acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(k, _mm256_loadu_ps(Rows[i] + j + 8)));
+			}
+
+			_mm256_storeu_ps(Dest + j, acc0);
+			_mm256_storeu_ps(Dest + j + 8, acc1);
+		}
+#endif
+
+#if ENGINE_SIMD_SSE2
+		for (; j + 8 <= Count; j += 8)
+		{
+			__m128 acc0 = _mm_setzero_ps();
+			__m128 acc1 = _mm_setzero_ps();
+
+			for (SIZE_T i = 0; i < Taps; ++i)
+			{
+				const __m128 k = _mm_set1_ps(Kernel[i]);
+
+				acc0 = _mm_add_ps(acc0, _mm_mul_ps(k, _mm_loadu_ps(Rows[i] + j)));
+				acc1 = _mm_add_ps(acc1, _mm_mul_ps(k, _mm_loadu_ps(Rows[i] + j + 4)));
+			}
+
+			_mm_storeu_ps(Dest + j, acc0);
+			_mm_storeu_ps(Dest + j + 4, acc1);
+		}
+#endif
+
+		for (; j < Count; ++j)
+		{
+			float acc = 0.0f;
+
+			for (SIZE_T i = 0; i < Taps; ++i)
+			{
+				acc += Kernel[i] * Rows[i][j];
+			}
+
+			Dest[j] = acc;
+		}
+	}
+
+	static void ConvolveHorizontal(const SFloatImage& InImage, Span<const float> InKernel, SFloatImage& OutImage)
+	{
+		OutImage.Allocate(InImage.Width, InImage.Height, InImage.Channels);
+
+		const uint32 radius = static_cast<uint32>(InKernel.size() / 2);
+		const SIZE_T rowLength = InImage.GetRowLength();
+
+		ParallelFor(InImage.Height, Details::GetRowsGrain(rowLength), [&](SIZE_T Begin, SIZE_T End)
+		{
+			JVector<float> padded((InImage.Width + 2 * radius) * static_cast<SIZE_T>(InImage.Channels));
+
+			for (SIZE_T y = Begin; y < End; ++y)
+			{
+				float* dest = OutImage.Row(static_cast<uint32>(y));
+
+				PadRow(InImage.Row(static_cast<uint32>(y)), InImage.Width, InImage.Channels, radius, radius, padded.data());
+				std::fill_n(dest, rowLength, 0.0f);
+				AccumulateRow(padded.data(), InKernel.data(), InKernel.size(), InImage.Channels, dest, rowLength);
+			}
+		});
+	}
+
+	static void ConvolveVertical(const SFloatImage& InImage, Span<const float> InKernel, SFloatImage& OutImage)
+	{
+		OutImage.Allocate(InImage.Width, InImage.Height, InImage.Channels);
+
+		const int64 radius = static_cast<int64>(InKernel.size() / 2);
+
+		ForEachTile(InImage, [&](SIZE_T StripBegin, SIZE_T StripEnd, uint32 RowBegin, uint32 RowEnd)
+		{
+			JVector<const float*> rows(InKernel.size());
+
+			for (uint32 y = RowBegin; y < RowEnd; ++y)
+			{
+				for (SIZE_T i = 0; i < InKernel.size(); ++i)
+				{
+					rows[i] = InImage.Row(ClampRow(y + static_cast<int64>(i) - radius, InImage.Height)) + StripBegin;
+				}
+
+				ConvolveColumns(rows.data(), InKernel.data(), InKernel.size(), OutImage.Row(y) + StripBegin, StripEnd - StripBegin);
+			}
+		});
+	}
+
+	static void Convolve2D(const SFloatImage& InImage, Span<const float> InKernel, uint32 InKernelWidth, uint32 InKernelHeight, SFloatImage& OutImage)
+	{
+		const uint32 radiusX = InKernelWidth / 2;
+		const int64 radiusY = InKernelHeight / 2;
+		const uint32 channels = InImage.Channels;
+
+		// pad every row once, so the tiles below read contiguous memory only
+		SFloatImage padded;
+		padded.Allocate(InImage.Width + 2 * radiusX, InImage.Height, channels);
+
+		ParallelFor(InImage.Height, Details::GetRowsGrain(padded.GetRowLength()), [&](SIZE_T Begin, SIZE_T End)
+		{
+			for (SIZE_T y = Begin; y < End; ++y)
+			{
+				PadRow(InImage.Row(static_cast<uint32>(y)), InImage.Width, channels, radiusX, radiusX, padded.Row(static_cast<uint32>(y)));
+			}
+		});
+
+		OutImage.Allocate(InImage.Width, InImage.Height, channels);
+
+		ForEachTile(OutImage, [&](SIZE_T StripBegin, SIZE_T StripEnd, uint32 RowBegin, uint32 RowEnd)
+		{
+			for (uint32 y = RowBegin; y < RowEnd; ++y)
+			{
+				float* dest = OutImage.Row(y) + StripBegin;
+				std::fill_n(dest, StripEnd - StripBegin, 0.0f);
+
+				for (uint32 ky = 0; ky < InKernelHeight; ++ky)
+				{
+					const float* source = padded.Row(ClampRow(y + static_cast<int64>(ky) - radiusY, InImage.Height)) + StripBegin;
+
+					AccumulateRow(source, InKernel.data() + ky * InKernelWidth, InKernelWidth, channels, dest, StripEnd - StripBegin);
+				}
+			}
+		});
+	}
+
+
+	/************************************************************************/
+	/*								BOX BLUR                                */
+	/************************************************************************/
+
+	/** Sliding window along a padded row: one add and one subtract per value whatever the radius. */
+	static void BoxRow(const float* Padded, uint32 Width, uint32 Channels, uint32 Radius, float* Dest)
+	{
+		const uint32 window = 2 * Radius + 1;
+		const float scale = 1.0f / window;
+
+#if ENGINE_SIMD_SSE2
+		if (Channels == 4)
+		{
+			const __m128 scale4 = _mm_set1_ps(scale);
+			__m128 sum = _mm_setzero_ps();
+
+			for (uint32 i = 0; i < window; ++i)
+			{
+				sum = _mm_add_ps(sum, _mm_loadu_ps(Padded + i * 4));
+			}
+
+			for (uint32 x = 0; x < Width; ++x)
+			{
+				_mm_storeu_ps(Dest + x * 4, _mm_mul_ps(sum, scale4));
+				sum = _mm_add_ps(sum, _mm_sub_ps(_mm_loadu_ps(Padded + (x + window) * 4), _mm_loadu_ps(Padded + x * 4)));
+			}
+
+			return;
+		}
+#endif
+
+		for (uint32 c = 0; c < Channels; ++c)
+		{
+			float sum = 0.0f;
+
+			for (uint32 i = 0; i < window; ++i)
+			{
+				sum += Padded[i * Channels + c];
+			}
+
+			for (uint32 x = 0; x < Width; ++x)
+			{
+				Dest[x * Channels + c] = sum * scale;
+				sum += Padded[(x + window) * Channels + c] - Padded[x * Channels + c];
+			}
+		}
+	}
+
+	static void BoxHorizontal(const SFloatImage& InImage, uint32 InRadius, SFloatImage& OutImage)
+	{
+		OutImage.Allocate(InImage.Width, InImage.Height, InImage.Channels);
+
+		ParallelFor(InImage.Height, Details::GetRowsGrain(InImage.GetRowLength()), [&](SIZE_T Begin, SIZE_T End)
+		{
+			// one extra pixel on the right, read by the last window update
+			JVector<float> padded((InImage.Width + 2 * InRadius + 1) * static_cast<SIZE_T>(InImage.Channels));
+
+			for (SIZE_T y = Begin; y < End; ++y)
+			{
+				PadRow(InImage.Row(static_cast<uint32>(y)), InImage.Width, InImage.Channels, InRadius, InRadius + 1, padded.data());
+				BoxRow(padded.data(), InImage.Width, InImage.Channels, InRadius, OutImage.Row(static_cast<uint32>(y)));
+			}
+		});
+	}
+
+	static void BoxVertical(const SFloatImage& InImage, uint32 InRadius, SFloatImage& OutImage)
+	{
+		OutImage.Allocate(InImage.Width, InImage.Height, InImage.Channels);
+
+		const int64 radius = InRadius;
+		const float scale = 1.0f / (2 * InRadius + 1);
+
+		ForEachTile(InImage, [&](SIZE_T StripBegin, SIZE_T StripEnd, uint32 RowBegin, uint32 RowEnd)
+		{
+			const SIZE_T count = StripEnd - StripBegin;
+			float sum[GColumnStripSize] = { };
+
+			for (int64 y = RowBegin - radius; y <= RowBegin + radius; ++y)
+			{
+				const float* row = InImage.Row(ClampRow(y, InImage.Height)) + StripBegin;
+
+				for (SIZE_T j = 0; j < count; ++j)
+				{
+					sum[j] += row[j];
+				}
+			}
+
+			for (uint32 y = RowBegin; y < RowEnd; ++y)
+			{
+				const float* added = InImage.Row(ClampRow(y + radius + 1, InImage.Height)) + StripBegin;
+				const float* removed = InImage.Row(ClampRow(y - radius, InImage.Height)) + StripBegin;
+				float* dest = OutImage.Row(y) + StripBegin;
+
+				SIZE_T j = 0;
+
+#if ENGINE_SIMD_SSE2
+				const __m128 scale4 = _mm_set1_ps(scale);
+
+				for (; j + 4 <= count; j += 4)
+				{
+					const __m128 value = _mm_loadu_ps(sum + j);
+
+					_mm_storeu_ps(dest + j, _mm_mul_ps(value, scale4));
+					_mm_storeu_ps(sum + j, _mm_add_ps(value, _mm_sub_ps(_mm_loadu_ps(added + j), _mm_loadu_ps(removed + j))));
+				}
+#endif
+
+				for (; j < count; ++j)
+				{
+					dest[j] = sum[j] * scale;
+					sum[j] += added[j] - removed[j];
+				}
+			}
+		});
+	}
+
+	/** Box blur in place, InTemp is scratch storage. */
+	static void BoxBlurInPlace(SFloatImage& InOutImage, uint32 InRadius, SFloatImage& InTemp)
+	{
+		BoxHorizontal(InOutImage, InRadius, InTemp);
+		BoxVertical(InTemp, InRadius, InOutImage);
+	}
+
+
+	/************************************************************************/
+	/*								GAUSSIAN                                */
+	/************************************************************************/
+
+	static JVector<float> MakeGaussianKernel(float InSigma, uint32 InRadius)
+	{
+		JVector<float> kernel(2 * InRadius + 1);
+		const float denominator = 2.0f * InSigma * InSigma;
+		float sum = 0.0f;
+
+		for (uint32 i = 0; i < kernel.size(); ++i)
+		{
+			const float x = static_cast<float>(i) - static_cast<float>(InRadius);
+			kernel[i] = std::exp(-x * x / denominator);
+			sum += kernel[i];
+		}
+
+		for (float& weight : kernel)
+		{
+			weight /= sum;
+		}
+
+		return kernel;
+	}
+
+	/** Radii of the three box passes that match a gaussian with the given sigma (W. Wells, 1986). */
+	static void GetGaussianBoxRadii(float InSigma, uint32 (&OutRadii)[3])
+	{
+		constexpr float passes = 3.0f;
+
+		const float idealWidth = std::sqrt(12.0f * InSigma * InSigma / passes + 1.0f);
+
+		int32 lower = static_cast<int32>(std::floor(idealWidth));
+		lower -= (lower % 2 == 0) ? 1 : 0;
+
+		const int32 upper = lower + 2;
+		const float idealLowerCount = (12.0f * InSigma * InSigma - passes * lower * lower - 4.0f * passes * lower - 3.0f * passes) / (-4.0f * lower - 4.0f);
+		const int32 lowerCount = static_cast<int32>(std::lround(idealLowerCount));
+
+		for (int32 i = 0; i < 3; ++i)
+		{
+			OutRadii[i] = static_cast<uint32>(((i < lowerCount) ? lower : upper) - 1) / 2;
+		}
+	}
+
+
+	/************************************************************************/
+	/*								KAWASE                                  */
+	/************************************************************************/
+
+	/**
+	 * One Kawase pass: average of four bilinear taps at (+-(Offset + 0.5), +-(Offset + 0.5)).
+	 * Each tap at a half pixel offset is the average of a 2x2 block, so the pass sums 16 pixels:
+	 * pairs of rows first, then pairs of columns on a padded row.
+	 */
+	static void KawasePass(const SFloatImage& InImage, uint32 InOffset, SFloatImage& OutImage)
+	{
+		OutImage.Allocate(InImage.Width, InImage.Height, InImage.Channels);
+
+		const int64 offset = InOffset;
+		const uint32 channels = InImage.Channels;
+		const uint32 padding = InOffset + 1;
+		const SIZE_T rowLength = InImage.GetRowLength();
+
+		ParallelFor(InImage.Height, Details::GetRowsGrain(rowLength), [&](SIZE_T Begin, SIZE_T End)
+		{
+			JVector<float> rowSum(rowLength);
+			JVector<float> padded((InImage.Width + 2 * padding) * static_cast<SIZE_T>(channels));
+
+			for (SIZE_T y = Begin; y < End; ++y)
+			{
+				const float* r0 = InImage.Row(ClampRow(static_cast<int64>(y) - offset - 1, InImage.Height));
+				const float* r1 = InImage.Row(ClampRow(static_cast<int64>(y) - offset, InImage.Height));
+				const float* r2 = InImage.Row(ClampRow(static_cast<int64>(y) + offset, InImage.Height));
+				const float* r3 = InImage.Row(ClampRow(static_cast<int64>(y) + offset + 1, InImage.Height));
+
+				SIZE_T j = 0;
+
+#if ENGINE_SIMD_SSE2
+				for (; j + 4 <= rowLength; j += 4)
+				{
+					const __m128 top = _mm_add_ps(_mm_loadu_ps(r0 + j), _mm_loadu_ps(r1 + j));
+					const __m128 bottom = _mm_add_ps(_mm_loadu_ps(r2 + j), _mm_loadu_ps(r3 + j));
+
+					_mm_storeu_ps(rowSum.data() + j, _mm_add_ps(top, bottom));
+				}
+#endif
+
+				for (; j < rowLength; ++j)
+				{
+					rowSum[j] = r0[j] + r1[j] + r2[j] + r3[j];
+				}
+
+				PadRow(rowSum.data(), InImage.Width, channels, padding, padding, padded.data());
+
+				// padded pixel p is x + padding, so the taps x - offset - 1, x - offset, x + offset, x + offset + 1
+				// become p = x, x + 1, x + 2 * offset + 1, x + 2 * offset + 2
+				const float* s0 = padded.data();
+				const float* s1 = s0 + channels;
+				const float* s2 = s0 + (2 * InOffset + 1) * channels;
+				const float* s3 = s0 + (2 * InOffset + 2) * channels;
+				float* dest = OutImage.Row(static_cast<uint32>(y));
+
+				j = 0;
+
+#if ENGINE_SIMD_SSE2
+				const __m128 scale = _mm_set1_ps(1.0f / 16.0f);
+
+				for (; j + 4 <= rowLength; j += 4)
+				{
+					const __m128 left = _mm_add_ps(_mm_loadu_ps(s0 + j), _mm_loadu_ps(s1 + j));
+					const __m128 right = _mm_add_ps(_mm_loadu_ps(s2 + j), _mm_loadu_ps(s3 + j));
+
+					_mm_storeu_ps(dest + j, _mm_mul_ps(_mm_add_ps(left, right), scale));
+				}
+#endif
+
+				for (; j < rowLength; ++j)
+				{
+					dest[j] = (s0[j] + s1[j] + s2[j] + s3[j]) * (1.0f / 16.0f);
+				}
+			}
+		});
+	}
+
+
+	/************************************************************************/
+	/*								IMAGE UTILS                             */
+	/************************************************************************/
+
+	void ImageUtils::Convolve(const Image& InFrom, Span<const float> InKernelX, Span<const float> InKernelY, Image& InDest)
+	{
+		JF_PROFILE_SCOPE("ImageUtils::Convolve");
+
+		JF_ASSERT((InKernelX.size() % 2) == 1 && (InKernelY.size() % 2) == 1, "Convolution kernels must have odd sizes.");
+
+		if (!InFrom.IsInitialized())
+		{
+			// #TODO HALT
+			return;
+		}
+
+		SFloatImage source, temp;
+		Details::LoadFloatImage(InFrom, source);
+
+		ConvolveHorizontal(source, InKernelX, temp);
+		ConvolveVertical(temp, InKernelY, source);
+
+		Details::StoreFloatImage(source, InDest, InFrom.GetFormat());
+	}
+
+	void ImageUtils::Convolve(const Image& InFrom, Span<const float> InKernel, VectorUInt2 InKernelSize, Image& InDest)
+	{
+		JF_PROFILE_SCOPE("ImageUtils::Convolve");
+
+		JF_ASSERT((InKernelSize.x % 2) == 1 && (InKernelSize.y % 2) == 1, "Convolution kernel must have odd sizes.");
+		JF_ASSERT(InKernel.size() == static_cast<SIZE_T>(InKernelSize.x) * InKernelSize.y, "Kernel size does not match its weights count.");
+
+		if (!InFrom.IsInitialized())
+		{
+			// #TODO HALT
+			return;
+		}
+
+		SFloatImage source, result;
+		Details::LoadFloatImage(InFrom, source);
+
+		Convolve2D(source, InKernel, InKernelSize.x, InKernelSize.y, result);
+
+		Details::StoreFloatImage(result, InDest, InFrom.GetFormat());
+	}
+
+	void ImageUtils::GaussianBlur(const Image& InFrom, float InSigma, Image& InDest)
+	{
+		JF_PROFILE_SCOPE("ImageUtils::GaussianBlur");
+
+		if (!InFrom.IsInitialized())
+		{
+			// #TODO HALT
+			return;
+		}
+
+		SFloatImage source, temp;
+		Details::LoadFloatImage(InFrom, source);
+
+		if (InSigma > 0.0f)
+		{
+			const uint32 radius = static_cast<uint32>(std::ceil(3.0f * InSigma));
+
+			if (radius <= GMaxGaussianRadius)
+			{
+				const JVector<float> kernel = MakeGaussianKernel(InSigma, radius);
+
+				ConvolveHorizontal(source, kernel, temp);
+				ConvolveVertical(temp, kernel, source);
+			}
+			else
+			{
+				// wide kernels cost O(radius) per pixel, three box passes cost O(1) and are within a few percent
+				uint32 radii[3];
+				GetGaussianBoxRadii(InSigma, radii);
+
+				for (uint32 boxRadius : radii)
+				{
+					BoxBlurInPlace(source, boxRadius, temp);
+				}
+			}
+		}
+
+		Details::StoreFloatImage(source, InDest, InFrom.GetFormat());
+	}
+
+	void ImageUtils::BoxBlur(const Image& InFrom, uint32 InRadius, Image& InDest, uint32 InIterations)
+	{
+		JF_PROFILE_SCOPE("ImageUtils::BoxBlur");
+
+		if (!InFrom.IsInitialized())
+		{
+			// #TODO HALT
+			return;
+		}
+
+		SFloatImage source, temp;
+		Details::LoadFloatImage(InFrom, source);
+
+		for (uint32 i = 0; i < InIterations && InRadius > 0; ++i)
+		{
+			BoxBlurInPlace(source, InRadius, temp);
+		}
+
+		Details::StoreFloatImage(source, InDest, InFrom.GetFormat());
+	}
+
+	void ImageUtils::KawaseBlur(const Image& InFrom, uint32 InIterations, Image& InDest)
+	{
+		JF_PROFILE_SCOPE("ImageUtils::KawaseBlur");
+
+		if (!InFrom.IsInitialized())
+		{
+			// #TODO HALT
+			return;
+		}
+
+		SFloatImage source, temp;
+		Details::LoadFloatImage(InFrom, source);
+
+		for (uint32 i = 0; i < InIterations; ++i)
+		{
+			KawasePass(source, i, temp);
+			std::swap(source, temp);
+		}
+
+		Details::StoreFloatImage(source, InDest, InFrom.GetFormat());
+	}
+
+}
@@ -1,6 +1,8 @@
 #include <OpenImageIO/filesystem.h>
 #include "ImageUtils.h"
 #include "ImageLoader.h"
+#include "PixelConversion.h"
+#include "../Utils/Profiling/Profiler.h"
 
 
 namespace J::Utils
@@ -8,6 +10,8 @@ namespace J::Utils
 
 	Scope<Image> ImageLoader::Load(const system::FilePath& InPath, bool vertical_flip)
 	{
+		JF_PROFILE_SCOPE("ImageLoader::Load");
+
 		auto imInput = OIIO::ImageInput::open(InPath.string());
 		
 		if (!imInput)
@@ -62,6 +66,8 @@ namespace J::Utils
 
 	Scope<Image> ImageLoader::LoadFromMemory(const std::string& InFileName, CMemPtr InSource, SIZE_T InSize, bool vertical_flip)
 	{
+		JF_PROFILE_SCOPE("ImageLoader::LoadFromMemory");
+
 		auto ioMemReader = IOMemoryProxy(const_cast<MemPtr>(InSource), InSize);
 		auto imInput = OIIO::ImageInput::open(InFileName, nullptr, &ioMemReader);
 		
@@ -92,15 +98,44 @@ namespace J::Utils
 	}
 
 	bool ImageLoader::Save(const system::FilePath& InPath, Ref<Image> InImage, ERawImageFormat InFormat)
+	{
+		// HDR -> 8-bit export, single deterministic pass instead of the generic conversion
+		if (InFormat != ERawImageFormat::AUTO
+			&& InFormat != InImage->GetFormat()
+			&& InFormat == Details::GetUInt8Format(InImage->GetFormat()))
+		{
+			// plain linear quantization: sRGB and dithering are only opt-in through the STonemapSettings overload
+			STonemapSettings settings;
+			settings.Operator = ETonemapOperator::Clamp;
+			settings.bEncodeSRGB = false;
+			settings.Dither = EDitherMode::None;
+
+			return Save(InPath, *InImage, settings);
+		}
+
+		return Write(InPath, *InImage, InFormat);
+	}
+
+	bool ImageLoader::Save(const system::FilePath& InPath, const Image& InImage, const STonemapSettings& InSettings)
+	{
+		Image quantized;
+		ImageUtils::Tonemap(InImage, quantized, InSettings);
+
+		return Write(InPath, quantized, ERawImageFormat::AUTO);
+	}
+
+	bool ImageLoader::Write(const system::FilePath& InPath, const Image& InImage, ERawImageFormat InFormat)
 	{
 		const std::string PathString = InPath.string();
 
 		auto imOutput = OIIO::ImageOutput::create(PathString);
 		auto imSpec = OIIO::ImageSpec(
-										InImage->GetSize().x,
-										InImage->GetSize().y,
-										InImage->GetChannelsCount(),
-										Details::ToOIIOImageDataType(InImage->GetFormat()));
+										InImage.GetSize().x,
+										InImage.GetSize().y,
+										InImage.GetChannelsCount(),
+										(InFormat == ERawImageFormat::AUTO)
+										? Details::ToOIIOImageDataType(InImage.GetFormat())
+										: Details::ToOIIOImageDataType(InFormat));
 		
 		if (!imOutput)
 		{
@@ -113,12 +148,7 @@ namespace J::Utils
 			return false;
 		}
 
-
-		return 
-			imOutput->write_image(
-								(InFormat == ERawImageFormat::AUTO)
-								? imSpec.format
-								: Details::ToOIIOImageDataType(InFormat),
-								InImage->RawData());
+		// the spec holds the file data type, the pixels are described by the image format
+		return imOutput->write_image(Details::ToOIIOImageDataType(InImage.GetFormat()), InImage.RawData());
 	}
 }
@@ -5,6 +5,8 @@
 
 namespace J::Utils
 {
+	struct STonemapSettings;
+
 
 	class ImageLoader
 	{
@@ -34,11 +36,27 @@ namespace J::Utils
 		 */
 		static Scope<Image> LoadFromMemory(const ImageLoadMetaData& InData, CMemPtr InSource);
 
+		/**
+		 * Saves the image. Exporting a half / float image into the 8-bit format with the same channels
+		 * (e.g. RGBAF -> RGBA8) goes through ImageUtils::Tonemap with a plain linear quantization (clamp,
+		 * no sRGB, no dithering) instead of the generic conversion. See the STonemapSettings overload for more.
+		 * 
+		 * \param InPath	- The output file, the format is deduced from the extension.
+		 * \param InImage	- The image to save.
+		 * \param InFormat	- The format written to the file, AUTO keeps the image format.
+		 */
 		static bool			Save(const system::FilePath& InPath, Ref<Image> InImage, ERawImageFormat InFormat = ERawImageFormat::AUTO);
 
+		/**
+		 * Tonemaps an HDR image into 8 bits with the given settings and saves it.
+		 */
+		static bool			Save(const system::FilePath& InPath, const Image& InImage, const STonemapSettings& InSettings);
+
 
 	private:
 
+		static bool			Write(const system::FilePath& InPath, const Image& InImage, ERawImageFormat InFormat);
+
 // #todo: MAKE CUSTOM PROXY SUPPORT
 #if JF_SUPPORT_OIIO_CUSTOM_PROXY
 		using IOFileProxy = OIIO::Filesystem::IOFileSTLProxy;
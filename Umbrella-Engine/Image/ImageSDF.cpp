@@ -0,0 +1,222 @@
+#include "ImageUtils.h"
+#include "PixelConversion.h"
+#include "../Utils/Threading/ThreadPool.h"
+#include "../Utils/Profiling/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+
+
+namespace J::Utils
+{
+	using Details::SFloatImage;
+
+	// "no feature pixel" marker for squared distances
+	static constexpr float GInfinity = 1e20f;
+
+	// Column passes gather this many columns at once, so every source row is read a cache line at a time.
+	static constexpr uint32 GColumnBlockSize = 16;
+
+
+	/**
+	 * Exact 1D squared distance transform (P. Felzenszwalb, D. Huttenlocher, "Distance Transforms of Sampled Functions").
+	 * Lower envelope of the parabolas rooted at every finite sample, O(Count).
+	 *
+	 * \param Source	- Sampled function, GInfinity where there is no feature.
+	 * \param Dest		- Squared distances, may not alias Source.
+	 * \param Count		- Number of samples.
+	 * \param Sites		- Scratch storage, Count values.
+	 * \param Bounds	- Scratch storage, Count + 1 values.
+	 */
+	static void DistanceTransform1D(const float* Source, float* Dest, uint32 Count, int32* Sites, float* Bounds)
+	{
+		int32 k = -1;
+
+		for (int32 q = 0; q < static_cast<int32>(Count); ++q)
+		{
+			if (Source[q] >= GInfinity)
+			{
+				continue;
+			}
+
+			if (k < 0)
+			{
+				k = 0;
+				Sites[0] = q;
+				Bounds[0] = -GInfinity;
+				Bounds[1] = GInfinity;
+				continue;
+			}
+
+			const float valueQ = Source[q] + static_cast<float>(q) * q;
+			float s;
+
+			while (true)
+			{
+				const int32 site = Sites[k];
+				s = (valueQ - (Source[site] + static_cast<float>(site) * site)) / (2.0f * (q - site));
+
+				if (s > Bounds[k])
+				{
+					break;
+				}
+
+				--k;
+			}
+
+			++k;
+			Sites[k] = q;
+			Bounds[k] = s;
+			Bounds[k + 1] = GInfinity;
+		}
+
+		if (k < 0)
+		{
+			std::fill_n(Dest, Count, GInfinity);
+			return;
+		}
+
+		k = 0;
+
+		for (int32 q = 0; q < static_cast<int32>(Count); ++q)
+		{
+			while (Bounds[k + 1] < q)
+			{
+				++k;
+			}
+
+			const float delta = static_cast<float>(q - Sites[k]);
+			Dest[q] = delta * delta + Source[Sites[k]];
+		}
+	}
+
+	/**
+	 * 2D squared distance transform in place: rows in parallel, then blocks of columns in parallel.
+	 */
+	static void DistanceTransform2D(JVector<float>& InOutGrid, uint32 Width, uint32 Height)
+	{
+		ParallelFor(Height, Details::GetRowsGrain(Width), [&](SIZE_T Begin, SIZE_T End)
+		{
+			JVector<float> source(Width);
+			JVector<int32> sites(Width);
+			JVector<float> bounds(Width + 1);
+
+			for (SIZE_T y = Begin; y < End; ++y)
+			{
+				float* row = InOutGrid.data() + y * Width;
+
+				std::copy_n(row, Width, source.data());
+				DistanceTransform1D(source.data(), row, Width, sites.data(), bounds.data());
+			}
+		});
+
+		const uint32 blocksCount = (Width + GColumnBlockSize - 1) / GColumnBlockSize;
+
+		ParallelFor(blocksCount, 1, [&](SIZE_T Begin, SIZE_T End)
+		{
+			// columns are gathered into contiguous buffers, transformed and scattered back
+			JVector<float> columns(static_cast<SIZE_T>(Height) * GColumnBlockSize);
+			JVector<float> result(Height);
+			JVector<int32> sites(Height);
+			JVector<float> bounds(Height + 1);
+
+			for (SIZE_T block = Begin; block < End; ++block)
+			{
+				const uint32 x0 = static_cast<uint32>(block) * GColumnBlockSize;
+				const uint32 count = std::min(GColumnBlockSize, Width - x0);
+
+				for (uint32 y = 0; y < Height; ++y)
+				{
+					const float* row = InOutGrid.data() + static_cast<SIZE_T>(y) * Width + x0;
+
+					for (uint32 i = 0; i < count; ++i)
+					{
+						columns[i * static_cast<SIZE_T>(Height) + y] = row[i];
+					}
+				}
+
+				for (uint32 i = 0; i < count; ++i)
+				{
+					float* column = columns.data() + i * static_cast<SIZE_T>(Height);
+
+					DistanceTransform1D(column, result.data(), Height, sites.data(), bounds.data());
+					std::copy_n(result.data(), Height, column);
+				}
+
+				for (uint32 y = 0; y < Height; ++y)
+				{
+					float* row = InOutGrid.data() + static_cast<SIZE_T>(y) * Width + x0;
+
+					for (uint32 i = 0; i < count; ++i)
+					{
+						row[i] = columns[i * static_cast<SIZE_T>(Height) + y];
+					}
+				}
+			}
+		});
+	}
+
+
+	void ImageUtils::GenerateSDF(const Image& InMask, float InSpread, Image& InDest, ERawImageFormat InFormat)
+	{
+		JF_PROFILE_SCOPE("ImageUtils::GenerateSDF");
+
+		JF_ASSERT(InFormat == ERawImageFormat::R8 || InFormat == ERawImageFormat::RF, "SDF can only be stored as R8 or RF.");
+		JF_ASSERT(InSpread > 0.0f, "SDF spread must be positive.");
+
+		if (!InMask.IsInitialized())
+		{
+			// #TODO HALT
+			return;
+		}
+
+		const uint32 width = InMask.GetWidth();
+		const uint32 height = InMask.GetHeight();
+		const SIZE_T pixelsCount = InMask.GetPixelsCount();
+
+		SFloatImage mask;
+		Details::LoadFloatImage(InMask, mask);
+
+		const uint32 maskChannel = Details::HasAlphaChannel(InMask.GetFormat()) ? mask.Channels - 1 : 0;
+
+		// distances to the nearest inside pixel (for outside pixels) and to the nearest outside pixel (for inside pixels)
+		JVector<float> toInside(pixelsCount);
+		JVector<float> toOutside(pixelsCount);
+
+		ParallelFor(pixelsCount, 64 * 1024, [&](SIZE_T Begin, SIZE_T End)
+		{
+			for (SIZE_T i = Begin; i < End; ++i)
+			{
+				const bool bInside = mask.Pixels[i * mask.Channels + maskChannel] >= 0.5f;
+
+				toInside[i] = bInside ? 0.0f : GInfinity;
+				toOutside[i] = bInside ? GInfinity : 0.0f;
+			}
+		});
+
+		DistanceTransform2D(toInside, width, height);
+		DistanceTransform2D(toOutside, width, height);
+
+		// the edge lies half a pixel away from the centers of the pixels on both sides of it
+		SFloatImage distances;
+		distances.Allocate(width, height, 1);
+
+		const bool bNormalize = (InFormat == ERawImageFormat::R8);
+		const float scale = 0.5f / InSpread;
+
+		ParallelFor(pixelsCount, 64 * 1024, [&](SIZE_T Begin, SIZE_T End)
+		{
+			for (SIZE_T i = Begin; i < End; ++i)
+			{
+				const float distance = (toInside[i] == 0.0f)
+					? std::sqrt(toOutside[i]) - 0.5f
+					: 0.5f - std::sqrt(toInside[i]);
+
+				distances.Pixels[i] = bNormalize ? 0.5f + distance * scale : distance;
+			}
+		});
+
+		Details::StoreFloatImage(distances, InDest, InFormat);
+	}
+
+}
@@ -0,0 +1,343 @@
+#include "ImageUtils.h"
+#include "PixelConversion.h"
+#include "../Utils/Threading/ThreadPool.h"
+#include "../Utils/Profiling/Profiler.h"
+#include <algorithm>
+#include <limits>
+
+
+
+namespace J::Utils
+{
+	using Details::EChannelDataType;
+	using Details::GPixelChunkSize;
+
+	// Accumulators are 12 lanes wide: 12 is divisible by every channel count, so lane i % 12
+	// always holds channel i % ChannelsCount and the vector loops never need to know the layout.
+	static constexpr uint32 GLanesCount = 12;
+
+	// Finer histogram for percentiles, interpolated inside a bin.
+	static constexpr uint32 GLuminanceBinsCount = 4096;
+
+	static constexpr float GLuminanceWeights[3] = { 0.2126f, 0.7152f, 0.0722f };
+
+
+	/** Everything one parallel job accumulates, merged into the result at the end of the job. */
+	struct SPartialStats
+	{
+		float			Min[GLanesCount];
+		float			Max[GLanesCount];
+		double			Sum[GLanesCount] = { };
+
+		// 8-bit sources count raw values, everything is derived from these at the end
+		uint32			ValueCounts[4][256] = { };
+
+		uint32			Histograms[4][SImageStats::HistogramBinsCount] = { };
+
+		JVector<uint32>	LuminanceHistogram;
+
+		SPartialStats()
+		{
+			std::fill_n(Min, GLanesCount, std::numeric_limits<float>::max());
+			std::fill_n(Max, GLanesCount, std::numeric_limits<float>::lowest());
+		}
+	};
+
+	static INLINE uint32 ToBin(float InValue, float InMin, float InScale, uint32 InBinsCount)
+	{
+		const float bin = (InValue - InMin) * InScale;
+
+		// NaN goes to the first bin
+		return (bin > 0.0f) ? std::min(static_cast<uint32>(bin), InBinsCount - 1) : 0;
+	}
+
+	/** Lane-wise min, max and sum of Count floats, Count starting at a lane 0 value. */
+	static void AccumulateMinMaxSum(const float* Values, SIZE_T Count, SPartialStats& InOutStats)
+	{
+		float sum[GLanesCount] = { };
+		SIZE_T i = 0;
+
+#if ENGINE_SIMD_SSE2
+		__m128 min[3], max[3], acc[3];
+
+		for (SIZE_T r = 0; r < 3; ++r)
+		{
+			min[r] = _mm_loadu_ps(InOutStats.Min + r * 4);
+			max[r] = _mm_loadu_ps(InOutStats.Max + r * 4);
+			acc[r] = _mm_setzero_ps();
+		}
+
+		for (; i + GLanesCount <= Count; i += GLanesCount)
+		{
+			for (SIZE_T r = 0; r < 3; ++r)
+			{
+				const __m128 value = _mm_loadu_ps(Values + i + r * 4);
+
+				min[r] = _mm_min_ps(min[r], value);
+				max[r] = _mm_max_ps(max[r], value);
+				acc[r] = _mm_add_ps(acc[r], value);
+			}
+		}
+
+		for (SIZE_T r = 0; r < 3; ++r)
+		{
+			_mm_storeu_ps(InOutStats.Min + r * 4, min[r]);
+			_mm_storeu_ps(InOutStats.Max + r * 4, max[r]);
+			_mm_storeu_ps(sum + r * 4, acc[r]);
+		}
+#endif
+
+		for (; i < Count; ++i)
+		{
+			const SIZE_T lane = i % GLanesCount;
+
+			InOutStats.Min[lane] = std::min(InOutStats.Min[lane], Values[i]);
+			InOutStats.Max[lane] = std::max(InOutStats.Max[lane], Values[i]);
+			sum[lane] += Values[i];
+		}
+
+		// float sums only span a chunk, the running totals are double
+		for (SIZE_T lane = 0; lane < GLanesCount; ++lane)
+		{
+			InOutStats.Sum[lane] += sum[lane];
+		}
+	}
+
+	static void CountValues(const uint8* Values, SIZE_T Count, uint32 Channels, SPartialStats& InOutStats)
+	{
+		SIZE_T i = 0;
+
+		if (Channels == 4)
+		{
+			for (; i + 4 <= Count; i += 4)
+			{
+				++InOutStats.ValueCounts[0][Values[i + 0]];
+				++InOutStats.ValueCounts[1][Values[i + 1]];
+				++InOutStats.ValueCounts[2][Values[i + 2]];
+				++InOutStats.ValueCounts[3][Values[i + 3]];
+			}
+		}
+
+		for (; i < Count; ++i)
+		{
+			++InOutStats.ValueCounts[i % Channels][Values[i]];
+		}
+	}
+
+
+	SImageStats ImageUtils::ComputeStats(const Image& InImage, const SImageStatsOptions& InOptions)
+	{
+		JF_PROFILE_SCOPE("ImageUtils::ComputeStats");
+
+		SImageStats stats;
+
+		if (!InImage.IsInitialized() || InImage.GetPixelsCount() == 0)
+		{
+			return stats;
+		}
+
+		const uint32 channels = InImage.GetChannelsCount();
+		const uint32 width = InImage.GetWidth();
+		const uint32 height = InImage.GetHeight();
+		const EChannelDataType type = Details::GetChannelDataType(InImage.GetFormat());
+		const SIZE_T rowLength = static_cast<SIZE_T>(width) * channels;
+		const SIZE_T rowBytes = static_cast<SIZE_T>(width) * InImage.GetBytesPerPixel();
+
+		const bool bByteCounts = (type == EChannelDataType::UInt8);
+		const bool bLuminance = !InOptions.LuminancePercentiles.empty();
+		const uint32 colorChannels = Details::HasAlphaChannel(InImage.GetFormat()) ? channels - 1 : channels;
+
+		const float histogramScale = SImageStats::HistogramBinsCount / std::max(InOptions.HistogramMax - InOptions.HistogramMin, 1e-20f);
+		const float luminanceScale = GLuminanceBinsCount / std::max(InOptions.HistogramMax - InOptions.HistogramMin, 1e-20f);
+
+		SPartialStats total;
+
+		if (bLuminance)
+		{
+			total.LuminanceHistogram.assign(GLuminanceBinsCount, 0);
+		}
+
+		TMutex mergeMutex;
+
+		// a few jobs per thread, each one with its own partial stats
+		const SIZE_T grain = std::max<SIZE_T>(1, height / (ThreadPool::Get().GetConcurrency() * 4));
+
+		ParallelFor(height, grain, [&](SIZE_T Begin, SIZE_T End)
+		{
+			auto partial = MakeScoped<SPartialStats>();
+			float values[GPixelChunkSize];
+
+			if (bLuminance)
+			{
+				partial->LuminanceHistogram.assign(GLuminanceBinsCount, 0);
+			}
+
+			for (SIZE_T y = Begin; y < End; ++y)
+			{
+				const byte* row = InImage.RawData() + y * rowBytes;
+
+				if (bByteCounts)
+				{
+					CountValues(reinterpret_cast<const uint8*>(row), rowLength, channels, *partial);
+
+					if (!bLuminance)
+					{
+						continue;
+					}
+				}
+
+				for (SIZE_T offset = 0; offset < rowLength; offset += GPixelChunkSize)
+				{
+					const SIZE_T count = std::min(GPixelChunkSize, rowLength - offset);
+
+					Details::LoadChannels(row + offset * InImage.GetBytesPerChannel(), type, values, count);
+
+					if (!bByteCounts)
+					{
+						AccumulateMinMaxSum(values, count, *partial);
+
+						if (InOptions.bHistograms)
+						{
+							for (SIZE_T i = 0; i < count; ++i)
+							{
+								++partial->Histograms[i % channels][ToBin(values[i], InOptions.HistogramMin, histogramScale, SImageStats::HistogramBinsCount)];
+							}
+						}
+					}
+
+					if (bLuminance)
+					{
+						for (SIZE_T i = 0; i < count; i += channels)
+						{
+							const float luminance = (colorChannels >= 3)
+								? values[i] * GLuminanceWeights[0] + values[i + 1] * GLuminanceWeights[1] + values[i + 2] * GLuminanceWeights[2]
+								: values[i];
+
+							++partial->LuminanceHistogram[ToBin(luminance, InOptions.HistogramMin, luminanceScale, GLuminanceBinsCount)];
+						}
+					}
+				}
+			}
+
+			JF_SCOPED_LOCK(mergeMutex);
+
+			for (uint32 lane = 0; lane < GLanesCount; ++lane)
+			{
+				total.Min[lane] = std::min(total.Min[lane], partial->Min[lane]);
+				total.Max[lane] = std::max(total.Max[lane], partial->Max[lane]);
+				total.Sum[lane] += partial->Sum[lane];
+			}
+
+			for (uint32 c = 0; c < channels; ++c)
+			{
+				for (uint32 value = 0; value < 256; ++value)
+				{
+					total.ValueCounts[c][value] += partial->ValueCounts[c][value];
+				}
+
+				for (uint32 bin = 0; bin < SImageStats::HistogramBinsCount; ++bin)
+				{
+					total.Histograms[c][bin] += partial->Histograms[c][bin];
+				}
+			}
+
+			for (SIZE_T bin = 0; bin < partial->LuminanceHistogram.size(); ++bin)
+			{
+				total.LuminanceHistogram[bin] += partial->LuminanceHistogram[bin];
+			}
+		});
+
+		// fold lanes / value counts into per-channel results
+
+		stats.ChannelsCount = channels;
+		stats.PixelsCount = InImage.GetPixelsCount();
+
+		for (uint32 c = 0; c < channels; ++c)
+		{
+			if (InOptions.bHistograms)
+			{
+				stats.Histograms[c].assign(SImageStats::HistogramBinsCount, 0);
+			}
+
+			if (bByteCounts)
+			{
+				double sum = 0.0;
+				uint32 first = 255, last = 0;
+
+				for (uint32 value = 0; value < 256; ++value)
+				{
+					const uint32 count = total.ValueCounts[c][value];
+
+					if (count == 0)
+					{
+						continue;
+					}
+
+					first = std::min(first, value);
+					last = std::max(last, value);
+					sum += static_cast<double>(count) * value;
+
+					if (InOptions.bHistograms)
+					{
+						stats.Histograms[c][ToBin(value / 255.0f, InOptions.HistogramMin, histogramScale, SImageStats::HistogramBinsCount)] += count;
+					}
+				}
+
+				stats.Min[c] = first / 255.0f;
+				stats.Max[c] = last / 255.0f;
+				stats.Mean[c] = static_cast<float>(sum / (255.0 * stats.PixelsCount));
+			}
+			else
+			{
+				float min = std::numeric_limits<float>::max();
+				float max = std::numeric_limits<float>::lowest();
+				double sum = 0.0;
+
+				for (uint32 lane = c; lane < GLanesCount; lane += channels)
+				{
+					min = std::min(min, total.Min[lane]);
+					max = std::max(max, total.Max[lane]);
+					sum += total.Sum[lane];
+				}
+
+				stats.Min[c] = min;
+				stats.Max[c] = max;
+				stats.Mean[c] = static_cast<float>(sum / stats.PixelsCount);
+
+				if (InOptions.bHistograms)
+				{
+					std::copy_n(total.Histograms[c], SImageStats::HistogramBinsCount, stats.Histograms[c].data());
+				}
+			}
+		}
+
+		// percentiles, linearly interpolated inside the bin where the cumulative count crosses them
+
+		const float binWidth = (InOptions.HistogramMax - InOptions.HistogramMin) / GLuminanceBinsCount;
+
+		for (float percentile : InOptions.LuminancePercentiles)
+		{
+			const double target = std::clamp(percentile, 0.0f, 1.0f) * static_cast<double>(stats.PixelsCount);
+			double cumulative = 0.0;
+			uint32 bin = 0;
+
+			for (; bin < GLuminanceBinsCount - 1; ++bin)
+			{
+				if (cumulative + total.LuminanceHistogram[bin] >= target)
+				{
+					break;
+				}
+
+				cumulative += total.LuminanceHistogram[bin];
+			}
+
+			const uint32 count = total.LuminanceHistogram[bin];
+			const double fraction = (count > 0) ? std::clamp((target - cumulative) / count, 0.0, 1.0) : 0.0;
+
+			stats.LuminancePercentiles.push_back(InOptions.HistogramMin + binWidth * static_cast<float>(bin + fraction));
+		}
+
+		return stats;
+	}
+
+}
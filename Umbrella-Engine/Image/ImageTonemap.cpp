@@ -0,0 +1,461 @@
+#include "ImageUtils.h"
+#include "PixelConversion.h"
+#include "../Math/ColorSpace.h"
+#include "../Utils/Threading/ThreadPool.h"
+#include "../Utils/Profiling/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+
+
+namespace J::Utils
+{
+	using Details::EChannelDataType;
+	using Details::GPixelChunkSize;
+
+
+	/************************************************************************/
+	/*							DITHER PATTERNS                             */
+	/************************************************************************/
+
+	static constexpr uint32 GBayerSize = 8;
+	static constexpr uint32 GBlueNoiseSize = 64;
+
+	/** 8x8 Bayer thresholds in (0, 1), built recursively: M(2n) = [ 4M, 4M + 2; 4M + 3, 4M + 1 ]. */
+	static const float* GetBayerThresholds()
+	{
+		static const JVector<float> thresholds = []()
+		{
+			JVector<uint32> matrix = { 0 };
+
+			for (uint32 size = 1; size < GBayerSize; size *= 2)
+			{
+				JVector<uint32> next(4 * size * size);
+
+				for (uint32 y = 0; y < size; ++y)
+				{
+					for (uint32 x = 0; x < size; ++x)
+					{
+						const uint32 value = 4 * matrix[y * size + x];
+
+						next[(y) * 2 * size + x]				= value;
+						next[(y) * 2 * size + x + size]			= value + 2;
+						next[(y + size) * 2 * size + x]			= value + 3;
+						next[(y + size) * 2 * size + x + size]	= value + 1;
+					}
+				}
+
+				matrix = std::move(next);
+			}
+
+			JVector<float> result(matrix.size());
+
+			for (SIZE_T i = 0; i < matrix.size(); ++i)
+			{
+				result[i] = (matrix[i] + 0.5f) / matrix.size();
+			}
+
+			return result;
+		}();
+
+		return thresholds.data();
+	}
+
+	/**
+	 * 64x64 blue noise thresholds in (0, 1), ranked with the void-and-cluster method (R. Ulichney, 1993).
+	 * Built once with a fixed seed, so dithered output is reproducible.
+	 */
+	static const float* GetBlueNoiseThresholds()
+	{
+		static const JVector<float> thresholds = []()
+		{
+			constexpr uint32 size = GBlueNoiseSize;
+			constexpr uint32 count = size * size;
+			constexpr float sigma = 1.5f;
+
+			// toroidal gaussian, indexed by the wrapped offset between two cells
+			JVector<float> kernel(count);
+
+			for (uint32 y = 0; y < size; ++y)
+			{
+				for (uint32 x = 0; x < size; ++x)
+				{
+					const float dx = static_cast<float>(std::min(x, size - x));
+					const float dy = static_cast<float>(std::min(y, size - y));
+
+					kernel[y * size + x] = std::exp(-(dx * dx + dy * dy) / (2.0f * sigma * sigma));
+				}
+			}
+
+			JVector<uint8> pattern(count, 0);
+			JVector<float> energy(count, 0.0f);
+
+			auto splat = [&](uint32 InIndex, float InSign)
+			{
+				const uint32 px = InIndex % size;
+				const uint32 py = InIndex / size;
+
+				for (uint32 y = 0; y < size; ++y)
+				{
+					const float* kernelRow = kernel.data() + ((y + size - py) % size) * size;
+
+					for (uint32 x = 0; x < size; ++x)
+					{
+						energy[y * size + x] += InSign * kernelRow[(x + size - px) % size];
+					}
+				}
+			};
+
+			auto tightestCluster = [&]()
+			{
+				uint32 best = 0;
+				float bestEnergy = -1.0f;
+
+				for (uint32 i = 0; i < count; ++i)
+				{
+					if (pattern[i] && energy[i] > bestEnergy)
+					{
+						best = i;
+						bestEnergy = energy[i];
+					}
+				}
+
+				return best;
+			};
+
+			auto largestVoid = [&]()
+			{
+				uint32 best = 0;
+				float bestEnergy = 1e30f;
+
+				for (uint32 i = 0; i < count; ++i)
+				{
+					if (!pattern[i] && energy[i] < bestEnergy)
+					{
+						best = i;
+						bestEnergy = energy[i];
+					}
+				}
+
+				return best;
+			};
+
+			// initial points (10%), xorshift so the pattern does not depend on the standard library
+			const uint32 initialCount = count / 10;
+			uint32 state = 0x9E3779B9u;
+
+			for (uint32 placed = 0; placed < initialCount; )
+			{
+				state ^= state << 13;
+				state ^= state >> 17;
+				state ^= state << 5;
+
+				const uint32 index = state % count;
+
+				if (!pattern[index])
+				{
+					pattern[index] = 1;
+					splat(index, 1.0f);
+					++placed;
+				}
+			}
+
+			// spread them evenly: move the tightest cluster into the largest void until it stays in place
+			for (uint32 i = 0; i < count; ++i)
+			{
+				const uint32 cluster = tightestCluster();
+				pattern[cluster] = 0;
+				splat(cluster, -1.0f);
+
+				const uint32 hole = largestVoid();
+				pattern[hole] = 1;
+				splat(hole, 1.0f);
+
+				if (hole == cluster)
+				{
+					break;
+				}
+			}
+
+			const JVector<uint8> prototype = pattern;
+			const JVector<float> prototypeEnergy = energy;
+			JVector<uint32> ranks(count);
+
+			// ranks below the initial points: remove clusters one by one
+			for (uint32 rank = initialCount; rank-- > 0; )
+			{
+				const uint32 cluster = tightestCluster();
+				pattern[cluster] = 0;
+				splat(cluster, -1.0f);
+				ranks[cluster] = rank;
+			}
+
+			// ranks above: fill voids one by one
+			pattern = prototype;
+			energy = prototypeEnergy;
+
+			for (uint32 rank = initialCount; rank < count; ++rank)
+			{
+				const uint32 hole = largestVoid();
+				pattern[hole] = 1;
+				splat(hole, 1.0f);
+				ranks[hole] = rank;
+			}
+
+			JVector<float> result(count);
+
+			for (uint32 i = 0; i < count; ++i)
+			{
+				result[i] = (ranks[i] + 0.5f) / count;
+			}
+
+			return result;
+		}();
+
+		return thresholds.data();
+	}
+
+
+	/************************************************************************/
+	/*								CURVES                                  */
+	/************************************************************************/
+
+	struct SCurveParams
+	{
+		float	Scale;			// exposure
+		float	InvWhite2;		// Reinhard
+		float	HableScale;		// 1 / Hable(WhitePoint)
+	};
+
+	// ACES fit
+	static constexpr float GAcesA = 2.51f;
+	static constexpr float GAcesB = 0.03f;
+	static constexpr float GAcesC = 2.43f;
+	static constexpr float GAcesD = 0.59f;
+	static constexpr float GAcesE = 0.14f;
+
+	// Hable: shoulder strength, linear strength, linear angle, toe strength, toe numerator, toe denominator
+	static constexpr float GHableA = 0.15f;
+	static constexpr float GHableB = 0.50f;
+	static constexpr float GHableC = 0.10f;
+	static constexpr float GHableD = 0.20f;
+	static constexpr float GHableE = 0.02f;
+	static constexpr float GHableF = 0.30f;
+	static constexpr float GHableExposureBias = 2.0f;
+
+	static INLINE float HablePartial(float x)
+	{
+		return ((x * (GHableA * x + GHableC * GHableB) + GHableD * GHableE) / (x * (GHableA * x + GHableB) + GHableD * GHableF)) - GHableE / GHableF;
+	}
+
+	template<ETonemapOperator Operator>
+	static INLINE float ApplyCurve(float InValue, const SCurveParams& InParams)
+	{
+		// also flushes NaNs to 0
+		const float scaled = InValue * InParams.Scale;
+		const float x = (scaled > 0.0f) ? scaled : 0.0f;
+
+		if constexpr (Operator == ETonemapOperator::Reinhard)
+		{
+			return x * (1.0f + x * InParams.InvWhite2) / (1.0f + x);
+		}
+		else if constexpr (Operator == ETonemapOperator::ACES)
+		{
+			return (x * (GAcesA * x + GAcesB)) / (x * (GAcesC * x + GAcesD) + GAcesE);
+		}
+		else if constexpr (Operator == ETonemapOperator::Hable)
+		{
+			return HablePartial(x * GHableExposureBias) * InParams.HableScale;
+		}
+		else
+		{
+			return x;
+		}
+	}
+
+#if ENGINE_SIMD_SSE2
+	template<ETonemapOperator Operator>
+	static INLINE __m128 ApplyCurve(__m128 InValue, const SCurveParams& InParams)
+	{
+		const __m128 x = _mm_max_ps(_mm_mul_ps(InValue, _mm_set1_ps(InParams.Scale)), _mm_setzero_ps());
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		if constexpr (Operator == ETonemapOperator::Reinhard)
+		{
+			const __m128 numerator = _mm_mul_ps(x, _mm_add_ps(one, _mm_mul_ps(x, _mm_set1_ps(InParams.InvWhite2))));
+			return _mm_div_ps(numerator, _mm_add_ps(one, x));
+		}
+		else if constexpr (Operator == ETonemapOperator::ACES)
+		{
+			const __m128 numerator = _mm_mul_ps(x, _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(GAcesA)), _mm_set1_ps(GAcesB)));
+			const __m128 denominator = _mm_add_ps(_mm_mul_ps(x, _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(GAcesC)), _mm_set1_ps(GAcesD))), _mm_set1_ps(GAcesE));
+			return _mm_div_ps(numerator, denominator);
+		}
+		else if constexpr (Operator == ETonemapOperator::Hable)
+		{
+			const __m128 v = _mm_mul_ps(x, _mm_set1_ps(GHableExposureBias));
+			const __m128 av = _mm_mul_ps(v, _mm_set1_ps(GHableA));
+
+			const __m128 numerator = _mm_add_ps(_mm_mul_ps(v, _mm_add_ps(av, _mm_set1_ps(GHableC * GHableB))), _mm_set1_ps(GHableD * GHableE));
+			const __m128 denominator = _mm_add_ps(_mm_mul_ps(v, _mm_add_ps(av, _mm_set1_ps(GHableB))), _mm_set1_ps(GHableD * GHableF));
+			const __m128 partial = _mm_sub_ps(_mm_div_ps(numerator, denominator), _mm_set1_ps(GHableE / GHableF));
+
+			return _mm_mul_ps(partial, _mm_set1_ps(InParams.HableScale));
+		}
+		else
+		{
+			return x;
+		}
+	}
+#endif
+
+	template<ETonemapOperator Operator>
+	static void ApplyCurve(float* InOutValues, SIZE_T Count, const SCurveParams& InParams)
+	{
+		SIZE_T i = 0;
+
+#if ENGINE_SIMD_SSE2
+		for (; i + 4 <= Count; i += 4)
+		{
+			_mm_storeu_ps(InOutValues + i, ApplyCurve<Operator>(_mm_loadu_ps(InOutValues + i), InParams));
+		}
+#endif
+
+		for (; i < Count; ++i)
+		{
+			InOutValues[i] = ApplyCurve<Operator>(InOutValues[i], InParams);
+		}
+	}
+
+	static void ApplyCurve(ETonemapOperator Operator, float* InOutValues, SIZE_T Count, const SCurveParams& InParams)
+	{
+		switch (Operator)
+		{
+		case ETonemapOperator::Reinhard:	ApplyCurve<ETonemapOperator::Reinhard>(InOutValues, Count, InParams);	break;
+		case ETonemapOperator::ACES:		ApplyCurve<ETonemapOperator::ACES>(InOutValues, Count, InParams);		break;
+		case ETonemapOperator::Hable:		ApplyCurve<ETonemapOperator::Hable>(InOutValues, Count, InParams);		break;
+		default:							ApplyCurve<ETonemapOperator::Clamp>(InOutValues, Count, InParams);		break;
+		}
+	}
+
+
+	/************************************************************************/
+	/*								IMAGE UTILS                             */
+	/************************************************************************/
+
+	void ImageUtils::Tonemap(const Image& InFrom, Image& InDest, const STonemapSettings& InSettings)
+	{
+		JF_PROFILE_SCOPE("ImageUtils::Tonemap");
+
+		if (!InFrom.IsInitialized())
+		{
+			// #TODO HALT
+			return;
+		}
+
+		const uint32 width = InFrom.GetWidth();
+		const uint32 height = InFrom.GetHeight();
+		const uint32 channels = InFrom.GetChannelsCount();
+		const bool bAlpha = Details::HasAlphaChannel(InFrom.GetFormat());
+		const ERawImageFormat destFormat = Details::GetUInt8Format(InFrom.GetFormat());
+
+		const EChannelDataType sourceType = Details::GetChannelDataType(InFrom.GetFormat());
+		const SIZE_T rowLength = static_cast<SIZE_T>(width) * channels;
+		const SIZE_T sourcePitch = static_cast<SIZE_T>(width) * InFrom.GetBytesPerPixel();
+
+		SCurveParams params;
+		params.Scale = std::exp2(InSettings.Exposure);
+		params.InvWhite2 = 1.0f / (InSettings.WhitePoint * InSettings.WhitePoint);
+		params.HableScale = 1.0f / HablePartial(InSettings.WhitePoint);
+
+		const float* thresholds = nullptr;
+		uint32 patternSize = 1;
+
+		switch (InSettings.Dither)
+		{
+		case EDitherMode::Ordered:
+			thresholds = GetBayerThresholds();
+			patternSize = GBayerSize;
+			break;
+
+		case EDitherMode::BlueNoise:
+			thresholds = GetBlueNoiseThresholds();
+			patternSize = GBlueNoiseSize;
+			break;
+
+		default:
+			break;
+		}
+
+		// written into a new image, so InDest may be InFrom
+		Image result(width, height, destFormat);
+		const SIZE_T destPitch = static_cast<SIZE_T>(width) * result.GetBytesPerPixel();
+
+		ParallelFor(height, Details::GetRowsGrain(rowLength), [&](SIZE_T Begin, SIZE_T End)
+		{
+			float values[GPixelChunkSize];
+			float alpha[GPixelChunkSize];
+
+			for (SIZE_T y = Begin; y < End; ++y)
+			{
+				const byte* source = InFrom.RawData() + y * sourcePitch;
+				byte* dest = result.RawData() + y * destPitch;
+
+				const float* thresholdRow = thresholds ? thresholds + (y % patternSize) * patternSize : nullptr;
+
+				for (SIZE_T offset = 0; offset < rowLength; offset += GPixelChunkSize)
+				{
+					const SIZE_T count = std::min(GPixelChunkSize, rowLength - offset);
+
+					Details::LoadChannels(source + offset * InFrom.GetBytesPerChannel(), sourceType, values, count);
+
+					if (bAlpha)
+					{
+						for (SIZE_T i = channels - 1; i < count; i += channels)
+						{
+							alpha[i] = values[i];
+						}
+					}
+
+					ApplyCurve(InSettings.Operator, values, count, params);
+
+					if (InSettings.bEncodeSRGB)
+					{
+						Math::ColorSpace::LinearToSRGB(values, count);
+					}
+
+					if (bAlpha)
+					{
+						for (SIZE_T i = channels - 1; i < count; i += channels)
+						{
+							values[i] = alpha[i];
+						}
+					}
+
+					if (thresholdRow)
+					{
+						// chunks start on pixel boundaries, so the pixel index is offset / channels + i / channels
+						const SIZE_T firstPixel = offset / channels;
+						const uint32 colorChannels = bAlpha ? channels - 1 : channels;
+
+						for (SIZE_T i = 0, x = firstPixel; i < count; i += channels, ++x)
+						{
+							const float noise = (thresholdRow[x % patternSize] - 0.5f) * (1.0f / 255.0f);
+
+							for (uint32 c = 0; c < colorChannels; ++c)
+							{
+								values[i + c] += noise;
+							}
+						}
+					}
+
+					Details::StoreChannels(values, EChannelDataType::UInt8, dest + offset, count);
+				}
+			}
+		});
+
+		result.MarkInitialized();
+		InDest = std::move(result);
+	}
+
+}
@@ -0,0 +1,380 @@
+#include "ImageUtils.h"
+#include "../Utils/Threading/ThreadPool.h"
+#include "../Utils/Profiling/Profiler.h"
+#include <algorithm>
+
+
+
+namespace J::Utils
+{
+	// Transposes are done in 8x8 pixel blocks, visited tile by tile so that the 8 destination rows
+	// touched by a block column stay in cache while the source rows are streamed.
+	static constexpr uint32 GBlockSize = 8;
+	static constexpr uint32 GTileSize = 64;
+
+
+	enum class ETransposeMode : uint8
+	{
+		Transpose,		// dest(x, y) = src(y, x)
+		Rotate90,		// dest(x, y) = src(y, H - 1 - x)
+		Rotate270,		// dest(x, y) = src(W - 1 - y, x)
+	};
+
+
+	/************************************************************************/
+	/*							8x8 BLOCK KERNELS                           */
+	/************************************************************************/
+
+	/**
+	 * DestRows[c][k] = Rows[k][c] for an 8x8 block of PixelSize bytes pixels.
+	 * Rows point to 8 contiguous source pixels each, DestRows to 8 contiguous destination pixels.
+	 */
+	template<SIZE_T PixelSize>
+	static void TransposeBlock(const byte* const* Rows, byte* const* DestRows)
+	{
+#if ENGINE_SIMD_SSE2
+		if constexpr (PixelSize == 1)
+		{
+			const __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Rows[0])), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(Rows[1])));
+			const __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Rows[2])), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(Rows[3])));
+			const __m128i c = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Rows[4])), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(Rows[5])));
+			const __m128i d = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Rows[6])), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(Rows[7])));
+
+			// columns 0-3 and 4-7 of rows 0-3 / 4-7
+			const __m128i e = _mm_unpacklo_epi16(a, b);
+			const __m128i f = _mm_unpackhi_epi16(a, b);
+			const __m128i g = _mm_unpacklo_epi16(c, d);
+			const __m128i h = _mm_unpackhi_epi16(c, d);
+
+			// two full columns per register
+			const __m128i columns[4] =
+			{
+				_mm_unpacklo_epi32(e, g),
+				_mm_unpackhi_epi32(e, g),
+				_mm_unpacklo_epi32(f, h),
+				_mm_unpackhi_epi32(f, h),
+			};
+
+			for (SIZE_T i = 0; i < 4; ++i)
+			{
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(DestRows[2 * i + 0]), columns[i]);
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(DestRows[2 * i + 1]), _mm_srli_si128(columns[i], 8));
+			}
+
+			return;
+		}
+		else if constexpr (PixelSize == 2)
+		{
+			__m128i r[8];
+
+			for (SIZE_T i = 0; i < 8; ++i)
+			{
+				r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Rows[i]));
+			}
+
+			const __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]), a1 = _mm_unpackhi_epi16(r[0], r[1]);
+			const __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]), a3 = _mm_unpackhi_epi16(r[2], r[3]);
+			const __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]), a5 = _mm_unpackhi_epi16(r[4], r[5]);
+			const __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]), a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+			const __m128i b0 = _mm_unpacklo_epi32(a0, a2), b1 = _mm_unpackhi_epi32(a0, a2);
+			const __m128i b2 = _mm_unpacklo_epi32(a1, a3), b3 = _mm_unpackhi_epi32(a1, a3);
+			const __m128i b4 = _mm_unpacklo_epi32(a4, a6), b5 = _mm_unpackhi_epi32(a4, a6);
+			const __m128i b6 = _mm_unpacklo_epi32(a5, a7), b7 = _mm_unpackhi_epi32(a5, a7);
+
+			const __m128i columns[8] =
+			{
+				_mm_unpacklo_epi64(b0, b4), _mm_unpackhi_epi64(b0, b4),
+				_mm_unpacklo_epi64(b1, b5), _mm_unpackhi_epi64(b1, b5),
+				_mm_unpacklo_epi64(b2, b6), _mm_unpackhi_epi64(b2, b6),
+				_mm_unpacklo_epi64(b3, b7), _mm_unpackhi_epi64(b3, b7),
+			};
+
+			for (SIZE_T i = 0; i < 8; ++i)
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(DestRows[i]), columns[i]);
+			}
+
+			return;
+		}
+		else if constexpr (PixelSize == 4)
+		{
+			// four 4x4 quadrants, each one transposed in place
+			for (SIZE_T rowBlock = 0; rowBlock < 8; rowBlock += 4)
+			{
+				for (SIZE_T columnBlock = 0; columnBlock < 8; columnBlock += 4)
+				{
+					__m128 r0 = _mm_loadu_ps(reinterpret_cast<const float*>(Rows[rowBlock + 0] + columnBlock * 4));
+					__m128 r1 = _mm_loadu_ps(reinterpret_cast<const float*>(Rows[rowBlock + 1] + columnBlock * 4));
+					__m128 r2 = _mm_loadu_ps(reinterpret_cast<const float*>(Rows[rowBlock + 2] + columnBlock * 4));
+					__m128 r3 = _mm_loadu_ps(reinterpret_cast<const float*>(Rows[rowBlock + 3] + columnBlock * 4));
+
+					_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+					_mm_storeu_ps(reinterpret_cast<float*>(DestRows[columnBlock + 0] + rowBlock * 4), r0);
+					_mm_storeu_ps(reinterpret_cast<float*>(DestRows[columnBlock + 1] + rowBlock * 4), r1);
+					_mm_storeu_ps(reinterpret_cast<float*>(DestRows[columnBlock + 2] + rowBlock * 4), r2);
+					_mm_storeu_ps(reinterpret_cast<float*>(DestRows[columnBlock + 3] + rowBlock * 4), r3);
+				}
+			}
+
+			return;
+		}
+		else if constexpr (PixelSize == 8)
+		{
+			// 2x2 blocks of 64-bit pixels
+			for (SIZE_T row = 0; row < 8; row += 2)
+			{
+				for (SIZE_T column = 0; column < 8; column += 2)
+				{
+					const __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Rows[row + 0] + column * 8));
+					const __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Rows[row + 1] + column * 8));
+
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(DestRows[column + 0] + row * 8), _mm_unpacklo_epi64(r0, r1));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(DestRows[column + 1] + row * 8), _mm_unpackhi_epi64(r0, r1));
+				}
+			}
+
+			return;
+		}
+#endif
+
+		// other sizes (3, 6, 12, 16 bytes): whole pixel moves, constant size memcpy becomes register moves
+		for (SIZE_T c = 0; c < GBlockSize; ++c)
+		{
+			for (SIZE_T k = 0; k < GBlockSize; ++k)
+			{
+				Memory::Memcpy(Rows[k] + c * PixelSize, DestRows[c] + k * PixelSize, PixelSize);
+			}
+		}
+	}
+
+	/** Reverses the order of Count pixels. */
+	template<SIZE_T PixelSize>
+	static void ReverseRow(const byte* Source, byte* Dest, SIZE_T Count)
+	{
+		SIZE_T i = 0;
+
+#if ENGINE_SIMD_SSE2
+		if constexpr (PixelSize == 4)
+		{
+			for (; i + 4 <= Count; i += 4)
+			{
+				const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + (Count - i - 4) * 4));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dest + i * 4), _mm_shuffle_epi32(pixels, _MM_SHUFFLE(0, 1, 2, 3)));
+			}
+		}
+		else if constexpr (PixelSize == 8)
+		{
+			for (; i + 2 <= Count; i += 2)
+			{
+				const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + (Count - i - 2) * 8));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dest + i * 8), _mm_shuffle_epi32(pixels, _MM_SHUFFLE(1, 0, 3, 2)));
+			}
+		}
+#endif
+
+#if ENGINE_SIMD_SSE41
+		if constexpr (PixelSize == 1)
+		{
+			const __m128i reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+
+			for (; i + 16 <= Count; i += 16)
+			{
+				const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + Count - i - 16));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dest + i), _mm_shuffle_epi8(pixels, reverse));
+			}
+		}
+#endif
+
+		for (; i < Count; ++i)
+		{
+			Memory::Memcpy(Source + (Count - i - 1) * PixelSize, Dest + i * PixelSize, PixelSize);
+		}
+	}
+
+
+	/************************************************************************/
+	/*								DRIVERS                                 */
+	/************************************************************************/
+
+	template<SIZE_T PixelSize>
+	static void TransposeImage(const Image& InFrom, Image& InDest, ETransposeMode InMode)
+	{
+		const uint32 width = InFrom.GetWidth();
+		const uint32 height = InFrom.GetHeight();
+
+		const SIZE_T sourcePitch = static_cast<SIZE_T>(width) * PixelSize;
+		const SIZE_T destPitch = static_cast<SIZE_T>(height) * PixelSize;
+
+		const byte* source = InFrom.RawData();
+		byte* dest = InDest.RawData();
+
+		// destination coordinates of the source pixel (x, y)
+		auto destPixel = [&](uint32 x, uint32 y) -> byte*
+		{
+			switch (InMode)
+			{
+			case ETransposeMode::Rotate90:	return dest + x * destPitch + (height - 1 - y) * PixelSize;
+			case ETransposeMode::Rotate270:	return dest + (width - 1 - x) * destPitch + y * PixelSize;
+			default:						return dest + x * destPitch + y * PixelSize;
+			}
+		};
+
+		const uint32 blockWidth = width - width % GBlockSize;
+		const uint32 blockHeight = height - height % GBlockSize;
+
+		const uint32 tilesX = (blockWidth + GTileSize - 1) / GTileSize;
+		const uint32 tilesY = (blockHeight + GTileSize - 1) / GTileSize;
+
+		ParallelFor(static_cast<SIZE_T>(tilesX) * tilesY, 1, [&](SIZE_T Begin, SIZE_T End)
+		{
+			const byte* rows[GBlockSize];
+			byte* destRows[GBlockSize];
+
+			for (SIZE_T tile = Begin; tile < End; ++tile)
+			{
+				const uint32 tileX = static_cast<uint32>(tile % tilesX) * GTileSize;
+				const uint32 tileY = static_cast<uint32>(tile / tilesX) * GTileSize;
+
+				// block columns outside, so the 8 destination rows of a block column are filled in sequence
+				for (uint32 x = tileX; x < std::min(tileX + GTileSize, blockWidth); x += GBlockSize)
+				{
+					for (uint32 y = tileY; y < std::min(tileY + GTileSize, blockHeight); y += GBlockSize)
+					{
+						for (uint32 k = 0; k < GBlockSize; ++k)
+						{
+							// rotating by 90 reverses the source rows, which makes the destination rows ascending
+							const uint32 row = (InMode == ETransposeMode::Rotate90) ? y + GBlockSize - 1 - k : y + k;
+							rows[k] = source + row * sourcePitch + x * PixelSize;
+						}
+
+						for (uint32 c = 0; c < GBlockSize; ++c)
+						{
+							// first pixel of the destination row that receives source column x + c
+							destRows[c] = (InMode == ETransposeMode::Rotate90)
+								? destPixel(x + c, y + GBlockSize - 1)
+								: destPixel(x + c, y);
+						}
+
+						TransposeBlock<PixelSize>(rows, destRows);
+					}
+				}
+			}
+		});
+
+		// right and bottom borders that do not fill a whole block
+		for (uint32 y = 0; y < height; ++y)
+		{
+			for (uint32 x = (y < blockHeight) ? blockWidth : 0; x < width; ++x)
+			{
+				Memory::Memcpy(source + y * sourcePitch + x * PixelSize, destPixel(x, y), PixelSize);
+			}
+		}
+	}
+
+	template<SIZE_T PixelSize>
+	static void RotateImage180(const Image& InFrom, Image& InDest)
+	{
+		const uint32 width = InFrom.GetWidth();
+		const uint32 height = InFrom.GetHeight();
+		const SIZE_T pitch = static_cast<SIZE_T>(width) * PixelSize;
+
+		const byte* source = InFrom.RawData();
+		byte* dest = InDest.RawData();
+
+		ParallelFor(height, std::max<SIZE_T>(1, (64 * 1024) / std::max<SIZE_T>(1, pitch)), [&](SIZE_T Begin, SIZE_T End)
+		{
+			for (SIZE_T y = Begin; y < End; ++y)
+			{
+				ReverseRow<PixelSize>(source + y * pitch, dest + (height - 1 - y) * pitch, width);
+			}
+		});
+	}
+
+	/** Calls InFunction.template operator()<PixelSize>() for the image pixel size. */
+	template<typename FunctionType>
+	static void DispatchPixelSize(uint32 InPixelSize, const FunctionType& InFunction)
+	{
+		switch (InPixelSize)
+		{
+		case 1:		InFunction.template operator()<1>();	break;
+		case 2:		InFunction.template operator()<2>();	break;
+		case 3:		InFunction.template operator()<3>();	break;
+		case 4:		InFunction.template operator()<4>();	break;
+		case 6:		InFunction.template operator()<6>();	break;
+		case 8:		InFunction.template operator()<8>();	break;
+		case 12:	InFunction.template operator()<12>();	break;
+		case 16:	InFunction.template operator()<16>();	break;
+		default:	JF_ASSERT(false, "Unsupported pixel size."); break;
+		}
+	}
+
+	static void TransposeImage(const Image& InFrom, Image& InDest, ETransposeMode InMode)
+	{
+		if (!InFrom.IsInitialized())
+		{
+			// #TODO HALT
+			return;
+		}
+
+		Image result(InFrom.GetHeight(), InFrom.GetWidth(), InFrom.GetFormat());
+
+		DispatchPixelSize(InFrom.GetBytesPerPixel(), [&]<SIZE_T PixelSize>()
+		{
+			TransposeImage<PixelSize>(InFrom, result, InMode);
+		});
+
+		result.MarkInitialized();
+		InDest = std::move(result);
+	}
+
+
+	/************************************************************************/
+	/*								IMAGE UTILS                             */
+	/************************************************************************/
+
+	void ImageUtils::Rotate(const Image& InFrom, Image& InDest, ERotation InRotation)
+	{
+		JF_PROFILE_SCOPE("ImageUtils::Rotate");
+
+		switch (InRotation)
+		{
+		case ERotation::Rotate90:
+			TransposeImage(InFrom, InDest, ETransposeMode::Rotate90);
+			break;
+
+		case ERotation::Rotate270:
+			TransposeImage(InFrom, InDest, ETransposeMode::Rotate270);
+			break;
+
+		case ERotation::Rotate180:
+		{
+			if (!InFrom.IsInitialized())
+			{
+				// #TODO HALT
+				return;
+			}
+
+			Image result(InFrom.GetSize(), InFrom.GetFormat());
+
+			DispatchPixelSize(InFrom.GetBytesPerPixel(), [&]<SIZE_T PixelSize>()
+			{
+				RotateImage180<PixelSize>(InFrom, result);
+			});
+
+			result.MarkInitialized();
+			InDest = std::move(result);
+			break;
+		}
+		}
+	}
+
+	void ImageUtils::Transpose(const Image& InFrom, Image& InDest)
+	{
+		JF_PROFILE_SCOPE("ImageUtils::Transpose");
+
+		TransposeImage(InFrom, InDest, ETransposeMode::Transpose);
+	}
+
+}
@@ -1,7 +1,13 @@
 #include <OpenImageIO/filesystem.h>
 #include <OpenImageIO/imagebufalgo.h>
 #include "ImageUtils.h"
+#include "PixelOps.h"
+#include "PixelConversion.h"
+#include "../Math/ColorSpace.h"
+#include "../Utils/Profiling/Profiler.h"
 #include <boost/algorithm/string.hpp>
+#include <cmath>
+#include <numbers>
 
 
 namespace J::Utils::Details
@@ -52,6 +58,8 @@ namespace J::Utils
 
 	void ImageUtils::Copy(Ref<Image> InFrom, Image& InTo, ERawImageFormat InFormat)
 	{
+		JF_PROFILE_SCOPE("ImageUtils::Copy");
+
 		auto ImSpec = OIIO::ImageSpec(
 										InFrom->GetSize().x,
 										InFrom->GetSize().y,
@@ -80,6 +88,8 @@ namespace J::Utils
 
 	void ImageUtils::Convert(Ref<Image> InFrom, ERawImageFormat InFormat)
 	{
+		JF_PROFILE_SCOPE("ImageUtils::Convert");
+
 		if (InFrom->GetBytesSize() == 0)
 		{
 			return;
@@ -99,6 +109,8 @@ namespace J::Utils
 
 	void ImageUtils::Resize(Ref<Image> InFrom, Image& InDest, VectorUInt2 InDestSize, ERawImageFormat InDestFormat)
 	{
+		JF_PROFILE_SCOPE("ImageUtils::Resize");
+
 		auto Result = Image(InDestSize, InDestFormat);
 
 		auto imSourceSpec = OIIO::ImageSpec(
@@ -127,6 +139,8 @@ namespace J::Utils
 
 	void ImageUtils::VerticalFlip(Ref<Image> InFrom, Image& ToFlip)
 	{
+		JF_PROFILE_SCOPE("ImageUtils::VerticalFlip");
+
 		auto imBothSpec = OIIO::ImageSpec(
 			InFrom->GetSize().x,
 			InFrom->GetSize().y,
@@ -149,6 +163,8 @@ namespace J::Utils
 
 	void ImageUtils::HorizontalFlip(Ref<Image> InFrom, Image& ToFlip)
 	{
+		JF_PROFILE_SCOPE("ImageUtils::HorizontalFlip");
+
 		auto imBothSpec = OIIO::ImageSpec(
 			InFrom->GetSize().x,
 			InFrom->GetSize().y,
@@ -171,6 +187,25 @@ namespace J::Utils
 
 	void ImageUtils::Rotate(Ref<Image> InFrom, Image& InDest, float InAngle)
 	{
+		JF_PROFILE_SCOPE("ImageUtils::Rotate");
+
+		// quarter turns are exact, no need to resample
+		constexpr float quarterTurn = std::numbers::pi_v<float> / 2.0f;
+
+		const float quarters = InAngle / quarterTurn;
+		const float roundedQuarters = std::round(quarters);
+
+		if (std::abs(quarters - roundedQuarters) < 1e-4f)
+		{
+			switch (((static_cast<int64>(roundedQuarters) % 4) + 4) % 4)
+			{
+			case 0:		InDest = *InFrom;									return;
+			case 1:		Rotate(*InFrom, InDest, ERotation::Rotate90);		return;
+			case 2:		Rotate(*InFrom, InDest, ERotation::Rotate180);		return;
+			default:	Rotate(*InFrom, InDest, ERotation::Rotate270);		return;
+			}
+		}
+
 		auto imBothSpec = OIIO::ImageSpec(
 			InFrom->GetSize().x,
 			InFrom->GetSize().y,
@@ -193,51 +228,131 @@ namespace J::Utils
 
 	void ImageUtils::PixelSum(Ref<Image> InFirstOperand, Ref<Image> InSecondOperand, Image& InDest)
 	{
+		JF_PROFILE_SCOPE("ImageUtils::PixelSum");
+
 		JF_ASSERT(InFirstOperand->GetSize() == InSecondOperand->GetSize(), "Images' sizes should the same.");
 
-		auto imSpec = OIIO::ImageSpec(
-			InFirstOperand->GetSize().x,
-			InFirstOperand->GetSize().y,
-			InFirstOperand->GetChannelsCount(),
-			Details::ToOIIOImageDataType(InFirstOperand->GetFormat()));
+		PixelOps::Add(*InFirstOperand, *InSecondOperand, InDest);
+	}
 
-		auto imFirstBuf = OIIO::ImageBuf(imSpec, InFirstOperand->RawData());
+	void ImageUtils::PixelSum(Ref<Image> InFirstOperand, Span<float> InSecondOperand, Image& InDest)
+	{
+		JF_PROFILE_SCOPE("ImageUtils::PixelSum");
 
-		auto imSecondBuf = OIIO::ImageBuf(imSpec, InSecondOperand->RawData());
+		PixelOps::Add(*InFirstOperand, Span<const float>(InSecondOperand), InDest);
+	}
 
-		auto Result = Image(InFirstOperand->GetSize(), InFirstOperand->GetFormat());
+	static void ConvertColorSpace(const Image& InFrom, Image& InDest, bool bToLinear)
+	{
+		using Details::EChannelDataType;
 
-		auto imResultBuf = OIIO::ImageBuf(imSpec, Result.RawData());
+		const uint32 channels = InFrom.GetChannelsCount();
 
-		if (OIIO::ImageBufAlgo::add(imResultBuf, imFirstBuf, imSecondBuf))
+		if (!InFrom.IsInitialized() || channels == 0)
 		{
-			Result.MarkInitialized();
+			return;
 		}
-		// else LOG ERROR
 
-		InDest = std::move(Result);
-	}
+		if (&InDest != &InFrom && (InDest.GetSize() != InFrom.GetSize() || InDest.GetChannelsCount() != channels))
+		{
+			InDest = Image(InFrom.GetSize(), InFrom.GetFormat());
+		}
 
-	void ImageUtils::PixelSum(Ref<Image> InFirstOperand, Span<float> InSecondOperand, Image& InDest)
-	{
-		auto imSpec = OIIO::ImageSpec(
-			InFirstOperand->GetSize().x,
-			InFirstOperand->GetSize().y,
-			InFirstOperand->GetChannelsCount(),
-			Details::ToOIIOImageDataType(InFirstOperand->GetFormat()));
+		// channels affected by the transfer curve, alpha is the last one
+		const uint32 colorChannels = Details::HasAlphaChannel(InFrom.GetFormat()) ? channels - 1 : channels;
 
-		auto imSourceBuf = OIIO::ImageBuf(imSpec, InFirstOperand->RawData());
+		const EChannelDataType sourceType = Details::GetChannelDataType(InFrom.GetFormat());
+		const EChannelDataType destType = Details::GetChannelDataType(InDest.GetFormat());
+		const SIZE_T totalCount = InFrom.GetPixelsCount() * channels;
 
-		auto Result = Image(InFirstOperand->GetSize(), InFirstOperand->GetFormat());
+		const uint8* source = reinterpret_cast<const uint8*>(InFrom.RawData());
+		uint8* dest = reinterpret_cast<uint8*>(InDest.RawData());
 
-		auto imResultBuf = OIIO::ImageBuf(imSpec, Result.RawData());
+		// 8-bit to 8-bit goes through a byte table, memory bound
+		if (sourceType == EChannelDataType::UInt8 && destType == EChannelDataType::UInt8)
+		{
+			const auto convert = bToLinear ? &ColorSpace::SRGB8ToLinear8 : &ColorSpace::Linear8ToSRGB8;
+
+			if (colorChannels == channels)
+			{
+				convert(source, dest, totalCount);
+			}
+			else
+			{
+				for (SIZE_T i = 0; i < totalCount; i += channels)
+				{
+					convert(source + i, dest + i, colorChannels);
+					dest[i + colorChannels] = source[i + colorChannels];
+				}
+			}
+
+			InDest.MarkInitialized();
+			return;
+		}
+
+		alignas(64) float chunk[Details::GPixelChunkSize];
+		alignas(64) float alpha[Details::GPixelChunkSize];
+
+		const SIZE_T sourceChannelSize = InFrom.GetBytesPerChannel();
+		const SIZE_T destChannelSize = InDest.GetBytesPerChannel();
 
-		if (OIIO::ImageBufAlgo::add(imResultBuf, imSourceBuf, InSecondOperand.data()))
+		for (SIZE_T offset = 0; offset < totalCount; offset += Details::GPixelChunkSize)
 		{
-			Result.MarkInitialized();
+			const SIZE_T count = std::min(Details::GPixelChunkSize, totalCount - offset);
+
+			if (bToLinear && sourceType == EChannelDataType::UInt8)
+			{
+				// decode table instead of the curve
+				ColorSpace::SRGB8ToLinear(source + offset, chunk, count);
+			}
+			else
+			{
+				Details::LoadChannels(InFrom.RawData() + offset * sourceChannelSize, sourceType, chunk, count);
+			}
+
+			if (colorChannels != channels)
+			{
+				for (SIZE_T i = colorChannels; i < count; i += channels)
+				{
+					alpha[i] = (sourceType == EChannelDataType::UInt8) ? source[offset + i] * (1.0f / 255.0f) : chunk[i];
+				}
+			}
+
+			if (!bToLinear)
+			{
+				ColorSpace::LinearToSRGB(chunk, count);
+			}
+			else if (sourceType != EChannelDataType::UInt8)
+			{
+				ColorSpace::SRGBToLinear(chunk, count);
+			}
+
+			if (colorChannels != channels)
+			{
+				for (SIZE_T i = colorChannels; i < count; i += channels)
+				{
+					chunk[i] = alpha[i];
+				}
+			}
+
+			Details::StoreChannels(chunk, destType, InDest.RawData() + offset * destChannelSize, count);
 		}
-	
-		InDest = std::move(Result);
+
+		InDest.MarkInitialized();
 	}
 
-}
+	void ImageUtils::SRGBToLinear(const Image& InFrom, Image& InDest)
+	{
+		JF_PROFILE_SCOPE("ImageUtils::SRGBToLinear");
+
+		ConvertColorSpace(InFrom, InDest, true);
+	}
+
+	void ImageUtils::LinearToSRGB(const Image& InFrom, Image& InDest)
+	{
+		JF_PROFILE_SCOPE("ImageUtils::LinearToSRGB");
+
+		ConvertColorSpace(InFrom, InDest, false);
+	}
+
+}
\ No newline at end of file
@@ -62,6 +62,114 @@ namespace J::Utils::Details
 
 namespace J::Utils {
 
+	/** Exact rotations, clockwise. */
+	enum class ERotation : uint8
+	{
+		Rotate90,
+		Rotate180,
+		Rotate270,
+	};
+
+
+	/**
+	 * What ImageUtils::ComputeStats should compute besides min / max / mean.
+	 * Values are in the normalized domain, 8-bit channels are treated as [0, 1].
+	 */
+	struct SImageStatsOptions
+	{
+		bool				bHistograms = true;
+
+		/** Histograms range, values outside land in the first / last bin. */
+		float				HistogramMin = 0.0f;
+
+		float				HistogramMax = 1.0f;
+
+		/** Luminance percentiles to compute, in [0, 1] (e.g. { 0.05f, 0.5f, 0.95f }), empty to skip. */
+		Span<const float>	LuminancePercentiles;
+	};
+
+
+	struct SImageStats
+	{
+		static constexpr uint32 HistogramBinsCount = 256;
+
+		uint32				ChannelsCount = 0;
+
+		SIZE_T				PixelsCount = 0;
+
+		float				Min[4] = { };
+
+		float				Max[4] = { };
+
+		float				Mean[4] = { };
+
+		/** HistogramBinsCount bins per channel, empty if not requested. */
+		JVector<uint32>		Histograms[4];
+
+		/** Same order as SImageStatsOptions::LuminancePercentiles. */
+		JVector<float>		LuminancePercentiles;
+	};
+
+
+	enum class ETonemapOperator : uint8
+	{
+		Clamp,		// no curve, values above 1 saturate
+		Reinhard,	// extended Reinhard, WhitePoint maps to 1
+		ACES,		// ACES filmic fit (K. Narkowicz)
+		Hable,		// Uncharted 2 filmic curve (J. Hable), WhitePoint maps to 1
+	};
+
+	enum class EDitherMode : uint8
+	{
+		None,
+		Ordered,	// 8x8 Bayer matrix
+		BlueNoise,	// 64x64 void-and-cluster pattern
+	};
+
+	struct STonemapSettings
+	{
+		ETonemapOperator	Operator = ETonemapOperator::ACES;
+
+		/** In stops, applied before the curve. */
+		float				Exposure = 0.0f;
+
+		/** Linear value mapped to 1 by Reinhard and Hable. */
+		float				WhitePoint = 11.2f;
+
+		bool				bEncodeSRGB = true;
+
+		EDitherMode			Dither = EDitherMode::BlueNoise;
+	};
+
+
+	struct SImageCompareResult
+	{
+		/** false if the images have different sizes or channels counts, nothing else is filled then. */
+		bool				bComparable = false;
+
+		/** MaxDelta <= tolerance. */
+		bool				bPassed = false;
+
+		/** Largest absolute channel difference, in the normalized domain. */
+		float				MaxDelta = 0.0f;
+
+		VectorUInt2			MaxDeltaPosition = { 0, 0 };
+
+		SIZE_T				PixelsOverTolerance = 0;
+
+		double				MeanSquaredError = 0.0;
+
+		/** In dB for a peak value of 1, infinity for identical images. */
+		double				PSNR = 0.0;
+
+		/** Mean structural similarity of the luminance (11x11 gaussian window, sigma 1.5), 1 for identical images. */
+		double				SSIM = 1.0;
+
+		/** RF, largest absolute channel difference of every pixel. */
+		Image				ErrorMap;
+	};
+
+
 	class ImageUtils
 	{
 	public:
@@ -98,11 +206,140 @@ namespace J::Utils {
 
 		static void HorizontalFlip(Ref<Image> InFrom, Image& InDest);
 
+		/**
+		 * Rotates the image clockwise by InAngle radians. Multiples of 90 degrees take the exact
+		 * Rotate(ERotation) path (and swap width and height for 90 and 270), other angles are resampled.
+		 */
 		static void Rotate(Ref<Image> InFrom, Image& InDest, float InAngle);
 
+		/**
+		 * Rotates the image by a multiple of 90 degrees without resampling. InDest may be InFrom.
+		 * 
+		 * \param InFrom		- The source image.
+		 * \param InDest		- The rotated image, width and height are swapped for 90 and 270.
+		 * \param InRotation	- Clockwise rotation.
+		 */
+		static void Rotate(const Image& InFrom, Image& InDest, ERotation InRotation);
+
+		/**
+		 * Swaps rows and columns: dest(x, y) = src(y, x). InDest may be InFrom.
+		 */
+		static void Transpose(const Image& InFrom, Image& InDest);
+
 		static void PixelSum(Ref<Image> InFirstOperand, Ref<Image> InSecondOperand, Image& InDest);
 
 		static void PixelSum(Ref<Image> InFirstOperand, Span<float> InSecondOperand, Image& InDest);
+
+		/**
+		 * Decodes an sRGB image into linear space. Alpha channel is left untouched.
+		 * InDest keeps its format if it already has the source size and channels count
+		 * (e.g. RGBA8 -> RGBAF), otherwise it gets the source format. InDest may be InFrom.
+		 * 
+		 * \param InFrom	- The sRGB encoded image.
+		 * \param InDest	- The linear image.
+		 */
+		static void SRGBToLinear(const Image& InFrom, Image& InDest);
+
+		/**
+		 * Encodes a linear image into sRGB. Same destination rules as SRGBToLinear.
+		 * 
+		 * \param InFrom	- The linear image.
+		 * \param InDest	- The sRGB encoded image.
+		 */
+		static void LinearToSRGB(const Image& InFrom, Image& InDest);
+
+		// Filters. Computed in float whatever the image format, edges are clamped.
+		// InDest gets (re)allocated with the source size and format if needed, InDest may be InFrom.
+
+		/**
+		 * Convolves the image with a separable kernel: a horizontal pass, then a vertical one.
+		 *
+		 * \param InFrom	- The source image.
+		 * \param InKernelX	- Horizontal weights, odd count, centered.
+		 * \param InKernelY	- Vertical weights, odd count, centered.
+		 * \param InDest	- The filtered image.
+		 */
+		static void Convolve(const Image& InFrom, Span<const float> InKernelX, Span<const float> InKernelY, Image& InDest);
+
+		/**
+		 * Convolves the image with a full 2D kernel. Prefer the separable version when possible.
+		 *
+		 * \param InFrom		- The source image.
+		 * \param InKernel		- Row-major weights, InKernelSize.x * InKernelSize.y values.
+		 * \param InKernelSize	- Kernel width and height, both odd.
+		 * \param InDest		- The filtered image.
+		 */
+		static void Convolve(const Image& InFrom, Span<const float> InKernel, VectorUInt2 InKernelSize, Image& InDest);
+
+		/**
+		 * Gaussian blur. Radius is 3 * sigma, wide kernels fall back to three box passes.
+		 *
+		 * \param InFrom	- The source image.
+		 * \param InSigma	- Standard deviation in pixels, <= 0 copies the image.
+		 * \param InDest	- The blurred image.
+		 */
+		static void GaussianBlur(const Image& InFrom, float InSigma, Image& InDest);
+
+		/**
+		 * Box blur, constant cost per pixel whatever the radius.
+		 *
+		 * \param InFrom		- The source image.
+		 * \param InRadius		- Window radius, the window is 2 * InRadius + 1 pixels wide.
+		 * \param InDest		- The blurred image.
+		 * \param InIterations	- Number of passes, 3 passes are close to a gaussian.
+		 */
+		static void BoxBlur(const Image& InFrom, uint32 InRadius, Image& InDest, uint32 InIterations = 1);
+
+		/**
+		 * Kawase blur: pass i averages four bilinear taps at i + 0.5 pixels diagonally.
+		 * Cheap approximation of a large gaussian (e.g. for bloom).
+		 *
+		 * \param InFrom		- The source image.
+		 * \param InIterations	- Number of passes.
+		 * \param InDest		- The blurred image.
+		 */
+		static void KawaseBlur(const Image& InFrom, uint32 InIterations, Image& InDest);
+
+		/**
+		 * Builds a signed distance field from a mask with an exact euclidean distance transform.
+		 * A pixel is inside when its alpha (or first channel for formats without alpha) is >= 0.5.
+		 * 
+		 * \param InMask		- The mask, e.g. a glyph rasterized at a high resolution.
+		 * \param InSpread		- Distance in pixels mapped to the [0, 1] range of R8 output.
+		 * \param InDest		- The distance field, same size as the mask.
+		 * \param InFormat		- R8: 0.5 on the edge, above inside, saturating at InSpread pixels.
+		 *						  RF: signed distance in pixels, positive inside.
+		 */
+		static void GenerateSDF(const Image& InMask, float InSpread, Image& InDest, ERawImageFormat InFormat = ERawImageFormat::R8);
+
+		/**
+		 * Computes per-channel min, max, mean and optionally histograms and luminance percentiles
+		 * (Rec. 709 luminance for RGB formats, first channel otherwise) in one parallel pass.
+		 * 
+		 * \param InImage		- The image to measure.
+		 * \param InOptions		- What to compute.
+		 */
+		static SImageStats ComputeStats(const Image& InImage, const SImageStatsOptions& InOptions = { });
+
+		/**
+		 * Turns a linear (HDR) image into an 8-bit one in a single pass: exposure, tone curve,
+		 * sRGB encoding, dithering and quantization. Alpha is only clamped and quantized.
+		 * The result is deterministic for a given image and settings.
+		 * 
+		 * \param InFrom		- Linear image, usually RGBAF / RGBAH.
+		 * \param InDest		- The 8-bit image with the same channels (RGBAF -> RGBA8, RGBF -> RGB8, RF -> R8). May be InFrom.
+		 * \param InSettings	- The tonemapping settings.
+		 */
+		static void Tonemap(const Image& InFrom, Image& InDest, const STonemapSettings& InSettings = { });
+
+		/**
+		 * Compares two images with the same size and channels count (formats may differ), e.g. a render against a golden image.
+		 * 
+		 * \param InA			- The first image (reference).
+		 * \param InB			- The second image.
+		 * \param InTolerance	- Largest channel difference still considered equal, in the normalized domain.
+		 */
+		static SImageCompareResult Compare(const Image& InA, const Image& InB, float InTolerance = 0.0f);
 	};
 
 }
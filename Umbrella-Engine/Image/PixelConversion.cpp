@@ -0,0 +1,216 @@
+#include "PixelConversion.h"
+#include "../Utils/Threading/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+
+
+namespace J::Utils::Details
+{
+	static constexpr float OneOver255 = 1.0f / 255.0f;
+
+
+	EChannelDataType GetChannelDataType(ERawImageFormat Format)
+	{
+		switch (Format)
+		{
+		case ERawImageFormat::RF:
+		case ERawImageFormat::RGBF:
+		case ERawImageFormat::RGBAF:
+			return EChannelDataType::Float;
+
+		case ERawImageFormat::RH:
+		case ERawImageFormat::RGBH:
+		case ERawImageFormat::RGBAH:
+			return EChannelDataType::Half;
+
+		default:
+			return EChannelDataType::UInt8;
+		}
+	}
+
+	bool HasAlphaChannel(ERawImageFormat Format)
+	{
+		switch (Format)
+		{
+		case ERawImageFormat::LA8:
+		case ERawImageFormat::RGBA8:
+		case ERawImageFormat::RGBAH:
+		case ERawImageFormat::RGBAF:
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	ERawImageFormat GetUInt8Format(ERawImageFormat Format)
+	{
+		switch (Format)
+		{
+		case ERawImageFormat::RF:
+		case ERawImageFormat::RH:
+			return ERawImageFormat::R8;
+
+		case ERawImageFormat::RGBF:
+		case ERawImageFormat::RGBH:
+			return ERawImageFormat::RGB8;
+
+		case ERawImageFormat::RGBAF:
+		case ERawImageFormat::RGBAH:
+			return ERawImageFormat::RGBA8;
+
+		default:
+			return Format;
+		}
+	}
+
+	static void LoadUInt8(const uint8* Source, float* Dest, SIZE_T Count)
+	{
+		SIZE_T i = 0;
+
+#if ENGINE_SIMD_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		const __m128 scale = _mm_set1_ps(OneOver255);
+
+		for (; i + 16 <= Count; i += 16)
+		{
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + i));
+			const __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+			const __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+
+			_mm_storeu_ps(Dest + i + 0,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+			_mm_storeu_ps(Dest + i + 4,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+			_mm_storeu_ps(Dest + i + 8,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+			_mm_storeu_ps(Dest + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+		}
+#endif
+
+		for (; i < Count; ++i)
+		{
+			Dest[i] = Source[i] * OneOver255;
+		}
+	}
+
+	static void StoreUInt8(const float* Source, uint8* Dest, SIZE_T Count)
+	{
+		SIZE_T i = 0;
+
+#if ENGINE_SIMD_SSE2
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 max = _mm_set1_ps(255.0f);
+
+		for (; i + 16 <= Count; i += 16)
+		{
+			// max(v, 0) also flushes NaNs to 0
+			const __m128i v0 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(Source + i + 0), max), zero), max));
+			const __m128i v1 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(Source + i + 4), max), zero), max));
+			const __m128i v2 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(Source + i + 8), max), zero), max));
+			const __m128i v3 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(Source + i + 12), max), zero), max));
+
+			const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(v0, v1), _mm_packs_epi32(v2, v3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dest + i), packed);
+		}
+#endif
+
+		for (; i < Count; ++i)
+		{
+			const float value = Source[i] * 255.0f;
+			Dest[i] = (value > 0.0f) ? static_cast<uint8>(std::nearbyint(value < 255.0f ? value : 255.0f)) : 0;
+		}
+	}
+
+	void LoadChannels(const byte* Source, EChannelDataType Type, float* Dest, SIZE_T Count)
+	{
+		switch (Type)
+		{
+		case EChannelDataType::UInt8:
+			LoadUInt8(reinterpret_cast<const uint8*>(Source), Dest, Count);
+			break;
+
+		case EChannelDataType::Half:
+			Float16::ToFloat(reinterpret_cast<const Float16*>(Source), Dest, Count);
+			break;
+
+		case EChannelDataType::Float:
+			Memory::Memcpy(Source, Dest, Count * sizeof(float));
+			break;
+		}
+	}
+
+	void StoreChannels(const float* Source, EChannelDataType Type, byte* Dest, SIZE_T Count)
+	{
+		switch (Type)
+		{
+		case EChannelDataType::UInt8:
+			StoreUInt8(Source, reinterpret_cast<uint8*>(Dest), Count);
+			break;
+
+		case EChannelDataType::Half:
+			Float16::FromFloat(Source, reinterpret_cast<Float16*>(Dest), Count);
+			break;
+
+		case EChannelDataType::Float:
+			Memory::Memcpy(Source, Dest, Count * sizeof(float));
+			break;
+		}
+	}
+
+
+	void SFloatImage::Allocate(uint32 InWidth, uint32 InHeight, uint32 InChannels)
+	{
+		Width = InWidth;
+		Height = InHeight;
+		Channels = InChannels;
+		Pixels.resize(GetRowLength() * Height);
+	}
+
+	SIZE_T GetRowsGrain(SIZE_T InRowLength)
+	{
+		return std::max<SIZE_T>(1, (16 * 1024) / std::max<SIZE_T>(1, InRowLength));
+	}
+
+	void LoadFloatImage(const Image& InImage, SFloatImage& OutImage)
+	{
+		OutImage.Allocate(InImage.GetWidth(), InImage.GetHeight(), InImage.GetChannelsCount());
+
+		const EChannelDataType type = GetChannelDataType(InImage.GetFormat());
+		const SIZE_T rowLength = OutImage.GetRowLength();
+		const SIZE_T rowBytes = static_cast<SIZE_T>(InImage.GetWidth()) * InImage.GetBytesPerPixel();
+		const byte* source = InImage.RawData();
+
+		ParallelFor(OutImage.Height, GetRowsGrain(rowLength), [&](SIZE_T Begin, SIZE_T End)
+		{
+			for (SIZE_T y = Begin; y < End; ++y)
+			{
+				LoadChannels(source + y * rowBytes, type, OutImage.Row(static_cast<uint32>(y)), rowLength);
+			}
+		});
+	}
+
+	void StoreFloatImage(const SFloatImage& InImage, Image& OutImage, ERawImageFormat InFormat)
+	{
+		if (OutImage.GetWidth() != InImage.Width || OutImage.GetHeight() != InImage.Height || OutImage.GetFormat() != InFormat)
+		{
+			OutImage = Image(InImage.Width, InImage.Height, InFormat);
+		}
+
+		JF_ASSERT(OutImage.GetChannelsCount() == InImage.Channels, "Destination format has a different channels count.");
+
+		const EChannelDataType type = GetChannelDataType(InFormat);
+		const SIZE_T rowLength = InImage.GetRowLength();
+		const SIZE_T rowBytes = static_cast<SIZE_T>(OutImage.GetWidth()) * OutImage.GetBytesPerPixel();
+		byte* dest = OutImage.RawData();
+
+		ParallelFor(InImage.Height, GetRowsGrain(rowLength), [&](SIZE_T Begin, SIZE_T End)
+		{
+			for (SIZE_T y = Begin; y < End; ++y)
+			{
+				StoreChannels(InImage.Row(static_cast<uint32>(y)), type, dest + y * rowBytes, rowLength);
+			}
+		});
+
+		OutImage.MarkInitialized();
+	}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "Image.h"
+
+
+
+namespace J::Utils::Details
+{
+	/**
+	 * Storage type of a single channel.
+	 */
+	enum class EChannelDataType : uint8
+	{
+		UInt8,
+		Half,
+		Float,
+	};
+
+	EChannelDataType	GetChannelDataType(ERawImageFormat Format);
+
+	/** True for formats whose last channel is alpha (LA8, RGBA8, RGBAH, RGBAF). */
+	bool				HasAlphaChannel(ERawImageFormat Format);
+
+	/** 8-bit format with the same channels (RGBAF -> RGBA8, RH -> R8, ...). 8-bit formats are returned as is. */
+	ERawImageFormat		GetUInt8Format(ERawImageFormat Format);
+
+	/**
+	 * Converts Count channel values into floats. 8-bit values are normalized to [0, 1].
+	 *
+	 * \param Source	- The first channel value.
+	 * \param Type		- The storage type of the source channels.
+	 * \param Dest		- The destination storage, at least Count floats.
+	 * \param Count		- Number of channel values (not pixels) to convert.
+	 */
+	void				LoadChannels(const byte* Source, EChannelDataType Type, float* Dest, SIZE_T Count);
+
+	/**
+	 * Converts Count floats back into channel values. 8-bit values get clamped to [0, 1] and rounded.
+	 *
+	 * \param Source	- The floats to convert.
+	 * \param Type		- The storage type of the destination channels.
+	 * \param Dest		- The first destination channel value.
+	 * \param Count		- Number of channel values (not pixels) to convert.
+	 */
+	void				StoreChannels(const float* Source, EChannelDataType Type, byte* Dest, SIZE_T Count);
+
+	/**
+	 * Number of floats the chunked kernels process at once. Divisible by every channel count (1 to 4),
+	 * so a chunk always starts at a pixel boundary, and small enough to keep several chunks in L1.
+	 */
+	constexpr SIZE_T	GPixelChunkSize = 768;
+
+
+	/**
+	 * Whole image unpacked into interleaved floats, for kernels that need random access to
+	 * neighbouring pixels (filters, transforms) where the chunked streaming does not fit.
+	 */
+	struct SFloatImage
+	{
+		JVector<float>	Pixels;
+
+		uint32			Width = 0;
+
+		uint32			Height = 0;
+
+		uint32			Channels = 0;
+
+
+		void			Allocate(uint32 InWidth, uint32 InHeight, uint32 InChannels);
+
+		SIZE_T			GetRowLength() const { return static_cast<SIZE_T>(Width) * Channels; }
+
+		float*			Row(uint32 Y) { return Pixels.data() + Y * GetRowLength(); }
+
+		const float*	Row(uint32 Y) const { return Pixels.data() + Y * GetRowLength(); }
+	};
+
+	/** Unpacks InImage into OutImage, rows are converted in parallel. */
+	void				LoadFloatImage(const Image& InImage, SFloatImage& OutImage);
+
+	/**
+	 * Packs InImage back into OutImage. OutImage is (re)allocated with InFormat if its size or format differs.
+	 * InFormat must have InImage.Channels channels.
+	 */
+	void				StoreFloatImage(const SFloatImage& InImage, Image& OutImage, ERawImageFormat InFormat);
+
+	/** Number of rows handed to a single parallel job, so that each job touches a few dozen KB. */
+	SIZE_T				GetRowsGrain(SIZE_T InRowLength);
+
+}
@@ -0,0 +1,486 @@
+#include "PixelOps.h"
+#include "PixelConversion.h"
+#include <algorithm>
+
+
+
+namespace J::Utils
+{
+	using Details::EChannelDataType;
+	using Details::GPixelChunkSize;
+
+
+	static void FillConstant(float* Dest, Span<const float> InConstant)
+	{
+		JF_ASSERT(!InConstant.empty(), "Constant operand should contain at least one value.");
+
+		for (SIZE_T i = 0; i < 4; ++i)
+		{
+			Dest[i] = InConstant[std::min(i, InConstant.size() - 1)];
+		}
+	}
+
+	// operation factories
+
+	SPixelOperation SPixelOperation::Make(EPixelOperation InOperation, const Image& InOperand)
+	{
+		SPixelOperation result{ InOperation, &InOperand, { 0.f, 0.f, 0.f, 0.f }, { 0.f, 0.f, 0.f, 0.f } };
+		return result;
+	}
+
+	SPixelOperation SPixelOperation::Make(EPixelOperation InOperation, Span<const float> InConstant)
+	{
+		SPixelOperation result{ InOperation, nullptr, { }, { 0.f, 0.f, 0.f, 0.f } };
+		FillConstant(result.A, InConstant);
+		return result;
+	}
+
+	SPixelOperation SPixelOperation::MakeLerp(const Image& InOperand, float InFactor)
+	{
+		SPixelOperation result{ EPixelOperation::Lerp, &InOperand, { InFactor, InFactor, InFactor, InFactor }, { 0.f, 0.f, 0.f, 0.f } };
+		return result;
+	}
+
+	SPixelOperation SPixelOperation::MakeLerp(Span<const float> InConstant, float InFactor)
+	{
+		// constant lerp is stored as scale-bias: a * (1 - t) + c * t
+		SPixelOperation result{ EPixelOperation::ScaleBias, nullptr, { }, { } };
+		FillConstant(result.B, InConstant);
+
+		for (SIZE_T i = 0; i < 4; ++i)
+		{
+			result.A[i] = 1.0f - InFactor;
+			result.B[i] *= InFactor;
+		}
+
+		return result;
+	}
+
+	SPixelOperation SPixelOperation::MakeClamp(Span<const float> InLow, Span<const float> InHigh)
+	{
+		SPixelOperation result{ EPixelOperation::Clamp, nullptr, { }, { } };
+		FillConstant(result.A, InLow);
+		FillConstant(result.B, InHigh);
+		return result;
+	}
+
+	SPixelOperation SPixelOperation::MakeScaleBias(Span<const float> InScale, Span<const float> InBias)
+	{
+		SPixelOperation result{ EPixelOperation::ScaleBias, nullptr, { }, { } };
+		FillConstant(result.A, InScale);
+		FillConstant(result.B, InBias);
+		return result;
+	}
+
+	SPixelOperation SPixelOperation::MakePremultiply()
+	{
+		return { EPixelOperation::Premultiply, nullptr, { 0.f, 0.f, 0.f, 0.f }, { 0.f, 0.f, 0.f, 0.f } };
+	}
+
+	SPixelOperation SPixelOperation::MakeUnpremultiply()
+	{
+		return { EPixelOperation::Unpremultiply, nullptr, { 0.f, 0.f, 0.f, 0.f }, { 0.f, 0.f, 0.f, 0.f } };
+	}
+
+
+	/************************************************************************/
+	/*							FLOAT KERNELS                               */
+	/************************************************************************/
+
+	// All kernels work on Count floats, Count is a multiple of 4 (see GPixelChunkSize).
+	// B is either an operand chunk or a constant pattern of the same length.
+
+#if ENGINE_SIMD_SSE2
+	#define DEFINE_BINARY_KERNEL(Name, SimdExpr, ScalarExpr)						\
+	static void Name(float* X, const float* B, SIZE_T Count)						\
+	{																				\
+		for (SIZE_T i = 0; i < Count; i += 4)										\
+		{																			\
+			const __m128 a = _mm_loadu_ps(X + i);									\
+			const __m128 b = _mm_loadu_ps(B + i);									\
+			_mm_storeu_ps(X + i, SimdExpr);											\
+		}																			\
+	}
+#else
+	#define DEFINE_BINARY_KERNEL(Name, SimdExpr, ScalarExpr)						\
+	static void Name(float* X, const float* B, SIZE_T Count)						\
+	{																				\
+		for (SIZE_T i = 0; i < Count; ++i)											\
+		{																			\
+			const float a = X[i];													\
+			const float b = B[i];													\
+			X[i] = ScalarExpr;														\
+		}																			\
+	}
+#endif
+
+	DEFINE_BINARY_KERNEL(KernelAdd, _mm_add_ps(a, b), a + b)
+	DEFINE_BINARY_KERNEL(KernelSub, _mm_sub_ps(a, b), a - b)
+	DEFINE_BINARY_KERNEL(KernelMul, _mm_mul_ps(a, b), a * b)
+	DEFINE_BINARY_KERNEL(KernelMin, _mm_min_ps(a, b), (b < a) ? b : a)
+	DEFINE_BINARY_KERNEL(KernelMax, _mm_max_ps(a, b), (b > a) ? b : a)
+
+#undef DEFINE_BINARY_KERNEL
+
+	// X = X + (B - X) * T
+	static void KernelLerp(float* X, const float* B, const float* T, SIZE_T Count)
+	{
+		SIZE_T i = 0;
+
+#if ENGINE_SIMD_SSE2
+		for (; i < Count; i += 4)
+		{
+			const __m128 a = _mm_loadu_ps(X + i);
+			const __m128 d = _mm_sub_ps(_mm_loadu_ps(B + i), a);
+			_mm_storeu_ps(X + i, _mm_add_ps(a, _mm_mul_ps(d, _mm_loadu_ps(T + i))));
+		}
+#endif
+
+		for (; i < Count; ++i)
+		{
+			X[i] = X[i] + (B[i] - X[i]) * T[i];
+		}
+	}
+
+	// X = X * S + C (scale-bias) or clamp(X, S, C)
+	static void KernelScaleBias(float* X, const float* S, const float* C, SIZE_T Count)
+	{
+		SIZE_T i = 0;
+
+#if ENGINE_SIMD_SSE2
+		for (; i < Count; i += 4)
+		{
+			_mm_storeu_ps(X + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(X + i), _mm_loadu_ps(S + i)), _mm_loadu_ps(C + i)));
+		}
+#endif
+
+		for (; i < Count; ++i)
+		{
+			X[i] = X[i] * S[i] + C[i];
+		}
+	}
+
+	static void KernelClamp(float* X, const float* Low, const float* High, SIZE_T Count)
+	{
+		SIZE_T i = 0;
+
+#if ENGINE_SIMD_SSE2
+		for (; i < Count; i += 4)
+		{
+			_mm_storeu_ps(X + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(X + i), _mm_loadu_ps(Low + i)), _mm_loadu_ps(High + i)));
+		}
+#endif
+
+		for (; i < Count; ++i)
+		{
+			X[i] = std::min(std::max(X[i], Low[i]), High[i]);
+		}
+	}
+
+	static void KernelPremultiply(float* X, SIZE_T Count, uint32 Channels, bool bInverse)
+	{
+		SIZE_T i = 0;
+
+#if ENGINE_SIMD_SSE41
+		if (Channels == 4)
+		{
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.0f);
+
+			for (; i < Count; i += 4)
+			{
+				const __m128 pixel = _mm_loadu_ps(X + i);
+				__m128 alpha = _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3));
+
+				if (bInverse)
+				{
+					// 1 / alpha, or 1 where alpha is 0
+					alpha = _mm_blendv_ps(_mm_div_ps(one, alpha), one, _mm_cmpeq_ps(alpha, zero));
+				}
+
+				// keep alpha itself untouched
+				_mm_storeu_ps(X + i, _mm_blend_ps(_mm_mul_ps(pixel, alpha), pixel, 0x8));
+			}
+
+			return;
+		}
+#endif
+
+		for (; i < Count; i += Channels)
+		{
+			float alpha = X[i + Channels - 1];
+
+			if (bInverse)
+			{
+				alpha = (alpha != 0.0f) ? 1.0f / alpha : 1.0f;
+			}
+
+			for (uint32 c = 0; c + 1 < Channels; ++c)
+			{
+				X[i + c] *= alpha;
+			}
+		}
+	}
+
+
+	/************************************************************************/
+	/*						8-BIT INTEGER FAST PATHS                        */
+	/************************************************************************/
+
+	// Saturating integer arithmetic gives exactly the same result as the normalized float path
+	// for add, sub, min and max, without any conversion.
+	static bool TryApplyUInt8(const Image& InA, const SPixelOperation& InOperation, Image& InDest)
+	{
+		if (Details::GetChannelDataType(InA.GetFormat()) != EChannelDataType::UInt8
+			|| InOperation.Operand == nullptr
+			|| InOperation.Operand->GetFormat() != InA.GetFormat())
+		{
+			return false;
+		}
+
+		const uint8* a = reinterpret_cast<const uint8*>(InA.RawData());
+		const uint8* b = reinterpret_cast<const uint8*>(InOperation.Operand->RawData());
+		uint8* dest = reinterpret_cast<uint8*>(InDest.RawData());
+		const SIZE_T count = InA.GetPixelsCount() * InA.GetBytesPerPixel();
+
+		SIZE_T i = 0;
+
+		switch (InOperation.Operation)
+		{
+
+#if ENGINE_SIMD_SSE2
+	#define VECTOR_LOOP(expr)																	\
+			for (; i + 16 <= count; i += 16)													\
+			{																					\
+				const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));	\
+				const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));	\
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), expr);					\
+			}
+#else
+	#define VECTOR_LOOP(expr)
+#endif
+
+		case EPixelOperation::Add:
+			VECTOR_LOOP(_mm_adds_epu8(va, vb));
+			for (; i < count; ++i) dest[i] = static_cast<uint8>(std::min(a[i] + b[i], 255));
+			return true;
+
+		case EPixelOperation::Sub:
+			VECTOR_LOOP(_mm_subs_epu8(va, vb));
+			for (; i < count; ++i) dest[i] = static_cast<uint8>(std::max(a[i] - b[i], 0));
+			return true;
+
+		case EPixelOperation::Min:
+			VECTOR_LOOP(_mm_min_epu8(va, vb));
+			for (; i < count; ++i) dest[i] = std::min(a[i], b[i]);
+			return true;
+
+		case EPixelOperation::Max:
+			VECTOR_LOOP(_mm_max_epu8(va, vb));
+			for (; i < count; ++i) dest[i] = std::max(a[i], b[i]);
+			return true;
+
+#undef VECTOR_LOOP
+
+		default:
+			return false;
+		}
+	}
+
+
+	/************************************************************************/
+	/*								DRIVER                                  */
+	/************************************************************************/
+
+	// Repeats per-channel constants along a whole chunk.
+	static void BuildPattern(float* Pattern, const float* Constant, uint32 Channels)
+	{
+		for (SIZE_T i = 0; i < GPixelChunkSize; ++i)
+		{
+			Pattern[i] = Constant[i % Channels];
+		}
+	}
+
+	bool PixelOps::Apply(const Image& InA, Span<const SPixelOperation> InOperations, Image& InDest)
+	{
+		const uint32 channels = InA.GetChannelsCount();
+		const SIZE_T pixels = InA.GetPixelsCount();
+
+		if (!InA.IsInitialized() || channels == 0)
+		{
+			return false;
+		}
+
+		for (const auto& operation : InOperations)
+		{
+			if (operation.Operand != nullptr
+				&& (operation.Operand->GetSize() != InA.GetSize() || operation.Operand->GetChannelsCount() != channels))
+			{
+				JF_ASSERT(false, "Operand image should have the same size and channels count.");
+				return false;
+			}
+
+			if ((operation.Operation == EPixelOperation::Premultiply || operation.Operation == EPixelOperation::Unpremultiply)
+				&& !Details::HasAlphaChannel(InA.GetFormat()))
+			{
+				return false;
+			}
+		}
+
+		if (&InDest != &InA && (InDest.GetSize() != InA.GetSize() || InDest.GetFormat() != InA.GetFormat()))
+		{
+			// reallocating an operand would lose its pixels before they are read
+			for (const auto& operation : InOperations)
+			{
+				if (operation.Operand == &InDest)
+				{
+					Image result;
+
+					if (!Apply(InA, InOperations, result))
+					{
+						return false;
+					}
+
+					InDest = std::move(result);
+					return true;
+				}
+			}
+
+			InDest = Image(InA.GetSize(), InA.GetFormat());
+		}
+
+		if (InOperations.size() == 1 && TryApplyUInt8(InA, InOperations[0], InDest))
+		{
+			InDest.MarkInitialized();
+			return true;
+		}
+
+		// constant patterns are built once per operation
+		const SIZE_T operationsCount = InOperations.size();
+		JVector<float> patterns(operationsCount * 2 * GPixelChunkSize);
+
+		for (SIZE_T op = 0; op < operationsCount; ++op)
+		{
+			BuildPattern(&patterns[(op * 2 + 0) * GPixelChunkSize], InOperations[op].A, channels);
+			BuildPattern(&patterns[(op * 2 + 1) * GPixelChunkSize], InOperations[op].B, channels);
+		}
+
+		alignas(64) float chunk[GPixelChunkSize];
+		alignas(64) float operand[GPixelChunkSize];
+
+		const EChannelDataType sourceType = Details::GetChannelDataType(InA.GetFormat());
+		const SIZE_T channelSize = InA.GetBytesPerChannel();
+		const SIZE_T totalCount = pixels * channels;
+
+		for (SIZE_T offset = 0; offset < totalCount; offset += GPixelChunkSize)
+		{
+			const SIZE_T count = std::min(GPixelChunkSize, totalCount - offset);
+			const SIZE_T paddedCount = (count + 3) & ~SIZE_T(3);
+
+			Details::LoadChannels(InA.RawData() + offset * channelSize, sourceType, chunk, count);
+
+			for (SIZE_T op = 0; op < operationsCount; ++op)
+			{
+				const SPixelOperation& operation = InOperations[op];
+				const float* constA = &patterns[(op * 2 + 0) * GPixelChunkSize];
+				const float* constB = &patterns[(op * 2 + 1) * GPixelChunkSize];
+
+				const float* b = constA;
+
+				if (operation.Operand != nullptr)
+				{
+					const Image& operandImage = *operation.Operand;
+
+					Details::LoadChannels(
+											operandImage.RawData() + offset * operandImage.GetBytesPerChannel(),
+											Details::GetChannelDataType(operandImage.GetFormat()),
+											operand, count);
+					b = operand;
+				}
+
+				switch (operation.Operation)
+				{
+				case EPixelOperation::Add:				KernelAdd(chunk, b, paddedCount); break;
+				case EPixelOperation::Sub:				KernelSub(chunk, b, paddedCount); break;
+				case EPixelOperation::Mul:				KernelMul(chunk, b, paddedCount); break;
+				case EPixelOperation::Min:				KernelMin(chunk, b, paddedCount); break;
+				case EPixelOperation::Max:				KernelMax(chunk, b, paddedCount); break;
+				case EPixelOperation::Lerp:				KernelLerp(chunk, b, constA, paddedCount); break;
+				case EPixelOperation::Clamp:			KernelClamp(chunk, constA, constB, paddedCount); break;
+				case EPixelOperation::ScaleBias:		KernelScaleBias(chunk, constA, constB, paddedCount); break;
+				case EPixelOperation::Premultiply:		KernelPremultiply(chunk, count, channels, false); break;
+				case EPixelOperation::Unpremultiply:	KernelPremultiply(chunk, count, channels, true); break;
+				}
+			}
+
+			Details::StoreChannels(chunk, sourceType, InDest.RawData() + offset * channelSize, count);
+		}
+
+		InDest.MarkInitialized();
+
+		return true;
+	}
+
+
+	/************************************************************************/
+	/*							SINGLE OPERATIONS                           */
+	/************************************************************************/
+
+#define DEFINE_IMAGE_OPERATION(Name)														\
+	void PixelOps::Name(const Image& InA, const Image& InB, Image& InDest)					\
+	{																						\
+		const SPixelOperation operation = SPixelOperation::Make(EPixelOperation::Name, InB);	\
+		Apply(InA, Span<const SPixelOperation>(&operation, 1), InDest);						\
+	}																						\
+																							\
+	void PixelOps::Name(const Image& InA, Span<const float> InConstant, Image& InDest)		\
+	{																						\
+		const SPixelOperation operation = SPixelOperation::Make(EPixelOperation::Name, InConstant);	\
+		Apply(InA, Span<const SPixelOperation>(&operation, 1), InDest);						\
+	}
+
+	DEFINE_IMAGE_OPERATION(Add)
+	DEFINE_IMAGE_OPERATION(Sub)
+	DEFINE_IMAGE_OPERATION(Mul)
+	DEFINE_IMAGE_OPERATION(Min)
+	DEFINE_IMAGE_OPERATION(Max)
+
+#undef DEFINE_IMAGE_OPERATION
+
+	void PixelOps::Lerp(const Image& InA, const Image& InB, float InFactor, Image& InDest)
+	{
+		const SPixelOperation operation = SPixelOperation::MakeLerp(InB, InFactor);
+		Apply(InA, Span<const SPixelOperation>(&operation, 1), InDest);
+	}
+
+	void PixelOps::Lerp(const Image& InA, Span<const float> InConstant, float InFactor, Image& InDest)
+	{
+		const SPixelOperation operation = SPixelOperation::MakeLerp(InConstant, InFactor);
+		Apply(InA, Span<const SPixelOperation>(&operation, 1), InDest);
+	}
+
+	void PixelOps::Clamp(const Image& InA, Span<const float> InLow, Span<const float> InHigh, Image& InDest)
+	{
+		const SPixelOperation operation = SPixelOperation::MakeClamp(InLow, InHigh);
+		Apply(InA, Span<const SPixelOperation>(&operation, 1), InDest);
+	}
+
+	void PixelOps::ScaleBias(const Image& InA, Span<const float> InScale, Span<const float> InBias, Image& InDest)
+	{
+		const SPixelOperation operation = SPixelOperation::MakeScaleBias(InScale, InBias);
+		Apply(InA, Span<const SPixelOperation>(&operation, 1), InDest);
+	}
+
+	void PixelOps::Premultiply(const Image& InA, Image& InDest)
+	{
+		const SPixelOperation operation = SPixelOperation::MakePremultiply();
+		Apply(InA, Span<const SPixelOperation>(&operation, 1), InDest);
+	}
+
+	void PixelOps::Unpremultiply(const Image& InA, Image& InDest)
+	{
+		const SPixelOperation operation = SPixelOperation::MakeUnpremultiply();
+		Apply(InA, Span<const SPixelOperation>(&operation, 1), InDest);
+	}
+
+}
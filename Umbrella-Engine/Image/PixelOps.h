@@ -0,0 +1,128 @@
+#pragma once
+#include "Image.h"
+
+
+
+namespace J::Utils
+{
+
+	enum class EPixelOperation : uint8
+	{
+		Add,				// a + b
+		Sub,				// a - b
+		Mul,				// a * b
+		Min,				// min(a, b)
+		Max,				// max(a, b)
+		Lerp,				// a + (b - a) * t
+		Clamp,				// clamp(a, low, high)
+		ScaleBias,			// a * scale + bias
+		Premultiply,		// rgb * alpha
+		Unpremultiply,		// rgb / alpha (0 alpha leaves rgb untouched)
+	};
+
+
+	/**
+	 * Single step of a fused pixel operation.
+	 *
+	 * The second operand is either an image (Operand != nullptr) or per-channel constants stored in A.
+	 * Constants are given in the normalized domain: 8-bit images are treated as [0, 1] values.
+	 */
+	struct SPixelOperation
+	{
+		EPixelOperation		Operation;
+
+		const Image*		Operand;	//< second operand image, nullptr for constant variants
+
+		float				A[4];		//< operand constant / lerp factor / low bound / scale
+
+		float				B[4];		//< high bound / bias
+
+
+		static SPixelOperation Make(EPixelOperation InOperation, const Image& InOperand);
+
+		static SPixelOperation Make(EPixelOperation InOperation, Span<const float> InConstant);
+
+		static SPixelOperation MakeLerp(const Image& InOperand, float InFactor);
+
+		static SPixelOperation MakeLerp(Span<const float> InConstant, float InFactor);
+
+		static SPixelOperation MakeClamp(Span<const float> InLow, Span<const float> InHigh);
+
+		static SPixelOperation MakeScaleBias(Span<const float> InScale, Span<const float> InBias);
+
+		static SPixelOperation MakePremultiply();
+
+		static SPixelOperation MakeUnpremultiply();
+	};
+
+
+	/**
+	 * Per-pixel arithmetic over whole images.
+	 *
+	 * All kernels stream the source through a small float chunk that stays in L1 cache, so
+	 * every pixel gets loaded and stored exactly once whatever the number of fused operations.
+	 * Dest may be the same object as the source or an operand (in-place). Operand images must have the same
+	 * size and channels count as the source, but may use another channel data type.
+	 * Per-channel constants are broadcast when a single value is given.
+	 */
+	class PixelOps
+	{
+	public:
+
+		// image - image
+
+		static void Add(const Image& InA, const Image& InB, Image& InDest);
+
+		static void Sub(const Image& InA, const Image& InB, Image& InDest);
+
+		static void Mul(const Image& InA, const Image& InB, Image& InDest);
+
+		static void Min(const Image& InA, const Image& InB, Image& InDest);
+
+		static void Max(const Image& InA, const Image& InB, Image& InDest);
+
+		static void Lerp(const Image& InA, const Image& InB, float InFactor, Image& InDest);
+
+		// image - constant
+
+		static void Add(const Image& InA, Span<const float> InConstant, Image& InDest);
+
+		static void Sub(const Image& InA, Span<const float> InConstant, Image& InDest);
+
+		static void Mul(const Image& InA, Span<const float> InConstant, Image& InDest);
+
+		static void Min(const Image& InA, Span<const float> InConstant, Image& InDest);
+
+		static void Max(const Image& InA, Span<const float> InConstant, Image& InDest);
+
+		static void Lerp(const Image& InA, Span<const float> InConstant, float InFactor, Image& InDest);
+
+		static void Clamp(const Image& InA, Span<const float> InLow, Span<const float> InHigh, Image& InDest);
+
+		static void ScaleBias(const Image& InA, Span<const float> InScale, Span<const float> InBias, Image& InDest);
+
+		// alpha, only for images with alpha channel (LA8, RGBA8, RGBAH, RGBAF)
+
+		static void Premultiply(const Image& InA, Image& InDest);
+
+		static void Unpremultiply(const Image& InA, Image& InDest);
+
+		// in-place convenience
+
+		static void Premultiply(Image& InOutImage) { Premultiply(InOutImage, InOutImage); }
+
+		static void Unpremultiply(Image& InOutImage) { Unpremultiply(InOutImage, InOutImage); }
+
+		/**
+		 * Applies the given operations one after another in a single pass over the source.
+		 *
+		 * \param InA			- The source image.
+		 * \param InOperations	- The operations to apply, in order.
+		 * \param InDest		- The destination image, gets (re)allocated with the source size and format if needed.
+		 * \return				- false if the operations are not applicable to the source image.
+		 */
+		static bool Apply(const Image& InA, Span<const SPixelOperation> InOperations, Image& InDest);
+
+	};
+
+}
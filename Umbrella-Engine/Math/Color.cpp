@@ -1,4 +1,6 @@
 #include "Color.h"
+#include "ColorSpace.h"
+#include "Math.h"
 
 
 namespace J::Math
@@ -36,14 +38,30 @@ namespace J::Math
 	{
 		return Color
 					(
-						static_cast<uint8>(InColor.R() * MAX_UINT8),
-						static_cast<uint8>(InColor.B() * MAX_UINT8),
-						static_cast<uint8>(InColor.G() * MAX_UINT8),
-						static_cast<uint8>(InColor.A() * MAX_UINT8)
+						ColorSpace::LinearToSRGB8(InColor.R()),
+						ColorSpace::LinearToSRGB8(InColor.G()),
+						ColorSpace::LinearToSRGB8(InColor.B()),
+						Quantize(InColor).A()
 					);
 	}
 
+	Color LinearColor::Quantize(const LinearColor& InColor)
+	{
+		const auto quantize = [](float value) { return static_cast<uint8>(Clamp(value, 0.0f, 1.0f) * MAX_UINT8 + 0.5f); };
+
+		return Color(quantize(InColor.R()), quantize(InColor.G()), quantize(InColor.B()), quantize(InColor.A()));
+	}
+
 	LinearColor Color::ToLinearColor(const Color& InColor)
+	{
+		return LinearColor
+					(
+						ColorSpace::SRGB8ToLinear(InColor.R()), ColorSpace::SRGB8ToLinear(InColor.G()),
+						ColorSpace::SRGB8ToLinear(InColor.B()), OneOver255 * InColor.A()
+					);
+	}
+
+	LinearColor Color::Normalize(const Color& InColor)
 	{
 		return LinearColor
 					(
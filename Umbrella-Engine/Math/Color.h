@@ -16,17 +16,20 @@ namespace J::Math
 		{
 			uint8 channels[4];
 
-			// red component
-			uint8 r;
-		
-			// green component
-			uint8 g;
+			struct
+			{
+				// red component
+				uint8 r;
+
+				// green component
+				uint8 g;
 
-			// blue component
-			uint8 b;
+				// blue component
+				uint8 b;
 
-			// alpha (opacity) component
-			uint8 a;
+				// alpha (opacity) component
+				uint8 a;
+			};
 	
 		} color;
 
@@ -58,8 +61,16 @@ namespace J::Math
 
 		const uint8* GetValue() const { return color.channels; }
 
+		/**
+		 * Decodes sRGB color into linear space (alpha stays linear).
+		 */
 		static LinearColor ToLinearColor(const Color& InColor);
 
+		/**
+		 * Scales channels into [0, 1] without any transfer curve.
+		 */
+		static LinearColor Normalize(const Color& InColor);
+
 
 		static const Color White;
 		static const Color Black;
@@ -78,6 +89,8 @@ namespace J::Math
 
 	};
 
+	static_assert(sizeof(Color) == 4, "Color is expected to be tightly packed (RGBA8 pixel).");
+
 	class LinearColor
 	{
 	private:
@@ -86,10 +99,13 @@ namespace J::Math
 
 			float	channels[4];
 
-			float	r,
-					g,
-					b,
-					a;
+			struct
+			{
+				float	r,
+						g,
+						b,
+						a;
+			};
 
 		} color;
 
@@ -122,8 +138,16 @@ namespace J::Math
 		
 		const float* GetValue() const { return color.channels; }
 
+		/**
+		 * Encodes linear color into sRGB (alpha stays linear).
+		 */
 		static Color ToColor(const LinearColor& InColor);
 
+		/**
+		 * Quantizes channels into [0, 255] without any transfer curve.
+		 */
+		static Color Quantize(const LinearColor& InColor);
+
 		
 		static const LinearColor White;
 		static const LinearColor Gray;
@@ -136,6 +160,8 @@ namespace J::Math
 
 	};
 
+	static_assert(sizeof(LinearColor) == 16, "LinearColor is expected to be tightly packed (RGBAF pixel).");
+
 }
 
 
@@ -0,0 +1,277 @@
+#include "ColorSpace.h"
+#include "Color.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+
+
+namespace J::Math::ColorSpace
+{
+	static constexpr float OneOver255 = 1.0f / 255.0f;
+
+	// linear segment threshold of the sRGB curve, in linear space
+	static constexpr float LinearThreshold = 0.0031308f;
+
+	// x^(1/2.4) approximated with x^(1/2), x^(1/4) and x^(1/8) (fitted for the [0.0031308, 1] range)
+	static constexpr float EncodeC1 = 0.662002687f;
+	static constexpr float EncodeC2 = 0.684122060f;
+	static constexpr float EncodeC3 = -0.323583601f;
+	static constexpr float EncodeC4 = -0.0225411470f;
+
+
+	float SRGBToLinear(float InValue)
+	{
+		return (InValue <= 0.04045f)
+			? InValue / 12.92f
+			: std::pow((InValue + 0.055f) / 1.055f, 2.4f);
+	}
+
+	float LinearToSRGB(float InValue)
+	{
+		return (InValue <= LinearThreshold)
+			? InValue * 12.92f
+			: 1.055f * std::pow(InValue, 1.0f / 2.4f) - 0.055f;
+	}
+
+	const float* GetSRGBToLinearTable()
+	{
+		static const std::array<float, 256> table = []()
+		{
+			std::array<float, 256> result;
+
+			for (uint32 i = 0; i < 256; ++i)
+			{
+				result[i] = SRGBToLinear(i * OneOver255);
+			}
+
+			return result;
+		}();
+
+		return table.data();
+	}
+
+	static const uint8* GetSRGB8ToLinear8Table()
+	{
+		static const std::array<uint8, 256> table = []()
+		{
+			std::array<uint8, 256> result;
+
+			for (uint32 i = 0; i < 256; ++i)
+			{
+				result[i] = static_cast<uint8>(std::lround(SRGBToLinear(i * OneOver255) * 255.0f));
+			}
+
+			return result;
+		}();
+
+		return table.data();
+	}
+
+	static const uint8* GetLinear8ToSRGB8Table()
+	{
+		static const std::array<uint8, 256> table = []()
+		{
+			std::array<uint8, 256> result;
+
+			for (uint32 i = 0; i < 256; ++i)
+			{
+				result[i] = static_cast<uint8>(std::lround(LinearToSRGB(i * OneOver255) * 255.0f));
+			}
+
+			return result;
+		}();
+
+		return table.data();
+	}
+
+
+	/************************************************************************/
+	/*							ENCODE KERNELS                              */
+	/************************************************************************/
+
+	static INLINE float EncodeApproximate(float InValue)
+	{
+		const float x = std::min(std::max(InValue, 0.0f), 1.0f);
+
+		if (x < LinearThreshold)
+		{
+			return x * 12.92f;
+		}
+
+		const float s1 = std::sqrt(x);
+		const float s2 = std::sqrt(s1);
+		const float s3 = std::sqrt(s2);
+
+		return EncodeC1 * s1 + EncodeC2 * s2 + EncodeC3 * s3 + EncodeC4 * x;
+	}
+
+#if ENGINE_SIMD_SSE2
+	static INLINE __m128 EncodeApproximate(__m128 InValue)
+	{
+		const __m128 x = _mm_min_ps(_mm_max_ps(InValue, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+
+		const __m128 s1 = _mm_sqrt_ps(x);
+		const __m128 s2 = _mm_sqrt_ps(s1);
+		const __m128 s3 = _mm_sqrt_ps(s2);
+
+		__m128 curve = _mm_mul_ps(s1, _mm_set1_ps(EncodeC1));
+		curve = _mm_add_ps(curve, _mm_mul_ps(s2, _mm_set1_ps(EncodeC2)));
+		curve = _mm_add_ps(curve, _mm_mul_ps(s3, _mm_set1_ps(EncodeC3)));
+		curve = _mm_add_ps(curve, _mm_mul_ps(x, _mm_set1_ps(EncodeC4)));
+
+		const __m128 linear = _mm_mul_ps(x, _mm_set1_ps(12.92f));
+		const __m128 mask = _mm_cmplt_ps(x, _mm_set1_ps(LinearThreshold));
+
+		return _mm_or_ps(_mm_and_ps(mask, linear), _mm_andnot_ps(mask, curve));
+	}
+#endif
+
+	uint8 LinearToSRGB8(float InValue)
+	{
+		return static_cast<uint8>(EncodeApproximate(InValue) * 255.0f + 0.5f);
+	}
+
+
+	/************************************************************************/
+	/*							BULK CONVERSIONS                            */
+	/************************************************************************/
+
+	void SRGB8ToLinear(const uint8* Source, float* Dest, SIZE_T Count)
+	{
+		const float* table = GetSRGBToLinearTable();
+
+		for (SIZE_T i = 0; i < Count; ++i)
+		{
+			Dest[i] = table[Source[i]];
+		}
+	}
+
+	void LinearToSRGB8(const float* Source, uint8* Dest, SIZE_T Count)
+	{
+		SIZE_T i = 0;
+
+#if ENGINE_SIMD_SSE2
+		const __m128 scale = _mm_set1_ps(255.0f);
+
+		for (; i + 16 <= Count; i += 16)
+		{
+			const __m128i v0 = _mm_cvtps_epi32(_mm_mul_ps(EncodeApproximate(_mm_loadu_ps(Source + i + 0)), scale));
+			const __m128i v1 = _mm_cvtps_epi32(_mm_mul_ps(EncodeApproximate(_mm_loadu_ps(Source + i + 4)), scale));
+			const __m128i v2 = _mm_cvtps_epi32(_mm_mul_ps(EncodeApproximate(_mm_loadu_ps(Source + i + 8)), scale));
+			const __m128i v3 = _mm_cvtps_epi32(_mm_mul_ps(EncodeApproximate(_mm_loadu_ps(Source + i + 12)), scale));
+
+			const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(v0, v1), _mm_packs_epi32(v2, v3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dest + i), packed);
+		}
+#endif
+
+		for (; i < Count; ++i)
+		{
+			Dest[i] = LinearToSRGB8(Source[i]);
+		}
+	}
+
+	void SRGB8ToLinear8(const uint8* Source, uint8* Dest, SIZE_T Count)
+	{
+		const uint8* table = GetSRGB8ToLinear8Table();
+
+		for (SIZE_T i = 0; i < Count; ++i)
+		{
+			Dest[i] = table[Source[i]];
+		}
+	}
+
+	void Linear8ToSRGB8(const uint8* Source, uint8* Dest, SIZE_T Count)
+	{
+		const uint8* table = GetLinear8ToSRGB8Table();
+
+		for (SIZE_T i = 0; i < Count; ++i)
+		{
+			Dest[i] = table[Source[i]];
+		}
+	}
+
+	void SRGBToLinear(float* InOutValues, SIZE_T Count)
+	{
+		for (SIZE_T i = 0; i < Count; ++i)
+		{
+			InOutValues[i] = SRGBToLinear(InOutValues[i]);
+		}
+	}
+
+	void LinearToSRGB(float* InOutValues, SIZE_T Count)
+	{
+		SIZE_T i = 0;
+
+#if ENGINE_SIMD_SSE2
+		for (; i + 4 <= Count; i += 4)
+		{
+			_mm_storeu_ps(InOutValues + i, EncodeApproximate(_mm_loadu_ps(InOutValues + i)));
+		}
+#endif
+
+		for (; i < Count; ++i)
+		{
+			InOutValues[i] = EncodeApproximate(InOutValues[i]);
+		}
+	}
+
+
+	/************************************************************************/
+	/*								COLORS                                  */
+	/************************************************************************/
+
+	void ToLinear(Span<const Color> Source, Span<LinearColor> Dest)
+	{
+		JF_ASSERT(Dest.size() >= Source.size(), "Destination span is too small.");
+
+		const float* table = GetSRGBToLinearTable();
+
+		for (SIZE_T i = 0; i < Source.size(); ++i)
+		{
+			const uint8* channels = Source[i].GetValue();
+
+			Dest[i] = LinearColor(table[channels[0]], table[channels[1]], table[channels[2]], channels[3] * OneOver255);
+		}
+	}
+
+	void ToSRGB(Span<const LinearColor> Source, Span<Color> Dest)
+	{
+		JF_ASSERT(Dest.size() >= Source.size(), "Destination span is too small.");
+
+		SIZE_T i = 0;
+
+#if ENGINE_SIMD_SSE41
+		const __m128 scale = _mm_set1_ps(255.0f);
+		const __m128 zero = _mm_setzero_ps();
+
+		// one pixel per register, alpha lane gets quantized without the curve
+		for (; i + 4 <= Source.size(); i += 4)
+		{
+			__m128i pixels[4];
+
+			for (SIZE_T p = 0; p < 4; ++p)
+			{
+				const __m128 value = _mm_loadu_ps(Source[i + p].GetValue());
+				const __m128 alpha = _mm_min_ps(_mm_max_ps(value, zero), _mm_set1_ps(1.0f));
+				const __m128 encoded = _mm_blend_ps(EncodeApproximate(value), alpha, 0x8);
+
+				pixels[p] = _mm_cvtps_epi32(_mm_mul_ps(encoded, scale));
+			}
+
+			const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(pixels[0], pixels[1]), _mm_packs_epi32(pixels[2], pixels[3]));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&Dest[i]), packed);
+		}
+#endif
+
+		for (; i < Source.size(); ++i)
+		{
+			const LinearColor& color = Source[i];
+			const float alpha = std::min(std::max(color.A(), 0.0f), 1.0f);
+
+			Dest[i] = Color(LinearToSRGB8(color.R()), LinearToSRGB8(color.G()), LinearToSRGB8(color.B()), static_cast<uint8>(alpha * 255.0f + 0.5f));
+		}
+	}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "../Core.h"
+
+
+
+namespace J::Math
+{
+	class Color;
+	class LinearColor;
+}
+
+namespace J::Math::ColorSpace
+{
+	/**
+	 * sRGB transfer functions.
+	 *
+	 * Decoding 8-bit values goes through a 256-entry table, encoding uses a vectorized
+	 * approximation that rounds to the same 8-bit value as the exact curve (up to 1 code).
+	 * Alpha channels are always left linear.
+	 */
+
+	// Exact curves, for single values and for the bulk float decode.
+
+	float			SRGBToLinear(float InValue);
+
+	float			LinearToSRGB(float InValue);
+
+
+	// 8-bit paths
+
+	/** 256-entry sRGB -> linear decode table. */
+	const float*	GetSRGBToLinearTable();
+
+	INLINE float	SRGB8ToLinear(uint8 InValue) { return GetSRGBToLinearTable()[InValue]; }
+
+	uint8			LinearToSRGB8(float InValue);
+
+
+	// bulk conversions, Count is a number of values (not pixels)
+
+	void			SRGB8ToLinear(const uint8* Source, float* Dest, SIZE_T Count);
+
+	void			LinearToSRGB8(const float* Source, uint8* Dest, SIZE_T Count);
+
+	/** 8-bit sRGB -> 8-bit linear and back, table driven. Source and Dest may be the same. */
+	void			SRGB8ToLinear8(const uint8* Source, uint8* Dest, SIZE_T Count);
+
+	void			Linear8ToSRGB8(const uint8* Source, uint8* Dest, SIZE_T Count);
+
+	/** In-place float conversions (for half and float images). */
+	void			SRGBToLinear(float* InOutValues, SIZE_T Count);
+
+	/** Vectorized approximation: clamps to [0, 1] and is only exact to 8-bit precision, use LinearToSRGB(float) for more. */
+	void			LinearToSRGB(float* InOutValues, SIZE_T Count);
+
+
+	// colors
+
+	void			ToLinear(Span<const Color> Source, Span<LinearColor> Dest);
+
+	void			ToSRGB(Span<const LinearColor> Source, Span<Color> Dest);
+
+}
@@ -1,12 +1,109 @@
 #include "Float16.h"
+#include "../Common/SIMD.h"
+#include <bit>
+#include <utility>
 
 
 namespace J
 {
+	uint16 Float16::FloatToHalfBits(float InValue)
+	{
+		uint32 bits = std::bit_cast<uint32>(InValue);
+		const uint32 sign = (bits >> 16) & 0x8000;
+		
+		bits &= 0x7FFFFFFF;
+
+		uint32 result;
+
+		if (bits >= 0x47800000)
+		{
+			// out of half range: Inf or NaN (keep NaN quiet)
+			result = (bits > 0x7F800000) ? 0x7E00 : 0x7C00;
+		}
+		else if (bits < 0x38800000)
+		{
+			// half denormal or zero, let FPU do the rounding with a magic number
+			const float magic = std::bit_cast<float>(uint32(126) << 23);
+			result = std::bit_cast<uint32>(std::bit_cast<float>(bits) + magic) - std::bit_cast<uint32>(magic);
+		}
+		else
+		{
+			const uint32 mantissaOdd = (bits >> 13) & 1;
+
+			bits += (uint32(15 - 127) << 23) + 0xFFF;	// rebias exponent and round
+			bits += mantissaOdd;
+
+			result = bits >> 13;
+		}
+
+		return static_cast<uint16>(result | sign);
+	}
+
+	float Float16::HalfBitsToFloat(uint16 InBits)
+	{
+		constexpr uint32 shiftedExponent = 0x7C00 << 13;
+
+		uint32 bits = (InBits & 0x7FFF) << 13;
+		const uint32 exponent = shiftedExponent & bits;
+
+		bits += uint32(127 - 15) << 23;
+
+		if (exponent == shiftedExponent)
+		{
+			// Inf or NaN
+			bits += uint32(128 - 16) << 23;
+		}
+		else if (exponent == 0)
+		{
+			// zero or denormal, renormalize
+			bits += 1 << 23;
+			bits = std::bit_cast<uint32>(std::bit_cast<float>(bits) - std::bit_cast<float>(uint32(113) << 23));
+		}
+
+		bits |= uint32(InBits & 0x8000) << 16;
+
+		return std::bit_cast<float>(bits);
+	}
+
+	void Float16::ToFloat(const Float16* Source, float* Dest, SIZE_T Count)
+	{
+		SIZE_T i = 0;
+
+#if ENGINE_SIMD_F16C
+		for (; i + 8 <= Count; i += 8)
+		{
+			const __m128i halfs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + i));
+			_mm256_storeu_ps(Dest + i, _mm256_cvtph_ps(halfs));
+		}
+#endif
+
+		for (; i < Count; ++i)
+		{
+			Dest[i] = HalfBitsToFloat(Source[i].Value);
+		}
+	}
+
+	void Float16::FromFloat(const float* Source, Float16* Dest, SIZE_T Count)
+	{
+		SIZE_T i = 0;
+
+#if ENGINE_SIMD_F16C
+		for (; i + 8 <= Count; i += 8)
+		{
+			const __m128i halfs = _mm256_cvtps_ph(_mm256_loadu_ps(Source + i), _MM_FROUND_TO_NEAREST_INT);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dest + i), halfs);
+		}
+#endif
+
+		for (; i < Count; ++i)
+		{
+			Dest[i].Value = FloatToHalfBits(Source[i]);
+		}
+	}
+
 	Float16::Float16(float InValue)
 	{
-		// #todo: perform necessary checks and set;
-		this->Value = (float)InValue;
+		this->Value = FloatToHalfBits(InValue);
 	}
 
 	Float16::Float16(const Float16& another)
@@ -20,7 +117,7 @@ namespace J
 		another.Value = 0;
 	}
 
-	inline Float16& Float16::operator=(const Float16& another)
+	Float16& Float16::operator=(const Float16& another)
 	{
 		if (this != &another)
 		{
@@ -30,7 +127,7 @@ namespace J
 		return *this;
 	}
 
-	inline Float16& Float16::operator=(Float16&& another)
+	Float16& Float16::operator=(Float16&& another)
 	{
 		this->Value = another.Value;
 		another.Value = 0;
@@ -38,8 +135,8 @@ namespace J
 		return *this;
 	}
 
-	inline Float16::operator float() const
+	Float16::operator float() const
 	{
-		// #todo Make it work
+		return HalfBitsToFloat(this->Value);
 	}
 }
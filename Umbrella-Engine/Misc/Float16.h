@@ -43,8 +43,28 @@ namespace J
 		operator float() const;
 
 		auto operator <=> (const Float16& another) const = default;		// automatically generates all six comparison operators
+
+		/**
+		 * Bit-exact conversions (round to nearest even, Inf/NaN/denormals preserved).
+		 */
+		static uint16	FloatToHalfBits(float InValue);
+
+		static float	HalfBitsToFloat(uint16 InBits);
+
+		/**
+		 * Bulk conversions. Use F16C instructions when the engine is compiled with them.
+		 * 
+		 * \param Source	- The values to convert.
+		 * \param Dest		- The destination storage, at least Count elements.
+		 * \param Count		- Number of values to convert.
+		 */
+		static void		ToFloat(const Float16* Source, float* Dest, SIZE_T Count);
+
+		static void		FromFloat(const float* Source, Float16* Dest, SIZE_T Count);
 	};
 
+	static_assert(sizeof(Float16) == 2, "Float16 is expected to be tightly packed.");
+
 
 
 
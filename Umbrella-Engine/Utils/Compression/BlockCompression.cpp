@@ -0,0 +1,619 @@
+#include "BlockCompression.h"
+#include "../Threading/ThreadPool.h"
+#include <algorithm>
+#include <bit>
+
+
+
+namespace J::Compression
+{
+
+	// LZ4 block format limits
+	static constexpr SIZE_T GMinMatch = 4;
+	static constexpr SIZE_T GLastLiterals = 5;			// a block always ends with at least 5 literals
+	static constexpr SIZE_T GMatchSearchLimit = 12;		// no match starts in the last 12 bytes
+	static constexpr SIZE_T GMaxOffset = 65535;
+
+	// 8K entries (32 KiB), small enough to be cleared for every block
+	static constexpr uint32 GHashLog = 13;
+
+	// the decoder copies in 8 / 16 byte chunks (writing past the sequence) while this far from the buffer ends
+	static constexpr SIZE_T GFastPathMargin = 32;
+
+	static constexpr uint32 GStoredBlockFlag = 0x80000000u;
+
+	// at least this much data per ParallelFor chunk
+	static constexpr SIZE_T GParallelGrainBytes = SIZE_T(1) << 20;
+
+
+	template<class T>
+	static FORCEINLINE T Load(const uint8* Data)
+	{
+		T value;
+		Memory::Memcpy(Data, &value, sizeof(T));
+
+		return value;
+	}
+
+	static FORCEINLINE uint32 HashSequence(uint32 InSequence)
+	{
+		return (InSequence * 2654435761u) >> (32 - GHashLog);
+	}
+
+	/** Number of equal bytes from InLeft / InRight, InLeft stops at InLimit. */
+	static FORCEINLINE SIZE_T CountMatch(const uint8* InLeft, const uint8* InRight, const uint8* InLimit)
+	{
+		const uint8* start = InLeft;
+
+		while (InLeft + 8 <= InLimit)
+		{
+			const uint64 difference = Load<uint64>(InLeft) ^ Load<uint64>(InRight);
+
+			if (difference != 0)
+			{
+				const int32 bits = (std::endian::native == std::endian::little) ? std::countr_zero(difference) : std::countl_zero(difference);
+
+				return static_cast<SIZE_T>(InLeft - start) + static_cast<SIZE_T>(bits >> 3);
+			}
+
+			InLeft += 8;
+			InRight += 8;
+		}
+
+		while (InLeft < InLimit && *InLeft == *InRight)
+		{
+			++InLeft;
+			++InRight;
+		}
+
+		return static_cast<SIZE_T>(InLeft - start);
+	}
+
+	/** Length above the 15 of a token nibble: runs of 255 and a final byte below 255. */
+	static FORCEINLINE uint8* WriteLength(uint8* Output, SIZE_T InLength)
+	{
+		for (; InLength >= 255; InLength -= 255)
+		{
+			*Output++ = 255;
+		}
+
+		*Output++ = static_cast<uint8>(InLength);
+
+		return Output;
+	}
+
+	static FORCEINLINE bool ReadLength(const uint8*& Input, const uint8* InEnd, SIZE_T& Length)
+	{
+		uint32 value;
+
+		do
+		{
+			if (Input >= InEnd)
+			{
+				return false;
+			}
+
+			value = *Input++;
+			Length += value;
+		}
+		while (value == 255);
+
+		return true;
+	}
+
+	/**
+	 * Copies a match closer than 8 bytes back, writing up to 8 bytes past InLength. The first 8 bytes are
+	 * assembled from the period, the rest is copied 8 bytes at a time from a whole number of periods (at least 8) back.
+	 */
+	static FORCEINLINE void CopyShortPeriod(uint8* Output, SIZE_T InOffset, SIZE_T InLength)
+	{
+		// per offset: where the second 4 bytes are read from, then how far back the 8-byte copies read
+		static constexpr uint8 GSecondHalfShift[8] = { 0, 1, 2, 1, 0, 4, 4, 4 };
+		static constexpr uint8 GPeriodsDistance[8] = { 0, 8, 8, 9, 8, 10, 12, 14 };
+
+		const uint8* match = Output - InOffset;
+
+		Output[0] = match[0];
+		Output[1] = match[1];
+		Output[2] = match[2];
+		Output[3] = match[3];
+		Memory::Memcpy(match + GSecondHalfShift[InOffset], Output + 4, 4);
+
+		const SIZE_T distance = GPeriodsDistance[InOffset];
+
+		for (SIZE_T i = 8; i < InLength; i += 8)
+		{
+			Memory::Memcpy(Output + i - distance, Output + i, 8);
+		}
+	}
+
+	static uint8* WriteLiterals(uint8* Output, const uint8* InLiterals, SIZE_T InLiteralsCount, uint8*& OutToken)
+	{
+		OutToken = Output++;
+		*OutToken = static_cast<uint8>(std::min<SIZE_T>(InLiteralsCount, 15) << 4);
+
+		if (InLiteralsCount >= 15)
+		{
+			Output = WriteLength(Output, InLiteralsCount - 15);
+		}
+
+		if (InLiteralsCount != 0)
+		{
+			Memory::Memcpy(InLiterals, Output, InLiteralsCount);
+		}
+
+		return Output + InLiteralsCount;
+	}
+
+	SIZE_T CompressBlock(const void* InData, SIZE_T InSize, void* OutData)
+	{
+		JF_ASSERT(InSize <= (SIZE_T(1) << 31), "Block is too large.");
+
+		const uint8* source = static_cast<const uint8*>(InData);
+		const uint8* end = source + InSize;
+		const uint8* anchor = source;
+
+		uint8* output = static_cast<uint8*>(OutData);
+		uint8* token;
+
+		if (InSize > GMatchSearchLimit)
+		{
+			// positions of the last 4-byte sequences seen, 0 doubles as "empty" and is verified like any candidate
+			uint32 table[1u << GHashLog] = {};
+
+			const uint8* matchLimit = end - GMatchSearchLimit;
+			const uint8* matchEnd = end - GLastLiterals;
+			const uint8* input = source + 1;
+
+			while (true)
+			{
+				const uint8* match = nullptr;
+
+				// the step grows while nothing matches, so incompressible data is skipped quickly
+				for (uint32 attempts = 1u << 6; input < matchLimit; input += attempts++ >> 6)
+				{
+					const uint32 sequence = Load<uint32>(input);
+					const uint32 hash = HashSequence(sequence);
+
+					const uint8* candidate = source + table[hash];
+					table[hash] = static_cast<uint32>(input - source);
+
+					if (candidate < input && static_cast<SIZE_T>(input - candidate) <= GMaxOffset && Load<uint32>(candidate) == sequence)
+					{
+						match = candidate;
+						break;
+					}
+				}
+
+				if (match == nullptr)
+				{
+					break;
+				}
+
+				while (input > anchor && match > source && input[-1] == match[-1])
+				{
+					--input;
+					--match;
+				}
+
+				const SIZE_T matchLength = GMinMatch + CountMatch(input + GMinMatch, match + GMinMatch, matchEnd);
+				const SIZE_T offset = static_cast<SIZE_T>(input - match);
+
+				output = WriteLiterals(output, anchor, static_cast<SIZE_T>(input - anchor), token);
+
+				*output++ = static_cast<uint8>(offset);
+				*output++ = static_cast<uint8>(offset >> 8);
+
+				*token |= static_cast<uint8>(std::min<SIZE_T>(matchLength - GMinMatch, 15));
+
+				if (matchLength - GMinMatch >= 15)
+				{
+					output = WriteLength(output, matchLength - GMinMatch - 15);
+				}
+
+				input += matchLength;
+				anchor = input;
+
+				// the positions inside the match are skipped, one close to its end is remembered
+				if (input < matchLimit)
+				{
+					table[HashSequence(Load<uint32>(input - 2))] = static_cast<uint32>(input - 2 - source);
+				}
+			}
+		}
+
+		output = WriteLiterals(output, anchor, static_cast<SIZE_T>(end - anchor), token);
+
+		return static_cast<SIZE_T>(output - static_cast<uint8*>(OutData));
+	}
+
+	SIZE_T DecompressBlock(const void* InData, SIZE_T InSize, void* OutData, SIZE_T InCapacity)
+	{
+		const uint8* input = static_cast<const uint8*>(InData);
+		const uint8* inputEnd = input + InSize;
+
+		uint8* const outputStart = static_cast<uint8*>(OutData);
+		uint8* const outputEnd = outputStart + InCapacity;
+		uint8* output = outputStart;
+
+		while (true)
+		{
+			if (input >= inputEnd)
+			{
+				return InvalidSize;
+			}
+
+			const uint32 token = *input++;
+
+			SIZE_T literals = token >> 4;
+
+			// most sequences have less than 15 literals: one fixed-size copy
+			if (literals != 15 && static_cast<SIZE_T>(inputEnd - input) >= GFastPathMargin && static_cast<SIZE_T>(outputEnd - output) >= GFastPathMargin)
+			{
+				Memory::Memcpy(input, output, 16);
+			}
+			else
+			{
+				if (literals == 15 && !ReadLength(input, inputEnd, literals))
+				{
+					return InvalidSize;
+				}
+
+				if (static_cast<SIZE_T>(inputEnd - input) >= literals + GFastPathMargin && static_cast<SIZE_T>(outputEnd - output) >= literals + GFastPathMargin)
+				{
+					for (SIZE_T i = 0; i < literals; i += 16)
+					{
+						Memory::Memcpy(input + i, output + i, 16);
+					}
+				}
+				else if (literals <= static_cast<SIZE_T>(inputEnd - input) && literals <= static_cast<SIZE_T>(outputEnd - output))
+				{
+					if (literals != 0)
+					{
+						Memory::Memcpy(input, output, literals);
+					}
+				}
+				else
+				{
+					return InvalidSize;
+				}
+			}
+
+			input += literals;
+			output += literals;
+
+			// the last sequence has no match
+			if (input == inputEnd)
+			{
+				return static_cast<SIZE_T>(output - outputStart);
+			}
+
+			if (inputEnd - input < 2)
+			{
+				return InvalidSize;
+			}
+
+			const SIZE_T offset = static_cast<SIZE_T>(input[0]) | (static_cast<SIZE_T>(input[1]) << 8);
+			input += 2;
+
+			if (offset == 0 || offset > static_cast<SIZE_T>(output - outputStart))
+			{
+				return InvalidSize;
+			}
+
+			SIZE_T length = token & 15;
+
+			// short matches (up to 18 bytes): fixed-size copies, none overlapping itself
+			if (length != 15 && static_cast<SIZE_T>(outputEnd - output) >= GFastPathMargin)
+			{
+				length += GMinMatch;
+
+				if (offset >= 8)
+				{
+					const uint8* match = output - offset;
+
+					Memory::Memcpy(match, output, 8);
+					Memory::Memcpy(match + 8, output + 8, 8);
+					Memory::Memcpy(match + 16, output + 16, 2);
+				}
+				else
+				{
+					CopyShortPeriod(output, offset, length);
+				}
+
+				output += length;
+				continue;
+			}
+
+			if (length == 15 && !ReadLength(input, inputEnd, length))
+			{
+				return InvalidSize;
+			}
+
+			length += GMinMatch;
+
+			const uint8* match = output - offset;
+
+			if (static_cast<SIZE_T>(outputEnd - output) >= length + GFastPathMargin)
+			{
+				if (offset >= 16)
+				{
+					for (SIZE_T i = 0; i < length; i += 16)
+					{
+						Memory::Memcpy(match + i, output + i, 16);
+					}
+				}
+				else if (offset >= 8)
+				{
+					for (SIZE_T i = 0; i < length; i += 8)
+					{
+						Memory::Memcpy(match + i, output + i, 8);
+					}
+				}
+				else
+				{
+					CopyShortPeriod(output, offset, length);
+				}
+			}
+			else
+			{
+				if (length > static_cast<SIZE_T>(outputEnd - output))
+				{
+					return InvalidSize;
+				}
+
+				for (SIZE_T i = 0; i < length; ++i)
+				{
+					output[i] = match[i];
+				}
+			}
+
+			output += length;
+		}
+	}
+
+
+	/****/
+	/* BLOCK STREAM */
+	/****/
+
+	JVector<byte> Compress(Span<const byte> InData, SIZE_T InBlockSize, bool bInParallel)
+	{
+		JF_ASSERT(InBlockSize > 0 && InBlockSize <= MaxBlockSize, "Invalid compression block size.");
+
+		const SIZE_T blocksCount = (InData.size() + InBlockSize - 1) / InBlockSize;
+		const SIZE_T headerSize = sizeof(SBlockStreamHeader) + blocksCount * sizeof(uint32);
+		const SIZE_T slotSize = GetCompressBound(InBlockSize);
+
+		// every block is compressed into its own worst-case slot, then the slots are packed
+		JVector<byte> output(headerSize + blocksCount * slotSize);
+		JVector<uint32> blockSizes(blocksCount);
+
+		auto compressBlocks = [&](SIZE_T InBegin, SIZE_T InEnd)
+		{
+			for (SIZE_T block = InBegin; block < InEnd; ++block)
+			{
+				const SIZE_T offset = block * InBlockSize;
+				const SIZE_T size = std::min(InBlockSize, InData.size() - offset);
+
+				byte* slot = output.data() + headerSize + block * slotSize;
+				const SIZE_T compressedSize = CompressBlock(InData.data() + offset, size, slot);
+
+				// blocks that don't shrink are stored as is and cost a plain copy to read
+				if (compressedSize >= size)
+				{
+					Memory::Memcpy(InData.data() + offset, slot, size);
+					blockSizes[block] = static_cast<uint32>(size) | GStoredBlockFlag;
+				}
+				else
+				{
+					blockSizes[block] = static_cast<uint32>(compressedSize);
+				}
+			}
+		};
+
+		if (bInParallel)
+		{
+			Utils::ParallelFor(blocksCount, std::max<SIZE_T>(1, GParallelGrainBytes / InBlockSize), compressBlocks);
+		}
+		else
+		{
+			compressBlocks(0, blocksCount);
+		}
+
+		SIZE_T position = headerSize;
+
+		for (SIZE_T block = 0; block < blocksCount; ++block)
+		{
+			const SIZE_T size = blockSizes[block] & ~GStoredBlockFlag;
+
+			Memory::Memmove(output.data() + headerSize + block * slotSize, output.data() + position, size);
+			position += size;
+		}
+
+		const SBlockStreamHeader header = { SBlockStreamHeader::MagicValue, static_cast<uint32>(InBlockSize), InData.size() };
+
+		Memory::Memcpy(&header, output.data(), sizeof(header));
+
+		if (blocksCount != 0)
+		{
+			Memory::Memcpy(blockSizes.data(), output.data() + sizeof(header), blocksCount * sizeof(uint32));
+		}
+
+		output.resize(position);
+
+		return output;
+	}
+
+	SIZE_T GetDecompressedSize(Span<const byte> InData)
+	{
+		SBlockStreamHeader header;
+
+		if (InData.size() < sizeof(header))
+		{
+			return InvalidSize;
+		}
+
+		Memory::Memcpy(InData.data(), &header, sizeof(header));
+
+		return (header.Magic == SBlockStreamHeader::MagicValue) ? static_cast<SIZE_T>(header.Size) : InvalidSize;
+	}
+
+	bool Decompress(Span<const byte> InData, byte* OutData, bool bInParallel)
+	{
+		const BlockStreamReader reader(InData);
+
+		if (!reader.IsValid())
+		{
+			return false;
+		}
+
+		Atomic::TAtomicBool bSucceeded { true };
+
+		auto decompressBlocks = [&](SIZE_T InBegin, SIZE_T InEnd)
+		{
+			for (SIZE_T block = InBegin; block < InEnd; ++block)
+			{
+				if (!reader.ReadBlock(block, OutData + block * reader.GetBlockSize()))
+				{
+					bSucceeded.store(false, std::memory_order_relaxed);
+				}
+			}
+		};
+
+		if (bInParallel)
+		{
+			Utils::ParallelFor(reader.GetBlocksCount(), std::max<SIZE_T>(1, GParallelGrainBytes / reader.GetBlockSize()), decompressBlocks);
+		}
+		else
+		{
+			decompressBlocks(0, reader.GetBlocksCount());
+		}
+
+		return bSucceeded.load();
+	}
+
+
+	BlockStreamReader::BlockStreamReader(Span<const byte> InData)
+		: Data(InData)
+	{
+		SBlockStreamHeader header;
+
+		if (InData.size() < sizeof(header))
+		{
+			return;
+		}
+
+		Memory::Memcpy(InData.data(), &header, sizeof(header));
+
+		if (header.Magic != SBlockStreamHeader::MagicValue || header.BlockSize == 0 || header.BlockSize > MaxBlockSize)
+		{
+			return;
+		}
+
+		// counted without rounding up first, a damaged size can't overflow
+		const uint64 blocksCount = header.Size / header.BlockSize + (header.Size % header.BlockSize != 0 ? 1 : 0);
+
+		if (blocksCount > (InData.size() - sizeof(header)) / sizeof(uint32))
+		{
+			return;
+		}
+
+		const uint64 headerSize = sizeof(header) + blocksCount * sizeof(uint32);
+
+		BlockOffsets.resize(static_cast<SIZE_T>(blocksCount) + 1);
+		BlockOffsets[0] = headerSize;
+
+		for (SIZE_T block = 0; block < blocksCount; ++block)
+		{
+			const uint32 stored = Load<uint32>(reinterpret_cast<const uint8*>(InData.data()) + sizeof(header) + block * sizeof(uint32));
+			const uint64 expectedSize = std::min<uint64>(header.BlockSize, header.Size - block * header.BlockSize);
+
+			if ((stored & GStoredBlockFlag) != 0 && (stored & ~GStoredBlockFlag) != expectedSize)
+			{
+				BlockOffsets.clear();
+				return;
+			}
+
+			BlockOffsets[block + 1] = BlockOffsets[block] + (stored & ~GStoredBlockFlag);
+		}
+
+		if (BlockOffsets.back() > InData.size())
+		{
+			BlockOffsets.clear();
+			return;
+		}
+
+		Size = header.Size;
+		BlockSize = header.BlockSize;
+		bValid = true;
+	}
+
+	bool BlockStreamReader::ReadBlock(SIZE_T InIndex, byte* OutData) const
+	{
+		if (!bValid || InIndex >= GetBlocksCount())
+		{
+			return false;
+		}
+
+		const SIZE_T expectedSize = static_cast<SIZE_T>(std::min<uint64>(BlockSize, Size - static_cast<uint64>(InIndex) * BlockSize));
+
+		const byte* block = Data.data() + BlockOffsets[InIndex];
+		const SIZE_T storedSize = static_cast<SIZE_T>(BlockOffsets[InIndex + 1] - BlockOffsets[InIndex]);
+
+		const uint32 flags = Load<uint32>(reinterpret_cast<const uint8*>(Data.data()) + sizeof(SBlockStreamHeader) + InIndex * sizeof(uint32));
+
+		if ((flags & GStoredBlockFlag) != 0)
+		{
+			Memory::Memcpy(block, OutData, expectedSize);
+			return true;
+		}
+
+		return DecompressBlock(block, storedSize, OutData, expectedSize) == expectedSize;
+	}
+
+	bool BlockStreamReader::Read(uint64 InOffset, SIZE_T InSize, byte* OutData) const
+	{
+		if (!bValid || InOffset > Size || InSize > Size - InOffset)
+		{
+			return false;
+		}
+
+		JVector<byte> partial;
+
+		while (InSize > 0)
+		{
+			const SIZE_T block = static_cast<SIZE_T>(InOffset / BlockSize);
+			const SIZE_T inBlock = static_cast<SIZE_T>(InOffset % BlockSize);
+			const SIZE_T blockEnd = static_cast<SIZE_T>(std::min<uint64>(BlockSize, Size - static_cast<uint64>(block) * BlockSize));
+			const SIZE_T count = std::min(InSize, blockEnd - inBlock);
+
+			if (inBlock == 0 && count == blockEnd)
+			{
+				// whole blocks go straight to the destination
+				if (!ReadBlock(block, OutData))
+				{
+					return false;
+				}
+			}
+			else
+			{
+				partial.resize(BlockSize);
+
+				if (!ReadBlock(block, partial.data()))
+				{
+					return false;
+				}
+
+				Memory::Memcpy(partial.data() + inBlock, OutData, count);
+			}
+
+			InOffset += count;
+			InSize -= count;
+			OutData += count;
+		}
+
+		return true;
+	}
+
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include "../../Core.h"
+
+
+namespace J::Compression
+{
+
+	/** Returned by the decompression functions for damaged input. */
+	static constexpr SIZE_T InvalidSize = ~static_cast<SIZE_T>(0);
+
+	static constexpr SIZE_T DefaultBlockSize = SIZE_T(64) << 10;
+
+	static constexpr SIZE_T MaxBlockSize = SIZE_T(4) << 20;
+
+
+	/** Largest compressed size of InSize bytes (incompressible input grows slightly). */
+	constexpr SIZE_T GetCompressBound(SIZE_T InSize)
+	{
+		return InSize + InSize / 255 + 16;
+	}
+
+	/**
+	 * Compresses one block in the LZ4 block format (greedy matcher over a hash of the last positions, 64 KiB window).
+	 *
+	 * \param InData		- Bytes to compress, at most 2 GiB.
+	 * \param InSize		- Number of bytes.
+	 * \param OutData		- Receives the block, at least GetCompressBound(InSize) bytes.
+	 * \return compressed size.
+	 */
+	SIZE_T CompressBlock(const void* InData, SIZE_T InSize, void* OutData);
+
+	/**
+	 * Decompresses one LZ4 block. Every read and write is bounds checked, damaged input can't overrun the buffers.
+	 *
+	 * \param InCapacity - Size of OutData.
+	 * \return decompressed size, InvalidSize if the block is damaged or doesn't fit.
+	 */
+	SIZE_T DecompressBlock(const void* InData, SIZE_T InSize, void* OutData, SIZE_T InCapacity);
+
+
+	/**
+	 * Seekable stream of independently compressed blocks:
+	 *
+	 *		SBlockStreamHeader
+	 *		uint32 BlockSizes[BlocksCount]		compressed sizes, the high bit marks blocks stored as is
+	 *		blocks
+	 *
+	 * Any block can be decompressed on its own, so ranges are read without touching the rest
+	 * and blocks are (de)compressed on several threads.
+	 */
+	struct SBlockStreamHeader
+	{
+		static constexpr uint32 MagicValue = 0x425A4C4A;	// "JLZB"
+
+		uint32		Magic;
+
+		uint32		BlockSize;
+
+		uint64		Size;
+	};
+
+	/**
+	 * \param InBlockSize	- Uncompressed size of the blocks (the last may be shorter), up to MaxBlockSize.
+	 * \param bInParallel	- Compresses the blocks on the engine thread pool.
+	 */
+	JVector<byte> Compress(Span<const byte> InData, SIZE_T InBlockSize = DefaultBlockSize, bool bInParallel = true);
+
+	/** Uncompressed size of a block stream, InvalidSize if InData is not one. */
+	SIZE_T GetDecompressedSize(Span<const byte> InData);
+
+	/**
+	 * Decompresses a whole block stream.
+	 *
+	 * \param OutData		- GetDecompressedSize bytes.
+	 * \param bInParallel	- Decompresses the blocks on the engine thread pool.
+	 * \return false if the stream is damaged.
+	 */
+	bool Decompress(Span<const byte> InData, byte* OutData, bool bInParallel = true);
+
+
+	/**
+	 * Random access into a block stream: only the blocks overlapping a range are decompressed.
+	 * The stream is referenced, not copied.
+	 */
+	class BlockStreamReader
+	{
+	public:
+
+		BlockStreamReader() = default;
+
+		/** Validates the header and the block table, see IsValid. */
+		explicit BlockStreamReader(Span<const byte> InData);
+
+		bool IsValid() const { return bValid; }
+
+		/** Uncompressed size. */
+		uint64 GetSize() const { return Size; }
+
+		SIZE_T GetBlockSize() const { return BlockSize; }
+
+		SIZE_T GetBlocksCount() const { return BlockOffsets.empty() ? 0 : BlockOffsets.size() - 1; }
+
+		/**
+		 * Decompresses one block.
+		 *
+		 * \param OutData - At least GetBlockSize() bytes.
+		 * \return false if the block is damaged.
+		 */
+		bool ReadBlock(SIZE_T InIndex, byte* OutData) const;
+
+		/**
+		 * Decompresses [InOffset, InOffset + InSize) of the uncompressed data.
+		 *
+		 * \return false if the range is out of bounds or a block is damaged.
+		 */
+		bool Read(uint64 InOffset, SIZE_T InSize, byte* OutData) const;
+
+	private:
+
+		Span<const byte>	Data;
+
+		// where each block starts in Data, one more entry marks the end of the last block
+		JVector<uint64>		BlockOffsets;
+
+		uint64				Size		= 0;
+
+		SIZE_T				BlockSize	= 0;
+
+		bool				bValid		= false;
+	};
+
+}
@@ -180,10 +180,10 @@ namespace J::Utils
 
 		int32 DecRefCount( const _ResRef& ref )
 		{
-			JF_ASSERT( IsInUse( ref ), "Cannot increment invalid resource." );
+			JF_ASSERT( IsInUse( ref ), "Cannot decrement invalid resource." );
 			SData& data = Resources[IdToIndex( ref )];
 
-			int32 newRefCount = ++data.RefCount;
+			int32 newRefCount = --data.RefCount;
 
 			JF_ASSERT( newRefCount >= 0, "Decref'ing a resource ref too many times." );
 
@@ -1 +1,381 @@
 #include "CRC32.h"
+
+#if defined(__ARM_FEATURE_CRC32)
+	#include <arm_acle.h>
+#endif
+
+
+
+namespace J::Crypto
+{
+
+	// bit-reflected polynomials, CRCs are computed LSB first
+	static constexpr uint32 GCRC32Polynomial = 0xEDB88320u;
+	static constexpr uint32 GCRC32CPolynomial = 0x82F63B78u;
+
+	// The hardware CRC32C path runs three independent streams over blocks of this size
+	// to hide the latency of the crc32 instruction, then merges them.
+	static constexpr SIZE_T GInterleaveBlockSize = 2048;
+
+
+	template<class T>
+	static FORCEINLINE T Load(const uint8* Data)
+	{
+		T value;
+		Memory::Memcpy(Data, &value, sizeof(T));
+
+		return value;
+	}
+
+	/** Slicing-by-8 tables: Table[k][b] is the CRC of byte b followed by k zero bytes. */
+	struct SCRCTables
+	{
+		uint32 Table[8][256];
+
+		explicit SCRCTables(uint32 InPolynomial)
+		{
+			for (uint32 b = 0; b < 256; ++b)
+			{
+				uint32 crc = b;
+
+				for (uint32 bit = 0; bit < 8; ++bit)
+				{
+					crc = (crc & 1) ? (crc >> 1) ^ InPolynomial : (crc >> 1);
+				}
+
+				Table[0][b] = crc;
+			}
+
+			for (uint32 k = 1; k < 8; ++k)
+			{
+				for (uint32 b = 0; b < 256; ++b)
+				{
+					Table[k][b] = (Table[k - 1][b] >> 8) ^ Table[0][Table[k - 1][b] & 0xFF];
+				}
+			}
+		}
+	};
+
+	static const SCRCTables& GetTables(ECRCType InType)
+	{
+		static const SCRCTables crc32Tables(GCRC32Polynomial);
+		static const SCRCTables crc32cTables(GCRC32CPolynomial);
+
+		return (InType == ECRCType::CRC32) ? crc32Tables : crc32cTables;
+	}
+
+	/**
+	 * Slicing-by-8 update of a raw (not inverted) CRC register.
+	 * Assumes a little-endian host, as does the rest of the engine.
+	 */
+	static uint32 UpdateSlicing8(uint32 InCRC, const uint8* Data, SIZE_T Size, const SCRCTables& InTables)
+	{
+		const auto& table = InTables.Table;
+		uint32 crc = InCRC;
+
+		for (; Size >= 8; Data += 8, Size -= 8)
+		{
+			const uint32 low = Load<uint32>(Data) ^ crc;
+			const uint32 high = Load<uint32>(Data + 4);
+
+			crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24]
+				^ table[3][high & 0xFF] ^ table[2][(high >> 8) & 0xFF] ^ table[1][(high >> 16) & 0xFF] ^ table[0][high >> 24];
+		}
+
+		for (; Size > 0; ++Data, --Size)
+		{
+			crc = table[0][(crc ^ *Data) & 0xFF] ^ (crc >> 8);
+		}
+
+		return crc;
+	}
+
+	/** a * b modulo the polynomial, both in the bit-reflected representation (x^0 is the MSB). */
+	static uint32 MultiplyModP(uint32 A, uint32 B, uint32 InPolynomial)
+	{
+		uint32 product = 0;
+
+		for (uint32 mask = 1u << 31; mask != 0; mask >>= 1)
+		{
+			if (A & mask)
+			{
+				product ^= B;
+			}
+
+			B = (B & 1) ? (B >> 1) ^ InPolynomial : (B >> 1);
+		}
+
+		return product;
+	}
+
+	/** x^(8 * InBytes) modulo the polynomial: multiplying a raw CRC by it appends InBytes zero bytes. */
+	static uint32 ZeroBytesOperator(SIZE_T InBytes, uint32 InPolynomial)
+	{
+		uint32 result = 1u << 31;	// x^0
+		uint32 square = 1u << 23;	// x^8
+
+		for (SIZE_T n = InBytes; n != 0; n >>= 1)
+		{
+			if (n & 1)
+			{
+				result = MultiplyModP(square, result, InPolynomial);
+			}
+
+			square = MultiplyModP(square, square, InPolynomial);
+		}
+
+		return result;
+	}
+
+
+	/************************************************************************/
+	/* CRC32C                                                               */
+	/************************************************************************/
+
+#if ENGINE_ARCH_X86
+
+	/** Shifts a raw CRC32C register over GInterleaveBlockSize zero bytes, one lookup per byte of the register. */
+	struct SCRC32CShiftTable
+	{
+		uint32 Table[4][256];
+
+		SCRC32CShiftTable()
+		{
+			const uint32 shift = ZeroBytesOperator(GInterleaveBlockSize, GCRC32CPolynomial);
+
+			for (uint32 k = 0; k < 4; ++k)
+			{
+				for (uint32 b = 0; b < 256; ++b)
+				{
+					Table[k][b] = MultiplyModP(shift, b << (k * 8), GCRC32CPolynomial);
+				}
+			}
+		}
+
+		FORCEINLINE uint32 Shift(uint32 InCRC) const
+		{
+			return Table[0][InCRC & 0xFF] ^ Table[1][(InCRC >> 8) & 0xFF] ^ Table[2][(InCRC >> 16) & 0xFF] ^ Table[3][InCRC >> 24];
+		}
+	};
+
+#if defined(_M_X64) || defined(__x86_64__)
+	using CRCWordType = uint64;
+#else
+	using CRCWordType = uint32;
+#endif
+
+	ENGINE_SIMD_TARGET("sse4.2")
+	static FORCEINLINE uint32 UpdateCRC32CWord(uint32 InCRC, const uint8* Data)
+	{
+#if defined(_M_X64) || defined(__x86_64__)
+		return static_cast<uint32>(_mm_crc32_u64(InCRC, Load<uint64>(Data)));
+#else
+		return _mm_crc32_u32(InCRC, Load<uint32>(Data));
+#endif
+	}
+
+	ENGINE_SIMD_TARGET("sse4.2")
+	static uint32 UpdateCRC32CSSE42(uint32 InCRC, const uint8* Data, SIZE_T Size)
+	{
+		static const SCRC32CShiftTable shiftTable;
+
+		uint32 crc = InCRC;
+
+		for (; Size >= 3 * GInterleaveBlockSize; Data += 3 * GInterleaveBlockSize, Size -= 3 * GInterleaveBlockSize)
+		{
+			uint32 crc1 = 0;
+			uint32 crc2 = 0;
+
+			for (SIZE_T i = 0; i < GInterleaveBlockSize; i += sizeof(CRCWordType))
+			{
+				crc = UpdateCRC32CWord(crc, Data + i);
+				crc1 = UpdateCRC32CWord(crc1, Data + GInterleaveBlockSize + i);
+				crc2 = UpdateCRC32CWord(crc2, Data + 2 * GInterleaveBlockSize + i);
+			}
+
+			// CRCs are linear: the first streams are moved past the bytes that follow them
+			crc = shiftTable.Shift(shiftTable.Shift(crc) ^ crc1) ^ crc2;
+		}
+
+		for (; Size >= sizeof(CRCWordType); Data += sizeof(CRCWordType), Size -= sizeof(CRCWordType))
+		{
+			crc = UpdateCRC32CWord(crc, Data);
+		}
+
+		for (; Size > 0; ++Data, --Size)
+		{
+			crc = _mm_crc32_u8(crc, *Data);
+		}
+
+		return crc;
+	}
+
+#endif
+
+	uint32 CRC32C(const void* Data, SIZE_T Size, uint32 InPrevious)
+	{
+		const uint8* data = static_cast<const uint8*>(Data);
+		uint32 crc = ~InPrevious;
+
+#if ENGINE_ARCH_X86
+		if (SIMD::GetCPUFeatures().bSSE42)
+		{
+			return ~UpdateCRC32CSSE42(crc, data, Size);
+		}
+#elif defined(__ARM_FEATURE_CRC32)
+		for (; Size >= 8; data += 8, Size -= 8)
+		{
+			crc = __crc32cd(crc, Load<uint64>(data));
+		}
+
+		for (; Size > 0; ++data, --Size)
+		{
+			crc = __crc32cb(crc, *data);
+		}
+
+		return ~crc;
+#endif
+
+		return ~UpdateSlicing8(crc, data, Size, GetTables(ECRCType::CRC32C));
+	}
+
+
+	/************************************************************************/
+	/* CRC32                                                                */
+	/************************************************************************/
+
+#if ENGINE_ARCH_X86
+
+	/** Moves Accumulator 128 bits forward and adds the next 128 bits of data. */
+	ENGINE_SIMD_TARGET("pclmul")
+	static FORCEINLINE __m128i Fold128(__m128i Accumulator, __m128i Next, __m128i Constants)
+	{
+		const __m128i low = _mm_clmulepi64_si128(Accumulator, Constants, 0x00);
+		const __m128i high = _mm_clmulepi64_si128(Accumulator, Constants, 0x11);
+
+		return _mm_xor_si128(_mm_xor_si128(high, low), Next);
+	}
+
+	/**
+	 * Folds 64-byte blocks with carry-less multiplications, then Barrett-reduces the remaining 128 bits
+	 * (V. Gopal et al., "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction", Intel 2009).
+	 *
+	 * \param InCRC	- Raw CRC register.
+	 * \param Size	- At least 64 and a multiple of 16.
+	 */
+	ENGINE_SIMD_TARGET("sse4.1,pclmul")
+	static uint32 UpdateCRC32PCLMUL(uint32 InCRC, const uint8* Data, SIZE_T Size)
+	{
+		// x^(4*128+32), x^(4*128-32), x^(128+32), x^(128-32), x^64 mod P and the Barrett constants, bit-reflected
+		const __m128i k1k2 = _mm_set_epi64x(0x01C6E41596, 0x0154442BD4);
+		const __m128i k3k4 = _mm_set_epi64x(0x00CCAA009E, 0x01751997D0);
+		const __m128i k5 = _mm_set_epi64x(0, 0x0163CD6124);
+		const __m128i barrett = _mm_set_epi64x(0x01F7011641, 0x01DB710641);
+		const __m128i low32Mask = _mm_setr_epi32(-1, 0, -1, 0);
+
+		__m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + 0x00));
+		__m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + 0x10));
+		__m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + 0x20));
+		__m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + 0x30));
+
+		x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int32>(InCRC)));
+
+		Data += 64;
+		Size -= 64;
+
+		// four independent 128-bit accumulators
+		for (; Size >= 64; Data += 64, Size -= 64)
+		{
+			const __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+			const __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+			const __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+			const __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+
+			x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+			x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+			x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+			x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + 0x00)));
+			x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + 0x10)));
+			x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + 0x20)));
+			x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + 0x30)));
+		}
+
+		x1 = Fold128(x1, x2, k3k4);
+		x1 = Fold128(x1, x3, k3k4);
+		x1 = Fold128(x1, x4, k3k4);
+
+		for (; Size >= 16; Data += 16, Size -= 16)
+		{
+			x1 = Fold128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data)), k3k4);
+		}
+
+		// 128 -> 64 bits
+		x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+		x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+		// 64 -> 32 bits
+		x2 = _mm_srli_si128(x1, 4);
+		x1 = _mm_and_si128(x1, low32Mask);
+		x1 = _mm_clmulepi64_si128(x1, k5, 0x00);
+		x1 = _mm_xor_si128(x1, x2);
+
+		// Barrett reduction
+		x2 = _mm_and_si128(x1, low32Mask);
+		x2 = _mm_clmulepi64_si128(x2, barrett, 0x10);
+		x2 = _mm_and_si128(x2, low32Mask);
+		x2 = _mm_clmulepi64_si128(x2, barrett, 0x00);
+		x1 = _mm_xor_si128(x1, x2);
+
+		return static_cast<uint32>(_mm_extract_epi32(x1, 1));
+	}
+
+#endif
+
+	uint32 CRC32(const void* Data, SIZE_T Size, uint32 InPrevious)
+	{
+		const uint8* data = static_cast<const uint8*>(Data);
+		uint32 crc = ~InPrevious;
+
+#if ENGINE_ARCH_X86
+		const SIMD::SCPUFeatures& features = SIMD::GetCPUFeatures();
+
+		if (Size >= 64 && features.bPCLMUL && features.bSSE41)
+		{
+			const SIZE_T folded = Size & ~static_cast<SIZE_T>(15);
+
+			crc = UpdateCRC32PCLMUL(crc, data, folded);
+			data += folded;
+			Size -= folded;
+		}
+#elif defined(__ARM_FEATURE_CRC32)
+		for (; Size >= 8; data += 8, Size -= 8)
+		{
+			crc = __crc32d(crc, Load<uint64>(data));
+		}
+
+		for (; Size > 0; ++data, --Size)
+		{
+			crc = __crc32b(crc, *data);
+		}
+#endif
+
+		return ~UpdateSlicing8(crc, data, Size, GetTables(ECRCType::CRC32));
+	}
+
+
+	namespace Details
+	{
+		uint32 CRC32Software(const void* Data, SIZE_T Size, uint32 InPrevious)
+		{
+			return ~UpdateSlicing8(~InPrevious, static_cast<const uint8*>(Data), Size, GetTables(ECRCType::CRC32));
+		}
+
+		uint32 CRC32CSoftware(const void* Data, SIZE_T Size, uint32 InPrevious)
+		{
+			return ~UpdateSlicing8(~InPrevious, static_cast<const uint8*>(Data), Size, GetTables(ECRCType::CRC32C));
+		}
+	}
+
+}
@@ -1,9 +1,83 @@
 #pragma once
+#include "../../Core.h"
 
 
 namespace J::Crypto
 {
 
+	enum class ECRCType : uint8
+	{
+		CRC32,		// ISO-HDLC polynomial 0x04C11DB7 (zlib, PNG, zip)
+		CRC32C,		// Castagnoli polynomial 0x1EDC6F41 (iSCSI, ext4, SSE4.2 crc32)
+	};
 
+	/**
+	 * CRC-32 of a buffer. Uses PCLMULQDQ folding when the CPU has it, slicing-by-8 tables otherwise.
+	 *
+	 * \param Data		- Bytes to checksum.
+	 * \param Size		- Number of bytes.
+	 * \param InPrevious - CRC of the preceding bytes, lets a checksum be computed in pieces
+	 *					   (CRC32(b, CRC32(a)) == CRC32(a + b)).
+	 */
+	uint32 CRC32(const void* Data, SIZE_T Size, uint32 InPrevious = 0);
+
+	INLINE uint32 CRC32(Span<const byte> Data, uint32 InPrevious = 0)
+	{
+		return CRC32(Data.data(), Data.size(), InPrevious);
+	}
+
+	/**
+	 * CRC-32C of a buffer. Uses the SSE4.2 / ARMv8 crc32c instructions when available, slicing-by-8 tables otherwise.
+	 *
+	 * \param Data		- Bytes to checksum.
+	 * \param Size		- Number of bytes.
+	 * \param InPrevious - CRC of the preceding bytes.
+	 */
+	uint32 CRC32C(const void* Data, SIZE_T Size, uint32 InPrevious = 0);
+
+	INLINE uint32 CRC32C(Span<const byte> Data, uint32 InPrevious = 0)
+	{
+		return CRC32C(Data.data(), Data.size(), InPrevious);
+	}
+
+	/**
+	 * Incremental checksum, for data that arrives in pieces (streamed pak entries, ...).
+	 */
+	class CRCStream
+	{
+	public:
+
+		explicit CRCStream(ECRCType InType = ECRCType::CRC32)
+			: Type(InType), Value(0)
+		{ }
+
+		void Update(const void* Data, SIZE_T Size)
+		{
+			Value = (Type == ECRCType::CRC32) ? CRC32(Data, Size, Value) : CRC32C(Data, Size, Value);
+		}
+
+		void Update(Span<const byte> Data) { Update(Data.data(), Data.size()); }
+
+		/** Checksum of everything passed to Update since the construction / last Reset. */
+		uint32 GetValue() const { return Value; }
+
+		ECRCType GetType() const { return Type; }
+
+		void Reset() { Value = 0; }
+
+	private:
+
+		ECRCType	Type;
+
+		uint32		Value;
+	};
+
+	namespace Details
+	{
+		/** Portable slicing-by-8 paths, exposed for verification and benchmarks. */
+		uint32 CRC32Software(const void* Data, SIZE_T Size, uint32 InPrevious = 0);
+
+		uint32 CRC32CSoftware(const void* Data, SIZE_T Size, uint32 InPrevious = 0);
+	}
 
 }
@@ -0,0 +1,416 @@
+#include "Hash.h"
+
+
+
+namespace J::Crypto
+{
+	using namespace Details;
+
+	static constexpr SIZE_T GStripesPerBlock = (GHashSecretSize - GHashStripeSize) / 8;
+	static constexpr SIZE_T GBlockSize = GStripesPerBlock * GHashStripeSize;
+
+	// the last stripe of an input uses its own slice of the secret
+	static constexpr SIZE_T GLastStripeSecretOffset = GHashSecretSize - GHashStripeSize - 7;
+
+
+	/************************************************************************/
+	/* ACCUMULATION KERNELS                                                 */
+	/************************************************************************/
+
+	/**
+	 * Every kernel set processes whole stripes (64 bytes) into the 8 accumulators; the secret moves
+	 * 8 bytes per stripe. Scramble runs at the end of every block of GStripesPerBlock stripes.
+	 */
+	struct SAccumulateKernels
+	{
+		void (*Accumulate)(uint64* Accumulators, const uint8* Data, const uint8* Secret, SIZE_T StripesCount);
+
+		void (*Scramble)(uint64* Accumulators, const uint8* Secret);
+	};
+
+#if !ENGINE_SIMD_SSE2 && !ENGINE_SIMD_NEON
+
+	static void AccumulateScalar(uint64* Accumulators, const uint8* Data, const uint8* Secret, SIZE_T StripesCount)
+	{
+		for (SIZE_T stripe = 0; stripe < StripesCount; ++stripe)
+		{
+			AccumulateStripeScalar(Accumulators, Data + stripe * GHashStripeSize, Secret + stripe * 8);
+		}
+	}
+
+#endif
+
+#if ENGINE_SIMD_SSE2
+
+	static void AccumulateSSE2(uint64* Accumulators, const uint8* Data, const uint8* Secret, SIZE_T StripesCount)
+	{
+		__m128i* accumulators = reinterpret_cast<__m128i*>(Accumulators);
+
+		for (SIZE_T stripe = 0; stripe < StripesCount; ++stripe)
+		{
+			const uint8* data = Data + stripe * GHashStripeSize;
+			const uint8* secret = Secret + stripe * 8;
+
+			_mm_prefetch(reinterpret_cast<const char*>(data) + 384, _MM_HINT_T0);
+
+			for (SIZE_T i = 0; i < 4; ++i)
+			{
+				const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data) + i);
+				const __m128i keyed = _mm_xor_si128(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i));
+
+				// low 32 bits * high 32 bits of every keyed lane
+				const __m128i product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+
+				// the value itself goes to the neighbouring lane
+				const __m128i swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+
+				accumulators[i] = _mm_add_epi64(accumulators[i], _mm_add_epi64(product, swapped));
+			}
+		}
+	}
+
+	static void ScrambleSSE2(uint64* Accumulators, const uint8* Secret)
+	{
+		__m128i* accumulators = reinterpret_cast<__m128i*>(Accumulators);
+		const __m128i prime = _mm_set1_epi32(static_cast<int32>(GPrime32_1));
+
+		for (SIZE_T i = 0; i < 4; ++i)
+		{
+			__m128i value = accumulators[i];
+			value = _mm_xor_si128(value, _mm_srli_epi64(value, 47));
+			value = _mm_xor_si128(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(Secret) + i));
+
+			// 64-bit lanes times a 32-bit constant, from two 32x32 products
+			const __m128i productLow = _mm_mul_epu32(value, prime);
+			const __m128i productHigh = _mm_mul_epu32(_mm_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+
+			accumulators[i] = _mm_add_epi64(productLow, _mm_slli_epi64(productHigh, 32));
+		}
+	}
+
+	ENGINE_SIMD_TARGET("avx2")
+	static void AccumulateAVX2(uint64* Accumulators, const uint8* Data, const uint8* Secret, SIZE_T StripesCount)
+	{
+		__m256i accumulators[2] =
+		{
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Accumulators)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Accumulators) + 1),
+		};
+
+		for (SIZE_T stripe = 0; stripe < StripesCount; ++stripe)
+		{
+			const uint8* data = Data + stripe * GHashStripeSize;
+			const uint8* secret = Secret + stripe * 8;
+
+			_mm_prefetch(reinterpret_cast<const char*>(data) + 384, _MM_HINT_T0);
+
+			for (SIZE_T i = 0; i < 2; ++i)
+			{
+				const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data) + i);
+				const __m256i keyed = _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + i));
+
+				const __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+				const __m256i swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+
+				accumulators[i] = _mm256_add_epi64(accumulators[i], _mm256_add_epi64(product, swapped));
+			}
+		}
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Accumulators), accumulators[0]);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Accumulators) + 1, accumulators[1]);
+	}
+
+	ENGINE_SIMD_TARGET("avx2")
+	static void ScrambleAVX2(uint64* Accumulators, const uint8* Secret)
+	{
+		const __m256i prime = _mm256_set1_epi32(static_cast<int32>(GPrime32_1));
+
+		for (SIZE_T i = 0; i < 2; ++i)
+		{
+			__m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Accumulators) + i);
+			value = _mm256_xor_si256(value, _mm256_srli_epi64(value, 47));
+			value = _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Secret) + i));
+
+			const __m256i productLow = _mm256_mul_epu32(value, prime);
+			const __m256i productHigh = _mm256_mul_epu32(_mm256_srli_epi64(value, 32), prime);
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(Accumulators) + i, _mm256_add_epi64(productLow, _mm256_slli_epi64(productHigh, 32)));
+		}
+	}
+
+#elif ENGINE_SIMD_NEON
+
+	static void AccumulateNEON(uint64* Accumulators, const uint8* Data, const uint8* Secret, SIZE_T StripesCount)
+	{
+		uint64x2_t accumulators[4];
+
+		for (SIZE_T i = 0; i < 4; ++i)
+		{
+			accumulators[i] = vld1q_u64(Accumulators + 2 * i);
+		}
+
+		for (SIZE_T stripe = 0; stripe < StripesCount; ++stripe)
+		{
+			const uint8* data = Data + stripe * GHashStripeSize;
+			const uint8* secret = Secret + stripe * 8;
+
+			for (SIZE_T i = 0; i < 4; ++i)
+			{
+				const uint64x2_t value = vreinterpretq_u64_u8(vld1q_u8(data + 16 * i));
+				const uint64x2_t keyed = veorq_u64(value, vreinterpretq_u64_u8(vld1q_u8(secret + 16 * i)));
+
+				const uint64x2_t product = vmull_u32(vmovn_u64(keyed), vshrn_n_u64(keyed, 32));
+				const uint64x2_t swapped = vextq_u64(value, value, 1);
+
+				accumulators[i] = vaddq_u64(accumulators[i], vaddq_u64(product, swapped));
+			}
+		}
+
+		for (SIZE_T i = 0; i < 4; ++i)
+		{
+			vst1q_u64(Accumulators + 2 * i, accumulators[i]);
+		}
+	}
+
+	static void ScrambleNEON(uint64* Accumulators, const uint8* Secret)
+	{
+		const uint32x2_t prime = vdup_n_u32(GPrime32_1);
+
+		for (SIZE_T i = 0; i < 4; ++i)
+		{
+			uint64x2_t value = vld1q_u64(Accumulators + 2 * i);
+			value = veorq_u64(value, vshrq_n_u64(value, 47));
+			value = veorq_u64(value, vreinterpretq_u64_u8(vld1q_u8(Secret + 16 * i)));
+
+			const uint64x2_t productLow = vmull_u32(vmovn_u64(value), prime);
+			const uint64x2_t productHigh = vmull_u32(vshrn_n_u64(value, 32), prime);
+
+			vst1q_u64(Accumulators + 2 * i, vaddq_u64(productLow, vshlq_n_u64(productHigh, 32)));
+		}
+	}
+
+#endif
+
+	static const SAccumulateKernels& GetKernels()
+	{
+		static const SAccumulateKernels kernels = []() -> SAccumulateKernels
+		{
+#if ENGINE_SIMD_SSE2
+			if (SIMD::GetCPUFeatures().bAVX2)
+			{
+				return { &AccumulateAVX2, &ScrambleAVX2 };
+			}
+
+			return { &AccumulateSSE2, &ScrambleSSE2 };
+#elif ENGINE_SIMD_NEON
+			return { &AccumulateNEON, &ScrambleNEON };
+#else
+			return { &AccumulateScalar, &ScrambleScalar };
+#endif
+		}();
+
+		return kernels;
+	}
+
+	/**
+	 * Accumulates StripesCount stripes, scrambling whenever a block of the secret is used up.
+	 * Returns the position inside the current block afterwards.
+	 */
+	static SIZE_T ConsumeStripes(uint64* Accumulators, const uint8* Data, SIZE_T StripesCount, SIZE_T InStripesInBlock, const uint8* Secret)
+	{
+		const SAccumulateKernels& kernels = GetKernels();
+
+		while (InStripesInBlock + StripesCount >= GStripesPerBlock)
+		{
+			const SIZE_T count = GStripesPerBlock - InStripesInBlock;
+
+			kernels.Accumulate(Accumulators, Data, Secret + InStripesInBlock * 8, count);
+			kernels.Scramble(Accumulators, Secret + GHashSecretSize - GHashStripeSize);
+
+			Data += count * GHashStripeSize;
+			StripesCount -= count;
+			InStripesInBlock = 0;
+		}
+
+		kernels.Accumulate(Accumulators, Data, Secret + InStripesInBlock * 8, StripesCount);
+
+		return InStripesInBlock + StripesCount;
+	}
+
+	/** Accumulators of a whole input longer than GHashMidSizeMax. */
+	static void HashLong(uint64* Accumulators, const uint8* Data, SIZE_T Size, const uint8* Secret)
+	{
+		std::copy_n(GHashInitialAccumulators, 8, Accumulators);
+
+		// the last stripe is always processed separately, even when the size is a multiple of the stripe
+		ConsumeStripes(Accumulators, Data, (Size - 1) / GHashStripeSize, 0, Secret);
+		GetKernels().Accumulate(Accumulators, Data + Size - GHashStripeSize, Secret + GLastStripeSecretOffset, 1);
+	}
+
+
+	/************************************************************************/
+	/* ONE SHOT                                                             */
+	/************************************************************************/
+
+	uint64 Hash64(const void* Data, SIZE_T Size, uint64 InSeed)
+	{
+		const uint8* data = static_cast<const uint8*>(Data);
+
+		if (Size <= GHashMidSizeMax)
+		{
+			return Hash64Short(data, Size, InSeed);
+		}
+
+		alignas(64) uint64 accumulators[8];
+
+		if (InSeed == 0)
+		{
+			HashLong(accumulators, data, Size, GHashSecret);
+			return MergeAccumulators64(accumulators, GHashSecret, Size);
+		}
+
+		const std::array<uint8, GHashSecretSize> secret = MakeSecret(InSeed);
+
+		HashLong(accumulators, data, Size, secret.data());
+		return MergeAccumulators64(accumulators, secret.data(), Size);
+	}
+
+	SHash128 Hash128(const void* Data, SIZE_T Size, uint64 InSeed)
+	{
+		const uint8* data = static_cast<const uint8*>(Data);
+
+		if (Size <= GHashMidSizeMax)
+		{
+			return Hash128Short(data, Size, InSeed);
+		}
+
+		alignas(64) uint64 accumulators[8];
+
+		if (InSeed == 0)
+		{
+			HashLong(accumulators, data, Size, GHashSecret);
+			return MergeAccumulators128(accumulators, GHashSecret, Size);
+		}
+
+		const std::array<uint8, GHashSecretSize> secret = MakeSecret(InSeed);
+
+		HashLong(accumulators, data, Size, secret.data());
+		return MergeAccumulators128(accumulators, secret.data(), Size);
+	}
+
+
+	/************************************************************************/
+	/* STREAMING                                                            */
+	/************************************************************************/
+
+	HashStream::HashStream(uint64 InSeed)
+		: Seed(InSeed)
+	{
+		const std::array<uint8, GHashSecretSize> secret = MakeSecret(InSeed);
+		std::copy(secret.begin(), secret.end(), Secret);
+
+		Reset();
+	}
+
+	void HashStream::Reset()
+	{
+		std::copy_n(GHashInitialAccumulators, 8, Accumulators);
+
+		TotalSize = 0;
+		StripesInBlock = 0;
+		BufferedSize = 0;
+	}
+
+	void HashStream::Update(const void* Data, SIZE_T Size)
+	{
+		const uint8* data = static_cast<const uint8*>(Data);
+		TotalSize += Size;
+
+		if (BufferedSize + Size <= BufferSize)
+		{
+			Memory::Memcpy(data, Buffer + BufferedSize, Size);
+			BufferedSize += static_cast<uint32>(Size);
+			return;
+		}
+
+		// The buffer is only flushed once more data follows it: the final stripe must stay
+		// in the buffer for the getters.
+		if (BufferedSize > 0)
+		{
+			const SIZE_T fill = BufferSize - BufferedSize;
+
+			Memory::Memcpy(data, Buffer + BufferedSize, fill);
+			data += fill;
+			Size -= fill;
+
+			StripesInBlock = ConsumeStripes(Accumulators, Buffer, BufferSize / GHashStripeSize, StripesInBlock, Secret);
+			BufferedSize = 0;
+		}
+
+		if (Size > BufferSize)
+		{
+			// straight from the input, keeping at least one byte for the buffer
+			const SIZE_T stripesCount = (Size - 1) / GHashStripeSize;
+
+			StripesInBlock = ConsumeStripes(Accumulators, data, stripesCount, StripesInBlock, Secret);
+			data += stripesCount * GHashStripeSize;
+			Size -= stripesCount * GHashStripeSize;
+
+			// the last consumed stripe may be needed to complete a short final stripe
+			Memory::Memcpy(data - GHashStripeSize, Buffer + BufferSize - GHashStripeSize, GHashStripeSize);
+		}
+
+		Memory::Memcpy(data, Buffer, Size);
+		BufferedSize = static_cast<uint32>(Size);
+	}
+
+	void HashStream::FinalizeAccumulators(uint64* OutAccumulators) const
+	{
+		std::copy_n(Accumulators, 8, OutAccumulators);
+
+		if (BufferedSize >= GHashStripeSize)
+		{
+			const SIZE_T stripesCount = (BufferedSize - 1) / GHashStripeSize;
+
+			ConsumeStripes(OutAccumulators, Buffer, stripesCount, StripesInBlock, Secret);
+			GetKernels().Accumulate(OutAccumulators, Buffer + BufferedSize - GHashStripeSize, Secret + GLastStripeSecretOffset, 1);
+			return;
+		}
+
+		// the final stripe overlaps the end of the previously consumed data
+		alignas(64) uint8 lastStripe[GHashStripeSize];
+		const SIZE_T catchUp = GHashStripeSize - BufferedSize;
+
+		Memory::Memcpy(Buffer + BufferSize - catchUp, lastStripe, catchUp);
+		Memory::Memcpy(Buffer, lastStripe + catchUp, BufferedSize);
+
+		GetKernels().Accumulate(OutAccumulators, lastStripe, Secret + GLastStripeSecretOffset, 1);
+	}
+
+	uint64 HashStream::GetHash64() const
+	{
+		if (TotalSize <= GHashMidSizeMax)
+		{
+			return Hash64Short(Buffer, TotalSize, Seed);
+		}
+
+		alignas(64) uint64 accumulators[8];
+		FinalizeAccumulators(accumulators);
+
+		return MergeAccumulators64(accumulators, Secret, TotalSize);
+	}
+
+	SHash128 HashStream::GetHash128() const
+	{
+		if (TotalSize <= GHashMidSizeMax)
+		{
+			return Hash128Short(Buffer, TotalSize, Seed);
+		}
+
+		alignas(64) uint64 accumulators[8];
+		FinalizeAccumulators(accumulators);
+
+		return MergeAccumulators128(accumulators, Secret, TotalSize);
+	}
+
+}
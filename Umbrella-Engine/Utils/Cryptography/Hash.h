@@ -0,0 +1,643 @@
+#pragma once
+#include "../../Core.h"
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <type_traits>
+
+
+namespace J::Crypto
+{
+
+	struct SHash128
+	{
+		uint64 Low	= 0;
+		uint64 High	= 0;
+
+		constexpr bool operator == (const SHash128&) const = default;
+	};
+
+	/**
+	 * XXH3 algorithm (Y. Collet, xxHash 0.8), bit-compatible with the reference implementation:
+	 * asset / cache keys hashed by the engine can be reproduced by external tools.
+	 * Everything up to GHashMidSizeMax bytes is constexpr, so string literals are hashed at compile time
+	 * with the very same function the runtime uses.
+	 */
+	namespace Details
+	{
+		inline constexpr SIZE_T GHashSecretSize = 192;
+		inline constexpr SIZE_T GHashStripeSize = 64;
+		inline constexpr SIZE_T GHashMidSizeMax = 240;
+
+		inline constexpr uint8 GHashSecret[GHashSecretSize] =
+		{
+			0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+			0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+			0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+			0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+			0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+			0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+			0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+			0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+			0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+			0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+			0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+			0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+		};
+
+		inline constexpr uint32 GPrime32_1 = 0x9E3779B1u;
+		inline constexpr uint32 GPrime32_2 = 0x85EBCA77u;
+		inline constexpr uint32 GPrime32_3 = 0xC2B2AE3Du;
+		inline constexpr uint64 GPrime64_1 = 0x9E3779B185EBCA87ull;
+		inline constexpr uint64 GPrime64_2 = 0xC2B2AE3D27D4EB4Full;
+		inline constexpr uint64 GPrime64_3 = 0x165667B19E3779F9ull;
+		inline constexpr uint64 GPrime64_4 = 0x85EBCA77C2B2AE63ull;
+		inline constexpr uint64 GPrime64_5 = 0x27D4EB2F165667C5ull;
+
+		inline constexpr uint64 GHashInitialAccumulators[8] =
+		{
+			GPrime32_3, GPrime64_1, GPrime64_2, GPrime64_3, GPrime64_4, GPrime32_2, GPrime64_5, GPrime32_1
+		};
+
+		/** Little-endian reads, byte by byte during constant evaluation. */
+		template<class CharType>
+		FORCEINLINE constexpr uint64 ReadLE64(const CharType* Data)
+		{
+			if (std::is_constant_evaluated())
+			{
+				uint64 value = 0;
+
+				for (uint32 i = 0; i < 8; ++i)
+				{
+					value |= static_cast<uint64>(static_cast<uint8>(Data[i])) << (i * 8);
+				}
+
+				return value;
+			}
+
+			uint64 value;
+			Memory::Memcpy(Data, &value, sizeof(value));
+
+			return value;
+		}
+
+		template<class CharType>
+		FORCEINLINE constexpr uint32 ReadLE32(const CharType* Data)
+		{
+			if (std::is_constant_evaluated())
+			{
+				uint32 value = 0;
+
+				for (uint32 i = 0; i < 4; ++i)
+				{
+					value |= static_cast<uint32>(static_cast<uint8>(Data[i])) << (i * 8);
+				}
+
+				return value;
+			}
+
+			uint32 value;
+			Memory::Memcpy(Data, &value, sizeof(value));
+
+			return value;
+		}
+
+		FORCEINLINE constexpr uint32 ByteSwap32(uint32 Value)
+		{
+			return (Value >> 24) | ((Value >> 8) & 0xFF00u) | ((Value << 8) & 0xFF0000u) | (Value << 24);
+		}
+
+		FORCEINLINE constexpr uint64 ByteSwap64(uint64 Value)
+		{
+			return (static_cast<uint64>(ByteSwap32(static_cast<uint32>(Value))) << 32) | ByteSwap32(static_cast<uint32>(Value >> 32));
+		}
+
+		FORCEINLINE constexpr uint64 RotateLeft64(uint64 Value, uint32 Shift)
+		{
+			return (Value << Shift) | (Value >> (64 - Shift));
+		}
+
+		FORCEINLINE constexpr uint32 RotateLeft32(uint32 Value, uint32 Shift)
+		{
+			return (Value << Shift) | (Value >> (32 - Shift));
+		}
+
+		/** Full 64x64 -> 128 bits product. */
+		FORCEINLINE constexpr SHash128 Multiply128(uint64 A, uint64 B)
+		{
+			if (!std::is_constant_evaluated())
+			{
+#if defined(__SIZEOF_INT128__)
+				const unsigned __int128 product = static_cast<unsigned __int128>(A) * B;
+				return { static_cast<uint64>(product), static_cast<uint64>(product >> 64) };
+#elif ENGINE_MSVC_COMPILER && defined(_M_X64)
+				uint64 high;
+				const uint64 low = _umul128(A, B, &high);
+				return { low, high };
+#endif
+			}
+
+			const uint64 lowLow = (A & 0xFFFFFFFF) * (B & 0xFFFFFFFF);
+			const uint64 highLow = (A >> 32) * (B & 0xFFFFFFFF);
+			const uint64 lowHigh = (A & 0xFFFFFFFF) * (B >> 32);
+			const uint64 highHigh = (A >> 32) * (B >> 32);
+
+			const uint64 cross = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + lowHigh;
+
+			return { (cross << 32) | (lowLow & 0xFFFFFFFF), highHigh + (highLow >> 32) + (cross >> 32) };
+		}
+
+		FORCEINLINE constexpr uint64 MultiplyFold64(uint64 A, uint64 B)
+		{
+			const SHash128 product = Multiply128(A, B);
+			return product.Low ^ product.High;
+		}
+
+		FORCEINLINE constexpr uint64 XXH64Avalanche(uint64 Value)
+		{
+			Value ^= Value >> 33;
+			Value *= GPrime64_2;
+			Value ^= Value >> 29;
+			Value *= GPrime64_3;
+
+			return Value ^ (Value >> 32);
+		}
+
+		FORCEINLINE constexpr uint64 Avalanche(uint64 Value)
+		{
+			Value ^= Value >> 37;
+			Value *= 0x165667919E3779F9ull;
+
+			return Value ^ (Value >> 32);
+		}
+
+		FORCEINLINE constexpr uint64 StrongAvalanche(uint64 Value, uint64 InSize)
+		{
+			Value ^= RotateLeft64(Value, 49) ^ RotateLeft64(Value, 24);
+			Value *= 0x9FB21C651E98DF25ull;
+			Value ^= (Value >> 35) + InSize;
+			Value *= 0x9FB21C651E98DF25ull;
+
+			return Value ^ (Value >> 28);
+		}
+
+		template<class CharType>
+		FORCEINLINE constexpr uint64 Mix16(const CharType* Data, const uint8* Secret, uint64 InSeed)
+		{
+			return MultiplyFold64(ReadLE64(Data) ^ (ReadLE64(Secret) + InSeed), ReadLE64(Data + 8) ^ (ReadLE64(Secret + 8) - InSeed));
+		}
+
+		template<class CharType>
+		FORCEINLINE constexpr void Mix32(SHash128& InOutAccumulator, const CharType* First, const CharType* Second, const uint8* Secret, uint64 InSeed)
+		{
+			InOutAccumulator.Low += Mix16(First, Secret, InSeed);
+			InOutAccumulator.Low ^= ReadLE64(Second) + ReadLE64(Second + 8);
+			InOutAccumulator.High += Mix16(Second, Secret + 16, InSeed);
+			InOutAccumulator.High ^= ReadLE64(First) + ReadLE64(First + 8);
+		}
+
+		/** Secret used by inputs longer than GHashMidSizeMax when the seed is not 0. */
+		constexpr std::array<uint8, GHashSecretSize> MakeSecret(uint64 InSeed)
+		{
+			std::array<uint8, GHashSecretSize> secret = { };
+
+			for (SIZE_T i = 0; i < GHashSecretSize; i += 16)
+			{
+				const uint64 low = ReadLE64(GHashSecret + i) + InSeed;
+				const uint64 high = ReadLE64(GHashSecret + i + 8) - InSeed;
+
+				for (SIZE_T b = 0; b < 8; ++b)
+				{
+					secret[i + b] = static_cast<uint8>(low >> (b * 8));
+					secret[i + 8 + b] = static_cast<uint8>(high >> (b * 8));
+				}
+			}
+
+			return secret;
+		}
+
+		/************************************************************************/
+		/* 64 bits, short inputs                                                */
+		/************************************************************************/
+
+		template<class CharType>
+		constexpr uint64 Hash64Upto16(const CharType* Data, SIZE_T Size, uint64 InSeed, const uint8* Secret)
+		{
+			if (Size > 8)
+			{
+				const uint64 low = ReadLE64(Data) ^ ((ReadLE64(Secret + 24) ^ ReadLE64(Secret + 32)) + InSeed);
+				const uint64 high = ReadLE64(Data + Size - 8) ^ ((ReadLE64(Secret + 40) ^ ReadLE64(Secret + 48)) - InSeed);
+
+				return Avalanche(Size + ByteSwap64(low) + high + MultiplyFold64(low, high));
+			}
+
+			if (Size >= 4)
+			{
+				const uint64 seed = InSeed ^ (static_cast<uint64>(ByteSwap32(static_cast<uint32>(InSeed))) << 32);
+				const uint64 value = ReadLE32(Data + Size - 4) + (static_cast<uint64>(ReadLE32(Data)) << 32);
+
+				return StrongAvalanche(value ^ ((ReadLE64(Secret + 8) ^ ReadLE64(Secret + 16)) - seed), Size);
+			}
+
+			if (Size > 0)
+			{
+				const uint32 combined = (static_cast<uint32>(static_cast<uint8>(Data[0])) << 16)
+					| (static_cast<uint32>(static_cast<uint8>(Data[Size >> 1])) << 24)
+					| static_cast<uint32>(static_cast<uint8>(Data[Size - 1]))
+					| (static_cast<uint32>(Size) << 8);
+
+				return XXH64Avalanche(combined ^ ((static_cast<uint64>(ReadLE32(Secret) ^ ReadLE32(Secret + 4))) + InSeed));
+			}
+
+			return XXH64Avalanche(InSeed ^ ReadLE64(Secret + 56) ^ ReadLE64(Secret + 64));
+		}
+
+		template<class CharType>
+		constexpr uint64 Hash64Upto128(const CharType* Data, SIZE_T Size, uint64 InSeed, const uint8* Secret)
+		{
+			uint64 accumulator = Size * GPrime64_1;
+
+			if (Size > 32)
+			{
+				if (Size > 64)
+				{
+					if (Size > 96)
+					{
+						accumulator += Mix16(Data + 48, Secret + 96, InSeed);
+						accumulator += Mix16(Data + Size - 64, Secret + 112, InSeed);
+					}
+
+					accumulator += Mix16(Data + 32, Secret + 64, InSeed);
+					accumulator += Mix16(Data + Size - 48, Secret + 80, InSeed);
+				}
+
+				accumulator += Mix16(Data + 16, Secret + 32, InSeed);
+				accumulator += Mix16(Data + Size - 32, Secret + 48, InSeed);
+			}
+
+			accumulator += Mix16(Data, Secret, InSeed);
+			accumulator += Mix16(Data + Size - 16, Secret + 16, InSeed);
+
+			return Avalanche(accumulator);
+		}
+
+		template<class CharType>
+		constexpr uint64 Hash64Upto240(const CharType* Data, SIZE_T Size, uint64 InSeed, const uint8* Secret)
+		{
+			const SIZE_T roundsCount = Size / 16;
+			uint64 accumulator = Size * GPrime64_1;
+
+			for (SIZE_T i = 0; i < 8; ++i)
+			{
+				accumulator += Mix16(Data + 16 * i, Secret + 16 * i, InSeed);
+			}
+
+			accumulator = Avalanche(accumulator);
+
+			for (SIZE_T i = 8; i < roundsCount; ++i)
+			{
+				accumulator += Mix16(Data + 16 * i, Secret + 16 * (i - 8) + 3, InSeed);
+			}
+
+			accumulator += Mix16(Data + Size - 16, Secret + 136 - 17, InSeed);
+
+			return Avalanche(accumulator);
+		}
+
+		/** Inputs of at most GHashMidSizeMax bytes, always with the default secret. */
+		template<class CharType>
+		constexpr uint64 Hash64Short(const CharType* Data, SIZE_T Size, uint64 InSeed)
+		{
+			if (Size <= 16)
+			{
+				return Hash64Upto16(Data, Size, InSeed, GHashSecret);
+			}
+
+			return (Size <= 128) ? Hash64Upto128(Data, Size, InSeed, GHashSecret) : Hash64Upto240(Data, Size, InSeed, GHashSecret);
+		}
+
+		/************************************************************************/
+		/* 128 bits, short inputs                                               */
+		/************************************************************************/
+
+		template<class CharType>
+		constexpr SHash128 Hash128Upto16(const CharType* Data, SIZE_T Size, uint64 InSeed, const uint8* Secret)
+		{
+			if (Size > 8)
+			{
+				const uint64 flipLow = (ReadLE64(Secret + 32) ^ ReadLE64(Secret + 40)) - InSeed;
+				const uint64 flipHigh = (ReadLE64(Secret + 48) ^ ReadLE64(Secret + 56)) + InSeed;
+				const uint64 low = ReadLE64(Data);
+				const uint64 high = ReadLE64(Data + Size - 8) ^ flipHigh;
+
+				SHash128 product = Multiply128(low ^ ReadLE64(Data + Size - 8) ^ flipLow, GPrime64_1);
+
+				product.Low += static_cast<uint64>(Size - 1) << 54;
+				product.High += high + static_cast<uint64>(static_cast<uint32>(high)) * (GPrime32_2 - 1);
+				product.Low ^= ByteSwap64(product.High);
+
+				SHash128 result = Multiply128(product.Low, GPrime64_2);
+				result.High += product.High * GPrime64_2;
+
+				return { Avalanche(result.Low), Avalanche(result.High) };
+			}
+
+			if (Size >= 4)
+			{
+				const uint64 seed = InSeed ^ (static_cast<uint64>(ByteSwap32(static_cast<uint32>(InSeed))) << 32);
+				const uint64 value = ReadLE32(Data) + (static_cast<uint64>(ReadLE32(Data + Size - 4)) << 32);
+				const uint64 keyed = value ^ ((ReadLE64(Secret + 16) ^ ReadLE64(Secret + 24)) + seed);
+
+				SHash128 product = Multiply128(keyed, GPrime64_1 + (static_cast<uint64>(Size) << 2));
+
+				product.High += product.Low << 1;
+				product.Low ^= product.High >> 3;
+
+				product.Low ^= product.Low >> 35;
+				product.Low *= 0x9FB21C651E98DF25ull;
+				product.Low ^= product.Low >> 28;
+
+				return { product.Low, Avalanche(product.High) };
+			}
+
+			if (Size > 0)
+			{
+				const uint32 combinedLow = (static_cast<uint32>(static_cast<uint8>(Data[0])) << 16)
+					| (static_cast<uint32>(static_cast<uint8>(Data[Size >> 1])) << 24)
+					| static_cast<uint32>(static_cast<uint8>(Data[Size - 1]))
+					| (static_cast<uint32>(Size) << 8);
+				const uint32 combinedHigh = RotateLeft32(ByteSwap32(combinedLow), 13);
+
+				const uint64 flipLow = (static_cast<uint64>(ReadLE32(Secret)) ^ ReadLE32(Secret + 4)) + InSeed;
+				const uint64 flipHigh = (static_cast<uint64>(ReadLE32(Secret + 8)) ^ ReadLE32(Secret + 12)) - InSeed;
+
+				return { XXH64Avalanche(combinedLow ^ flipLow), XXH64Avalanche(combinedHigh ^ flipHigh) };
+			}
+
+			return
+			{
+				XXH64Avalanche(InSeed ^ ReadLE64(Secret + 64) ^ ReadLE64(Secret + 72)),
+				XXH64Avalanche(InSeed ^ ReadLE64(Secret + 80) ^ ReadLE64(Secret + 88))
+			};
+		}
+
+		FORCEINLINE constexpr SHash128 Finalize128(const SHash128& InAccumulator, SIZE_T Size, uint64 InSeed)
+		{
+			const uint64 low = InAccumulator.Low + InAccumulator.High;
+			const uint64 high = InAccumulator.Low * GPrime64_1 + InAccumulator.High * GPrime64_4 + (Size - InSeed) * GPrime64_2;
+
+			return { Avalanche(low), 0 - Avalanche(high) };
+		}
+
+		template<class CharType>
+		constexpr SHash128 Hash128Upto128(const CharType* Data, SIZE_T Size, uint64 InSeed, const uint8* Secret)
+		{
+			SHash128 accumulator = { Size * GPrime64_1, 0 };
+
+			if (Size > 32)
+			{
+				if (Size > 64)
+				{
+					if (Size > 96)
+					{
+						Mix32(accumulator, Data + 48, Data + Size - 64, Secret + 96, InSeed);
+					}
+
+					Mix32(accumulator, Data + 32, Data + Size - 48, Secret + 64, InSeed);
+				}
+
+				Mix32(accumulator, Data + 16, Data + Size - 32, Secret + 32, InSeed);
+			}
+
+			Mix32(accumulator, Data, Data + Size - 16, Secret, InSeed);
+
+			return Finalize128(accumulator, Size, InSeed);
+		}
+
+		template<class CharType>
+		constexpr SHash128 Hash128Upto240(const CharType* Data, SIZE_T Size, uint64 InSeed, const uint8* Secret)
+		{
+			const SIZE_T roundsCount = Size / 32;
+			SHash128 accumulator = { Size * GPrime64_1, 0 };
+
+			for (SIZE_T i = 0; i < 4; ++i)
+			{
+				Mix32(accumulator, Data + 32 * i, Data + 32 * i + 16, Secret + 32 * i, InSeed);
+			}
+
+			accumulator.Low = Avalanche(accumulator.Low);
+			accumulator.High = Avalanche(accumulator.High);
+
+			for (SIZE_T i = 4; i < roundsCount; ++i)
+			{
+				Mix32(accumulator, Data + 32 * i, Data + 32 * i + 16, Secret + 32 * (i - 4) + 3, InSeed);
+			}
+
+			Mix32(accumulator, Data + Size - 16, Data + Size - 32, Secret + 136 - 17 - 16, 0 - InSeed);
+
+			return Finalize128(accumulator, Size, InSeed);
+		}
+
+		template<class CharType>
+		constexpr SHash128 Hash128Short(const CharType* Data, SIZE_T Size, uint64 InSeed)
+		{
+			if (Size <= 16)
+			{
+				return Hash128Upto16(Data, Size, InSeed, GHashSecret);
+			}
+
+			return (Size <= 128) ? Hash128Upto128(Data, Size, InSeed, GHashSecret) : Hash128Upto240(Data, Size, InSeed, GHashSecret);
+		}
+
+		/************************************************************************/
+		/* Long inputs                                                          */
+		/************************************************************************/
+
+		/** Folds the 8 accumulators into 64 bits. */
+		FORCEINLINE constexpr uint64 MergeAccumulators(const uint64* Accumulators, const uint8* Secret, uint64 InStart)
+		{
+			uint64 result = InStart;
+
+			for (SIZE_T i = 0; i < 4; ++i)
+			{
+				result += MultiplyFold64(Accumulators[2 * i] ^ ReadLE64(Secret + 16 * i), Accumulators[2 * i + 1] ^ ReadLE64(Secret + 16 * i + 8));
+			}
+
+			return Avalanche(result);
+		}
+
+		FORCEINLINE constexpr uint64 MergeAccumulators64(const uint64* Accumulators, const uint8* Secret, SIZE_T Size)
+		{
+			return MergeAccumulators(Accumulators, Secret + 11, Size * GPrime64_1);
+		}
+
+		FORCEINLINE constexpr SHash128 MergeAccumulators128(const uint64* Accumulators, const uint8* Secret, SIZE_T Size)
+		{
+			return
+			{
+				MergeAccumulators(Accumulators, Secret + 11, Size * GPrime64_1),
+				MergeAccumulators(Accumulators, Secret + GHashSecretSize - 64 - 11, ~(Size * GPrime64_2))
+			};
+		}
+
+		template<class CharType>
+		constexpr void AccumulateStripeScalar(uint64* Accumulators, const CharType* Data, const uint8* Secret)
+		{
+			for (SIZE_T i = 0; i < 8; ++i)
+			{
+				const uint64 value = ReadLE64(Data + 8 * i);
+				const uint64 keyed = value ^ ReadLE64(Secret + 8 * i);
+
+				Accumulators[i ^ 1] += value;
+				Accumulators[i] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+			}
+		}
+
+		constexpr void ScrambleScalar(uint64* Accumulators, const uint8* Secret)
+		{
+			for (SIZE_T i = 0; i < 8; ++i)
+			{
+				uint64 value = Accumulators[i];
+
+				value ^= value >> 47;
+				value ^= ReadLE64(Secret + 8 * i);
+				Accumulators[i] = value * GPrime32_1;
+			}
+		}
+
+		/** Scalar long-input loop for constant evaluation, the runtime uses the vector kernels of Hash.cpp. */
+		template<class CharType>
+		constexpr void HashLongScalar(uint64* Accumulators, const CharType* Data, SIZE_T Size, const uint8* Secret)
+		{
+			constexpr SIZE_T stripesPerBlock = (GHashSecretSize - GHashStripeSize) / 8;
+			constexpr SIZE_T blockSize = GHashStripeSize * stripesPerBlock;
+
+			const SIZE_T blocksCount = (Size - 1) / blockSize;
+
+			for (SIZE_T block = 0; block < blocksCount; ++block)
+			{
+				for (SIZE_T stripe = 0; stripe < stripesPerBlock; ++stripe)
+				{
+					AccumulateStripeScalar(Accumulators, Data + block * blockSize + stripe * GHashStripeSize, Secret + stripe * 8);
+				}
+
+				ScrambleScalar(Accumulators, Secret + GHashSecretSize - GHashStripeSize);
+			}
+
+			const SIZE_T stripesCount = ((Size - 1) - blockSize * blocksCount) / GHashStripeSize;
+
+			for (SIZE_T stripe = 0; stripe < stripesCount; ++stripe)
+			{
+				AccumulateStripeScalar(Accumulators, Data + blocksCount * blockSize + stripe * GHashStripeSize, Secret + stripe * 8);
+			}
+
+			AccumulateStripeScalar(Accumulators, Data + Size - GHashStripeSize, Secret + GHashSecretSize - GHashStripeSize - 7);
+		}
+
+		template<class CharType>
+		constexpr uint64 Hash64Constant(const CharType* Data, SIZE_T Size, uint64 InSeed)
+		{
+			if (Size <= GHashMidSizeMax)
+			{
+				return Hash64Short(Data, Size, InSeed);
+			}
+
+			const std::array<uint8, GHashSecretSize> secret = MakeSecret(InSeed);
+
+			uint64 accumulators[8] = { };
+			std::copy_n(GHashInitialAccumulators, 8, accumulators);
+
+			HashLongScalar(accumulators, Data, Size, secret.data());
+
+			return MergeAccumulators64(accumulators, secret.data(), Size);
+		}
+	}
+
+	/**
+	 * 64-bit XXH3 of a buffer, SIMD accumulation for inputs longer than 240 bytes.
+	 *
+	 * \param Data		- Bytes to hash.
+	 * \param Size		- Number of bytes.
+	 * \param InSeed	- Seed, 0 gives the reference XXH3_64bits value.
+	 */
+	uint64 Hash64(const void* Data, SIZE_T Size, uint64 InSeed = 0);
+
+	INLINE uint64 Hash64(Span<const byte> Data, uint64 InSeed = 0)
+	{
+		return Hash64(Data.data(), Data.size(), InSeed);
+	}
+
+	/**
+	 * 128-bit XXH3, for keys that must stay collision free over millions of entries (content-addressed caches).
+	 */
+	SHash128 Hash128(const void* Data, SIZE_T Size, uint64 InSeed = 0);
+
+	INLINE SHash128 Hash128(Span<const byte> Data, uint64 InSeed = 0)
+	{
+		return Hash128(Data.data(), Data.size(), InSeed);
+	}
+
+	/**
+	 * Hash64 of a string, evaluated at compile time for literals and constexpr strings.
+	 */
+	constexpr uint64 HashString(std::string_view InString, uint64 InSeed = 0)
+	{
+		if (std::is_constant_evaluated())
+		{
+			return Details::Hash64Constant(InString.data(), InString.size(), InSeed);
+		}
+
+		return Hash64(InString.data(), InString.size(), InSeed);
+	}
+
+	namespace Literals
+	{
+		/** "Name"_Hash, always a compile time constant. */
+		consteval uint64 operator ""_Hash(const CHAR* InString, SIZE_T InLength)
+		{
+			return Details::Hash64Constant(InString, InLength, 0);
+		}
+	}
+
+	/**
+	 * Incremental Hash64 / Hash128, gives the same values as hashing everything at once.
+	 */
+	class HashStream
+	{
+	public:
+
+		explicit HashStream(uint64 InSeed = 0);
+
+		void Update(const void* Data, SIZE_T Size);
+
+		void Update(Span<const byte> Data) { Update(Data.data(), Data.size()); }
+
+		uint64 GetHash64() const;
+
+		SHash128 GetHash128() const;
+
+		void Reset();
+
+	private:
+
+		/** Accumulators after the stripes still buffered are consumed, used by the getters. */
+		void FinalizeAccumulators(uint64* OutAccumulators) const;
+
+		static constexpr SIZE_T BufferSize = 256;
+
+		alignas(64) uint64	Accumulators[8];
+
+		alignas(64) uint8	Secret[Details::GHashSecretSize];
+
+		alignas(64) uint8	Buffer[BufferSize];
+
+		uint64				TotalSize;
+
+		uint64				Seed;
+
+		SIZE_T				StripesInBlock;
+
+		uint32				BufferedSize;
+	};
+
+}
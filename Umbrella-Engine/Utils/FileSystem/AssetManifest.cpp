@@ -0,0 +1,260 @@
+#include "AssetManifest.h"
+#include "BinaryArchive.h"
+#include "../Cryptography/CRC32.h"
+#include "../Threading/ThreadPool.h"
+#include <algorithm>
+
+
+
+namespace J::system
+{
+
+	// smaller files are read into a reused buffer, larger ones are mapped
+	static constexpr SIZE_T GMapThreshold = 256 * 1024;
+
+	// shared length, suffix length, size, time (a byte each at least) and the hash
+	static constexpr SIZE_T GMinEntrySize = 4 + sizeof(Crypto::SHash128);
+
+
+	/** Hashes a file from the disk, InOutSize becomes the size actually read (the file may have changed since the scan). */
+	static bool HashFile(const FilePath& InPath, uint64& InOutSize, Crypto::SHash128& OutHash)
+	{
+		if (InOutSize >= GMapThreshold)
+		{
+			// absolute, so the mounts are not looked at
+			MappedFile file;
+
+			if (!file.Open(InPath))
+			{
+				return false;
+			}
+
+			file.Advise(MappedFile::EAccessPattern::Sequential);
+
+			InOutSize = file.GetSize();
+			OutHash = Crypto::Hash128(file.GetView());
+
+			return true;
+		}
+
+		thread_local JVector<byte> buffer;
+
+		if (!Details::ReadFromDisk(InPath, buffer))
+		{
+			return false;
+		}
+
+		InOutSize = buffer.size();
+		OutHash = Crypto::Hash128(Span<const byte>(buffer));
+
+		return true;
+	}
+
+
+	bool AssetManifest::Build(const FilePath& InDirectory, const AssetManifest* InPrevious)
+	{
+		Entries.clear();
+
+		std::error_code error;
+		const FilePath directory = std::filesystem::absolute(InDirectory, error);
+
+		JVector<SScannedFile> files;
+
+		if (error)
+		{
+			return false;
+		}
+
+		bool bGood = ScanDirectory(directory, files);
+
+		Entries.resize(files.size());
+
+		// indices of the entries to hash
+		JVector<SIZE_T> changed;
+
+		for (SIZE_T i = 0; i < files.size(); ++i)
+		{
+			SManifestEntry& entry = Entries[i];
+
+			entry.Path = std::move(files[i].Path);
+			entry.Size = files[i].Size;
+			entry.ModificationTime = files[i].ModificationTime;
+
+			const SManifestEntry* previous = InPrevious ? InPrevious->Find(entry.Path) : nullptr;
+
+			if (previous && previous->Size == entry.Size && previous->ModificationTime == entry.ModificationTime)
+			{
+				entry.Hash = previous->Hash;
+			}
+			else
+			{
+				changed.push_back(i);
+			}
+		}
+
+		Utils::ThreadPool::Get().ParallelFor(changed.size(), 1, [this, &directory, &changed](SIZE_T InBegin, SIZE_T InEnd)
+		{
+			for (SIZE_T i = InBegin; i < InEnd; ++i)
+			{
+				SManifestEntry& entry = Entries[changed[i]];
+
+				if (!HashFile(directory / FilePath(entry.Path), entry.Size, entry.Hash))
+				{
+					// removed since the scan or unreadable, dropped below
+					entry.Path.clear();
+				}
+			}
+		});
+
+		const SIZE_T unreadable = std::erase_if(Entries, [](const SManifestEntry& InEntry) { return InEntry.Path.empty(); });
+
+		return bGood && unreadable == 0;
+	}
+
+	bool AssetManifest::Save(const FilePath& InPath) const
+	{
+		// built in memory for the checksum
+		BinaryWriter writer;
+
+		writer << MagicValue << CurrentVersion;
+		writer.WriteVarUInt(Entries.size());
+
+		std::string_view previous;
+
+		for (const SManifestEntry& entry : Entries)
+		{
+			const std::string_view path = entry.Path;
+			const SIZE_T shared = std::mismatch(path.begin(), path.end(), previous.begin(), previous.end()).first - path.begin();
+
+			writer.WriteVarUInt(shared);
+			writer.WriteString(path.substr(shared));
+			writer.WriteVarUInt(entry.Size);
+			writer.WriteVarInt(entry.ModificationTime);
+			writer << entry.Hash.Low << entry.Hash.High;
+
+			previous = path;
+		}
+
+		const uint32 checksum = Crypto::CRC32C(writer.GetData());
+		writer << checksum;
+
+		BinaryWriter file(InPath);
+		file.WriteSpan(writer.GetData());
+
+		return file.Close();
+	}
+
+	bool AssetManifest::Load(const FilePath& InPath)
+	{
+		Entries.clear();
+
+		BinaryReader file(InPath);
+
+		if (!file.IsGood() || file.GetSize() < sizeof(uint32))
+		{
+			return false;
+		}
+
+		const Span<const byte> content = file.ReadView(static_cast<SIZE_T>(file.GetSize()) - sizeof(uint32));
+
+		if (file.Read<uint32>() != Crypto::CRC32C(content))
+		{
+			// todo: normal error log system
+			return false;
+		}
+
+		BinaryReader reader(content);
+
+		if (reader.Read<uint32>() != MagicValue || reader.Read<uint32>() != CurrentVersion)
+		{
+			return false;
+		}
+
+		const uint64 count = reader.ReadVarUInt();
+
+		if (!reader.IsGood() || count > reader.GetRemaining() / GMinEntrySize)
+		{
+			return false;
+		}
+
+		Entries.resize(static_cast<SIZE_T>(count));
+
+		for (SIZE_T i = 0; i < Entries.size(); ++i)
+		{
+			SManifestEntry& entry = Entries[i];
+			const std::string_view previous = i > 0 ? std::string_view(Entries[i - 1].Path) : std::string_view();
+
+			const uint64 shared = reader.ReadVarUInt();
+			const std::string_view suffix = reader.ReadStringView();
+
+			if (!reader.IsGood() || shared > previous.size())
+			{
+				Entries.clear();
+				return false;
+			}
+
+			entry.Path.reserve(static_cast<SIZE_T>(shared) + suffix.size());
+			entry.Path.assign(previous.substr(0, static_cast<SIZE_T>(shared)));
+			entry.Path += suffix;
+
+			entry.Size = reader.ReadVarUInt();
+			entry.ModificationTime = reader.ReadVarInt();
+			reader >> entry.Hash.Low >> entry.Hash.High;
+
+			// Find relies on the order
+			if (!reader.IsGood() || entry.Path.empty() || entry.Path <= previous)
+			{
+				Entries.clear();
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	SManifestDiff AssetManifest::Diff(const AssetManifest& InPrevious) const
+	{
+		SManifestDiff diff;
+
+		auto current = Entries.begin();
+		auto previous = InPrevious.Entries.begin();
+
+		// both are sorted, one merge pass
+		while (current != Entries.end() || previous != InPrevious.Entries.end())
+		{
+			if (previous == InPrevious.Entries.end() || (current != Entries.end() && current->Path < previous->Path))
+			{
+				diff.Added.push_back(current->Path);
+				++current;
+			}
+			else if (current == Entries.end() || previous->Path < current->Path)
+			{
+				diff.Removed.push_back(previous->Path);
+				++previous;
+			}
+			else
+			{
+				if (current->Size != previous->Size || current->Hash != previous->Hash)
+				{
+					diff.Modified.push_back(current->Path);
+				}
+
+				++current;
+				++previous;
+			}
+		}
+
+		return diff;
+	}
+
+	const SManifestEntry* AssetManifest::Find(std::string_view InPath) const
+	{
+		auto found = std::lower_bound(Entries.begin(), Entries.end(), InPath, [](const SManifestEntry& InEntry, std::string_view InValue)
+		{
+			return InEntry.Path < InValue;
+		});
+
+		return found != Entries.end() && found->Path == InPath ? &*found : nullptr;
+	}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "DirectoryScanner.h"
+#include "../Cryptography/Hash.h"
+
+
+
+namespace J::system
+{
+
+	struct SManifestEntry
+	{
+		// relative to the manifest's directory, with '/' separators
+		std::string			Path;
+
+		uint64				Size				= 0;
+
+		// see SScannedFile
+		int64				ModificationTime	= 0;
+
+		// XXH3-128 of the contents
+		Crypto::SHash128	Hash;
+	};
+
+	/** Differences between two manifests of the same directory, paths sorted. */
+	struct SManifestDiff
+	{
+		JVector<std::string>	Added;
+
+		JVector<std::string>	Modified;
+
+		JVector<std::string>	Removed;
+
+		bool IsEmpty() const { return Added.empty() && Modified.empty() && Removed.empty(); }
+	};
+
+
+	/**
+	 * Sizes, modification times and content hashes of every file under an asset directory, saved next to cooked
+	 * data so the next run processes only what changed.
+	 *
+	 * Building against the previous manifest reads only the files whose size or modification time changed, the
+	 * others keep their hash. Diff then compares the contents: a file that was touched but not changed is not reported.
+	 *
+	 * File: "JMNF" magic, version, count, then the entries sorted by path, each path stored as the length it shares
+	 * with the previous one and the rest, and a CRC32C of everything before it.
+	 */
+	class AssetManifest
+	{
+	public:
+
+		static constexpr uint32 MagicValue = 0x464E4D4A;	// "JMNF"
+		static constexpr uint32 CurrentVersion = 1;
+
+	public:
+
+		AssetManifest() = default;
+
+		/**
+		 * Scans a directory and hashes its files in parallel.
+		 *
+		 * \param InDirectory	- Directory on the disk.
+		 * \param InPrevious	- Earlier manifest of the same directory, its hashes are reused for unchanged files.
+		 * \return false if the directory, or some of its files or subdirectories, could not be read (they are left out).
+		 */
+		bool Build(const FilePath& InDirectory, const AssetManifest* InPrevious = nullptr);
+
+		/** \return false if the file could not be written. */
+		bool Save(const FilePath& InPath) const;
+
+		/** \return false if the file is missing or damaged, the manifest is empty then. */
+		bool Load(const FilePath& InPath);
+
+		/** What changed since InPrevious. */
+		SManifestDiff Diff(const AssetManifest& InPrevious) const;
+
+		/** \return nullptr if the path is not in the manifest. */
+		const SManifestEntry* Find(std::string_view InPath) const;
+
+		Span<const SManifestEntry> GetEntries() const { return Entries; }
+
+		SIZE_T GetEntriesCount() const { return Entries.size(); }
+
+	private:
+
+		// sorted by path
+		JVector<SManifestEntry> Entries;
+	};
+
+}
@@ -0,0 +1,942 @@
+#include "AsyncIO.h"
+#include <algorithm>
+
+#if ENGINE_WINDOWS_PLATFORM
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+	#undef CreateDirectory
+#else
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#if ENGINE_LINUX_PLATFORM
+	#include <atomic>
+	#include <linux/io_uring.h>
+	#include <string>
+	#include <sys/eventfd.h>
+	#include <sys/mman.h>
+	#include <sys/syscall.h>
+	#include <unordered_map>
+#endif
+
+
+
+namespace J::system
+{
+
+	// the fallback reads in chunks of this size and checks for cancellation in between
+	static constexpr SIZE_T GFallbackChunkSize = SIZE_T(4) << 20;
+
+
+	/****/
+	/* REQUEST */
+	/****/
+
+	void AsyncReadRequest::Wait() const
+	{
+		while (!bDone.load(std::memory_order_acquire))
+		{
+			bDone.wait(false, std::memory_order_acquire);
+		}
+	}
+
+	bool AsyncIO::SPriorityOrder::operator () (const AsyncReadHandle& InLeft, const AsyncReadHandle& InRight) const
+	{
+		if (InLeft->Desc.Priority != InRight->Desc.Priority)
+		{
+			return InLeft->Desc.Priority > InRight->Desc.Priority;
+		}
+
+		return InLeft->Sequence < InRight->Sequence;
+	}
+
+
+	/****/
+	/* IO_URING */
+	/****/
+
+#if ENGINE_LINUX_PLATFORM
+
+	namespace
+	{
+		// user_data of the internal operations, reads use the address of their request
+		constexpr uint64 GWakeTag = 1;
+		constexpr uint64 GCancelTag = 2;
+
+		// longest single read, the length of a submission entry is 32-bit
+		constexpr SIZE_T GMaxReadSize = SIZE_T(1) << 30;
+
+		// ioprio of the best effort class, level 0 is served first and 7 last (linux/ioprio.h)
+		constexpr uint16 GIOPrioClassBestEffort = 2;
+		constexpr uint16 GIOPrioClassShift = 13;
+
+		uint16 ToIOPrio(EIOPriority InPriority)
+		{
+			const uint16 level = (InPriority == EIOPriority::High) ? 0 : (InPriority == EIOPriority::Normal) ? 4 : 7;
+
+			return static_cast<uint16>((GIOPrioClassBestEffort << GIOPrioClassShift) | level);
+		}
+
+		// the ring indices are shared with the kernel
+		uint32 LoadAcquire(uint32* InValue)
+		{
+			return std::atomic_ref<uint32>(*InValue).load(std::memory_order_acquire);
+		}
+
+		void StoreRelease(uint32* InValue, uint32 InNewValue)
+		{
+			std::atomic_ref<uint32>(*InValue).store(InNewValue, std::memory_order_release);
+		}
+	}
+
+
+	/** Submission and completion queues of one io_uring, used by the ring thread only (Wake excepted). */
+	struct AsyncIO::SRing
+	{
+		struct SOpenFile
+		{
+			int32				Descriptor	= -1;
+
+			uint32				Users		= 0;
+		};
+
+		struct SInFlight
+		{
+			AsyncReadHandle		Request;
+
+			SOpenFile*			File			= nullptr;
+
+			bool				bCancelIssued	= false;
+		};
+
+		~SRing();
+
+		bool Setup(uint32 InEntries);
+
+		/** Wakes the ring thread, callable from any thread. */
+		void Wake();
+
+		/** Opens the file (or reuses an open descriptor) and submits the first part of the read. */
+		void StartRead(const AsyncReadHandle& InRequest);
+
+		/** Submits the rest of a read, reads can complete short. */
+		void ContinueRead(SInFlight& InEntry);
+
+		void EndRead(AsyncReadRequest* InRequest, EIOStatus InStatus, int32 InError = 0);
+
+		void CancelRead(SInFlight& InEntry);
+
+		/** Keeps a read on the wake up eventfd in flight, so a wait on the ring returns when new work is queued. */
+		void ArmWake();
+
+		/** Submits the prepared entries, with bInWait blocks until a completion is available. */
+		void Submit(bool bInWait);
+
+		void ReapCompletions();
+
+		void OnCompletion(uint64 InUserData, int32 InResult);
+
+		/** Closes the descriptors no read uses, so files replaced on disk are opened again. */
+		void CloseIdleFiles();
+
+		/** Next free submission entry, flushes the queue when it is full. nullptr if the kernel does not take more. */
+		io_uring_sqe* GetSQE();
+
+		int32				Descriptor		= -1;
+
+		void*				SQMemory		= nullptr;
+		SIZE_T				SQMemorySize	= 0;
+
+		void*				CQMemory		= nullptr;
+		SIZE_T				CQMemorySize	= 0;
+
+		io_uring_sqe*		SQEs			= nullptr;
+		SIZE_T				SQEsSize		= 0;
+
+		uint32*				SQHead			= nullptr;
+		uint32*				SQTail			= nullptr;
+		uint32*				SQArray			= nullptr;
+		uint32				SQMask			= 0;
+		uint32				SQEntries		= 0;
+
+		uint32*				CQHead			= nullptr;
+		uint32*				CQTail			= nullptr;
+		io_uring_cqe*		CQEs			= nullptr;
+		uint32				CQMask			= 0;
+
+		// entries prepared since the last submission
+		uint32				LocalTail		= 0;
+		uint32				ToSubmit		= 0;
+
+		int32				WakeDescriptor	= -1;
+		uint64				WakeValue		= 0;
+		bool				bWakeArmed		= false;
+
+		std::unordered_map<AsyncReadRequest*, SInFlight>	InFlight;
+
+		std::unordered_map<std::string, SOpenFile>			Files;
+	};
+
+	AsyncIO::SRing::~SRing()
+	{
+		for (const auto& [path, file] : Files)
+		{
+			::close(file.Descriptor);
+		}
+
+		if (SQEs != nullptr)
+		{
+			::munmap(SQEs, SQEsSize);
+		}
+
+		if (CQMemory != nullptr && CQMemory != SQMemory)
+		{
+			::munmap(CQMemory, CQMemorySize);
+		}
+
+		if (SQMemory != nullptr)
+		{
+			::munmap(SQMemory, SQMemorySize);
+		}
+
+		if (WakeDescriptor >= 0)
+		{
+			::close(WakeDescriptor);
+		}
+
+		// closing the ring cancels whatever is still in flight (the wake up read)
+		if (Descriptor >= 0)
+		{
+			::close(Descriptor);
+		}
+	}
+
+	bool AsyncIO::SRing::Setup(uint32 InEntries)
+	{
+		io_uring_params params = {};
+
+		Descriptor = static_cast<int32>(::syscall(__NR_io_uring_setup, InEntries, &params));
+
+		if (Descriptor < 0)
+		{
+			// ENOSYS on old kernels, EPERM when disabled or filtered out by a sandbox
+			Descriptor = -1;
+			return false;
+		}
+
+		// IORING_OP_READ came with RW_CUR_POS (5.6), NODROP keeps completions when the queue overflows
+		if ((params.features & IORING_FEAT_NODROP) == 0 || (params.features & IORING_FEAT_RW_CUR_POS) == 0)
+		{
+			return false;
+		}
+
+		SQMemorySize = params.sq_off.array + params.sq_entries * sizeof(uint32);
+		CQMemorySize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+		const bool bSingleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+		if (bSingleMapping)
+		{
+			SQMemorySize = CQMemorySize = std::max(SQMemorySize, CQMemorySize);
+		}
+
+		auto map = [this](SIZE_T InSize, off_t InOffset) -> void*
+		{
+			void* address = ::mmap(nullptr, InSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Descriptor, InOffset);
+
+			return (address == MAP_FAILED) ? nullptr : address;
+		};
+
+		SQMemory = map(SQMemorySize, IORING_OFF_SQ_RING);
+		CQMemory = bSingleMapping ? SQMemory : map(CQMemorySize, IORING_OFF_CQ_RING);
+
+		SQEsSize = params.sq_entries * sizeof(io_uring_sqe);
+		SQEs = static_cast<io_uring_sqe*>(map(SQEsSize, IORING_OFF_SQES));
+
+		if (SQMemory == nullptr || CQMemory == nullptr || SQEs == nullptr)
+		{
+			return false;
+		}
+
+		byte* sq = static_cast<byte*>(SQMemory);
+		byte* cq = static_cast<byte*>(CQMemory);
+
+		SQHead		= reinterpret_cast<uint32*>(sq + params.sq_off.head);
+		SQTail		= reinterpret_cast<uint32*>(sq + params.sq_off.tail);
+		SQArray		= reinterpret_cast<uint32*>(sq + params.sq_off.array);
+		SQMask		= *reinterpret_cast<uint32*>(sq + params.sq_off.ring_mask);
+		SQEntries	= params.sq_entries;
+
+		CQHead		= reinterpret_cast<uint32*>(cq + params.cq_off.head);
+		CQTail		= reinterpret_cast<uint32*>(cq + params.cq_off.tail);
+		CQEs		= reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+		CQMask		= *reinterpret_cast<uint32*>(cq + params.cq_off.ring_mask);
+
+		LocalTail	= *SQTail;
+
+		WakeDescriptor = ::eventfd(0, EFD_CLOEXEC);
+
+		return WakeDescriptor >= 0;
+	}
+
+	void AsyncIO::SRing::Wake()
+	{
+		const uint64 value = 1;
+
+		// the counter only has to become non-zero, a failed write means it is already saturated
+		[[maybe_unused]] const ssize_t written = ::write(WakeDescriptor, &value, sizeof(value));
+	}
+
+	io_uring_sqe* AsyncIO::SRing::GetSQE()
+	{
+		if (LocalTail - LoadAcquire(SQHead) >= SQEntries)
+		{
+			Submit(false);
+
+			if (LocalTail - LoadAcquire(SQHead) >= SQEntries)
+			{
+				return nullptr;
+			}
+		}
+
+		const uint32 index = LocalTail & SQMask;
+
+		SQArray[index] = index;
+
+		++LocalTail;
+		++ToSubmit;
+
+		io_uring_sqe* sqe = &SQEs[index];
+		*sqe = {};
+
+		return sqe;
+	}
+
+	void AsyncIO::SRing::Submit(bool bInWait)
+	{
+		// publishes the entries filled since the last call
+		StoreRelease(SQTail, LocalTail);
+
+		const bool bWait = bInWait && LoadAcquire(CQTail) == *CQHead;
+
+		while (ToSubmit > 0 || bWait)
+		{
+			const long result = ::syscall(__NR_io_uring_enter, Descriptor, ToSubmit, bWait ? 1 : 0, bWait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+
+			if (result >= 0)
+			{
+				ToSubmit -= static_cast<uint32>(result);
+				break;
+			}
+
+			if (errno != EINTR)
+			{
+				// EBUSY / EAGAIN: the kernel is short on resources, the entries stay queued for the next call
+				break;
+			}
+		}
+	}
+
+	void AsyncIO::SRing::ReapCompletions()
+	{
+		uint32 head = *CQHead;
+
+		for (const uint32 tail = LoadAcquire(CQTail); head != tail; ++head)
+		{
+			const io_uring_cqe& cqe = CQEs[head & CQMask];
+
+			OnCompletion(cqe.user_data, cqe.res);
+		}
+
+		StoreRelease(CQHead, head);
+	}
+
+	void AsyncIO::SRing::ArmWake()
+	{
+		if (bWakeArmed)
+		{
+			return;
+		}
+
+		if (io_uring_sqe* sqe = GetSQE())
+		{
+			sqe->opcode		= IORING_OP_READ;
+			sqe->fd			= WakeDescriptor;
+			sqe->addr		= reinterpret_cast<uint64>(&WakeValue);
+			sqe->len		= sizeof(WakeValue);
+			sqe->user_data	= GWakeTag;
+
+			bWakeArmed = true;
+		}
+	}
+
+	void AsyncIO::SRing::StartRead(const AsyncReadHandle& InRequest)
+	{
+		const std::string& path = InRequest->Desc.Path.native();
+
+		auto file = Files.find(path);
+
+		if (file == Files.end())
+		{
+			const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+			if (descriptor < 0)
+			{
+				Finish(*InRequest, EIOStatus::Failed, errno);
+				return;
+			}
+
+			file = Files.emplace(path, SOpenFile{ descriptor, 0 }).first;
+		}
+
+		++file->second.Users;
+
+		SInFlight& entry = InFlight[InRequest.get()];
+		entry.Request = InRequest;
+		entry.File = &file->second;
+
+		ContinueRead(entry);
+	}
+
+	void AsyncIO::SRing::ContinueRead(SInFlight& InEntry)
+	{
+		AsyncReadRequest& request = *InEntry.Request;
+
+		io_uring_sqe* sqe = GetSQE();
+
+		if (sqe == nullptr)
+		{
+			EndRead(&request, EIOStatus::Failed, EBUSY);
+			return;
+		}
+
+		sqe->opcode		= IORING_OP_READ;
+		sqe->fd			= InEntry.File->Descriptor;
+		sqe->ioprio		= ToIOPrio(request.Desc.Priority);
+		sqe->addr		= reinterpret_cast<uint64>(static_cast<byte*>(request.Desc.Destination) + request.BytesRead);
+		sqe->len		= static_cast<uint32>(std::min(request.Desc.Size - request.BytesRead, GMaxReadSize));
+		sqe->off		= request.Desc.Offset + request.BytesRead;
+		sqe->user_data	= reinterpret_cast<uint64>(&request);
+	}
+
+	void AsyncIO::SRing::EndRead(AsyncReadRequest* InRequest, EIOStatus InStatus, int32 InError)
+	{
+		auto entry = InFlight.find(InRequest);
+
+		// keeps the request alive during the completion
+		AsyncReadHandle request = std::move(entry->second.Request);
+
+		--entry->second.File->Users;
+		InFlight.erase(entry);
+
+		Finish(*request, InStatus, InError);
+	}
+
+	void AsyncIO::SRing::CancelRead(SInFlight& InEntry)
+	{
+		InEntry.Request->bCancelRequested.store(true, std::memory_order_relaxed);
+
+		if (InEntry.bCancelIssued)
+		{
+			return;
+		}
+
+		if (io_uring_sqe* sqe = GetSQE())
+		{
+			sqe->opcode		= IORING_OP_ASYNC_CANCEL;
+			sqe->addr		= reinterpret_cast<uint64>(InEntry.Request.get());
+			sqe->user_data	= GCancelTag;
+
+			InEntry.bCancelIssued = true;
+		}
+	}
+
+	void AsyncIO::SRing::OnCompletion(uint64 InUserData, int32 InResult)
+	{
+		if (InUserData == GWakeTag)
+		{
+			bWakeArmed = false;
+			return;
+		}
+
+		// the outcome of a cancellation shows up on the read itself
+		if (InUserData == GCancelTag)
+		{
+			return;
+		}
+
+		auto* request = reinterpret_cast<AsyncReadRequest*>(InUserData);
+
+		const bool bCancelRequested = request->bCancelRequested.load(std::memory_order_relaxed);
+
+		if (InResult < 0)
+		{
+			if (InResult == -ECANCELED || (InResult == -EINTR && bCancelRequested))
+			{
+				EndRead(request, EIOStatus::Cancelled);
+			}
+			else if (InResult == -EINTR || InResult == -EAGAIN)
+			{
+				ContinueRead(InFlight[request]);
+			}
+			else
+			{
+				EndRead(request, EIOStatus::Failed, -InResult);
+			}
+
+			return;
+		}
+
+		request->BytesRead += static_cast<SIZE_T>(InResult);
+
+		if (InResult == 0 || request->BytesRead == request->Desc.Size)
+		{
+			EndRead(request, EIOStatus::Completed);
+		}
+		else if (bCancelRequested)
+		{
+			EndRead(request, EIOStatus::Cancelled);
+		}
+		else
+		{
+			ContinueRead(InFlight[request]);
+		}
+	}
+
+	void AsyncIO::SRing::CloseIdleFiles()
+	{
+		std::erase_if(Files, [](const auto& InFile)
+		{
+			if (InFile.second.Users != 0)
+			{
+				return false;
+			}
+
+			::close(InFile.second.Descriptor);
+			return true;
+		});
+	}
+
+	void AsyncIO::RingLoop()
+	{
+		JVector<AsyncReadHandle> started;
+		JVector<AsyncReadHandle> dropped;
+		JVector<AsyncReadHandle> cancels;
+
+		while (true)
+		{
+			bool bStop;
+
+			{
+				JF_SCOPED_LOCK(Mutex);
+
+				bStop = bStopping;
+
+				JVector<AsyncReadHandle>& target = bStop ? dropped : started;
+
+				while (!Pending.empty() && (bStop || Ring->InFlight.size() + started.size() < QueueDepth))
+				{
+					target.push_back(std::move(Pending.extract(Pending.begin()).value()));
+				}
+
+				cancels.swap(CancelRequests);
+			}
+
+			for (const AsyncReadHandle& request : dropped)
+			{
+				Finish(*request, EIOStatus::Cancelled);
+			}
+
+			// the whole batch goes to the kernel with the single Submit below
+			for (const AsyncReadHandle& request : started)
+			{
+				Ring->StartRead(request);
+			}
+
+			for (const AsyncReadHandle& request : cancels)
+			{
+				auto entry = Ring->InFlight.find(request.get());
+
+				if (entry != Ring->InFlight.end())
+				{
+					Ring->CancelRead(entry->second);
+				}
+			}
+
+			if (bStop)
+			{
+				for (auto& [request, entry] : Ring->InFlight)
+				{
+					Ring->CancelRead(entry);
+				}
+			}
+
+			started.clear();
+			dropped.clear();
+			cancels.clear();
+
+			if (Ring->InFlight.empty())
+			{
+				Ring->CloseIdleFiles();
+
+				if (bStop)
+				{
+					return;
+				}
+			}
+
+			Ring->ArmWake();
+			Ring->Submit(true);
+			Ring->ReapCompletions();
+		}
+	}
+
+#else
+
+	struct AsyncIO::SRing
+	{
+	};
+
+	void AsyncIO::RingLoop()
+	{
+	}
+
+#endif
+
+
+	/****/
+	/* SERVICE */
+	/****/
+
+	AsyncIO::AsyncIO(uint32 InQueueDepth, bool bInAllowIOUring)
+		: QueueDepth(std::max(InQueueDepth, 1u))
+	{
+#if ENGINE_LINUX_PLATFORM
+		if (bInAllowIOUring)
+		{
+			auto ring = MakeScoped<SRing>();
+
+			// room for every read in flight, their cancellations and the wake up read
+			if (ring->Setup(QueueDepth * 2 + 1))
+			{
+				Ring = std::move(ring);
+			}
+		}
+#endif
+
+		if (Ring != nullptr)
+		{
+			Workers.emplace_back([this]() { RingLoop(); });
+		}
+		else
+		{
+			const uint32 workersCount = std::clamp(QueueDepth / 16, 2u, 8u);
+
+			for (uint32 i = 0; i < workersCount; ++i)
+			{
+				Workers.emplace_back([this]() { WorkerLoop(); });
+			}
+		}
+	}
+
+	AsyncIO::~AsyncIO()
+	{
+		{
+			JF_SCOPED_LOCK(Mutex);
+			bStopping = true;
+		}
+
+		WakeUp();
+
+		for (auto& worker : Workers)
+		{
+			worker.join();
+		}
+
+		// the fallback workers leave the queue as is
+		for (const AsyncReadHandle& request : Pending)
+		{
+			Finish(*request, EIOStatus::Cancelled);
+		}
+
+		Pending.clear();
+	}
+
+	AsyncIO& AsyncIO::Get()
+	{
+		static AsyncIO service;
+		return service;
+	}
+
+	AsyncReadHandle AsyncIO::ReadAsync(const FilePath& InPath, uint64 InOffset, SIZE_T InSize, void* InDestination,
+									   EIOPriority InPriority, CompletionType InCompletion)
+	{
+		return ReadAsync(SAsyncReadDesc{ InPath, InOffset, InSize, InDestination, InPriority }, std::move(InCompletion));
+	}
+
+	AsyncReadHandle AsyncIO::ReadAsync(const SAsyncReadDesc& InDesc, CompletionType InCompletion)
+	{
+		JF_ASSERT(InDesc.Destination != nullptr || InDesc.Size == 0, "Read has no destination.");
+
+		auto request = MakeRef<AsyncReadRequest>();
+		request->Desc = InDesc;
+		request->Completion = std::move(InCompletion);
+
+		if (InDesc.Size == 0)
+		{
+			Finish(*request, EIOStatus::Completed);
+		}
+		else
+		{
+			Enqueue({ &request, 1 });
+		}
+
+		return request;
+	}
+
+	JVector<AsyncReadHandle> AsyncIO::ReadAsync(Span<const SAsyncReadDesc> InDescs, const CompletionType& InCompletion)
+	{
+		JVector<AsyncReadHandle> requests;
+		requests.reserve(InDescs.size());
+
+		JVector<AsyncReadHandle> queued;
+		queued.reserve(InDescs.size());
+
+		for (const SAsyncReadDesc& desc : InDescs)
+		{
+			JF_ASSERT(desc.Destination != nullptr || desc.Size == 0, "Read has no destination.");
+
+			auto request = MakeRef<AsyncReadRequest>();
+			request->Desc = desc;
+			request->Completion = InCompletion;
+
+			requests.push_back(request);
+
+			if (desc.Size > 0)
+			{
+				queued.push_back(std::move(request));
+			}
+		}
+
+		Enqueue(queued);
+
+		for (const AsyncReadHandle& request : requests)
+		{
+			if (request->Desc.Size == 0)
+			{
+				Finish(*request, EIOStatus::Completed);
+			}
+		}
+
+		return requests;
+	}
+
+	bool AsyncIO::Cancel(const AsyncReadHandle& InRequest)
+	{
+		if (InRequest == nullptr || InRequest->IsDone())
+		{
+			return false;
+		}
+
+		{
+			TUniqueLock<TMutex> lock(Mutex);
+
+			if (Pending.erase(InRequest) == 0)
+			{
+				// already started: the ring thread cancels it in the kernel, the fallback between two chunks
+				if (InRequest->IsDone() || InRequest->bCancelRequested.exchange(true))
+				{
+					return !InRequest->IsDone();
+				}
+
+				if (Ring != nullptr)
+				{
+					CancelRequests.push_back(InRequest);
+
+					lock.unlock();
+					WakeUp();
+				}
+
+				return true;
+			}
+		}
+
+		InRequest->bCancelRequested.store(true);
+		Finish(*InRequest, EIOStatus::Cancelled);
+
+		return true;
+	}
+
+	void AsyncIO::Enqueue(Span<const AsyncReadHandle> InRequests)
+	{
+		if (InRequests.empty())
+		{
+			return;
+		}
+
+		{
+			JF_SCOPED_LOCK(Mutex);
+
+			for (const AsyncReadHandle& request : InRequests)
+			{
+				request->Sequence = NextSequence++;
+				Pending.insert(request);
+			}
+		}
+
+		WakeUp();
+	}
+
+	void AsyncIO::WakeUp()
+	{
+#if ENGINE_LINUX_PLATFORM
+		if (Ring != nullptr)
+		{
+			Ring->Wake();
+			return;
+		}
+#endif
+
+		Condition.notify_all();
+	}
+
+	void AsyncIO::Finish(AsyncReadRequest& InRequest, EIOStatus InStatus, int32 InError)
+	{
+		InRequest.Error = InError;
+		InRequest.Status.store(InStatus, std::memory_order_release);
+
+		if (InRequest.Completion)
+		{
+			InRequest.Completion(InRequest);
+		}
+
+		InRequest.bDone.store(true, std::memory_order_release);
+		InRequest.bDone.notify_all();
+	}
+
+
+	/****/
+	/* FALLBACK */
+	/****/
+
+	void AsyncIO::WorkerLoop()
+	{
+		while (true)
+		{
+			AsyncReadHandle request;
+
+			{
+				TUniqueLock<TMutex> lock(Mutex);
+				Condition.wait(lock, [this]() { return bStopping || !Pending.empty(); });
+
+				if (bStopping)
+				{
+					return;
+				}
+
+				request = std::move(Pending.extract(Pending.begin()).value());
+			}
+
+			ReadBlocking(*request);
+		}
+	}
+
+	void AsyncIO::ReadBlocking(AsyncReadRequest& InRequest)
+	{
+		const SAsyncReadDesc& desc = InRequest.Desc;
+		byte* destination = static_cast<byte*>(desc.Destination);
+
+		EIOStatus status = EIOStatus::Completed;
+		int32 error = 0;
+
+#if ENGINE_WINDOWS_PLATFORM
+		HANDLE file = CreateFileW(desc.Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			Finish(InRequest, EIOStatus::Failed, static_cast<int32>(GetLastError()));
+			return;
+		}
+#else
+		const int descriptor = ::open(desc.Path.c_str(), O_RDONLY | O_CLOEXEC);
+
+		if (descriptor < 0)
+		{
+			Finish(InRequest, EIOStatus::Failed, errno);
+			return;
+		}
+#endif
+
+		while (InRequest.BytesRead < desc.Size)
+		{
+			if (InRequest.bCancelRequested.load(std::memory_order_relaxed))
+			{
+				status = EIOStatus::Cancelled;
+				break;
+			}
+
+			const SIZE_T chunkSize = std::min(desc.Size - InRequest.BytesRead, GFallbackChunkSize);
+			const uint64 offset = desc.Offset + InRequest.BytesRead;
+
+#if ENGINE_WINDOWS_PLATFORM
+			// a synchronous handle reads at the offset of the OVERLAPPED, like pread
+			OVERLAPPED overlapped = {};
+			overlapped.Offset = static_cast<DWORD>(offset);
+			overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+			DWORD bytesRead = 0;
+
+			if (!ReadFile(file, destination + InRequest.BytesRead, static_cast<DWORD>(chunkSize), &bytesRead, &overlapped))
+			{
+				const DWORD lastError = GetLastError();
+
+				if (lastError != ERROR_HANDLE_EOF)
+				{
+					status = EIOStatus::Failed;
+					error = static_cast<int32>(lastError);
+				}
+
+				break;
+			}
+#else
+			const ssize_t bytesRead = ::pread(descriptor, destination + InRequest.BytesRead, chunkSize, static_cast<off_t>(offset));
+
+			if (bytesRead < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+
+				status = EIOStatus::Failed;
+				error = errno;
+				break;
+			}
+#endif
+
+			// end of the file
+			if (bytesRead == 0)
+			{
+				break;
+			}
+
+			InRequest.BytesRead += static_cast<SIZE_T>(bytesRead);
+		}
+
+#if ENGINE_WINDOWS_PLATFORM
+		CloseHandle(file);
+#else
+		::close(descriptor);
+#endif
+
+		Finish(InRequest, status, error);
+	}
+
+}
@@ -0,0 +1,199 @@
+#pragma once
+#include "FileSystem.h"
+#include <condition_variable>
+#include <functional>
+#include <set>
+#include <thread>
+
+
+
+namespace J::system
+{
+
+	enum class EIOPriority : uint8
+	{
+		Low,			// background prefetch
+		Normal,
+		High,			// something is waiting for the data right now
+	};
+
+	enum class EIOStatus : uint8
+	{
+		Pending,
+		Completed,		// check GetBytesRead, reads past the end of the file are short
+		Failed,			// see GetError
+		Cancelled,
+	};
+
+	/** Description of one read, see AsyncIO::ReadAsync. */
+	struct SAsyncReadDesc
+	{
+		FilePath		Path;
+
+		uint64			Offset			= 0;
+
+		SIZE_T			Size			= 0;
+
+		void*			Destination		= nullptr;
+
+		EIOPriority		Priority		= EIOPriority::Normal;
+	};
+
+
+	/**
+	 * Handle of a read queued in AsyncIO, shared between the caller and the I/O threads.
+	 * The destination buffer must stay alive until the request is done.
+	 */
+	class AsyncReadRequest
+	{
+	public:
+
+		/** Called once the request is done, on an I/O thread (or on the thread cancelling a read that was not started). */
+		using CompletionType = std::function<void(const AsyncReadRequest&)>;
+
+	public:
+
+		const SAsyncReadDesc& GetDesc() const { return Desc; }
+
+		/** Pending until the read is over, final already inside the completion callback. */
+		EIOStatus GetStatus() const { return Status.load(std::memory_order_acquire); }
+
+		bool IsDone() const { return bDone.load(std::memory_order_acquire); }
+
+		/** Blocks until the read is done and the completion callback has returned. */
+		void Wait() const;
+
+		/** Number of bytes written into the destination, valid once done. */
+		SIZE_T GetBytesRead() const { return BytesRead; }
+
+		/** errno (GetLastError on Windows) of a failed read. */
+		int32 GetError() const { return Error; }
+
+	private:
+
+		friend class AsyncIO;
+
+		SAsyncReadDesc				Desc;
+
+		CompletionType				Completion;
+
+		// orders requests of the same priority first come, first served
+		uint64						Sequence		= 0;
+
+		SIZE_T						BytesRead		= 0;
+
+		int32						Error			= 0;
+
+		Atomic::TAtomic<EIOStatus>	Status { EIOStatus::Pending };
+
+		Atomic::TAtomicBool			bCancelRequested { false };
+
+		Atomic::TAtomicBool			bDone { false };
+	};
+
+	using AsyncReadHandle = Ref<AsyncReadRequest>;
+
+
+	/**
+	 * Asynchronous file reads, so streaming can overlap the disk with decoding and uploads.
+	 *
+	 * On Linux the reads go through io_uring: one service thread submits every queued read in a single
+	 * system call and reaps the completions. Where io_uring is not available (other platforms, old kernels,
+	 * sandboxes) a few worker threads run blocking positional reads instead.
+	 *
+	 * Queued reads are started by priority, then in submission order. At most InQueueDepth reads are
+	 * in flight at once, so a late High read does not wait behind a deep queue of Low ones.
+	 */
+	class AsyncIO
+	{
+	public:
+
+		using CompletionType = AsyncReadRequest::CompletionType;
+
+	public:
+
+		/**
+		 * \param InQueueDepth		- Maximal number of reads in flight, the fallback runs InQueueDepth / 16 workers (2 to 8).
+		 * \param bInAllowIOUring	- false forces the worker threads fallback.
+		 */
+		explicit AsyncIO(uint32 InQueueDepth = 64, bool bInAllowIOUring = true);
+
+		/** Cancels the queued reads and waits for the ones in flight. */
+		~AsyncIO();
+
+		AsyncIO(const AsyncIO&) = delete;
+		AsyncIO& operator = (const AsyncIO&) = delete;
+
+		/** The engine-wide service, created on first use. */
+		static AsyncIO& Get();
+
+		bool IsUsingIOUring() const { return Ring != nullptr; }
+
+		/**
+		 * Queues a read of InSize bytes at InOffset of a file.
+		 *
+		 * \param InDestination - Receives the data, must stay alive until the request is done.
+		 * \param InCompletion	- Optional, called once the request is done.
+		 * \return handle to wait on, query or cancel the read.
+		 */
+		AsyncReadHandle ReadAsync(const FilePath& InPath, uint64 InOffset, SIZE_T InSize, void* InDestination,
+								  EIOPriority InPriority = EIOPriority::Normal, CompletionType InCompletion = {});
+
+		AsyncReadHandle ReadAsync(const SAsyncReadDesc& InDesc, CompletionType InCompletion = {});
+
+		/** Queues a batch of reads at once: one lock, one wake up and one submission for the whole batch. */
+		JVector<AsyncReadHandle> ReadAsync(Span<const SAsyncReadDesc> InDescs, const CompletionType& InCompletion = {});
+
+		/**
+		 * Cancels a read. A queued read finishes as Cancelled right away, a read in flight is interrupted
+		 * if the kernel (or the next chunk of the fallback) still allows it, otherwise it completes normally.
+		 *
+		 * \return false if the read was already done.
+		 */
+		bool Cancel(const AsyncReadHandle& InRequest);
+
+	private:
+
+		struct SPriorityOrder
+		{
+			bool operator () (const AsyncReadHandle& InLeft, const AsyncReadHandle& InRight) const;
+		};
+
+		struct SRing;
+
+		/** Queues already prepared requests and wakes the I/O threads. */
+		void Enqueue(Span<const AsyncReadHandle> InRequests);
+
+		void WakeUp();
+
+		/** Publishes the result, runs the completion and wakes the waiters. */
+		static void Finish(AsyncReadRequest& InRequest, EIOStatus InStatus, int32 InError = 0);
+
+		void RingLoop();
+
+		void WorkerLoop();
+
+		/** Blocking read used by the fallback workers. */
+		static void ReadBlocking(AsyncReadRequest& InRequest);
+
+		JVector<std::thread>					Workers;
+
+		std::set<AsyncReadHandle, SPriorityOrder> Pending;
+
+		// reads in flight the ring thread has to cancel
+		JVector<AsyncReadHandle>				CancelRequests;
+
+		TMutex									Mutex;
+
+		std::condition_variable					Condition;
+
+		Scope<SRing>							Ring;
+
+		uint64									NextSequence	= 0;
+
+		uint32									QueueDepth;
+
+		bool									bStopping		= false;
+	};
+
+}
@@ -0,0 +1,451 @@
+#include "BinaryArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#if ENGINE_WINDOWS_PLATFORM
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+	#undef CreateDirectory
+#else
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+
+
+namespace J::system
+{
+
+	// longest LEB128 encoding of a 64-bit value
+	static constexpr SIZE_T GMaxVarIntSize = 10;
+
+	static constexpr SIZE_T GMinBufferSize = 4096;
+
+
+	/****/
+	/* BINARY WRITER */
+	/****/
+
+	BinaryWriter::BinaryWriter(const FilePath& InPath, SIZE_T InBufferSize)
+	{
+		Open(InPath, InBufferSize);
+	}
+
+	BinaryWriter::~BinaryWriter()
+	{
+		Close();
+	}
+
+	bool BinaryWriter::Open(const FilePath& InPath, SIZE_T InBufferSize)
+	{
+		Close();
+
+		Buffer.clear();
+		Used = 0;
+		FlushedSize = 0;
+
+#if ENGINE_WINDOWS_PLATFORM
+		HANDLE file = CreateFileW(InPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		bGood = (file != INVALID_HANDLE_VALUE);
+		FileHandle = bGood ? file : nullptr;
+#else
+		Descriptor = ::open(InPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+		bGood = (Descriptor >= 0);
+#endif
+
+		if (bGood)
+		{
+			Buffer.resize(std::max(InBufferSize, GMinBufferSize));
+		}
+
+		return bGood;
+	}
+
+	bool BinaryWriter::Close()
+	{
+		if (!IsFile())
+		{
+			return bGood;
+		}
+
+		Flush();
+
+#if ENGINE_WINDOWS_PLATFORM
+		CloseHandle(FileHandle);
+		FileHandle = nullptr;
+#else
+		if (::close(Descriptor) != 0)
+		{
+			bGood = false;
+		}
+
+		Descriptor = -1;
+#endif
+
+		const bool bSucceeded = bGood;
+
+		Buffer = {};
+		Used = 0;
+		FlushedSize = 0;
+		bGood = true;
+
+		return bSucceeded;
+	}
+
+	bool BinaryWriter::Flush()
+	{
+		if (!IsFile() || !bGood)
+		{
+			return bGood;
+		}
+
+		if (Used > 0 && WriteToFile(Buffer.data(), Used))
+		{
+			FlushedSize += Used;
+			Used = 0;
+		}
+
+		return bGood;
+	}
+
+	bool BinaryWriter::IsFile() const
+	{
+#if ENGINE_WINDOWS_PLATFORM
+		return FileHandle != nullptr;
+#else
+		return Descriptor >= 0;
+#endif
+	}
+
+	JVector<byte> BinaryWriter::TakeData()
+	{
+		JF_ASSERT(!IsFile(), "Only a memory writer has its data.");
+
+		Buffer.resize(Used);
+		JVector<byte> data = std::move(Buffer);
+
+		Buffer = {};
+		Used = 0;
+
+		return data;
+	}
+
+	bool BinaryWriter::Reserve(SIZE_T InSize)
+	{
+		if (!bGood)
+		{
+			return false;
+		}
+
+		if (IsFile())
+		{
+			// the buffer is never smaller than the small writes that come here
+			return Flush();
+		}
+
+		Buffer.resize(std::max({ Buffer.size() * 2, Used + InSize, GMinBufferSize }));
+		return true;
+	}
+
+	bool BinaryWriter::WriteToFile(const void* InData, SIZE_T InSize)
+	{
+		const byte* data = static_cast<const byte*>(InData);
+
+		while (InSize > 0)
+		{
+#if ENGINE_WINDOWS_PLATFORM
+			// WriteFile counts in DWORDs
+			const DWORD chunk = static_cast<DWORD>(std::min<SIZE_T>(InSize, 1u << 30));
+			DWORD written = 0;
+
+			if (!WriteFile(FileHandle, data, chunk, &written, nullptr) || written == 0)
+			{
+				bGood = false;
+				return false;
+			}
+#else
+			const ssize_t written = ::write(Descriptor, data, InSize);
+
+			if (written < 0 && errno == EINTR)
+			{
+				continue;
+			}
+
+			if (written <= 0)
+			{
+				bGood = false;
+				return false;
+			}
+#endif
+
+			data += written;
+			InSize -= static_cast<SIZE_T>(written);
+		}
+
+		return true;
+	}
+
+	void BinaryWriter::WriteBytes(const void* InData, SIZE_T InSize)
+	{
+		if (Buffer.size() - Used >= InSize)
+		{
+			if (InSize > 0)
+			{
+				Memory::Memcpy(InData, Buffer.data() + Used, InSize);
+				Used += InSize;
+			}
+
+			return;
+		}
+
+		if (IsFile())
+		{
+			if (!Flush())
+			{
+				return;
+			}
+
+			// large writes skip the buffer
+			if (InSize >= Buffer.size())
+			{
+				if (WriteToFile(InData, InSize))
+				{
+					FlushedSize += InSize;
+				}
+
+				return;
+			}
+		}
+		else if (!Reserve(InSize))
+		{
+			return;
+		}
+
+		Memory::Memcpy(InData, Buffer.data() + Used, InSize);
+		Used += InSize;
+	}
+
+	void BinaryWriter::WriteVarUInt(uint64 InValue)
+	{
+		if (Buffer.size() - Used < GMaxVarIntSize && !Reserve(GMaxVarIntSize))
+		{
+			return;
+		}
+
+		byte* output = Buffer.data() + Used;
+
+		while (InValue >= 0x80)
+		{
+			*output++ = static_cast<byte>(static_cast<uint8>(InValue | 0x80));
+			InValue >>= 7;
+		}
+
+		*output++ = static_cast<byte>(static_cast<uint8>(InValue));
+
+		Used = static_cast<SIZE_T>(output - Buffer.data());
+	}
+
+	void BinaryWriter::WriteVarInt(int64 InValue)
+	{
+		// zigzag: small negative values stay short too
+		WriteVarUInt((static_cast<uint64>(InValue) << 1) ^ static_cast<uint64>(InValue >> 63));
+	}
+
+	void BinaryWriter::WriteString(std::string_view InString)
+	{
+		WriteVarUInt(InString.size());
+		WriteBytes(InString.data(), InString.size());
+	}
+
+
+
+	/****/
+	/* BINARY READER */
+	/****/
+
+	BinaryReader::BinaryReader(Span<const byte> InData)
+		: Data(InData.data())
+		, Size(InData.size())
+	{
+	}
+
+	BinaryReader::BinaryReader(const MappedFile& InFile)
+		: BinaryReader(InFile.GetView())
+	{
+	}
+
+	BinaryReader::BinaryReader(const FilePath& InPath)
+	{
+		Open(InPath);
+	}
+
+	BinaryReader::BinaryReader(BinaryReader&& Another) noexcept
+		: File(std::move(Another.File))
+		, Data(std::exchange(Another.Data, nullptr))
+		, Size(std::exchange(Another.Size, 0))
+		, Position(std::exchange(Another.Position, 0))
+		, bGood(std::exchange(Another.bGood, true))
+	{
+	}
+
+	BinaryReader& BinaryReader::operator = (BinaryReader&& Another) noexcept
+	{
+		if (this != &Another)
+		{
+			File = std::move(Another.File);
+			Data = std::exchange(Another.Data, nullptr);
+			Size = std::exchange(Another.Size, 0);
+			Position = std::exchange(Another.Position, 0);
+			bGood = std::exchange(Another.bGood, true);
+		}
+
+		return *this;
+	}
+
+	bool BinaryReader::Open(const FilePath& InPath)
+	{
+		Data = nullptr;
+		Size = 0;
+		Position = 0;
+
+		bGood = File.Open(InPath);
+
+		if (bGood)
+		{
+			File.Advise(MappedFile::EAccessPattern::Sequential);
+
+			Data = File.GetView().data();
+			Size = File.GetSize();
+		}
+
+		return bGood;
+	}
+
+	bool BinaryReader::Fail()
+	{
+		// every later read fails as well
+		bGood = false;
+		Position = Size;
+
+		return false;
+	}
+
+	bool BinaryReader::Seek(uint64 InPosition)
+	{
+		if (!bGood || InPosition > Size)
+		{
+			return Fail();
+		}
+
+		Position = static_cast<SIZE_T>(InPosition);
+		return true;
+	}
+
+	bool BinaryReader::Skip(SIZE_T InSize)
+	{
+		if (InSize > Size - Position)
+		{
+			return Fail();
+		}
+
+		Position += InSize;
+		return true;
+	}
+
+	bool BinaryReader::ReadBytes(void* OutData, SIZE_T InSize)
+	{
+		if (InSize > Size - Position)
+		{
+			if (InSize > 0)
+			{
+				std::memset(OutData, 0, InSize);
+			}
+
+			return Fail();
+		}
+
+		if (InSize > 0)
+		{
+			Memory::Memcpy(Data + Position, OutData, InSize);
+			Position += InSize;
+		}
+
+		return true;
+	}
+
+	Span<const byte> BinaryReader::ReadView(SIZE_T InSize)
+	{
+		if (InSize > Size - Position)
+		{
+			Fail();
+			return {};
+		}
+
+		const SIZE_T position = Position;
+		Position += InSize;
+
+		return { Data + position, InSize };
+	}
+
+	uint64 BinaryReader::ReadVarUInt()
+	{
+		uint64 value = 0;
+
+		for (uint32 shift = 0; shift < 64 && Position < Size; shift += 7)
+		{
+			const uint64 part = std::to_integer<uint64>(Data[Position++]);
+
+			value |= (part & 0x7F) << shift;
+
+			if ((part & 0x80) == 0)
+			{
+				// the 10th byte holds a single bit
+				if (shift == 63 && part > 1)
+				{
+					break;
+				}
+
+				return value;
+			}
+		}
+
+		Fail();
+		return 0;
+	}
+
+	int64 BinaryReader::ReadVarInt()
+	{
+		const uint64 value = ReadVarUInt();
+		return static_cast<int64>((value >> 1) ^ (~(value & 1) + 1));
+	}
+
+	std::string BinaryReader::ReadString()
+	{
+		return std::string(ReadStringView());
+	}
+
+	std::string_view BinaryReader::ReadStringView()
+	{
+		const uint64 length = ReadVarUInt();
+
+		if (length > GetRemaining())
+		{
+			Fail();
+			return {};
+		}
+
+		const Span<const byte> characters = ReadView(static_cast<SIZE_T>(length));
+
+		return { reinterpret_cast<const ANSICHAR*>(characters.data()), characters.size() };
+	}
+
+}
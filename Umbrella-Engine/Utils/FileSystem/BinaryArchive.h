@@ -0,0 +1,433 @@
+#pragma once
+#include "MappedFile.h"
+#include <string>
+#include <type_traits>
+
+
+
+namespace J::system
+{
+
+	/**
+	 * Binary archives for cooked assets, caches and scene files.
+	 *
+	 * Scalars (integers, floats, enums) are stored little-endian, lengths and counts as varints (LEB128, signed ones
+	 * zigzag encoded). Other trivially copyable types are stored as their memory image, padding included, so both
+	 * sides must agree on the layout. Types of their own are serialized with free operators:
+	 *
+	 *		BinaryWriter& operator << (BinaryWriter& Writer, const SMesh& InMesh);
+	 *		BinaryReader& operator >> (BinaryReader& Reader, SMesh& OutMesh);
+	 */
+	namespace Details
+	{
+		template<class T>
+		constexpr bool IsBinaryScalar = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+		template<class T>
+		constexpr bool IsBinaryTrivial = std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>;
+
+		template<class T>
+		struct IsVector : std::false_type {};
+
+		template<class T, class AllocatorType>
+		struct IsVector<JVector<T, AllocatorType>> : std::true_type {};
+
+		/** Converts between the native and the little-endian byte order (the same operation both ways). */
+		template<class T>
+		FORCEINLINE T SwapToLittleEndian(T InValue)
+		{
+#if ENGINE_PLATFORM_LITTLE_ENDIAN
+			return InValue;
+#else
+			byte bytes[sizeof(T)];
+			Memory::Memcpy(&InValue, bytes, sizeof(T));
+
+			for (SIZE_T i = 0; i < sizeof(T) / 2; ++i)
+			{
+				std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+			}
+
+			Memory::Memcpy(bytes, &InValue, sizeof(T));
+			return InValue;
+#endif
+		}
+	}
+
+
+	/**
+	 * Buffered binary output, into memory or into a file.
+	 *
+	 * File writes are collected in a large buffer and written with native calls, writes larger than the buffer
+	 * go straight to the file. A failed write is remembered (see IsGood), the later ones are dropped.
+	 */
+	class BinaryWriter
+	{
+	public:
+
+		static constexpr SIZE_T DefaultBufferSize = SIZE_T(1) << 20;
+
+	public:
+
+		/** Writes into memory, see GetData and TakeData. */
+		BinaryWriter() = default;
+
+		/** Creates (or truncates) a file, see IsGood. */
+		explicit BinaryWriter(const FilePath& InPath, SIZE_T InBufferSize = DefaultBufferSize);
+
+		BinaryWriter(const BinaryWriter&) = delete;
+
+		BinaryWriter& operator = (const BinaryWriter&) = delete;
+
+		/** Flushes and closes the file. */
+		~BinaryWriter();
+
+		/**
+		 * Creates (or truncates) a file to write, closing the previous one.
+		 *
+		 * \param InBufferSize - Writes are collected until this many bytes are buffered.
+		 * \return false if the file could not be created.
+		 */
+		bool Open(const FilePath& InPath, SIZE_T InBufferSize = DefaultBufferSize);
+
+		/**
+		 * Flushes and closes the file, the writer goes back to writing into memory.
+		 *
+		 * \return false if any write since Open failed.
+		 */
+		bool Close();
+
+		/** Writes the buffered data to the file. */
+		bool Flush();
+
+		bool IsFile() const;
+
+		/** false once a write failed. */
+		bool IsGood() const { return bGood; }
+
+		/** Number of bytes written so far. */
+		uint64 GetPosition() const { return FlushedSize + Used; }
+
+		/** Memory writer only: the bytes written so far. */
+		Span<const byte> GetData() const { return { Buffer.data(), Used }; }
+
+		/** Memory writer only: moves the written bytes out and starts over. */
+		JVector<byte> TakeData();
+
+
+		void WriteBytes(const void* InData, SIZE_T InSize);
+
+		template<class T> requires Details::IsBinaryScalar<T>
+		void Write(T InValue);
+
+		void WriteVarUInt(uint64 InValue);
+
+		void WriteVarInt(int64 InValue);
+
+		/** Length as a varint, then the characters. */
+		void WriteString(std::string_view InString);
+
+		/** Elements without a count, scalars and trivially copyable types in one copy on little-endian platforms. */
+		template<class T>
+		void WriteSpan(Span<const T> InElements);
+
+		/** Count as a varint, then the elements. */
+		template<class T>
+		void WriteArray(Span<const T> InElements);
+
+		template<class T>
+		BinaryWriter& operator << (const T& InValue);
+
+		BinaryWriter& operator << (std::string_view InString) { WriteString(InString); return *this; }
+
+		BinaryWriter& operator << (const CHAR* InString) { WriteString(InString); return *this; }
+
+	private:
+
+		/** Makes room for InSize more bytes: flushes a file writer, grows a memory one. */
+		bool Reserve(SIZE_T InSize);
+
+		bool WriteToFile(const void* InData, SIZE_T InSize);
+
+		JVector<byte>	Buffer;
+
+		// bytes of Buffer in use
+		SIZE_T			Used		= 0;
+
+		// bytes already written to the file
+		uint64			FlushedSize	= 0;
+
+		bool			bGood		= true;
+
+#if ENGINE_WINDOWS_PLATFORM
+		void*			FileHandle	= nullptr;
+#else
+		int32			Descriptor	= -1;
+#endif
+	};
+
+
+	/**
+	 * Binary input from contiguous memory, never copied: a span, a MappedFile or a file the reader maps itself
+	 * (through the VirtualFileSystem mounts, so pak entries read the same way).
+	 *
+	 * Reads past the end or damaged varints put the reader in the failed state (see IsGood), failed reads
+	 * return zeros, so a whole structure can be read and checked once at the end.
+	 */
+	class BinaryReader
+	{
+	public:
+
+		BinaryReader() = default;
+
+		/** Reads from memory, the data is referenced and must outlive the reader. */
+		explicit BinaryReader(Span<const byte> InData);
+
+		/** Reads the view of a mapped file, the file must stay open while the reader is used. */
+		explicit BinaryReader(const MappedFile& InFile);
+
+		/** Maps a file for reading, see IsGood. */
+		explicit BinaryReader(const FilePath& InPath);
+
+		BinaryReader(const BinaryReader&) = delete;
+
+		BinaryReader& operator = (const BinaryReader&) = delete;
+
+		/** The source is left empty, it can't read the same bytes again. */
+		BinaryReader(BinaryReader&& Another) noexcept;
+
+		BinaryReader& operator = (BinaryReader&& Another) noexcept;
+
+		/** \return false if the file can't be mapped. */
+		bool Open(const FilePath& InPath);
+
+		/** false once a read failed. */
+		bool IsGood() const { return bGood; }
+
+		uint64 GetPosition() const { return Position; }
+
+		uint64 GetSize() const { return Size; }
+
+		SIZE_T GetRemaining() const { return Size - Position; }
+
+		bool IsAtEnd() const { return Position == Size; }
+
+		bool Seek(uint64 InPosition);
+
+		bool Skip(SIZE_T InSize);
+
+
+		bool ReadBytes(void* OutData, SIZE_T InSize);
+
+		/** The next InSize bytes without copying them, empty if there are not enough. */
+		Span<const byte> ReadView(SIZE_T InSize);
+
+		template<class T> requires Details::IsBinaryScalar<T>
+		T Read();
+
+		template<class T> requires Details::IsBinaryScalar<T>
+		bool Read(T& OutValue);
+
+		uint64 ReadVarUInt();
+
+		int64 ReadVarInt();
+
+		std::string ReadString();
+
+		/** The characters of a string without copying them. */
+		std::string_view ReadStringView();
+
+		/** Fills the elements, the counterpart of BinaryWriter::WriteSpan. */
+		template<class T>
+		bool ReadSpan(Span<T> OutElements);
+
+		/** Counterpart of BinaryWriter::WriteArray. Fails without allocating if the count can't fit in the data left. */
+		template<class T, class AllocatorType>
+		bool ReadArray(JVector<T, AllocatorType>& OutElements);
+
+		template<class T>
+		BinaryReader& operator >> (T& OutValue);
+
+	private:
+
+		bool Fail();
+
+		MappedFile		File;
+
+		const byte*		Data		= nullptr;
+
+		SIZE_T			Size		= 0;
+
+		SIZE_T			Position	= 0;
+
+		bool			bGood		= true;
+	};
+
+
+
+	/****/
+	/* BINARY WRITER */
+	/****/
+
+	template<class T> requires Details::IsBinaryScalar<T>
+	FORCEINLINE void BinaryWriter::Write(T InValue)
+	{
+		if (Buffer.size() - Used < sizeof(T) && !Reserve(sizeof(T)))
+		{
+			return;
+		}
+
+		const T value = Details::SwapToLittleEndian(InValue);
+
+		Memory::Memcpy(&value, Buffer.data() + Used, sizeof(T));
+		Used += sizeof(T);
+	}
+
+	template<class T>
+	void BinaryWriter::WriteSpan(Span<const T> InElements)
+	{
+		if constexpr (Details::IsBinaryTrivial<T> && (ENGINE_PLATFORM_LITTLE_ENDIAN || !Details::IsBinaryScalar<T>))
+		{
+			WriteBytes(InElements.data(), InElements.size_bytes());
+		}
+		else
+		{
+			for (const T& element : InElements)
+			{
+				*this << element;
+			}
+		}
+	}
+
+	template<class T>
+	void BinaryWriter::WriteArray(Span<const T> InElements)
+	{
+		WriteVarUInt(InElements.size());
+		WriteSpan(InElements);
+	}
+
+	template<class T>
+	BinaryWriter& BinaryWriter::operator << (const T& InValue)
+	{
+		if constexpr (Details::IsBinaryScalar<T>)
+		{
+			Write(InValue);
+		}
+		else if constexpr (std::is_same_v<T, std::string>)
+		{
+			WriteString(InValue);
+		}
+		else if constexpr (Details::IsVector<T>::value)
+		{
+			WriteArray(Span<const typename T::value_type>(InValue));
+		}
+		else
+		{
+			static_assert(Details::IsBinaryTrivial<T>, "No binary serialization for the type, add an operator << for it.");
+			WriteBytes(&InValue, sizeof(T));
+		}
+
+		return *this;
+	}
+
+
+
+	/****/
+	/* BINARY READER */
+	/****/
+
+	template<class T> requires Details::IsBinaryScalar<T>
+	FORCEINLINE T BinaryReader::Read()
+	{
+		T value {};
+		Read(value);
+
+		return value;
+	}
+
+	template<class T> requires Details::IsBinaryScalar<T>
+	FORCEINLINE bool BinaryReader::Read(T& OutValue)
+	{
+		if (Size - Position < sizeof(T))
+		{
+			OutValue = T {};
+			return Fail();
+		}
+
+		if constexpr (std::is_same_v<T, bool>)
+		{
+			// a damaged byte is not a valid bool representation
+			OutValue = static_cast<uint8>(Data[Position]) != 0;
+		}
+		else
+		{
+			Memory::Memcpy(Data + Position, &OutValue, sizeof(T));
+			OutValue = Details::SwapToLittleEndian(OutValue);
+		}
+
+		Position += sizeof(T);
+
+		return true;
+	}
+
+	template<class T>
+	bool BinaryReader::ReadSpan(Span<T> OutElements)
+	{
+		if constexpr (Details::IsBinaryTrivial<T> && !std::is_same_v<T, bool> && (ENGINE_PLATFORM_LITTLE_ENDIAN || !Details::IsBinaryScalar<T>))
+		{
+			return ReadBytes(OutElements.data(), OutElements.size_bytes());
+		}
+		else
+		{
+			for (T& element : OutElements)
+			{
+				*this >> element;
+			}
+
+			return bGood;
+		}
+	}
+
+	template<class T, class AllocatorType>
+	bool BinaryReader::ReadArray(JVector<T, AllocatorType>& OutElements)
+	{
+		const uint64 count = ReadVarUInt();
+
+		// a damaged count must not allocate more than the data could hold (at least a byte per element)
+		const uint64 limit = Details::IsBinaryTrivial<T> ? GetRemaining() / std::max<SIZE_T>(sizeof(T), 1) : GetRemaining();
+
+		if (!bGood || count > limit)
+		{
+			OutElements.clear();
+			return Fail();
+		}
+
+		OutElements.resize(static_cast<SIZE_T>(count));
+
+		return ReadSpan(Span<T>(OutElements));
+	}
+
+	template<class T>
+	BinaryReader& BinaryReader::operator >> (T& OutValue)
+	{
+		if constexpr (Details::IsBinaryScalar<T>)
+		{
+			Read(OutValue);
+		}
+		else if constexpr (std::is_same_v<T, std::string>)
+		{
+			OutValue = ReadString();
+		}
+		else if constexpr (Details::IsVector<T>::value)
+		{
+			ReadArray(OutValue);
+		}
+		else
+		{
+			static_assert(Details::IsBinaryTrivial<T>, "No binary serialization for the type, add an operator >> for it.");
+			ReadBytes(&OutValue, sizeof(T));
+		}
+
+		return *this;
+	}
+
+}
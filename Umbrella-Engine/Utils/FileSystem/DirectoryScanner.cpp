@@ -0,0 +1,255 @@
+#include "DirectoryScanner.h"
+#include "../Threading/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
+#if ENGINE_LINUX_PLATFORM
+	#include <dirent.h>
+	#include <fcntl.h>
+	#include <sys/stat.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+
+
+namespace J::system
+{
+
+	namespace
+	{
+		/** What one directory contains, filled by one thread. */
+		struct SDirectoryListing
+		{
+			JVector<SScannedFile>	Files;
+
+			// relative paths of the subdirectories
+			JVector<std::string>	Directories;
+
+			bool					bGood = true;
+		};
+	}
+
+
+	static std::string JoinPath(const std::string& InDirectory, std::string_view InName)
+	{
+		std::string path;
+		path.reserve(InDirectory.size() + InName.size() + 1);
+
+		path = InDirectory;
+
+		if (!path.empty())
+		{
+			path += '/';
+		}
+
+		path += InName;
+
+		return path;
+	}
+
+#if ENGINE_LINUX_PLATFORM
+
+	// linux_dirent64 layout: inode (8), offset (8), record size (2), type (1), name
+	static constexpr SIZE_T GDirentSizeOffset = 16;
+	static constexpr SIZE_T GDirentTypeOffset = 18;
+	static constexpr SIZE_T GDirentNameOffset = 19;
+
+	// a few hundred names per call
+	static constexpr SIZE_T GDirentBufferSize = 32 * 1024;
+
+	static void ListDirectory(int32 InRoot, const std::string& InDirectory, SDirectoryListing& OutListing)
+	{
+		const int32 directory = ::openat(InRoot, InDirectory.empty() ? "." : InDirectory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+		if (directory < 0)
+		{
+			OutListing.bGood = false;
+			return;
+		}
+
+		alignas(8) char buffer[GDirentBufferSize];
+
+		while (true)
+		{
+			const long read = ::syscall(SYS_getdents64, directory, buffer, sizeof(buffer));
+
+			if (read <= 0)
+			{
+				OutListing.bGood = read == 0;
+				break;
+			}
+
+			for (long offset = 0; offset < read;)
+			{
+				const char* record = buffer + offset;
+
+				uint16 recordSize;
+				Memory::Memcpy(record + GDirentSizeOffset, &recordSize, sizeof(recordSize));
+				offset += recordSize;
+
+				const uint8 type = static_cast<uint8>(record[GDirentTypeOffset]);
+				const char* name = record + GDirentNameOffset;
+
+				if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+				{
+					continue;
+				}
+
+				if (type == DT_DIR)
+				{
+					OutListing.Directories.push_back(JoinPath(InDirectory, name));
+					continue;
+				}
+
+				if (type != DT_REG && type != DT_LNK && type != DT_UNKNOWN)
+				{
+					continue;
+				}
+
+				// relative to the open directory, no path lookups from the root
+				struct stat status;
+				bool bLink = type == DT_LNK;
+
+				if (::fstatat(directory, name, &status, bLink ? 0 : AT_SYMLINK_NOFOLLOW) != 0)
+				{
+					// removed meanwhile or a dangling link
+					continue;
+				}
+
+				if (S_ISLNK(status.st_mode))
+				{
+					bLink = true;
+
+					if (::fstatat(directory, name, &status, 0) != 0)
+					{
+						continue;
+					}
+				}
+
+				if (S_ISDIR(status.st_mode) && !bLink)
+				{
+					OutListing.Directories.push_back(JoinPath(InDirectory, name));
+				}
+				else if (S_ISREG(status.st_mode))
+				{
+					const int64 time = static_cast<int64>(status.st_mtim.tv_sec) * 1'000'000'000 + status.st_mtim.tv_nsec;
+
+					OutListing.Files.push_back({ JoinPath(InDirectory, name), static_cast<uint64>(status.st_size), time });
+				}
+			}
+		}
+
+		::close(directory);
+	}
+
+#else
+
+	static void ListDirectory(const FilePath& InRoot, const std::string& InDirectory, SDirectoryListing& OutListing)
+	{
+		std::error_code error;
+		std::filesystem::directory_iterator iterator(InDirectory.empty() ? InRoot : InRoot / FilePath(InDirectory), error);
+
+		for (const std::filesystem::directory_iterator end; !error && iterator != end; iterator.increment(error))
+		{
+			const std::filesystem::directory_entry& entry = *iterator;
+
+			// the entry caches what the directory listing returned, most of these do not touch the disk again
+			std::error_code statusError;
+			const bool bLink = entry.is_symlink(statusError);
+
+			if (entry.is_directory(statusError))
+			{
+				if (!bLink)
+				{
+					OutListing.Directories.push_back(JoinPath(InDirectory, entry.path().filename().generic_string()));
+				}
+
+				continue;
+			}
+
+			if (!entry.is_regular_file(statusError))
+			{
+				continue;
+			}
+
+			const uintmax_t size = entry.file_size(statusError);
+			const auto time = entry.last_write_time(statusError);
+
+			if (!statusError)
+			{
+				const int64 nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+
+				OutListing.Files.push_back({ JoinPath(InDirectory, entry.path().filename().generic_string()), size, nanoseconds });
+			}
+		}
+
+		OutListing.bGood = !error;
+	}
+
+#endif
+
+
+	bool ScanDirectory(const FilePath& InDirectory, JVector<SScannedFile>& OutFiles)
+	{
+		OutFiles.clear();
+
+#if ENGINE_LINUX_PLATFORM
+		const int32 root = ::open(InDirectory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+		if (root < 0)
+		{
+			return false;
+		}
+#else
+		std::error_code error;
+
+		if (!std::filesystem::is_directory(InDirectory, error))
+		{
+			return false;
+		}
+
+		const FilePath& root = InDirectory;
+#endif
+
+		bool bGood = true;
+
+		// relative paths of the directories of the current depth, "" is the root
+		JVector<std::string> level = { std::string() };
+
+		while (!level.empty())
+		{
+			JVector<SDirectoryListing> listings(level.size());
+
+			Utils::ThreadPool::Get().ParallelFor(level.size(), 1, [&](SIZE_T InBegin, SIZE_T InEnd)
+			{
+				for (SIZE_T i = InBegin; i < InEnd; ++i)
+				{
+					ListDirectory(root, level[i], listings[i]);
+				}
+			});
+
+			JVector<std::string> nextLevel;
+
+			for (SDirectoryListing& listing : listings)
+			{
+				bGood &= listing.bGood;
+
+				std::move(listing.Files.begin(), listing.Files.end(), std::back_inserter(OutFiles));
+				std::move(listing.Directories.begin(), listing.Directories.end(), std::back_inserter(nextLevel));
+			}
+
+			level = std::move(nextLevel);
+		}
+
+#if ENGINE_LINUX_PLATFORM
+		::close(root);
+#endif
+
+		std::sort(OutFiles.begin(), OutFiles.end(), [](const SScannedFile& InLeft, const SScannedFile& InRight) { return InLeft.Path < InRight.Path; });
+
+		return bGood;
+	}
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "FileSystem.h"
+#include <string>
+
+
+
+namespace J::system
+{
+
+	/** A regular file found by ScanDirectory. */
+	struct SScannedFile
+	{
+		// relative to the scanned directory, with '/' separators
+		std::string		Path;
+
+		uint64			Size				= 0;
+
+		// nanoseconds, only compared with the times of other scans on the same platform
+		int64			ModificationTime	= 0;
+	};
+
+
+	/**
+	 * Lists every regular file under a directory with its size and modification time.
+	 *
+	 * The tree is walked one level at a time, the directories of a level are read in parallel on the thread pool,
+	 * with getdents64 and fstatat relative to the directory on Linux and std::filesystem elsewhere.
+	 * Symbolic links to files are listed as files, links to directories are not followed.
+	 *
+	 * \param InDirectory	- Directory on the disk (the mounts are not looked at).
+	 * \param OutFiles		- Replaced by the files found, sorted by path.
+	 * \return false if the directory or one of its subdirectories could not be read (the readable ones are still listed).
+	 */
+	bool ScanDirectory(const FilePath& InDirectory, JVector<SScannedFile>& OutFiles);
+
+}
@@ -1,9 +1,149 @@
 #include "FileSystem.h"
+#include "VirtualFileSystem.h"
+#include <algorithm>
+
+#if ENGINE_WINDOWS_PLATFORM
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+	#undef CreateDirectory
+#else
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 
 
 
 namespace J::system
 {
+	/**
+	 * Reads a whole file with the size taken from the file's metadata: one allocation and
+	 * (almost always) a single read call, no stream buffering in between.
+	 */
+	template<class ContainerType>
+	static bool ReadWholeFile(const FilePath& path, ContainerType& content)
+	{
+		using ValueType = typename ContainerType::value_type;
+
+#if ENGINE_WINDOWS_PLATFORM
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER size;
+
+		if (!GetFileSizeEx(file, &size))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		content.resize(static_cast<SIZE_T>(size.QuadPart));
+
+		SIZE_T offset = 0;
+
+		while (offset < content.size())
+		{
+			// ReadFile counts in DWORDs
+			const DWORD chunk = static_cast<DWORD>(std::min<SIZE_T>(content.size() - offset, 1u << 30));
+			DWORD read = 0;
+
+			if (!ReadFile(file, reinterpret_cast<ValueType*>(content.data()) + offset, chunk, &read, nullptr))
+			{
+				CloseHandle(file);
+				content.clear();
+				return false;
+			}
+
+			if (read == 0)
+			{
+				break;
+			}
+
+			offset += read;
+		}
+
+		CloseHandle(file);
+#else
+		const int descriptor = ::open(path.c_str(), O_RDONLY);
+
+		if (descriptor < 0)
+		{
+			return false;
+		}
+
+		struct stat status;
+
+		if (::fstat(descriptor, &status) != 0)
+		{
+			::close(descriptor);
+			return false;
+		}
+
+		content.resize(static_cast<SIZE_T>(status.st_size));
+
+		SIZE_T offset = 0;
+
+		while (offset < content.size())
+		{
+			const ssize_t read = ::read(descriptor, reinterpret_cast<ValueType*>(content.data()) + offset, content.size() - offset);
+
+			if (read < 0 && errno == EINTR)
+			{
+				continue;
+			}
+
+			if (read < 0)
+			{
+				::close(descriptor);
+				content.clear();
+				return false;
+			}
+
+			if (read == 0)
+			{
+				break;
+			}
+
+			offset += static_cast<SIZE_T>(read);
+		}
+
+		::close(descriptor);
+#endif
+
+		// end of file before the size read, the file may have been truncated meanwhile
+		content.resize(offset);
+
+		return true;
+	}
+
+#if ENGINE_WINDOWS_PLATFORM
+	/** CRLF read as LF, as a text mode stream would. */
+	static void TranslateLineEndings(std::string& content)
+	{
+		SIZE_T written = 0;
+
+		for (SIZE_T i = 0; i < content.size(); ++i)
+		{
+			if (content[i] != '\r' || i + 1 == content.size() || content[i + 1] != '\n')
+			{
+				content[written++] = content[i];
+			}
+		}
+
+		content.resize(written);
+	}
+#endif
+
 	void File::_open(const FilePath& path, EMode mode)
 	{
 		Stream.open(path.string(), static_cast<std::ios::openmode>(mode));
@@ -107,7 +247,32 @@ namespace J::system
 			throw "File should be opened in read mode!";
 		}
 
-		content.assign(std::istreambuf_iterator<CHAR>(this->Stream), std::istreambuf_iterator<CHAR>());
+		// the rest of the stream in a single read
+		const auto begin = this->Stream.tellg();
+		this->Stream.seekg(0, std::ios::end);
+		const auto end = this->Stream.tellg();
+
+		if (begin == std::streampos(-1) || end == std::streampos(-1) || end < begin)
+		{
+			// no position to size the read with, streamed from where it was
+			this->Stream.clear();
+
+			if (begin != std::streampos(-1))
+			{
+				this->Stream.seekg(begin);
+			}
+
+			content.assign(std::istreambuf_iterator<CHAR>(this->Stream), std::istreambuf_iterator<CHAR>());
+			return content;
+		}
+
+		this->Stream.seekg(begin);
+
+		content.resize(static_cast<SIZE_T>(end - begin));
+		this->Stream.read(content.data(), content.size());
+
+		// text mode may translate line endings and read less
+		content.resize(static_cast<SIZE_T>(this->Stream.gcount()));
 		return content;
 	}
 
@@ -125,47 +290,83 @@ namespace J::system
 
 	bool File::Exists(const FilePath& path)
 	{
-		return std::filesystem::exists(path);
+		return VirtualFileSystem::Get().Exists(path) || std::filesystem::exists(path);
 	}
 
 	bool File::Exists(std::string_view path)
 	{
-		return std::filesystem::exists(path);
+		return Exists(FilePath(path));
 	}
 
 	bool File::Exists(const CHAR* path)
 	{
-		return std::filesystem::exists(path);
+		return Exists(FilePath(path));
 	}
 
 	bool File::IsFile(const FilePath& path)
 	{
-		return std::filesystem::is_regular_file(path);
+		return VirtualFileSystem::Get().Exists(path) || std::filesystem::is_regular_file(path);
 	}
 
 	bool File::IsFile(std::string_view path)
 	{
-		return std::filesystem::is_regular_file(path);
+		return IsFile(FilePath(path));
 	}
 
 	bool File::IsFile(const CHAR* path)
 	{
-		return std::filesystem::is_regular_file(path);
+		return IsFile(FilePath(path));
 	}
 
 	std::string File::ReadAllText(const FilePath& path)
 	{
-		return File(path).ReadAllText();
+		std::string content;
+
+		if (!VirtualFileSystem::Get().ReadAllText(path, content) && !ReadWholeFile(path, content))
+		{
+			// todo: normal error log system
+			throw "File could not be read!";
+		}
+
+#if ENGINE_WINDOWS_PLATFORM
+		// read in binary, the text keeps the line endings of a text mode stream
+		TranslateLineEndings(content);
+#endif
+
+		return content;
 	}
 
 	std::string File::ReadAllText(std::string_view path)
 	{
-		return File(path).ReadAllText();
+		return ReadAllText(FilePath(path));
 	}
 
 	std::string File::ReadAllText(const CHAR* path)
 	{
-		return File(path).ReadAllText();
+		return ReadAllText(FilePath(path));
+	}
+
+	JVector<byte> File::ReadAll(const FilePath& path)
+	{
+		JVector<byte> content;
+
+		if (!VirtualFileSystem::Get().ReadAll(path, content) && !ReadWholeFile(path, content))
+		{
+			// todo: normal error log system
+			throw "File could not be read!";
+		}
+
+		return content;
+	}
+
+	JVector<byte> File::ReadAll(std::string_view path)
+	{
+		return ReadAll(FilePath(path));
+	}
+
+	JVector<byte> File::ReadAll(const CHAR* path)
+	{
+		return ReadAll(FilePath(path));
 	}
 
 
@@ -199,4 +400,15 @@ namespace J::system
 		return std::filesystem::create_directory(path);
 	}
 
+
+	bool Details::ReadFromDisk(const FilePath& path, JVector<byte>& content)
+	{
+		return ReadWholeFile(path, content);
+	}
+
+	bool Details::ReadFromDisk(const FilePath& path, std::string& content)
+	{
+		return ReadWholeFile(path, content);
+	}
+
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "../../Core.h"
+#include "../../STL/Containers.h"
 #include <filesystem>
 #include <fstream>
 #include <string_view>
@@ -60,6 +61,7 @@ namespace J::system
 
 		std::string ReadAllText();
 
+		/** Formatted (text) stream operators, binary data goes through BinaryWriter / BinaryReader. */
 		template<class _Ty>
 		File& operator >> (_Ty&& Value);
 
@@ -90,6 +92,16 @@ namespace J::system
 
 		static std::string ReadAllText(const CHAR* path);
 
+		/**
+		 * Whole file in one read into a buffer sized from the file's metadata. Throws if the file can't be read.
+		 * The static read functions look relative paths up in the VirtualFileSystem mounts first.
+		 */
+		static JVector<byte> ReadAll(const FilePath& path);
+
+		static JVector<byte> ReadAll(std::string_view path);
+
+		static JVector<byte> ReadAll(const CHAR* path);
+
 
 	private:
 
@@ -138,4 +150,13 @@ namespace J::system
 
 	bool CreateDirectory(const CHAR* path);
 
+
+	namespace Details
+	{
+		/** Whole file from the disk, bypassing the mounted archives. */
+		bool ReadFromDisk(const FilePath& path, JVector<byte>& content);
+
+		bool ReadFromDisk(const FilePath& path, std::string& content);
+	}
+
 }
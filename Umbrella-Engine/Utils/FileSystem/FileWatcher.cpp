@@ -0,0 +1,545 @@
+#include "FileWatcher.h"
+#include <algorithm>
+
+#if ENGINE_LINUX_PLATFORM
+	#include <poll.h>
+	#include <sys/eventfd.h>
+	#include <sys/inotify.h>
+	#include <unistd.h>
+#endif
+
+
+
+namespace J::system
+{
+
+	// a steady stream of changes is still delivered after this many debounce times
+	static constexpr uint32 GMaxDebounceRounds = 10;
+
+#if ENGINE_LINUX_PLATFORM
+	static constexpr uint32 GInotifyMask = IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE
+										 | IN_EXCL_UNLINK | IN_ONLYDIR;
+#endif
+
+
+	/** Absolute, normalized and without a trailing separator, so paths compare as strings. */
+	static FilePath NormalizeDirectory(const FilePath& InDirectory, std::error_code& OutError)
+	{
+		FilePath directory = std::filesystem::absolute(InDirectory, OutError).lexically_normal();
+
+		return directory.has_filename() ? directory : directory.parent_path();
+	}
+
+	static bool IsUnder(const FilePath& InPath, const FilePath& InDirectory)
+	{
+		const auto& path = InPath.native();
+		const auto& directory = InDirectory.native();
+
+		return path.size() > directory.size() && path.compare(0, directory.size(), directory) == 0
+			&& path[directory.size()] == FilePath::preferred_separator;
+	}
+
+
+	FileWatcher::FileWatcher(uint32 InDebounceMilliseconds, [[maybe_unused]] bool bInAllowInotify)
+		: Debounce(std::max(InDebounceMilliseconds, 1u))
+	{
+#if ENGINE_LINUX_PLATFORM
+		if (bInAllowInotify)
+		{
+			InotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+			WakeDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+			if (InotifyDescriptor < 0 || WakeDescriptor < 0)
+			{
+				if (InotifyDescriptor >= 0)
+				{
+					::close(InotifyDescriptor);
+				}
+
+				if (WakeDescriptor >= 0)
+				{
+					::close(WakeDescriptor);
+				}
+
+				InotifyDescriptor = -1;
+				WakeDescriptor = -1;
+			}
+		}
+#endif
+
+		Thread = std::thread([this]() { WatcherLoop(); });
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		{
+			JF_SCOPED_LOCK(Mutex);
+			bStopping = true;
+		}
+
+		WakeUp();
+		Thread.join();
+
+#if ENGINE_LINUX_PLATFORM
+		if (IsUsingInotify())
+		{
+			::close(InotifyDescriptor);
+			::close(WakeDescriptor);
+		}
+#endif
+	}
+
+	FileWatcher& FileWatcher::Get()
+	{
+		static FileWatcher watcher;
+		return watcher;
+	}
+
+	FileWatcher::WatchId FileWatcher::Watch(const FilePath& InDirectory, CallbackType InCallback, bool bInRecursive)
+	{
+		std::error_code error;
+		FilePath directory = NormalizeDirectory(InDirectory, error);
+
+		if (error || !std::filesystem::is_directory(directory, error))
+		{
+			return InvalidWatch;
+		}
+
+		SWatch watch = { std::move(directory), std::move(InCallback), bInRecursive, {} };
+
+		if (!IsUsingInotify())
+		{
+			// the first scan only records what is there
+			TakeSnapshot(watch, false);
+		}
+
+		JF_SCOPED_LOCK(Mutex);
+
+		if (IsUsingInotify() && !AddDirectoryWatches(watch.Directory, bInRecursive, false))
+		{
+			return InvalidWatch;
+		}
+
+		const WatchId id = NextWatch++;
+		Watches.emplace(id, std::move(watch));
+
+		return id;
+	}
+
+	void FileWatcher::Unwatch(WatchId InWatch)
+	{
+		// waits for the running callbacks, unless it is called from one of them (the mutex is recursive)
+		std::lock_guard dispatchLock(DispatchMutex);
+
+		JF_SCOPED_LOCK(Mutex);
+
+		if (Watches.erase(InWatch) != 0 && IsUsingInotify())
+		{
+			RemoveUnusedDirectoryWatches();
+		}
+	}
+
+	bool FileWatcher::IsCovered(const SWatch& InWatch, const FilePath& InPath) const
+	{
+		return InPath == InWatch.Directory
+			|| (IsUnder(InPath, InWatch.Directory) && (InWatch.bRecursive || InPath.parent_path() == InWatch.Directory));
+	}
+
+	void FileWatcher::AddChange(const FilePath& InPath, EFileChange InChange)
+	{
+		const auto now = ClockType::now();
+
+		if (PendingChanges.empty())
+		{
+			FirstChangeTime = now;
+		}
+
+		LastChangeTime = now;
+
+		auto [pending, bInserted] = PendingChanges.try_emplace(InPath.native(), InChange);
+
+		if (bInserted)
+		{
+			return;
+		}
+
+		if (pending->second == EFileChange::Added)
+		{
+			// created and removed within one batch: nothing to report, created and written: still new
+			if (InChange == EFileChange::Removed)
+			{
+				PendingChanges.erase(pending);
+			}
+		}
+		else if (pending->second == EFileChange::Removed && InChange == EFileChange::Added)
+		{
+			// replaced
+			pending->second = EFileChange::Modified;
+		}
+		else
+		{
+			pending->second = InChange;
+		}
+	}
+
+	void FileWatcher::DispatchSettled()
+	{
+		// taken before Mutex, in the same order as Unwatch
+		std::lock_guard dispatchLock(DispatchMutex);
+
+		JVector<std::pair<CallbackType, JVector<SFileChange>>> batches;
+
+		{
+			JF_SCOPED_LOCK(Mutex);
+
+			const auto now = ClockType::now();
+
+			if (PendingChanges.empty() || (now < LastChangeTime + Debounce && now < FirstChangeTime + Debounce * GMaxDebounceRounds))
+			{
+				return;
+			}
+
+			for (const auto& [id, watch] : Watches)
+			{
+				JVector<SFileChange> changes;
+
+				for (const auto& [path, change] : PendingChanges)
+				{
+					if (IsCovered(watch, path))
+					{
+						changes.push_back({ path, change });
+					}
+				}
+
+				if (!changes.empty())
+				{
+					// copied, the callback may unwatch itself
+					batches.emplace_back(watch.Callback, std::move(changes));
+				}
+			}
+
+			PendingChanges.clear();
+		}
+
+		for (auto& [callback, changes] : batches)
+		{
+			callback(changes);
+		}
+	}
+
+	void FileWatcher::WatcherLoop()
+	{
+		while (true)
+		{
+#if ENGINE_LINUX_PLATFORM
+			if (IsUsingInotify())
+			{
+				int32 timeout = -1;
+
+				{
+					JF_SCOPED_LOCK(Mutex);
+
+					if (bStopping)
+					{
+						return;
+					}
+
+					if (!PendingChanges.empty())
+					{
+						const auto deadline = std::min(LastChangeTime + Debounce, FirstChangeTime + Debounce * GMaxDebounceRounds);
+						const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - ClockType::now());
+
+						timeout = static_cast<int32>(std::max<int64>(remaining.count(), 0));
+					}
+				}
+
+				pollfd descriptors[2] = { { InotifyDescriptor, POLLIN, 0 }, { WakeDescriptor, POLLIN, 0 } };
+
+				if (::poll(descriptors, 2, timeout) > 0)
+				{
+					if (descriptors[1].revents & POLLIN)
+					{
+						uint64 value;
+						[[maybe_unused]] const ssize_t length = ::read(WakeDescriptor, &value, sizeof(value));
+					}
+
+					if (descriptors[0].revents & POLLIN)
+					{
+						ReadEvents();
+					}
+				}
+
+				DispatchSettled();
+				continue;
+			}
+#endif
+
+			{
+				TUniqueLock<TMutex> lock(Mutex);
+
+				if (Condition.wait_for(lock, Debounce, [this]() { return bStopping; }))
+				{
+					return;
+				}
+
+				for (auto& [id, watch] : Watches)
+				{
+					TakeSnapshot(watch, true);
+				}
+			}
+
+			DispatchSettled();
+		}
+	}
+
+	void FileWatcher::TakeSnapshot(SWatch& InWatch, bool bInReportChanges)
+	{
+		namespace fs = std::filesystem;
+
+		decltype(SWatch::Snapshot) snapshot;
+		std::error_code error;
+
+		auto record = [&snapshot](const fs::directory_entry& InEntry)
+		{
+			std::error_code entryError;
+
+			if (!InEntry.is_regular_file(entryError))
+			{
+				return;
+			}
+
+			const auto time = InEntry.last_write_time(entryError);
+			const auto size = InEntry.file_size(entryError);
+
+			if (!entryError)
+			{
+				snapshot.emplace(InEntry.path().native(), std::make_pair(time, size));
+			}
+		};
+
+		if (InWatch.bRecursive)
+		{
+			for (fs::recursive_directory_iterator it(InWatch.Directory, fs::directory_options::skip_permission_denied, error), end; !error && it != end; it.increment(error))
+			{
+				record(*it);
+			}
+		}
+		else
+		{
+			for (fs::directory_iterator it(InWatch.Directory, error), end; !error && it != end; it.increment(error))
+			{
+				record(*it);
+			}
+		}
+
+		// an incomplete scan (something was removed during it) would report missing files, the next one decides
+		if (error)
+		{
+			return;
+		}
+
+		if (bInReportChanges)
+		{
+			for (const auto& [path, state] : snapshot)
+			{
+				auto previous = InWatch.Snapshot.find(path);
+
+				if (previous == InWatch.Snapshot.end())
+				{
+					AddChange(path, EFileChange::Added);
+				}
+				else if (previous->second != state)
+				{
+					AddChange(path, EFileChange::Modified);
+				}
+			}
+
+			for (const auto& [path, state] : InWatch.Snapshot)
+			{
+				if (!snapshot.contains(path))
+				{
+					AddChange(path, EFileChange::Removed);
+				}
+			}
+		}
+
+		InWatch.Snapshot = std::move(snapshot);
+	}
+
+	bool FileWatcher::AddDirectoryWatches(const FilePath& InDirectory, bool bInRecursive, bool bInReportFiles)
+	{
+#if ENGINE_LINUX_PLATFORM
+		namespace fs = std::filesystem;
+
+		// the same directory watched twice gets the same descriptor
+		const int32 descriptor = inotify_add_watch(InotifyDescriptor, InDirectory.c_str(), GInotifyMask);
+
+		if (descriptor < 0)
+		{
+			return false;
+		}
+
+		Directories[descriptor] = InDirectory;
+
+		if (!bInRecursive && !bInReportFiles)
+		{
+			return true;
+		}
+
+		std::error_code error;
+
+		for (fs::recursive_directory_iterator it(InDirectory, fs::directory_options::skip_permission_denied, error), end; !error && it != end; it.increment(error))
+		{
+			std::error_code entryError;
+
+			if (it->is_directory(entryError))
+			{
+				if (bInRecursive)
+				{
+					const int32 subdirectory = inotify_add_watch(InotifyDescriptor, it->path().c_str(), GInotifyMask);
+
+					if (subdirectory >= 0)
+					{
+						Directories[subdirectory] = it->path();
+					}
+				}
+				else
+				{
+					it.disable_recursion_pending();
+				}
+			}
+			else if (bInReportFiles && it->is_regular_file(entryError))
+			{
+				// written before the directory was watched
+				AddChange(it->path(), EFileChange::Added);
+			}
+		}
+
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void FileWatcher::ReadEvents()
+	{
+#if ENGINE_LINUX_PLATFORM
+		alignas(inotify_event) char buffer[16 * 1024];
+
+		while (true)
+		{
+			const ssize_t length = ::read(InotifyDescriptor, buffer, sizeof(buffer));
+
+			if (length <= 0)
+			{
+				return;
+			}
+
+			JF_SCOPED_LOCK(Mutex);
+
+			for (ssize_t offset = 0; offset < length; )
+			{
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += sizeof(inotify_event) + event->len;
+
+				if (event->mask & IN_Q_OVERFLOW)
+				{
+					// events were lost: everything has to be rescanned
+					for (const auto& [id, watch] : Watches)
+					{
+						AddChange(watch.Directory, EFileChange::Modified);
+					}
+
+					continue;
+				}
+
+				if (event->mask & IN_IGNORED)
+				{
+					Directories.erase(event->wd);
+					continue;
+				}
+
+				auto directory = Directories.find(event->wd);
+
+				if (directory == Directories.end() || event->len == 0)
+				{
+					continue;
+				}
+
+				FilePath path = directory->second / event->name;
+
+				if (event->mask & IN_ISDIR)
+				{
+					if (event->mask & (IN_CREATE | IN_MOVED_TO))
+					{
+						const bool bRecursive = std::any_of(Watches.begin(), Watches.end(), [&path](const auto& InWatch)
+						{
+							return InWatch.second.bRecursive && IsUnder(path, InWatch.second.Directory);
+						});
+
+						if (bRecursive)
+						{
+							AddDirectoryWatches(path, true, true);
+						}
+					}
+					else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+					{
+						AddChange(path, EFileChange::Removed);
+					}
+				}
+				else if (event->mask & (IN_CREATE | IN_MOVED_TO))
+				{
+					AddChange(path, EFileChange::Added);
+				}
+				else if (event->mask & (IN_MODIFY | IN_CLOSE_WRITE))
+				{
+					AddChange(path, EFileChange::Modified);
+				}
+				else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+				{
+					AddChange(path, EFileChange::Removed);
+				}
+			}
+		}
+#endif
+	}
+
+	void FileWatcher::RemoveUnusedDirectoryWatches()
+	{
+#if ENGINE_LINUX_PLATFORM
+		for (auto directory = Directories.begin(); directory != Directories.end(); )
+		{
+			const FilePath& path = directory->second;
+
+			const bool bUsed = std::any_of(Watches.begin(), Watches.end(), [&path](const auto& InWatch)
+			{
+				return path == InWatch.second.Directory || (InWatch.second.bRecursive && IsUnder(path, InWatch.second.Directory));
+			});
+
+			if (bUsed)
+			{
+				++directory;
+			}
+			else
+			{
+				inotify_rm_watch(InotifyDescriptor, directory->first);
+				directory = Directories.erase(directory);
+			}
+		}
+#endif
+	}
+
+	void FileWatcher::WakeUp()
+	{
+#if ENGINE_LINUX_PLATFORM
+		if (IsUsingInotify())
+		{
+			const uint64 value = 1;
+			[[maybe_unused]] const ssize_t length = ::write(WakeDescriptor, &value, sizeof(value));
+		}
+#endif
+
+		Condition.notify_all();
+	}
+
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include "FileSystem.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+
+
+namespace J::system
+{
+
+	enum class EFileChange : uint8
+	{
+		Added,
+		Modified,
+		Removed,
+	};
+
+	struct SFileChange
+	{
+		// absolute. A directory when everything under it changed: Removed when it was deleted or moved away,
+		// Modified when events were lost and it has to be rescanned
+		FilePath		Path;
+
+		EFileChange		Change;
+	};
+
+
+	/**
+	 * Watches directories for changed files: inotify on Linux, periodic scans of the modification times elsewhere
+	 * (or when inotify is not available).
+	 *
+	 * Changes are debounced and coalesced: a batch is delivered once nothing has changed for the debounce time
+	 * (or after ten debounce times of steady changes), and every file appears in it once, with its changes merged
+	 * (written several times - Modified once, created and removed - nothing).
+	 */
+	class FileWatcher
+	{
+	public:
+
+		using WatchId = uint32;
+
+		static constexpr WatchId InvalidWatch = 0;
+
+		/** Called on the watcher thread with the changes under the watched directory. */
+		using CallbackType = std::function<void(Span<const SFileChange>)>;
+
+		static constexpr uint32 DefaultDebounceMilliseconds = 100;
+
+	public:
+
+		/**
+		 * \param InDebounceMilliseconds	- Quiet time before a batch is delivered, also the scan period without inotify.
+		 * \param bInAllowInotify			- false always scans, for file systems inotify does not see (network shares).
+		 */
+		explicit FileWatcher(uint32 InDebounceMilliseconds = DefaultDebounceMilliseconds, bool bInAllowInotify = true);
+
+		FileWatcher(const FileWatcher&) = delete;
+
+		FileWatcher& operator = (const FileWatcher&) = delete;
+
+		~FileWatcher();
+
+		/** The engine-wide watcher, created on first use. */
+		static FileWatcher& Get();
+
+		bool IsUsingInotify() const { return InotifyDescriptor >= 0; }
+
+		/**
+		 * Starts watching a directory.
+		 *
+		 * \param bInRecursive - Watches the subdirectories too, including the ones created later.
+		 * \return InvalidWatch if the directory does not exist or can't be watched.
+		 */
+		WatchId Watch(const FilePath& InDirectory, CallbackType InCallback, bool bInRecursive = true);
+
+		/** Stops a watch. Once it returns the callback is not running and won't be called again (unless called from it). */
+		void Unwatch(WatchId InWatch);
+
+	private:
+
+		using ClockType = std::chrono::steady_clock;
+
+		struct SWatch
+		{
+			FilePath		Directory;
+
+			CallbackType	Callback;
+
+			bool			bRecursive;
+
+			// last seen modification times and sizes, scans only
+			std::unordered_map<FilePath::string_type, std::pair<std::filesystem::file_time_type, uintmax_t>> Snapshot;
+		};
+
+		bool IsCovered(const SWatch& InWatch, const FilePath& InPath) const;
+
+		/** Merges a change into the pending batch, Mutex must be held. */
+		void AddChange(const FilePath& InPath, EFileChange InChange);
+
+		/** Delivers the pending batch once it has settled. */
+		void DispatchSettled();
+
+		void WatcherLoop();
+
+		/** Scans a watched directory, reporting the differences from the previous scan when asked (Mutex must be held then). */
+		void TakeSnapshot(SWatch& InWatch, bool bInReportChanges);
+
+		/** Watches a directory (and its subdirectories) with inotify, Mutex must be held. */
+		bool AddDirectoryWatches(const FilePath& InDirectory, bool bInRecursive, bool bInReportFiles);
+
+		void ReadEvents();
+
+		void RemoveUnusedDirectoryWatches();
+
+		void WakeUp();
+
+		std::map<WatchId, SWatch>				Watches;
+
+		std::unordered_map<FilePath::string_type, EFileChange> PendingChanges;
+
+		ClockType::time_point					FirstChangeTime;
+
+		ClockType::time_point					LastChangeTime;
+
+		// inotify watch descriptors and the directories they watch
+		std::unordered_map<int32, FilePath>		Directories;
+
+		TMutex									Mutex;
+
+		// held while callbacks run, Unwatch waits on it
+		std::recursive_mutex					DispatchMutex;
+
+		std::condition_variable					Condition;
+
+		std::thread								Thread;
+
+		std::chrono::milliseconds				Debounce;
+
+		WatchId									NextWatch		= 1;
+
+		int32									InotifyDescriptor = -1;
+
+		int32									WakeDescriptor	= -1;
+
+		bool									bStopping		= false;
+	};
+
+}
@@ -0,0 +1,337 @@
+#include "HotReload.h"
+#include "VirtualFileSystem.h"
+#include "../Threading/ThreadPool.h"
+#include <algorithm>
+
+
+
+namespace J::system
+{
+
+	/** The file on the disk a path is read from: a mounted loose directory first, like the File reads. */
+	static bool ResolveDiskPath(const FilePath& InPath, FilePath& OutPath)
+	{
+		FilePath path = InPath;
+
+		if (InPath.is_relative())
+		{
+			VirtualFileSystem::SResolvedPath resolved;
+
+			if (VirtualFileSystem::Get().Resolve(InPath, resolved))
+			{
+				if (resolved.LoosePath.empty())
+				{
+					// served from a pak, nothing to watch
+					return false;
+				}
+
+				path = resolved.LoosePath;
+			}
+		}
+
+		std::error_code error;
+		OutPath = std::filesystem::absolute(path, error).lexically_normal();
+
+		return !error && OutPath.has_filename();
+	}
+
+
+	/****/
+	/* HANDLE */
+
+	HotReload::Handle& HotReload::Handle::operator = (Handle&& Another) noexcept
+	{
+		if (this != &Another)
+		{
+			Reset();
+			Id = std::exchange(Another.Id, 0);
+		}
+
+		return *this;
+	}
+
+	void HotReload::Handle::Reset()
+	{
+		if (Id != 0)
+		{
+			HotReload::Get().Unregister(std::exchange(Id, 0));
+		}
+	}
+
+
+	/****/
+	/* HOT RELOAD */
+
+	HotReload& HotReload::Get()
+	{
+		static HotReload hotReload;
+		return hotReload;
+	}
+
+	HotReload::Handle HotReload::Register(Span<const FilePath> InFiles, PrepareType InPrepare, ApplyType InApply)
+	{
+		JF_ASSERT(InPrepare && InApply, "Hot reload needs both steps.");
+
+		if (!IsEnabled())
+		{
+			return {};
+		}
+
+		JVector<FilePath> files;
+		files.reserve(InFiles.size());
+
+		for (const FilePath& file : InFiles)
+		{
+			FilePath path;
+
+			if (ResolveDiskPath(file, path) && std::find(files.begin(), files.end(), path) == files.end())
+			{
+				files.push_back(std::move(path));
+			}
+		}
+
+		JF_SCOPED_LOCK(Mutex);
+
+		SEntry entry = { {}, std::move(InPrepare), std::move(InApply) };
+
+		const HandleId id = NextId;
+
+		for (FilePath& file : files)
+		{
+			const FilePath directory = file.parent_path();
+			auto found = Directories.find(directory.native());
+
+			if (found == Directories.end())
+			{
+				// the directory and not the file, editors save by replacing the file
+				const FileWatcher::WatchId watch = FileWatcher::Get().Watch(directory, [this](Span<const SFileChange> InChanges) { OnFilesChanged(InChanges); }, false);
+
+				if (watch == FileWatcher::InvalidWatch)
+				{
+					continue;
+				}
+
+				found = Directories.emplace(directory.native(), SDirectory{ watch, 0 }).first;
+			}
+
+			auto& users = Files[file.native()];
+
+			if (users.empty())
+			{
+				++found->second.FilesCount;
+			}
+
+			users.push_back(id);
+			entry.Files.push_back(std::move(file));
+		}
+
+		if (entry.Files.empty())
+		{
+			return {};
+		}
+
+		++NextId;
+		Entries.emplace(id, std::move(entry));
+
+		return Handle(id);
+	}
+
+	void HotReload::Unregister(HandleId InId)
+	{
+		JVector<FileWatcher::WatchId> unusedWatches;
+
+		{
+			TUniqueLock<TMutex> lock(Mutex);
+
+			auto found = Entries.find(InId);
+
+			if (found == Entries.end())
+			{
+				return;
+			}
+
+			// the Prepare step may use the asset, references to map elements stay valid while others are added
+			SEntry& entry = found->second;
+			Condition.wait(lock, [&entry]() { return !entry.bPreparing; });
+
+			for (const FilePath& file : entry.Files)
+			{
+				auto users = Files.find(file.native());
+
+				std::erase(users->second, InId);
+
+				if (!users->second.empty())
+				{
+					continue;
+				}
+
+				Files.erase(users);
+
+				auto directory = Directories.find(file.parent_path().native());
+
+				if (--directory->second.FilesCount == 0)
+				{
+					unusedWatches.push_back(directory->second.Watch);
+					Directories.erase(directory);
+				}
+			}
+
+			Entries.erase(InId);
+			std::erase_if(Ready, [InId](const auto& InReady) { return InReady.first == InId; });
+		}
+
+		// outside Mutex, Unwatch waits for the running callbacks and they take it
+		for (FileWatcher::WatchId watch : unusedWatches)
+		{
+			FileWatcher::Get().Unwatch(watch);
+		}
+	}
+
+	void HotReload::Update()
+	{
+		JVector<std::pair<HandleId, Ref<void>>> ready;
+
+		{
+			JF_SCOPED_LOCK(Mutex);
+			ready.swap(Ready);
+		}
+
+		for (auto& [id, payload] : ready)
+		{
+			ApplyType apply;
+
+			{
+				JF_SCOPED_LOCK(Mutex);
+
+				// unregistered by an earlier Apply
+				auto found = Entries.find(id);
+
+				if (found == Entries.end())
+				{
+					continue;
+				}
+
+				apply = found->second.Apply;
+			}
+
+			// unlocked, Apply may register and unregister assets
+			apply(payload);
+		}
+	}
+
+	void HotReload::OnFilesChanged(Span<const SFileChange> InChanges)
+	{
+		if (!IsEnabled())
+		{
+			return;
+		}
+
+		JF_SCOPED_LOCK(Mutex);
+
+		for (const SFileChange& change : InChanges)
+		{
+			// the asset keeps its current data until the file is back
+			if (change.Change == EFileChange::Removed)
+			{
+				continue;
+			}
+
+			auto users = Files.find(change.Path.native());
+
+			if (users != Files.end())
+			{
+				for (HandleId id : users->second)
+				{
+					StartPrepare(id, Entries.at(id));
+				}
+
+				continue;
+			}
+
+			// a watched directory whose events were lost, every file in it may have changed
+			if (Directories.contains(change.Path.native()))
+			{
+				for (auto& [id, entry] : Entries)
+				{
+					const bool bInDirectory = std::any_of(entry.Files.begin(), entry.Files.end(), [&change](const FilePath& InFile)
+					{
+						return InFile.parent_path() == change.Path;
+					});
+
+					if (bInDirectory)
+					{
+						StartPrepare(id, entry);
+					}
+				}
+			}
+		}
+	}
+
+	void HotReload::StartPrepare(HandleId InId, SEntry& InEntry)
+	{
+		if (InEntry.bPreparing)
+		{
+			InEntry.bChangedAgain = true;
+			return;
+		}
+
+		InEntry.bPreparing = true;
+		Utils::ThreadPool::Get().Submit([this, InId]() { RunPrepare(InId); });
+	}
+
+	void HotReload::RunPrepare(HandleId InId)
+	{
+		PrepareType prepare;
+
+		{
+			// Unregister waits for bPreparing, the entry is still there
+			JF_SCOPED_LOCK(Mutex);
+			prepare = Entries.at(InId).Prepare;
+		}
+
+		while (true)
+		{
+			Ref<void> payload;
+
+			try
+			{
+				payload = prepare();
+			}
+			catch (...)
+			{
+				// the file is being written or is broken, the next change brings it back
+			}
+
+			TUniqueLock<TMutex> lock(Mutex);
+			SEntry& entry = Entries.at(InId);
+
+			if (entry.bChangedAgain)
+			{
+				// stale already
+				entry.bChangedAgain = false;
+				continue;
+			}
+
+			if (payload)
+			{
+				auto ready = std::find_if(Ready.begin(), Ready.end(), [InId](const auto& InReady) { return InReady.first == InId; });
+
+				if (ready != Ready.end())
+				{
+					ready->second = std::move(payload);
+				}
+				else
+				{
+					Ready.emplace_back(InId, std::move(payload));
+				}
+			}
+
+			entry.bPreparing = false;
+			lock.unlock();
+
+			Condition.notify_all();
+			return;
+		}
+	}
+
+}
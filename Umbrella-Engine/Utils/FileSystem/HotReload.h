@@ -0,0 +1,151 @@
+#pragma once
+#include "FileWatcher.h"
+
+
+
+namespace J::system
+{
+
+	/**
+	 * Reloads assets when their files change on disk, on by default when JF_HOT_RELOAD is set.
+	 *
+	 * The parent directories of the registered files are watched. A change runs only the Prepare step of the assets
+	 * using the file, on the thread pool (reading and decoding), and its result is handed to their Apply step in
+	 * Update, on the thread that owns the assets (uploading to the GPU). Files inside paks are not watched.
+	 */
+	class HotReload
+	{
+	public:
+
+		using HandleId = uint64;
+
+		/** Registration of an asset, unregisters it when destroyed. */
+		class Handle
+		{
+		public:
+
+			Handle() = default;
+
+			Handle(const Handle&) = delete;
+
+			Handle& operator = (const Handle&) = delete;
+
+			Handle(Handle&& Another) noexcept : Id(std::exchange(Another.Id, 0)) {}
+
+			Handle& operator = (Handle&& Another) noexcept;
+
+			~Handle() { Reset(); }
+
+			/** Unregisters, waiting for a Prepare step in progress. */
+			void Reset();
+
+			bool IsValid() const { return Id != 0; }
+
+		private:
+
+			friend class HotReload;
+
+			explicit Handle(HandleId InId) : Id(InId) {}
+
+			HandleId Id = 0;
+		};
+
+		/** Returns nullptr when nothing should be applied (the file could not be read or decoded). */
+		using PrepareType = std::function<Ref<void>()>;
+
+		using ApplyType = std::function<void(const Ref<void>&)>;
+
+	public:
+
+		HotReload() = default;
+
+		HotReload(const HotReload&) = delete;
+
+		HotReload& operator = (const HotReload&) = delete;
+
+		static HotReload& Get();
+
+		/** Registering does nothing and changes are ignored while disabled. */
+		void SetEnabled(bool bInEnabled) { bEnabled.store(bInEnabled, std::memory_order_relaxed); }
+
+		bool IsEnabled() const { return bEnabled.load(std::memory_order_relaxed); }
+
+		/**
+		 * Registers an asset loaded from files.
+		 *
+		 * \param InFiles	- Paths the asset was loaded from, relative ones resolved like the File reads (mounted directories first).
+		 * \param InPrepare	- Runs on the thread pool after a change, the object it captures must outlive the handle.
+		 * \param InApply	- Runs in Update with the prepared data.
+		 * \return an empty handle if disabled or none of the files can be watched.
+		 */
+		template<class PayloadType>
+		NODISCARD Handle Register(Span<const FilePath> InFiles, std::function<Ref<PayloadType>()> InPrepare, std::function<void(PayloadType&)> InApply);
+
+		NODISCARD Handle Register(Span<const FilePath> InFiles, PrepareType InPrepare, ApplyType InApply);
+
+		/** Applies the reloads prepared since the last call, once a frame on the thread that owns the assets. */
+		void Update();
+
+	private:
+
+		struct SEntry
+		{
+			// absolute paths on the disk
+			JVector<FilePath>	Files;
+
+			PrepareType			Prepare;
+
+			ApplyType			Apply;
+
+			bool				bPreparing		= false;
+
+			// changed while being prepared, prepared again right after
+			bool				bChangedAgain	= false;
+		};
+
+		struct SDirectory
+		{
+			FileWatcher::WatchId	Watch;
+
+			uint32					FilesCount;
+		};
+
+		void Unregister(HandleId InId);
+
+		void OnFilesChanged(Span<const SFileChange> InChanges);
+
+		/** Queues the Prepare step, Mutex must be held. */
+		void StartPrepare(HandleId InId, SEntry& InEntry);
+
+		void RunPrepare(HandleId InId);
+
+		std::unordered_map<HandleId, SEntry>	Entries;
+
+		// registered files and the assets using them
+		std::unordered_map<FilePath::string_type, JVector<HandleId>> Files;
+
+		std::unordered_map<FilePath::string_type, SDirectory> Directories;
+
+		// prepared, waiting for Update
+		JVector<std::pair<HandleId, Ref<void>>>	Ready;
+
+		TMutex									Mutex;
+
+		// signalled when a Prepare step is over
+		std::condition_variable					Condition;
+
+		HandleId								NextId		= 1;
+
+		Atomic::TAtomicBool						bEnabled	{ JF_HOT_RELOAD != 0 };
+	};
+
+
+	template<class PayloadType>
+	HotReload::Handle HotReload::Register(Span<const FilePath> InFiles, std::function<Ref<PayloadType>()> InPrepare, std::function<void(PayloadType&)> InApply)
+	{
+		return Register(InFiles,
+						PrepareType([Prepare = std::move(InPrepare)]() -> Ref<void> { return Prepare(); }),
+						ApplyType([Apply = std::move(InApply)](const Ref<void>& InPayload) { Apply(*std::static_pointer_cast<PayloadType>(InPayload)); }));
+	}
+
+}
@@ -0,0 +1,363 @@
+#include "MappedFile.h"
+#include "VirtualFileSystem.h"
+#include <algorithm>
+
+#if ENGINE_WINDOWS_PLATFORM
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+	#undef CreateDirectory
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+
+
+namespace J::system
+{
+
+	static SIZE_T GetPageSize()
+	{
+		static const SIZE_T pageSize = []()
+		{
+#if ENGINE_WINDOWS_PLATFORM
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+
+			return static_cast<SIZE_T>(info.dwPageSize);
+#else
+			return static_cast<SIZE_T>(sysconf(_SC_PAGESIZE));
+#endif
+		}();
+
+		return pageSize;
+	}
+
+	MappedFile::MappedFile(const FilePath& InPath, EAccess InAccess, SIZE_T InSize)
+	{
+		Open(InPath, InAccess, InSize);
+	}
+
+	MappedFile::MappedFile(MappedFile&& Another) noexcept
+	{
+		*this = std::move(Another);
+	}
+
+	MappedFile& MappedFile::operator = (MappedFile&& Another) noexcept
+	{
+		if (this != &Another)
+		{
+			Close();
+
+			Path	= std::move(Another.Path);
+			Data	= std::exchange(Another.Data, nullptr);
+			Size	= std::exchange(Another.Size, 0);
+			Access	= Another.Access;
+			bOpen	= std::exchange(Another.bOpen, false);
+			Owner	= std::move(Another.Owner);
+
+			bBuffered = std::exchange(Another.bBuffered, false);
+
+#if ENGINE_WINDOWS_PLATFORM
+			FileHandle = std::exchange(Another.FileHandle, nullptr);
+#endif
+		}
+
+		return *this;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	bool MappedFile::Open(const FilePath& InPath, EAccess InAccess, SIZE_T InSize)
+	{
+		Close();
+
+		VirtualFileSystem::SResolvedPath resolved;
+
+		if (InAccess != EAccess::Read || !VirtualFileSystem::Get().Resolve(InPath, resolved))
+		{
+			return OpenFromDisk(InPath, InAccess, InSize);
+		}
+
+		if (resolved.Archive == nullptr)
+		{
+			const bool bOpened = OpenFromDisk(resolved.LoosePath, InAccess, InSize);
+
+			if (bOpened)
+			{
+				Path = InPath;
+			}
+
+			return bOpened;
+		}
+
+		const SPakEntry& entry = *resolved.Entry;
+
+		if (entry.Compression == EPakCompression::None)
+		{
+			// the view keeps the whole archive mapped
+			Data = const_cast<byte*>(resolved.Archive->GetStoredData(entry).data());
+			Owner = resolved.Archive;
+		}
+		else
+		{
+			auto buffer = MakeRef<JVector<byte>>(static_cast<SIZE_T>(entry.Size));
+
+			if (!resolved.Archive->Read(entry, buffer->data()))
+			{
+				return false;
+			}
+
+			Data = buffer->data();
+			Owner = std::move(buffer);
+			bBuffered = true;
+		}
+
+		Size = static_cast<SIZE_T>(entry.Size);
+		Path = InPath;
+		Access = EAccess::Read;
+		bOpen = true;
+
+		return true;
+	}
+
+	bool MappedFile::OpenFromDisk(const FilePath& InPath, EAccess InAccess, SIZE_T InSize)
+	{
+		const bool bWrite = (InAccess == EAccess::ReadWrite);
+		const bool bResize = bWrite && InSize != 0;
+
+#if ENGINE_WINDOWS_PLATFORM
+		HANDLE file = CreateFileW(InPath.c_str(),
+								  bWrite ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+								  FILE_SHARE_READ,
+								  nullptr,
+								  bResize ? OPEN_ALWAYS : OPEN_EXISTING,
+								  FILE_ATTRIBUTE_NORMAL,
+								  nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+
+		if (bResize)
+		{
+			fileSize.QuadPart = static_cast<LONGLONG>(InSize);
+
+			if (!SetFilePointerEx(file, fileSize, nullptr, FILE_BEGIN) || !SetEndOfFile(file))
+			{
+				CloseHandle(file);
+				return false;
+			}
+		}
+
+		if (!GetFileSizeEx(file, &fileSize))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		Size = static_cast<SIZE_T>(fileSize.QuadPart);
+
+		if (Size > 0)
+		{
+			HANDLE mapping = CreateFileMappingW(file, nullptr, bWrite ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+
+			if (mapping != nullptr)
+			{
+				Data = static_cast<byte*>(MapViewOfFile(mapping, bWrite ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+
+				// the view keeps the mapping object alive
+				CloseHandle(mapping);
+			}
+
+			if (Data == nullptr)
+			{
+				CloseHandle(file);
+				Size = 0;
+				return false;
+			}
+		}
+
+		if (bWrite)
+		{
+			FileHandle = file;
+		}
+		else
+		{
+			CloseHandle(file);
+		}
+#else
+		const int descriptor = ::open(InPath.c_str(), bWrite ? (O_RDWR | (bResize ? O_CREAT : 0)) : O_RDONLY, 0644);
+
+		if (descriptor < 0)
+		{
+			return false;
+		}
+
+		struct stat status;
+
+		if ((bResize && ::ftruncate(descriptor, static_cast<off_t>(InSize)) != 0) || ::fstat(descriptor, &status) != 0)
+		{
+			::close(descriptor);
+			return false;
+		}
+
+		Size = static_cast<SIZE_T>(status.st_size);
+
+		if (Size > 0)
+		{
+			void* address = ::mmap(nullptr, Size, bWrite ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, descriptor, 0);
+
+			if (address == MAP_FAILED)
+			{
+				::close(descriptor);
+				Size = 0;
+				return false;
+			}
+
+			Data = static_cast<byte*>(address);
+		}
+
+		// the mapping stays valid after the descriptor is closed
+		::close(descriptor);
+#endif
+
+		Path = InPath;
+		Access = InAccess;
+		bOpen = true;
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (!bOpen)
+		{
+			return;
+		}
+
+#if ENGINE_WINDOWS_PLATFORM
+		if (Data != nullptr && Owner == nullptr)
+		{
+			UnmapViewOfFile(Data);
+		}
+
+		if (FileHandle != nullptr)
+		{
+			CloseHandle(FileHandle);
+			FileHandle = nullptr;
+		}
+#else
+		if (Data != nullptr && Owner == nullptr)
+		{
+			::munmap(Data, Size);
+		}
+#endif
+
+		Data = nullptr;
+		Size = 0;
+		bOpen = false;
+		Path.clear();
+		Owner.reset();
+		bBuffered = false;
+	}
+
+	Span<const byte> MappedFile::GetView(SIZE_T InOffset, SIZE_T InSize) const
+	{
+		const SIZE_T offset = std::min(InOffset, Size);
+
+		return { Data + offset, std::min(InSize, Size - offset) };
+	}
+
+	Span<byte> MappedFile::GetWritableView()
+	{
+		JF_ASSERT(Access == EAccess::ReadWrite, "File is mapped read-only.");
+
+		return { Data, Size };
+	}
+
+	bool MappedFile::GetPageRange(SIZE_T InOffset, SIZE_T InSize, byte*& OutBegin, SIZE_T& OutSize) const
+	{
+		// a decompressed copy has no pages to hint or flush
+		if (Data == nullptr || bBuffered || InOffset >= Size)
+		{
+			return false;
+		}
+
+		const SIZE_T pageSize = GetPageSize();
+		const SIZE_T end = (InSize >= Size - InOffset) ? Size : InOffset + InSize;
+
+		// pak entries are only aligned within the archive, the page that holds them is still part of the mapping
+		const uintptr_t address = reinterpret_cast<uintptr_t>(Data + InOffset);
+		const uintptr_t begin = address & ~static_cast<uintptr_t>(pageSize - 1);
+
+		OutBegin = reinterpret_cast<byte*>(begin);
+		OutSize = static_cast<SIZE_T>(reinterpret_cast<uintptr_t>(Data + end) - begin);
+
+		return OutSize > 0;
+	}
+
+	void MappedFile::Advise(EAccessPattern InPattern, SIZE_T InOffset, SIZE_T InSize)
+	{
+		byte* begin;
+		SIZE_T size;
+
+		if (!GetPageRange(InOffset, InSize, begin, size))
+		{
+			return;
+		}
+
+#if ENGINE_WINDOWS_PLATFORM
+		// Windows only has an explicit prefetch, the other patterns are left to the memory manager
+		if (InPattern == EAccessPattern::WillNeed)
+		{
+			WIN32_MEMORY_RANGE_ENTRY range = { begin, size };
+			PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+		}
+#else
+		int advice = MADV_NORMAL;
+
+		switch (InPattern)
+		{
+		case EAccessPattern::Sequential:	advice = MADV_SEQUENTIAL;	break;
+		case EAccessPattern::Random:		advice = MADV_RANDOM;		break;
+		case EAccessPattern::WillNeed:		advice = MADV_WILLNEED;		break;
+		case EAccessPattern::DontNeed:		advice = MADV_DONTNEED;		break;
+		default:														break;
+		}
+
+		::madvise(begin, size, advice);
+#endif
+	}
+
+	bool MappedFile::Flush(SIZE_T InOffset, SIZE_T InSize)
+	{
+		byte* begin;
+		SIZE_T size;
+
+		if (Access != EAccess::ReadWrite || !GetPageRange(InOffset, InSize, begin, size))
+		{
+			return true;
+		}
+
+#if ENGINE_WINDOWS_PLATFORM
+		return FlushViewOfFile(begin, size) && FlushFileBuffers(FileHandle);
+#else
+		return ::msync(begin, size, MS_SYNC) == 0;
+#endif
+	}
+
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include "FileSystem.h"
+
+
+
+namespace J::system
+{
+
+	/**
+	 * File mapped into the address space: the contents are read straight from the page cache, without copies.
+	 * An empty file opens successfully with an empty view.
+	 *
+	 * Read-only opens go through the VirtualFileSystem mounts first: a stored pak entry is a view into the
+	 * mapped archive, a compressed one is decompressed into memory.
+	 */
+	class MappedFile
+	{
+	public:
+
+		enum class EAccess : uint8
+		{
+			Read,
+			ReadWrite,
+		};
+
+		/** How a range is going to be accessed, forwarded to the kernel (madvise / PrefetchVirtualMemory). */
+		enum class EAccessPattern : uint8
+		{
+			Normal,
+			Sequential,		// aggressive read-ahead, pages can be dropped soon after use
+			Random,			// no read-ahead
+			WillNeed,		// starts reading the range in the background
+			DontNeed,		// the range can be dropped from memory
+		};
+
+		static constexpr SIZE_T WholeFile = ~static_cast<SIZE_T>(0);
+
+	public:
+
+		MappedFile() = default;
+
+		explicit MappedFile(const FilePath& InPath, EAccess InAccess = EAccess::Read, SIZE_T InSize = 0);
+
+		MappedFile(const MappedFile&) = delete;
+
+		MappedFile& operator = (const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& Another) noexcept;
+
+		MappedFile& operator = (MappedFile&& Another) noexcept;
+
+		~MappedFile();
+
+		/**
+		 * Maps a file, closing the previous one.
+		 *
+		 * \param InPath	- File to map.
+		 * \param InAccess	- ReadWrite mappings write back to the file.
+		 * \param InSize	- ReadWrite only: when not 0 the file is created if needed and resized to InSize bytes.
+		 * \return false if the file could not be opened or mapped.
+		 */
+		bool Open(const FilePath& InPath, EAccess InAccess = EAccess::Read, SIZE_T InSize = 0);
+
+		void Close();
+
+		bool IsOpen() const { return bOpen; }
+
+		SIZE_T GetSize() const { return Size; }
+
+		const FilePath& GetPath() const { return Path; }
+
+		Span<const byte> GetView() const { return { Data, Size }; }
+
+		Span<const byte> GetView(SIZE_T InOffset, SIZE_T InSize) const;
+
+		/** Writable view, the file must be mapped with EAccess::ReadWrite. */
+		Span<byte> GetWritableView();
+
+		/** Hints the kernel about the access pattern of [InOffset, InOffset + InSize). */
+		void Advise(EAccessPattern InPattern, SIZE_T InOffset = 0, SIZE_T InSize = WholeFile);
+
+		/** Starts loading a range asynchronously, so later reads do not fault on the disk. */
+		void Prefetch(SIZE_T InOffset = 0, SIZE_T InSize = WholeFile) { Advise(EAccessPattern::WillNeed, InOffset, InSize); }
+
+		/** Writes the modified pages of a range back to the file and waits for it. */
+		bool Flush(SIZE_T InOffset = 0, SIZE_T InSize = WholeFile);
+
+	private:
+
+		/** Clamps a range to the file and widens it to whole pages. Returns false for empty ranges. */
+		bool GetPageRange(SIZE_T InOffset, SIZE_T InSize, byte*& OutBegin, SIZE_T& OutSize) const;
+
+		/** Maps a file from the disk, bypassing the mounts. */
+		bool OpenFromDisk(const FilePath& InPath, EAccess InAccess, SIZE_T InSize);
+
+		FilePath	Path;
+
+		byte*		Data		= nullptr;
+
+		SIZE_T		Size		= 0;
+
+		EAccess		Access		= EAccess::Read;
+
+		bool		bOpen		= false;
+
+		// set when the data belongs to someone else: the mapped archive of a pak entry, or its decompressed copy
+		Ref<const void> Owner;
+
+		// the data is a decompressed copy, not backed by a file
+		bool		bBuffered	= false;
+
+#if ENGINE_WINDOWS_PLATFORM
+		// kept for Flush, the view itself does not need it
+		void*		FileHandle	= nullptr;
+#endif
+	};
+
+}
@@ -0,0 +1,369 @@
+#include "Pak.h"
+#include "../Cryptography/CRC32.h"
+#include "../Cryptography/Hash.h"
+#include "../Compression/BlockCompression.h"
+#include "DirectoryScanner.h"
+#include <algorithm>
+
+
+
+namespace J::system
+{
+
+	// an entry stays stored as is unless compressing it saves at least 1/8 of its size,
+	// a smaller gain does not pay for the decompression and loses the direct mapping
+	static constexpr SIZE_T GMinCompressionGainShift = 3;
+
+	static uint64 AlignOffset(uint64 InOffset, uint64 InAlignment)
+	{
+		return (InOffset + InAlignment - 1) & ~(InAlignment - 1);
+	}
+
+	/** Compressed form of an entry. false keeps the entry stored as is (no codec, or nothing gained). */
+	static bool CompressEntry(EPakCompression InCompression, Span<const byte> InData, JVector<byte>& OutData)
+	{
+		switch (InCompression)
+		{
+		case EPakCompression::LZBlock:
+			OutData = Compression::Compress(InData);
+			return OutData.size() <= InData.size() - (InData.size() >> GMinCompressionGainShift);
+
+		default:
+			return false;
+		}
+	}
+
+	static bool DecompressEntry(EPakCompression InCompression, Span<const byte> InData, byte* OutData, SIZE_T InSize)
+	{
+		switch (InCompression)
+		{
+		case EPakCompression::None:
+			if (InData.size() != InSize)
+			{
+				return false;
+			}
+
+			Memory::Memcpy(InData.data(), OutData, InSize);
+			return true;
+
+		case EPakCompression::LZBlock:
+			return Compression::GetDecompressedSize(InData) == InSize && Compression::Decompress(InData, OutData);
+
+		default:
+			return false;
+		}
+	}
+
+
+	std::string NormalizePakPath(std::string_view InPath)
+	{
+		std::string normalized;
+		normalized.reserve(InPath.size());
+
+		SIZE_T begin = 0;
+
+		while (begin <= InPath.size())
+		{
+			SIZE_T end = InPath.find_first_of("/\\", begin);
+
+			if (end == std::string_view::npos)
+			{
+				end = InPath.size();
+			}
+
+			const std::string_view part = InPath.substr(begin, end - begin);
+
+			if (part == "..")
+			{
+				// ".." above the root is dropped, an archive has nothing there
+				const SIZE_T slash = normalized.rfind('/');
+				normalized.resize(slash == std::string::npos ? 0 : slash);
+			}
+			else if (!part.empty() && part != ".")
+			{
+				if (!normalized.empty())
+				{
+					normalized += '/';
+				}
+
+				normalized += part;
+			}
+
+			begin = end + 1;
+		}
+
+		return normalized;
+	}
+
+	uint64 GetPakPathHash(std::string_view InNormalizedPath)
+	{
+		return Crypto::Hash64(InNormalizedPath.data(), InNormalizedPath.size());
+	}
+
+
+	/****/
+	/* WRITER */
+	/****/
+
+	PakWriter::PakWriter(uint32 InAlignment)
+		: Alignment(InAlignment)
+	{
+		JF_ASSERT(InAlignment >= alignof(SPakEntry) && (InAlignment & (InAlignment - 1)) == 0, "Pak alignment must be a power of two.");
+	}
+
+	void PakWriter::AddFile(const FilePath& InSource, std::string_view InPath, EPakCompression InCompression, bool bInCRC)
+	{
+		Sources.push_back({ NormalizePakPath(InPath), InSource, {}, InCompression, bInCRC });
+	}
+
+	void PakWriter::AddData(std::string_view InPath, JVector<byte> InData, EPakCompression InCompression, bool bInCRC)
+	{
+		Sources.push_back({ NormalizePakPath(InPath), {}, std::move(InData), InCompression, bInCRC });
+	}
+
+	SIZE_T PakWriter::AddDirectory(const FilePath& InDirectory, std::string_view InPrefix, EPakCompression InCompression, bool bInCRC)
+	{
+		JVector<SScannedFile> files;
+
+		if (!ScanDirectory(InDirectory, files))
+		{
+			bMissingSources = true;
+		}
+
+		for (const SScannedFile& file : files)
+		{
+			std::string path(InPrefix);
+			path += '/';
+			path += file.Path;
+
+			AddFile(InDirectory / FilePath(file.Path), path, InCompression, bInCRC);
+		}
+
+		return files.size();
+	}
+
+	bool PakWriter::Write(const FilePath& InOutput) const
+	{
+		if (bMissingSources)
+		{
+			return false;
+		}
+
+		JVector<const SSource*> sources;
+		sources.reserve(Sources.size());
+
+		for (const SSource& source : Sources)
+		{
+			sources.push_back(&source);
+		}
+
+		std::sort(sources.begin(), sources.end(), [](const SSource* InLeft, const SSource* InRight) { return InLeft->Path < InRight->Path; });
+
+		for (SIZE_T i = 1; i < sources.size(); ++i)
+		{
+			if (sources[i - 1]->Path == sources[i]->Path)
+			{
+				return false;
+			}
+		}
+
+		FileStream stream(InOutput, std::ios::out | std::ios::binary | std::ios::trunc);
+
+		if (!stream)
+		{
+			return false;
+		}
+
+		uint64 written = 0;
+
+		auto write = [&stream, &written](const void* InData, SIZE_T InSize)
+		{
+			stream.write(static_cast<const CHAR*>(InData), static_cast<std::streamsize>(InSize));
+			written += InSize;
+		};
+
+		auto pad = [&write, &written](uint64 InOffset)
+		{
+			static constexpr byte zeros[256] = {};
+
+			while (written < InOffset)
+			{
+				write(zeros, static_cast<SIZE_T>(std::min<uint64>(InOffset - written, sizeof(zeros))));
+			}
+		};
+
+		// the header is written last, once the table of contents is known
+		SPakHeader header = {};
+		write(&header, sizeof(header));
+
+		JVector<SPakEntry> entries;
+		entries.reserve(sources.size());
+
+		std::string names;
+
+		for (const SSource* source : sources)
+		{
+			JVector<byte> loaded;
+			Span<const byte> data = source->Data;
+
+			if (!source->File.empty())
+			{
+				if (!Details::ReadFromDisk(source->File, loaded))
+				{
+					return false;
+				}
+
+				data = loaded;
+			}
+
+			SPakEntry entry = {};
+			entry.PathHash		= GetPakPathHash(source->Path);
+			entry.Size			= data.size();
+			entry.NameOffset	= static_cast<uint32>(names.size());
+			entry.NameLength	= static_cast<uint16>(source->Path.size());
+			entry.bHasCRC		= source->bCRC ? 1 : 0;
+			entry.CRC			= source->bCRC ? Crypto::CRC32C(data) : 0;
+
+			JVector<byte> compressed;
+
+			if (CompressEntry(source->Compression, data, compressed))
+			{
+				entry.Compression = source->Compression;
+				data = compressed;
+			}
+
+			pad(AlignOffset(written, Alignment));
+
+			entry.Offset		= written;
+			entry.StoredSize	= data.size();
+
+			write(data.data(), data.size());
+
+			names += source->Path;
+			entries.push_back(entry);
+		}
+
+		// equal hashes (collisions) are told apart by the names at lookup
+		std::sort(entries.begin(), entries.end(), [](const SPakEntry& InLeft, const SPakEntry& InRight) { return InLeft.PathHash < InRight.PathHash; });
+
+		pad(AlignOffset(written, Alignment));
+
+		header.Magic			= SPakHeader::MagicValue;
+		header.Version			= SPakHeader::CurrentVersion;
+		header.EntriesCount		= static_cast<uint32>(entries.size());
+		header.Alignment		= Alignment;
+		header.TocOffset		= written;
+		header.NamesOffset		= written + entries.size() * sizeof(SPakEntry);
+		header.NamesSize		= names.size();
+		header.TocCRC			= Crypto::CRC32C(names.data(), names.size(), Crypto::CRC32C(entries.data(), entries.size() * sizeof(SPakEntry)));
+
+		write(entries.data(), entries.size() * sizeof(SPakEntry));
+		write(names.data(), names.size());
+
+		stream.seekp(0);
+		stream.write(reinterpret_cast<const CHAR*>(&header), sizeof(header));
+
+		return stream.good();
+	}
+
+
+	/****/
+	/* ARCHIVE */
+	/****/
+
+	bool PakArchive::Open(const FilePath& InPath)
+	{
+		Close();
+
+		if (!File.Open(InPath))
+		{
+			return false;
+		}
+
+		const Span<const byte> view = File.GetView();
+
+		SPakHeader header;
+
+		if (view.size() < sizeof(header))
+		{
+			Close();
+			return false;
+		}
+
+		Memory::Memcpy(view.data(), &header, sizeof(header));
+
+		const uint64 tocSize = static_cast<uint64>(header.EntriesCount) * sizeof(SPakEntry);
+
+		const bool bValidHeader = header.Magic == SPakHeader::MagicValue
+							   && header.Version == SPakHeader::CurrentVersion
+							   && header.TocOffset % alignof(SPakEntry) == 0
+							   && header.TocOffset <= view.size() && tocSize <= view.size() - header.TocOffset
+							   && header.NamesOffset == header.TocOffset + tocSize
+							   && header.NamesSize <= view.size() - header.NamesOffset;
+
+		if (!bValidHeader || Crypto::CRC32C(view.data() + header.NamesOffset, header.NamesSize,
+											Crypto::CRC32C(view.data() + header.TocOffset, tocSize)) != header.TocCRC)
+		{
+			Close();
+			return false;
+		}
+
+		Entries			= reinterpret_cast<const SPakEntry*>(view.data() + header.TocOffset);
+		EntriesCount	= header.EntriesCount;
+		Names			= reinterpret_cast<const CHAR*>(view.data() + header.NamesOffset);
+
+		// a damaged table could point anywhere, checked once here instead of on every access
+		for (const SPakEntry& entry : GetEntries())
+		{
+			const bool bValidEntry = entry.Offset <= view.size() && entry.StoredSize <= view.size() - entry.Offset
+								  && static_cast<uint64>(entry.NameOffset) + entry.NameLength <= header.NamesSize
+								  && (entry.Compression != EPakCompression::None || entry.StoredSize == entry.Size);
+
+			if (!bValidEntry)
+			{
+				Close();
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void PakArchive::Close()
+	{
+		File.Close();
+
+		Entries = nullptr;
+		EntriesCount = 0;
+		Names = nullptr;
+	}
+
+	const SPakEntry* PakArchive::Find(std::string_view InPath) const
+	{
+		const uint64 hash = GetPakPathHash(InPath);
+
+		const SPakEntry* end = Entries + EntriesCount;
+		const SPakEntry* entry = std::lower_bound(Entries, end, hash, [](const SPakEntry& InEntry, uint64 InHash) { return InEntry.PathHash < InHash; });
+
+		for (; entry != end && entry->PathHash == hash; ++entry)
+		{
+			if (GetEntryPath(*entry) == InPath)
+			{
+				return entry;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool PakArchive::Read(const SPakEntry& InEntry, byte* OutData) const
+	{
+		if (!DecompressEntry(InEntry.Compression, GetStoredData(InEntry), OutData, InEntry.Size))
+		{
+			return false;
+		}
+
+		return !InEntry.bHasCRC || Crypto::CRC32C(OutData, InEntry.Size) == InEntry.CRC;
+	}
+
+}
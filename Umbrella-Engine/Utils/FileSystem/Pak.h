@@ -0,0 +1,195 @@
+#pragma once
+#include "MappedFile.h"
+#include <string>
+
+
+
+namespace J::system
+{
+
+	enum class EPakCompression : uint8
+	{
+		None,
+
+		// Compression::Compress block stream, the blocks of large entries are decompressed in parallel
+		LZBlock,
+	};
+
+
+	/**
+	 * Engine archive layout, little endian:
+	 *
+	 *		SPakHeader					padded to Alignment
+	 *		entries data				each entry starts on an Alignment boundary
+	 *		SPakEntry[EntriesCount]		sorted by PathHash, starts on an Alignment boundary
+	 *		names						entry paths, not terminated
+	 *
+	 * The table of contents is read straight from the mapped archive, looking a path up is a binary search
+	 * on its hash. Aligned entries can be mapped and handed out without copies.
+	 */
+	struct SPakHeader
+	{
+		static constexpr uint32 MagicValue = 0x4B41504A;	// "JPAK"
+		static constexpr uint32 CurrentVersion = 1;
+
+		uint32			Magic;
+
+		uint32			Version;
+
+		uint32			EntriesCount;
+
+		uint32			Alignment;
+
+		uint64			TocOffset;
+
+		uint64			NamesOffset;
+
+		uint64			NamesSize;
+
+		// CRC32C of the entries table and the names
+		uint32			TocCRC;
+
+		uint32			Reserved;
+	};
+
+	struct SPakEntry
+	{
+		// Crypto::Hash64 of the normalized path
+		uint64			PathHash;
+
+		uint64			Offset;
+
+		// size in the archive, differs from Size for compressed entries
+		uint64			StoredSize;
+
+		uint64			Size;
+
+		uint32			NameOffset;
+
+		// CRC32C of the uncompressed contents, valid if bHasCRC
+		uint32			CRC;
+
+		uint16			NameLength;
+
+		EPakCompression	Compression;
+
+		uint8			bHasCRC;
+
+		uint32			Reserved;
+	};
+
+	static_assert(sizeof(SPakHeader) == 48 && sizeof(SPakEntry) == 48, "Pak structures are part of the file format.");
+
+
+	/** Archive path form: '/' separators, no "." / ".." parts, no leading or trailing separator. */
+	std::string NormalizePakPath(std::string_view InPath);
+
+	uint64 GetPakPathHash(std::string_view InNormalizedPath);
+
+
+	/**
+	 * Offline packer. Sources are only read by Write, entries are laid out in path order
+	 * so files of one directory stay next to each other on the disk.
+	 */
+	class PakWriter
+	{
+	public:
+
+		explicit PakWriter(uint32 InAlignment = 4096);
+
+		/** Adds a file from the disk under InPath in the archive. */
+		void AddFile(const FilePath& InSource, std::string_view InPath,
+					 EPakCompression InCompression = EPakCompression::None, bool bInCRC = true);
+
+		void AddData(std::string_view InPath, JVector<byte> InData,
+					 EPakCompression InCompression = EPakCompression::None, bool bInCRC = true);
+
+		/**
+		 * Adds every regular file under a directory, named by its relative path.
+		 *
+		 * A directory that can't be read (entirely or partly) makes Write fail, the readable files are still added.
+		 *
+		 * \param InPrefix - Prepended to the relative paths ("Textures" puts "a.png" at "Textures/a.png").
+		 * \return number of files added.
+		 */
+		SIZE_T AddDirectory(const FilePath& InDirectory, std::string_view InPrefix = {},
+							EPakCompression InCompression = EPakCompression::None, bool bInCRC = true);
+
+		SIZE_T GetEntriesCount() const { return Sources.size(); }
+
+		/** Writes the archive. Returns false if a source or a directory can't be read, a path is added twice or the output can't be written. */
+		bool Write(const FilePath& InOutput) const;
+
+	private:
+
+		struct SSource
+		{
+			std::string			Path;
+
+			FilePath			File;			// empty for AddData sources
+
+			JVector<byte>		Data;
+
+			EPakCompression		Compression;
+
+			bool				bCRC;
+		};
+
+		JVector<SSource>		Sources;
+
+		uint32					Alignment;
+
+		// an AddDirectory could not read its directory
+		bool					bMissingSources	= false;
+	};
+
+
+	/**
+	 * Runtime side of an archive: the file stays mapped, entries are served from the mapping.
+	 */
+	class PakArchive
+	{
+	public:
+
+		/** Maps an archive and validates its header and table of contents. */
+		bool Open(const FilePath& InPath);
+
+		void Close();
+
+		bool IsOpen() const { return File.IsOpen(); }
+
+		const FilePath& GetPath() const { return File.GetPath(); }
+
+		/** \param InPath - Normalized path, see NormalizePakPath. */
+		const SPakEntry* Find(std::string_view InPath) const;
+
+		Span<const SPakEntry> GetEntries() const { return { Entries, EntriesCount }; }
+
+		std::string_view GetEntryPath(const SPakEntry& InEntry) const { return { Names + InEntry.NameOffset, InEntry.NameLength }; }
+
+		/** Bytes of an entry as stored in the archive, straight from the mapping (no CRC check). */
+		Span<const byte> GetStoredData(const SPakEntry& InEntry) const { return File.GetView(InEntry.Offset, InEntry.StoredSize); }
+
+		/**
+		 * Uncompressed contents of an entry, checked against its CRC.
+		 *
+		 * \param OutData - At least InEntry.Size bytes.
+		 * \return false if the entry is corrupted.
+		 */
+		bool Read(const SPakEntry& InEntry, byte* OutData) const;
+
+		/** Starts loading an entry in the background. */
+		void Prefetch(const SPakEntry& InEntry) { File.Prefetch(InEntry.Offset, InEntry.StoredSize); }
+
+	private:
+
+		MappedFile			File;
+
+		const SPakEntry*	Entries			= nullptr;
+
+		uint32				EntriesCount	= 0;
+
+		const CHAR*			Names			= nullptr;
+	};
+
+}
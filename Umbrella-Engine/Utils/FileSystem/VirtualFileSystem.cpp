@@ -0,0 +1,162 @@
+#include "VirtualFileSystem.h"
+#include <algorithm>
+
+
+
+namespace J::system
+{
+
+	VirtualFileSystem& VirtualFileSystem::Get()
+	{
+		static VirtualFileSystem fileSystem;
+		return fileSystem;
+	}
+
+	bool VirtualFileSystem::MountPak(const FilePath& InPak, std::string_view InMountPoint, int32 InPriority)
+	{
+		// opened before taking the lock, mapping the archive resolves its path through the mounts
+		auto archive = MakeRef<PakArchive>();
+
+		if (!archive->Open(InPak))
+		{
+			return false;
+		}
+
+		AddMount({ std::filesystem::absolute(InPak).lexically_normal(), NormalizePakPath(InMountPoint), InPriority, std::move(archive) });
+		return true;
+	}
+
+	void VirtualFileSystem::MountDirectory(const FilePath& InDirectory, std::string_view InMountPoint, int32 InPriority)
+	{
+		// absolute, so reading the loose files does not come back here
+		AddMount({ std::filesystem::absolute(InDirectory).lexically_normal(), NormalizePakPath(InMountPoint), InPriority, nullptr });
+	}
+
+	void VirtualFileSystem::AddMount(SMount InMount)
+	{
+		JF_SCOPED_LOCK(Mutex);
+
+		// in front of the mounts with the same priority, the latest mount wins
+		auto position = std::find_if(Mounts.begin(), Mounts.end(), [&InMount](const SMount& InOther) { return InOther.Priority <= InMount.Priority; });
+
+		Mounts.insert(position, std::move(InMount));
+		MountsCount.store(static_cast<uint32>(Mounts.size()), std::memory_order_relaxed);
+	}
+
+	bool VirtualFileSystem::Unmount(const FilePath& InSource)
+	{
+		const FilePath source = std::filesystem::absolute(InSource).lexically_normal();
+
+		JF_SCOPED_LOCK(Mutex);
+
+		const SIZE_T removed = std::erase_if(Mounts, [&source](const SMount& InMount) { return InMount.Source == source; });
+
+		MountsCount.store(static_cast<uint32>(Mounts.size()), std::memory_order_relaxed);
+		return removed != 0;
+	}
+
+	void VirtualFileSystem::UnmountAll()
+	{
+		JF_SCOPED_LOCK(Mutex);
+
+		Mounts.clear();
+		MountsCount.store(0, std::memory_order_relaxed);
+	}
+
+	bool VirtualFileSystem::Resolve(const FilePath& InPath, SResolvedPath& OutResolved) const
+	{
+		if (!HasMounts() || InPath.is_absolute())
+		{
+			return false;
+		}
+
+		const std::string path = NormalizePakPath(InPath.generic_string());
+
+		JF_SCOPED_LOCK(Mutex);
+
+		for (const SMount& mount : Mounts)
+		{
+			std::string_view relative = path;
+
+			if (!mount.MountPoint.empty())
+			{
+				const SIZE_T length = mount.MountPoint.size();
+
+				if (!relative.starts_with(mount.MountPoint) || (relative.size() > length && relative[length] != '/'))
+				{
+					continue;
+				}
+
+				relative.remove_prefix(std::min(length + 1, relative.size()));
+			}
+
+			if (mount.Archive != nullptr)
+			{
+				if (const SPakEntry* entry = mount.Archive->Find(relative))
+				{
+					OutResolved.Archive = mount.Archive;
+					OutResolved.Entry = entry;
+					return true;
+				}
+			}
+			else if (!relative.empty())
+			{
+				FilePath loosePath = mount.Source / relative;
+
+				if (std::filesystem::is_regular_file(loosePath))
+				{
+					OutResolved.LoosePath = std::move(loosePath);
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool VirtualFileSystem::Exists(const FilePath& InPath) const
+	{
+		SResolvedPath resolved;
+		return Resolve(InPath, resolved);
+	}
+
+	template<class ContainerType>
+	bool VirtualFileSystem::ReadResolved(const FilePath& InPath, ContainerType& OutContent) const
+	{
+		SResolvedPath resolved;
+
+		if (!Resolve(InPath, resolved))
+		{
+			return false;
+		}
+
+		if (resolved.Archive != nullptr)
+		{
+			OutContent.resize(static_cast<SIZE_T>(resolved.Entry->Size));
+
+			if (!resolved.Archive->Read(*resolved.Entry, reinterpret_cast<byte*>(OutContent.data())))
+			{
+				// todo: normal error log system
+				throw "Archive entry is damaged!";
+			}
+		}
+		else if (!Details::ReadFromDisk(resolved.LoosePath, OutContent))
+		{
+			// todo: normal error log system
+			throw "File could not be read!";
+		}
+
+		return true;
+	}
+
+	bool VirtualFileSystem::ReadAll(const FilePath& InPath, JVector<byte>& OutContent) const
+	{
+		return ReadResolved(InPath, OutContent);
+	}
+
+	bool VirtualFileSystem::ReadAllText(const FilePath& InPath, std::string& OutContent) const
+	{
+		return ReadResolved(InPath, OutContent);
+	}
+
+}
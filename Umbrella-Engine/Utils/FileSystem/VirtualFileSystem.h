@@ -0,0 +1,98 @@
+#pragma once
+#include "Pak.h"
+
+
+
+namespace J::system
+{
+
+	/**
+	 * Mounted paks and loose directories, looked up by the File and MappedFile read functions before the disk.
+	 *
+	 * Relative paths are resolved against the mounts, highest priority first (later mounts win ties), and fall
+	 * through to the disk when no mount has them. Absolute paths always go to the disk.
+	 */
+	class VirtualFileSystem
+	{
+	public:
+
+		/** Loose directories mounted with the default priority shadow every pak mounted with the default one. */
+		static constexpr int32 DefaultPakPriority = 0;
+		static constexpr int32 DefaultDirectoryPriority = 1000;
+
+		/** Where a path ends up, see Resolve. */
+		struct SResolvedPath
+		{
+			// set when an archive serves the path
+			Ref<const PakArchive>	Archive;
+
+			const SPakEntry*		Entry		= nullptr;
+
+			// set when a mounted directory serves the path
+			FilePath				LoosePath;
+		};
+
+	public:
+
+		/** The engine-wide file system, File and MappedFile go through it. */
+		static VirtualFileSystem& Get();
+
+		/**
+		 * Mounts an archive.
+		 *
+		 * \param InMountPoint - Entries appear under this path ("Resources" maps "a.png" to "Resources/a.png").
+		 * \return false if the archive can't be opened or is damaged.
+		 */
+		bool MountPak(const FilePath& InPak, std::string_view InMountPoint = {}, int32 InPriority = DefaultPakPriority);
+
+		/** Mounts a directory of loose files, the development overlay over the paks. */
+		void MountDirectory(const FilePath& InDirectory, std::string_view InMountPoint = {}, int32 InPriority = DefaultDirectoryPriority);
+
+		/** Unmounts every mount of a pak or a directory. */
+		bool Unmount(const FilePath& InSource);
+
+		void UnmountAll();
+
+		bool HasMounts() const { return MountsCount.load(std::memory_order_relaxed) != 0; }
+
+		/** \return false if no mount has the path. */
+		bool Resolve(const FilePath& InPath, SResolvedPath& OutResolved) const;
+
+		bool Exists(const FilePath& InPath) const;
+
+		/**
+		 * Reads a whole file from the mounts.
+		 *
+		 * \return false if no mount has the path. Throws if the mount that has it can't read it (damaged entry).
+		 */
+		bool ReadAll(const FilePath& InPath, JVector<byte>& OutContent) const;
+
+		bool ReadAllText(const FilePath& InPath, std::string& OutContent) const;
+
+	private:
+
+		struct SMount
+		{
+			FilePath				Source;
+
+			std::string				MountPoint;
+
+			int32					Priority;
+
+			Ref<const PakArchive>	Archive;		// nullptr for directories
+		};
+
+		void AddMount(SMount InMount);
+
+		template<class ContainerType>
+		bool ReadResolved(const FilePath& InPath, ContainerType& OutContent) const;
+
+		// sorted by descending priority
+		JVector<SMount>			Mounts;
+
+		mutable TMutex			Mutex;
+
+		Atomic::TAtomic<uint32>	MountsCount { 0 };
+	};
+
+}
@@ -0,0 +1,375 @@
+#include "Profiler.h"
+#include "../FileSystem/BinaryArchive.h"
+#include <algorithm>
+#include <charconv>
+#include <memory>
+
+
+
+namespace J::Utils
+{
+
+	/** Zones of one thread, written by that thread and read by EndFrame. */
+	struct Profiler::SThreadBuffer
+	{
+		std::unique_ptr<SProfileZone[]>	Zones { new SProfileZone[ThreadBufferCapacity] };
+
+		// zones written so far, only the owner thread stores it
+		Atomic::TAtomic<uint64>			Head { 0 };
+
+		// zones collected so far, only EndFrame stores it
+		Atomic::TAtomic<uint64>			Tail { 0 };
+
+		Atomic::TAtomic<uint64>			Dropped { 0 };
+
+		// set when the thread exits, the buffer goes once its last zones are collected
+		Atomic::TAtomicBool				bFinished { false };
+
+		uint32							Thread = 0;
+
+		// a timeline of RegisterTrack, written under the profiler's mutex
+		bool							bTrack = false;
+	};
+
+	static_assert((Profiler::ThreadBufferCapacity & (Profiler::ThreadBufferCapacity - 1)) == 0, "The thread buffer capacity must be a power of two.");
+
+	// zones open on the calling thread
+	static thread_local uint32 GZoneDepth = 0;
+
+	// frame markers of the capture
+	static constexpr const char* GFrameZoneName = "Frame";
+
+
+	/** Time of a reading relative to an origin, negative for the earlier ones. */
+	static TimeSpan ToRelativeTime(uint64 InTicks, uint64 InOriginTicks)
+	{
+		return InTicks >= InOriginTicks ? Timer::ToTimeSpan(InTicks - InOriginTicks) : -Timer::ToTimeSpan(InOriginTicks - InTicks);
+	}
+
+	static void AppendMicroseconds(std::string& OutJson, TimeSpan InTime)
+	{
+		char digits[32];
+		const auto result = std::to_chars(digits, digits + sizeof(digits), static_cast<double>(InTime.GetNanoseconds()) * 1e-3, std::chars_format::fixed, 3);
+
+		OutJson.append(digits, result.ptr);
+	}
+
+	static void AppendJsonString(std::string& OutJson, std::string_view InString)
+	{
+		static constexpr char hexDigits[] = "0123456789abcdef";
+
+		OutJson += '"';
+
+		for (const char character : InString)
+		{
+			if (character == '"' || character == '\\')
+			{
+				OutJson += '\\';
+				OutJson += character;
+			}
+			else if (static_cast<unsigned char>(character) < 0x20)
+			{
+				OutJson += "\\u00";
+				OutJson += hexDigits[character >> 4];
+				OutJson += hexDigits[character & 0xF];
+			}
+			else
+			{
+				OutJson += character;
+			}
+		}
+
+		OutJson += '"';
+	}
+
+
+	/****/
+	/* RECORDING */
+
+	Profiler& Profiler::Get()
+	{
+		static Profiler profiler;
+		return profiler;
+	}
+
+	Profiler::SThreadBuffer& Profiler::GetThreadBuffer()
+	{
+		static thread_local SThreadBuffer* buffer = nullptr;
+
+		if (buffer == nullptr)
+		{
+			// marks the buffer finished when the thread exits, the profiler keeps it until its last zones are collected
+			struct SThreadBufferOwner
+			{
+				Ref<SThreadBuffer> Buffer;
+
+				~SThreadBufferOwner() { Buffer->bFinished.store(true, std::memory_order_release); }
+			};
+
+			static thread_local SThreadBufferOwner owner { Get().RegisterThread() };
+			buffer = owner.Buffer.get();
+		}
+
+		return *buffer;
+	}
+
+	Ref<Profiler::SThreadBuffer> Profiler::RegisterThread()
+	{
+		const Ref<SThreadBuffer> buffer = MakeRef<SThreadBuffer>();
+
+		JF_SCOPED_LOCK(Mutex);
+
+		buffer->Thread = NextThread++;
+		Threads.push_back(buffer);
+
+		return buffer;
+	}
+
+	void Profiler::SetThreadName(std::string_view InName)
+	{
+		const uint32 thread = GetThreadBuffer().Thread;
+		Profiler& profiler = Get();
+
+		JF_SCOPED_LOCK(profiler.Mutex);
+		profiler.ThreadNames[thread] = InName;
+	}
+
+	uint32 Profiler::RegisterTrack(std::string_view InName)
+	{
+		const Ref<SThreadBuffer> buffer = MakeRef<SThreadBuffer>();
+		buffer->bTrack = true;
+
+		JF_SCOPED_LOCK(Mutex);
+
+		buffer->Thread = NextThread++;
+		Threads.push_back(buffer);
+		ThreadNames[buffer->Thread] = InName;
+
+		return buffer->Thread;
+	}
+
+	void Profiler::SubmitZones(uint32 InTrack, Span<const SProfileZone> InZones)
+	{
+		JF_SCOPED_LOCK(Mutex);
+
+		const auto track = std::find_if(Threads.begin(), Threads.end(), [InTrack](const Ref<SThreadBuffer>& InBuffer)
+		{
+			return InBuffer->bTrack && InBuffer->Thread == InTrack;
+		});
+
+		JF_ASSERT(track != Threads.end(), "Unknown profiler track.");
+
+		SThreadBuffer& buffer = **track;
+
+		// the collection of EndFrame is behind the same lock
+		uint64 head = buffer.Head.load(std::memory_order_relaxed);
+		const uint64 tail = buffer.Tail.load(std::memory_order_relaxed);
+
+		for (const SProfileZone& zone : InZones)
+		{
+			if (head - tail >= ThreadBufferCapacity)
+			{
+				buffer.Dropped.fetch_add(1, std::memory_order_relaxed);
+				continue;
+			}
+
+			buffer.Zones[head++ & (ThreadBufferCapacity - 1)] = zone;
+		}
+
+		buffer.Head.store(head, std::memory_order_relaxed);
+	}
+
+	uint32 Profiler::BeginZone()
+	{
+		return GZoneDepth++;
+	}
+
+	void Profiler::EndZone(const char* InName, uint64 InStartTicks, uint32 InDepth)
+	{
+		const uint64 endTicks = Timer::GetTicks();
+
+		GZoneDepth = InDepth;
+
+		SThreadBuffer& buffer = GetThreadBuffer();
+
+		const uint64 head = buffer.Head.load(std::memory_order_relaxed);
+
+		if (head - buffer.Tail.load(std::memory_order_acquire) >= ThreadBufferCapacity)
+		{
+			buffer.Dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		buffer.Zones[head & (ThreadBufferCapacity - 1)] = { InName, InStartTicks, endTicks, InDepth };
+		buffer.Head.store(head + 1, std::memory_order_release);
+	}
+
+
+	/****/
+	/* COLLECTING */
+
+	void Profiler::EndFrame()
+	{
+		const uint64 frameEndTicks = Timer::GetTicks();
+		const uint32 collectorThread = GetThreadBuffer().Thread;
+
+		JF_SCOPED_LOCK(Mutex);
+
+		SProfileFrame frame;
+		frame.Index = LastFrame.Index + 1;
+		frame.Duration = FrameStartTicks != 0 ? Timer::ToTimeSpan(frameEndTicks - FrameStartTicks) : TimeSpan::Zero();
+
+		// track -> zone name -> index in frame.Zones, the same name can have several addresses across modules
+		std::unordered_map<uint32, std::unordered_map<std::string_view, SIZE_T>> zoneIndices;
+
+		for (SIZE_T threadIndex = 0; threadIndex < Threads.size();)
+		{
+			SThreadBuffer* buffer = Threads[threadIndex].get();
+
+			// read before the zones, a finished thread has written all of them
+			const bool bFinished = buffer->bFinished.load(std::memory_order_acquire);
+
+			const uint64 head = buffer->Head.load(std::memory_order_acquire);
+			const uint64 tail = buffer->Tail.load(std::memory_order_relaxed);
+
+			const uint32 track = buffer->bTrack ? buffer->Thread : 0;
+			std::unordered_map<std::string_view, SIZE_T>& trackIndices = zoneIndices[track];
+
+			for (uint64 i = tail; i < head; ++i)
+			{
+				const SProfileZone& zone = buffer->Zones[i & (ThreadBufferCapacity - 1)];
+				const TimeSpan duration = Timer::ToTimeSpan(zone.EndTicks - zone.StartTicks);
+
+				const auto [it, bInserted] = trackIndices.try_emplace(zone.Name, frame.Zones.size());
+
+				if (bInserted)
+				{
+					frame.Zones.push_back({ zone.Name, track, 0, TimeSpan::Zero(), TimeSpan::Zero() });
+				}
+
+				SProfileZoneStats& stats = frame.Zones[it->second];
+				stats.Count++;
+				stats.Total += duration;
+				stats.Max = std::max(stats.Max, duration);
+
+				if (bCapturing && Captured.size() < MaxCapturedZones)
+				{
+					Captured.push_back({ zone, buffer->Thread });
+				}
+			}
+
+			buffer->Tail.store(head, std::memory_order_release);
+			frame.DroppedZones += buffer->Dropped.exchange(0, std::memory_order_relaxed);
+
+			if (bFinished)
+			{
+				Threads.erase(Threads.begin() + threadIndex);
+			}
+			else
+			{
+				++threadIndex;
+			}
+		}
+
+		std::sort(frame.Zones.begin(), frame.Zones.end(), [](const SProfileZoneStats& InLeft, const SProfileZoneStats& InRight)
+		{
+			return InLeft.Total > InRight.Total;
+		});
+
+		if (bCapturing)
+		{
+			if (FrameStartTicks >= CaptureStartTicks)
+			{
+				Captured.push_back({ { GFrameZoneName, FrameStartTicks, frameEndTicks, 0 }, collectorThread });
+			}
+
+			bCapturing = Captured.size() < MaxCapturedZones;
+		}
+
+		FrameStartTicks = frameEndTicks;
+		LastFrame = std::move(frame);
+	}
+
+	SProfileFrame Profiler::GetLastFrame() const
+	{
+		JF_SCOPED_LOCK(Mutex);
+		return LastFrame;
+	}
+
+
+	/****/
+	/* CAPTURE */
+
+	void Profiler::BeginCapture(SIZE_T InMaxZones)
+	{
+		JF_SCOPED_LOCK(Mutex);
+
+		Captured.clear();
+		CaptureStartTicks = Timer::GetTicks();
+		MaxCapturedZones = InMaxZones;
+		bCapturing = true;
+	}
+
+	void Profiler::EndCapture()
+	{
+		JF_SCOPED_LOCK(Mutex);
+		bCapturing = false;
+	}
+
+	bool Profiler::IsCapturing() const
+	{
+		JF_SCOPED_LOCK(Mutex);
+		return bCapturing;
+	}
+
+	bool Profiler::ExportChromeTrace(const system::FilePath& InPath) const
+	{
+		std::string json;
+
+		{
+			JF_SCOPED_LOCK(Mutex);
+
+			json.reserve(64 + Captured.size() * 96);
+			json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+			bool bFirst = true;
+
+			for (const auto& [thread, name] : ThreadNames)
+			{
+				json += bFirst ? "\n" : ",\n";
+				json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+				json += std::to_string(thread);
+				json += ",\"args\":{\"name\":";
+				AppendJsonString(json, name);
+				json += "}}";
+
+				bFirst = false;
+			}
+
+			// complete events, the viewers nest them by time on each thread
+			for (const SCapturedZone& captured : Captured)
+			{
+				json += bFirst ? "\n" : ",\n";
+				json += "{\"name\":";
+				AppendJsonString(json, captured.Zone.Name);
+				json += ",\"ph\":\"X\",\"pid\":1,\"tid\":";
+				json += std::to_string(captured.Thread);
+				json += ",\"ts\":";
+				AppendMicroseconds(json, ToRelativeTime(captured.Zone.StartTicks, CaptureStartTicks));
+				json += ",\"dur\":";
+				AppendMicroseconds(json, Timer::ToTimeSpan(captured.Zone.EndTicks - captured.Zone.StartTicks));
+				json += '}';
+
+				bFirst = false;
+			}
+
+			json += "\n]}\n";
+		}
+
+		system::BinaryWriter file(InPath);
+		file.WriteBytes(json.data(), json.size());
+
+		return file.Close();
+	}
+
+}
@@ -0,0 +1,213 @@
+#pragma once
+#include "../Time/Timer.h"
+#include <string>
+#include <unordered_map>
+
+
+
+namespace J::Utils
+{
+
+	/** A finished zone. */
+	struct SProfileZone
+	{
+		// string with static storage (a literal)
+		const char*	Name;
+
+		uint64		StartTicks;
+
+		uint64		EndTicks;
+
+		// nesting level on its thread, 0 for the outermost zones
+		uint32		Depth;
+	};
+
+	struct SProfileZoneStats
+	{
+		const char*	Name;
+
+		// 0 for the zones of the CPU threads, see RegisterTrack
+		uint32		Track;
+
+		uint32		Count;
+
+		// including the nested zones
+		TimeSpan	Total;
+
+		TimeSpan	Max;
+	};
+
+	/** What the zones of one frame add up to, on every thread. */
+	struct SProfileFrame
+	{
+		uint64						Index		= 0;
+
+		TimeSpan					Duration;
+
+		// sorted by total time, longest first
+		JVector<SProfileZoneStats>	Zones;
+
+		// recorded while the thread's buffer was full
+		uint64						DroppedZones = 0;
+	};
+
+
+	/**
+	 * CPU profiler fed by JF_PROFILE_SCOPE zones.
+	 *
+	 * Every thread records its finished zones into its own ring buffer (one producer, one consumer, no locks), and
+	 * EndFrame collects them once a frame into per-frame aggregates, and into a capture that can be exported as a
+	 * Chrome Trace / Perfetto JSON file. A zone costs two TSC readings and a store into the buffer.
+	 */
+	class Profiler
+	{
+	public:
+
+		/** Zones a thread can record between two EndFrame calls, the later ones are dropped. */
+		static constexpr SIZE_T ThreadBufferCapacity = SIZE_T(1) << 14;
+
+		static constexpr SIZE_T DefaultMaxCapturedZones = SIZE_T(1) << 22;
+
+	public:
+
+		Profiler() = default;
+
+		Profiler(const Profiler&) = delete;
+
+		Profiler& operator = (const Profiler&) = delete;
+
+		static Profiler& Get();
+
+		/** Zones are not recorded while disabled, the open ones still are. */
+		static void SetEnabled(bool bInEnabled) { bEnabled.store(bInEnabled, std::memory_order_relaxed); }
+
+		static bool IsEnabled() { return bEnabled.load(std::memory_order_relaxed); }
+
+		/** Names the calling thread in the exported traces. */
+		static void SetThreadName(std::string_view InName);
+
+		/** Opens a zone on the calling thread, returns its depth. */
+		static uint32 BeginZone();
+
+		static void EndZone(const char* InName, uint64 InStartTicks, uint32 InDepth);
+
+		/** Adds a timeline for zones measured elsewhere than on the CPU threads (the GPU), returns its id. */
+		uint32 RegisterTrack(std::string_view InName);
+
+		/** Records zones of a track, their ticks converted to the Timer clock. They are collected by the next EndFrame. */
+		void SubmitZones(uint32 InTrack, Span<const SProfileZone> InZones);
+
+		/** Collects the zones finished since the previous call, once a frame on the main thread. */
+		void EndFrame();
+
+		SProfileFrame GetLastFrame() const;
+
+		/**
+		 * Keeps every collected zone for ExportChromeTrace, replacing the previous capture.
+		 *
+		 * \param InMaxZones - The capture stops by itself once it holds this many zones.
+		 */
+		void BeginCapture(SIZE_T InMaxZones = DefaultMaxCapturedZones);
+
+		void EndCapture();
+
+		bool IsCapturing() const;
+
+		/** Writes the capture (the zones and the frames) as Trace Event Format JSON, for chrome://tracing and Perfetto. */
+		bool ExportChromeTrace(const system::FilePath& InPath) const;
+
+	private:
+
+		struct SThreadBuffer;
+
+		struct SCapturedZone
+		{
+			SProfileZone	Zone;
+
+			uint32			Thread;
+		};
+
+		static SThreadBuffer& GetThreadBuffer();
+
+		Ref<SThreadBuffer> RegisterThread();
+
+		static inline Atomic::TAtomicBool	bEnabled { true };
+
+		// threads that recorded zones, the exited ones are removed once collected
+		JVector<Ref<SThreadBuffer>>			Threads;
+
+		std::unordered_map<uint32, std::string> ThreadNames;
+
+		JVector<SCapturedZone>				Captured;
+
+		SProfileFrame						LastFrame;
+
+		uint64								FrameStartTicks	= 0;
+
+		uint64								CaptureStartTicks = 0;
+
+		SIZE_T								MaxCapturedZones = 0;
+
+		uint32								NextThread		= 1;
+
+		bool								bCapturing		= false;
+
+		mutable TMutex						Mutex;
+	};
+
+
+	/** Zone around a scope, see JF_PROFILE_SCOPE. */
+	class ProfileScope
+	{
+	public:
+
+		explicit ProfileScope(const char* InName)
+		{
+			if (Profiler::IsEnabled())
+			{
+				Name = InName;
+				Depth = Profiler::BeginZone();
+				StartTicks = Timer::GetTicks();
+			}
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+
+		ProfileScope& operator = (const ProfileScope&) = delete;
+
+		~ProfileScope()
+		{
+			if (Name != nullptr)
+			{
+				Profiler::EndZone(Name, StartTicks, Depth);
+			}
+		}
+
+	private:
+
+		const char*	Name		= nullptr;
+
+		uint64		StartTicks	= 0;
+
+		uint32		Depth		= 0;
+	};
+
+}
+
+
+#if JF_PROFILE
+	/** Times the rest of the scope under a string literal name. */
+	#define JF_PROFILE_SCOPE(Name) ::J::Utils::ProfileScope JF_CONCATENATE2(profileScope, __LINE__)(Name)
+
+	#define JF_PROFILE_FUNCTION() JF_PROFILE_SCOPE(__FUNCTION__)
+
+	/** Ends the profiled frame, once a frame on the main thread. */
+	#define JF_PROFILE_FRAME() ::J::Utils::Profiler::Get().EndFrame()
+
+	#define JF_PROFILE_THREAD(Name) ::J::Utils::Profiler::SetThreadName(Name)
+#else
+	#define JF_PROFILE_SCOPE(Name)
+	#define JF_PROFILE_FUNCTION()
+	#define JF_PROFILE_FRAME()
+	#define JF_PROFILE_THREAD(Name)
+#endif
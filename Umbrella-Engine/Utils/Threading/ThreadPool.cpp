@@ -0,0 +1,162 @@
+#include "ThreadPool.h"
+#include "../Profiling/Profiler.h"
+#include <algorithm>
+
+
+
+namespace J::Utils
+{
+
+	namespace
+	{
+		// Shared by the caller and the helper tasks of one ParallelFor call.
+		// Helpers that start after everything is done only see Next >= ChunksCount and leave,
+		// so the task reference is never touched once ParallelFor has returned.
+		struct SParallelForState
+		{
+			Atomic::TAtomic<SIZE_T>			Next { 0 };
+			Atomic::TAtomic<SIZE_T>			Done { 0 };
+
+			SIZE_T							Count = 0;
+			SIZE_T							Grain = 1;
+			SIZE_T							ChunksCount = 0;
+
+			const ThreadPool::RangeTaskType* Task = nullptr;
+
+			void Work()
+			{
+				for (SIZE_T chunk = Next.fetch_add(1); chunk < ChunksCount; chunk = Next.fetch_add(1))
+				{
+					const SIZE_T begin = chunk * Grain;
+					(*Task)(begin, std::min(begin + Grain, Count));
+
+					if (Done.fetch_add(1) + 1 == ChunksCount)
+					{
+						Done.notify_all();
+					}
+				}
+			}
+		};
+	}
+
+
+	ThreadPool::ThreadPool(uint32 InWorkersCount)
+		: bStopping(false)
+	{
+		if (InWorkersCount == 0)
+		{
+			InWorkersCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+		}
+
+		Workers.reserve(InWorkersCount);
+
+		for (uint32 i = 0; i < InWorkersCount; ++i)
+		{
+			Workers.emplace_back([this]() { WorkerLoop(); });
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			JF_SCOPED_LOCK(Mutex);
+			bStopping = true;
+		}
+
+		Condition.notify_all();
+
+		for (auto& worker : Workers)
+		{
+			worker.join();
+		}
+	}
+
+	ThreadPool& ThreadPool::Get()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+	void ThreadPool::Submit(TaskType InTask)
+	{
+		{
+			JF_SCOPED_LOCK(Mutex);
+			Tasks.push_back(std::move(InTask));
+		}
+
+		Condition.notify_one();
+	}
+
+	void ThreadPool::ParallelFor(SIZE_T InCount, SIZE_T InGrain, const RangeTaskType& InTask)
+	{
+		if (InCount == 0)
+		{
+			return;
+		}
+
+		if (InGrain == 0)
+		{
+			InGrain = (InCount + GetConcurrency() - 1) / GetConcurrency();
+		}
+
+		const SIZE_T chunksCount = (InCount + InGrain - 1) / InGrain;
+
+		if (chunksCount == 1 || Workers.empty())
+		{
+			InTask(0, InCount);
+			return;
+		}
+
+		auto state = MakeRef<SParallelForState>();
+		state->Count = InCount;
+		state->Grain = InGrain;
+		state->ChunksCount = chunksCount;
+		state->Task = &InTask;
+
+		const SIZE_T helpersCount = std::min<SIZE_T>(Workers.size(), chunksCount - 1);
+
+		{
+			JF_SCOPED_LOCK(Mutex);
+
+			for (SIZE_T i = 0; i < helpersCount; ++i)
+			{
+				Tasks.push_back([state]() { state->Work(); });
+			}
+		}
+
+		Condition.notify_all();
+
+		state->Work();
+
+		for (SIZE_T done = state->Done.load(); done < chunksCount; done = state->Done.load())
+		{
+			state->Done.wait(done);
+		}
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		JF_PROFILE_THREAD("Worker");
+
+		while (true)
+		{
+			TaskType task;
+
+			{
+				TUniqueLock<TMutex> lock(Mutex);
+				Condition.wait(lock, [this]() { return bStopping || !Tasks.empty(); });
+
+				if (bStopping && Tasks.empty())
+				{
+					return;
+				}
+
+				task = std::move(Tasks.front());
+				Tasks.pop_front();
+			}
+
+			task();
+		}
+	}
+
+}
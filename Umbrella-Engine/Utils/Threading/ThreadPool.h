@@ -0,0 +1,78 @@
+#pragma once
+#include "../../Core.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <thread>
+
+
+
+namespace J::Utils
+{
+
+	/**
+	 * Fixed set of worker threads for CPU jobs (image kernels, asset processing, ...).
+	 */
+	class ThreadPool
+	{
+	public:
+
+		using TaskType = std::function<void()>;
+
+		/** Range job, called with [Begin, End) sub-ranges. */
+		using RangeTaskType = std::function<void(SIZE_T, SIZE_T)>;
+
+	public:
+
+		/**
+		 * \param InWorkersCount - Number of worker threads, 0 means hardware concurrency - 1
+		 *						   (the thread calling ParallelFor works as well).
+		 */
+		explicit ThreadPool(uint32 InWorkersCount = 0);
+
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator = (const ThreadPool&) = delete;
+
+		/** The engine-wide pool, created on first use. */
+		static ThreadPool& Get();
+
+		/** Number of threads that take part in ParallelFor (workers + caller). */
+		uint32 GetConcurrency() const { return static_cast<uint32>(Workers.size()) + 1; }
+
+		/** Queues a fire-and-forget task. */
+		void Submit(TaskType InTask);
+
+		/**
+		 * Splits [0, InCount) into InGrain-sized chunks and processes them on the workers and
+		 * the calling thread. Blocks until every chunk is done. Safe to call from a worker.
+		 *
+		 * \param InCount	- Number of items.
+		 * \param InGrain	- Minimal number of items per chunk (0 picks one chunk per thread).
+		 * \param InTask	- Called with [Begin, End) ranges.
+		 */
+		void ParallelFor(SIZE_T InCount, SIZE_T InGrain, const RangeTaskType& InTask);
+
+	private:
+
+		void WorkerLoop();
+
+		JVector<std::thread>		Workers;
+
+		std::deque<TaskType>		Tasks;
+
+		TMutex						Mutex;
+
+		std::condition_variable		Condition;
+
+		bool						bStopping;
+	};
+
+
+	INLINE void ParallelFor(SIZE_T InCount, SIZE_T InGrain, const ThreadPool::RangeTaskType& InTask)
+	{
+		ThreadPool::Get().ParallelFor(InCount, InGrain, InTask);
+	}
+
+}
@@ -1,6 +1,8 @@
 #pragma once
-
+#include "../../Core.h"
 #include <chrono>
+#include <compare>
+#include <limits>
 
 
 
@@ -8,16 +10,80 @@
 namespace J::Utils
 {
 
+	/**
+	 * Signed duration with nanosecond resolution (about 292 years each way), used by the timers, the profiler
+	 * and the fence timeouts. Converts implicitly from std::chrono durations: Lock(std::chrono::milliseconds(5)).
+	 */
 	class TimeSpan
 	{
 	public:
 
-	private:
+		using DurationType = std::chrono::nanoseconds;
 
+	public:
 
+		constexpr TimeSpan() = default;
 
-	};
+		constexpr explicit TimeSpan(int64 InNanoseconds) : Nanoseconds(InNanoseconds) {}
 
-}
+		template<class RepType, class PeriodType>
+		constexpr TimeSpan(std::chrono::duration<RepType, PeriodType> InDuration)
+			: Nanoseconds(std::chrono::duration_cast<DurationType>(InDuration).count())
+		{
+		}
+
+		static constexpr TimeSpan Zero() { return TimeSpan(); }
+
+		/** Waits that never time out, not to be used in arithmetic. */
+		static constexpr TimeSpan Infinite() { return TimeSpan(std::numeric_limits<int64>::max()); }
+
+		static constexpr TimeSpan FromNanoseconds(int64 InNanoseconds) { return TimeSpan(InNanoseconds); }
+
+		static constexpr TimeSpan FromMicroseconds(int64 InMicroseconds) { return TimeSpan(InMicroseconds * 1'000); }
+
+		static constexpr TimeSpan FromMilliseconds(int64 InMilliseconds) { return TimeSpan(InMilliseconds * 1'000'000); }
+
+		static constexpr TimeSpan FromSeconds(double InSeconds) { return TimeSpan(static_cast<int64>(InSeconds * 1e9)); }
+
+		constexpr bool IsInfinite() const { return Nanoseconds == std::numeric_limits<int64>::max(); }
+
+		constexpr int64 GetNanoseconds() const { return Nanoseconds; }
+
+		/** Whole units, truncated toward zero. */
+		constexpr int64 GetMicroseconds() const { return Nanoseconds / 1'000; }
+
+		constexpr int64 GetMilliseconds() const { return Nanoseconds / 1'000'000; }
+
+		constexpr double ToSeconds() const { return static_cast<double>(Nanoseconds) * 1e-9; }
 
+		constexpr double ToMilliseconds() const { return static_cast<double>(Nanoseconds) * 1e-6; }
 
+		constexpr DurationType ToDuration() const { return DurationType(Nanoseconds); }
+
+		constexpr auto operator <=> (const TimeSpan&) const = default;
+
+		constexpr TimeSpan operator - () const { return TimeSpan(-Nanoseconds); }
+
+		constexpr TimeSpan operator + (TimeSpan InOther) const { return TimeSpan(Nanoseconds + InOther.Nanoseconds); }
+
+		constexpr TimeSpan operator - (TimeSpan InOther) const { return TimeSpan(Nanoseconds - InOther.Nanoseconds); }
+
+		constexpr TimeSpan operator * (int64 InFactor) const { return TimeSpan(Nanoseconds * InFactor); }
+
+		constexpr TimeSpan operator * (double InFactor) const { return TimeSpan(static_cast<int64>(static_cast<double>(Nanoseconds) * InFactor)); }
+
+		constexpr TimeSpan operator / (int64 InDivisor) const { return TimeSpan(Nanoseconds / InDivisor); }
+
+		/** Ratio of two spans (frame time over budget, ...). */
+		constexpr double operator / (TimeSpan InOther) const { return static_cast<double>(Nanoseconds) / static_cast<double>(InOther.Nanoseconds); }
+
+		constexpr TimeSpan& operator += (TimeSpan InOther) { Nanoseconds += InOther.Nanoseconds; return *this; }
+
+		constexpr TimeSpan& operator -= (TimeSpan InOther) { Nanoseconds -= InOther.Nanoseconds; return *this; }
+
+	private:
+
+		int64 Nanoseconds = 0;
+	};
+
+}
@@ -1,9 +1,267 @@
 #include "Timer.h"
+#include <thread>
+
+#if defined(_M_X64) || defined(__x86_64__)
+	#if ENGINE_MSVC_COMPILER
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+		#include <x86intrin.h>
+	#endif
+#endif
 
 
 
 namespace J::Utils
 {
 
+	namespace
+	{
+		using SteadyClock = std::chrono::steady_clock;
+
+		/** Nanoseconds = (Ticks * Multiplier) >> GMultiplierShift. */
+		struct SClockCalibration
+		{
+			// reading at the calibration, where Now starts
+			uint64	Origin		= 0;
+
+			uint64	Multiplier	= 0;
+
+			double	Frequency	= 1e9;
+
+			bool	bTSC		= false;
+		};
+	}
+
+
+	// fraction bits of the multiplier
+	static constexpr uint32 GMultiplierShift = 32;
+
+	// the TSC is measured against the OS clock over this time, once
+	static constexpr std::chrono::milliseconds GCalibrationTime(10);
+
+	// readings taken around each calibration point, the tightest one is kept
+	static constexpr uint32 GCalibrationSamples = 16;
+
+
+	static uint64 SteadyNanoseconds()
+	{
+		return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now().time_since_epoch()).count());
+	}
+
+#if defined(_M_X64) || defined(__x86_64__)
+
+	static bool HasInvariantTSC()
+	{
+		// CPUID 0x80000007, EDX bit 8: the TSC runs at a constant rate in every power state
+#if ENGINE_MSVC_COMPILER
+		int registers[4];
+		__cpuid(registers, 0x80000000);
+
+		if (static_cast<uint32>(registers[0]) < 0x80000007)
+		{
+			return false;
+		}
+
+		__cpuid(registers, 0x80000007);
+
+		return (registers[3] & (1 << 8)) != 0;
+#else
+		unsigned int eax, ebx, ecx, edx;
+
+		return __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) != 0 && (edx & (1u << 8)) != 0;
+#endif
+	}
+
+	static uint64 MultiplyShift(uint64 InValue, uint64 InMultiplier)
+	{
+#if ENGINE_MSVC_COMPILER
+		uint64 high;
+		const uint64 low = _umul128(InValue, InMultiplier, &high);
+
+		return __shiftright128(low, high, GMultiplierShift);
+#else
+		return static_cast<uint64>((static_cast<unsigned __int128>(InValue) * InMultiplier) >> GMultiplierShift);
+#endif
+	}
+
+	/** A TSC reading and the OS clock time it was taken at. */
+	static void SampleClocks(uint64& OutTicks, uint64& OutNanoseconds)
+	{
+		uint64 bestGap = ~uint64(0);
+
+		for (uint32 i = 0; i < GCalibrationSamples; ++i)
+		{
+			const uint64 before = SteadyNanoseconds();
+			const uint64 ticks = __rdtsc();
+			const uint64 after = SteadyNanoseconds();
+
+			// an interrupt or a migration between the readings widens the gap
+			if (after - before < bestGap)
+			{
+				bestGap = after - before;
+
+				OutTicks = ticks;
+				OutNanoseconds = before + bestGap / 2;
+			}
+		}
+	}
+
+#endif
+
+	static SClockCalibration Calibrate()
+	{
+		SClockCalibration calibration;
+
+#if defined(_M_X64) || defined(__x86_64__)
+		if (HasInvariantTSC())
+		{
+			uint64 startTicks = 0, startNanoseconds = 0;
+			SampleClocks(startTicks, startNanoseconds);
+
+			std::this_thread::sleep_for(GCalibrationTime);
+
+			uint64 endTicks = 0, endNanoseconds = 0;
+			SampleClocks(endTicks, endNanoseconds);
+
+			const double frequency = static_cast<double>(endTicks - startTicks) * 1e9 / static_cast<double>(endNanoseconds - startNanoseconds);
+
+			// anything outside of 100 MHz - 10 GHz is a TSC broken by virtualization
+			if (endTicks > startTicks && endNanoseconds > startNanoseconds && frequency > 1e8 && frequency < 1e10)
+			{
+				calibration.Origin = startTicks;
+				calibration.Multiplier = static_cast<uint64>(1e9 / frequency * static_cast<double>(uint64(1) << GMultiplierShift) + 0.5);
+				calibration.Frequency = frequency;
+				calibration.bTSC = true;
+
+				return calibration;
+			}
+		}
+#endif
+
+		calibration.Origin = SteadyNanoseconds();
+
+		return calibration;
+	}
+
+	static const SClockCalibration& GetCalibration()
+	{
+		static const SClockCalibration calibration = Calibrate();
+		return calibration;
+	}
+
+
+	/****/
+	/* TIMER */
+
+	uint64 Timer::GetTicks()
+	{
+#if defined(_M_X64) || defined(__x86_64__)
+		if (GetCalibration().bTSC)
+		{
+			return __rdtsc();
+		}
+#endif
+
+		return SteadyNanoseconds();
+	}
+
+	TimeSpan Timer::ToTimeSpan(uint64 InTicks)
+	{
+#if defined(_M_X64) || defined(__x86_64__)
+		const SClockCalibration& calibration = GetCalibration();
+
+		if (calibration.bTSC)
+		{
+			return TimeSpan(static_cast<int64>(MultiplyShift(InTicks, calibration.Multiplier)));
+		}
+#endif
+
+		return TimeSpan(static_cast<int64>(InTicks));
+	}
+
+	uint64 Timer::ToTicks(TimeSpan InTime)
+	{
+		const double nanoseconds = static_cast<double>(InTime.GetNanoseconds());
+
+		return static_cast<uint64>(nanoseconds * GetCalibration().Frequency * 1e-9 + 0.5);
+	}
+
+	TimeSpan Timer::Now()
+	{
+		const SClockCalibration& calibration = GetCalibration();
+
+#if defined(_M_X64) || defined(__x86_64__)
+		if (calibration.bTSC)
+		{
+			return TimeSpan(static_cast<int64>(MultiplyShift(__rdtsc() - calibration.Origin, calibration.Multiplier)));
+		}
+#endif
+
+		return TimeSpan(static_cast<int64>(SteadyNanoseconds() - calibration.Origin));
+	}
+
+	double Timer::GetFrequency()
+	{
+		return GetCalibration().Frequency;
+	}
+
+	bool Timer::IsUsingTSC()
+	{
+		return GetCalibration().bTSC;
+	}
+
+
+	/****/
+	/* STOPWATCH */
+
+	Stopwatch::Stopwatch(bool bInStart)
+	{
+		if (bInStart)
+		{
+			Start();
+		}
+	}
+
+	void Stopwatch::Start()
+	{
+		if (!bRunning)
+		{
+			StartTicks = Timer::GetTicks();
+			bRunning = true;
+		}
+	}
+
+	void Stopwatch::Stop()
+	{
+		if (bRunning)
+		{
+			Accumulated += Timer::GetElapsed(StartTicks);
+			bRunning = false;
+		}
+	}
+
+	void Stopwatch::Reset()
+	{
+		Accumulated = TimeSpan::Zero();
+		bRunning = false;
+	}
+
+	TimeSpan Stopwatch::Restart()
+	{
+		const uint64 now = Timer::GetTicks();
+		const TimeSpan elapsed = bRunning ? Accumulated + Timer::ToTimeSpan(now - StartTicks) : Accumulated;
+
+		Accumulated = TimeSpan::Zero();
+		StartTicks = now;
+		bRunning = true;
+
+		return elapsed;
+	}
+
+	TimeSpan Stopwatch::GetElapsed() const
+	{
+		return bRunning ? Accumulated + Timer::GetElapsed(StartTicks) : Accumulated;
+	}
 
-}
\ No newline at end of file
+}
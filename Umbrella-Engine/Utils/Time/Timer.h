@@ -1,19 +1,75 @@
 #pragma once
+#include "TimeSpan.h"
 
 
 
 namespace J::Utils
 {
 
+	/**
+	 * Monotonic high-resolution clock of the engine.
+	 *
+	 * On x86 CPUs with an invariant TSC a reading is one rdtsc, converted with a factor calibrated against the
+	 * OS monotonic clock (steady_clock: CLOCK_MONOTONIC, QueryPerformanceCounter) on first use. Elsewhere the
+	 * ticks are steady_clock nanoseconds. Ticks only mean something within the process.
+	 */
 	class Timer
 	{
 	public:
 
+		/** Raw reading, the cheapest way to timestamp (profiler events, ...). */
+		static uint64 GetTicks();
 
+		/** Converts a number of ticks (the difference of two readings) to a span. */
+		static TimeSpan ToTimeSpan(uint64 InTicks);
+
+		/** Number of ticks in a positive span, to put times from other clocks (the GPU) on this one. */
+		static uint64 ToTicks(TimeSpan InTime);
+
+		/** Time since the clock was calibrated, close to the process start. */
+		static TimeSpan Now();
+
+		static TimeSpan GetElapsed(uint64 InStartTicks) { return ToTimeSpan(GetTicks() - InStartTicks); }
+
+		/** Ticks per second, 1e9 when the TSC is not used. */
+		static double GetFrequency();
+
+		static bool IsUsingTSC();
+	};
+
+
+	/**
+	 * Measures the time spent between Start and Stop, accumulated over several runs.
+	 */
+	class Stopwatch
+	{
+	public:
+
+		/** \param bInStart - Starts measuring right away. */
+		explicit Stopwatch(bool bInStart = true);
+
+		void Start();
+
+		void Stop();
+
+		/** Stops and clears the measured time. */
+		void Reset();
+
+		/** Starts again from zero, returning the time measured so far (the duration of a frame, ...). */
+		TimeSpan Restart();
+
+		TimeSpan GetElapsed() const;
+
+		bool IsRunning() const { return bRunning; }
 
 	private:
 
+		uint64		StartTicks	= 0;
+
+		// of the runs stopped so far
+		TimeSpan	Accumulated;
 
+		bool		bRunning	= false;
 	};
 
 }